@@ -90,8 +90,9 @@ int par_InitRXoperation(){
 void par_RXoperation(){
 
 	int32_t ret;
-	uint32_t len;
+	int32_t len;
 	uint8_t outbuf[BUFSIZE];
+	struct msgQ_rx_meta meta;
 	int status;
 
 	memset(outbuf, 0, BUFSIZE);
@@ -174,13 +175,16 @@ void par_RXoperation(){
 
 		}
 
-		len = recvMQ(outbuf);
+		len = recvMQ(outbuf, &meta);
 		if(len<0)
 			continue;
 
 		else if(len >0)
 		{
-			memcpy(&g_Packet,outbuf,len);
+			/* RSU 정보는 WSM body 에서, 수신 파워/RCPI 는 수신 메타데이터에서 얻는다 */
+			memcpy(&g_Packet, outbuf, ((uint32_t)len < sizeof(struct rsuInfo_t)) ? (uint32_t)len : sizeof(struct rsuInfo_t));
+			g_Packet.rxpower = meta.rxpower / 2;
+			g_Packet.rcpi = meta.rcpi;
 			if(g_Packet.rsuID >0 && g_Packet.rsuID <=g_mib.rsuNum)
 			{
 				stPARInfo[g_Packet.rsuID].check =1;
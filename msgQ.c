@@ -86,9 +86,26 @@ void releaseMQ(void)
 	}
 }
 
-int recvMQ(char *pkt)
+/****************************************************************************************
+
+  recvMQ()
+  prcsWSM 으로부터 수신 WSM 을 전달받는다.
+  msg 앞의 수신 메타데이터 헤더(struct msgQ_rx_meta)를 분리하여 meta 로 반환하고,
+  pkt 에는 WSM body 만 복사한다.
+
+  arguments
+    pkt  : WSM body 가 저장될 버퍼
+    meta : 수신 메타데이터가 저장될 구조체 (NULL 이면 반환하지 않는다)
+
+  return
+    성공 시 WSM body 길이, 실패 시 -1
+
+ ****************************************************************************************/
+int recvMQ(char *pkt, struct msgQ_rx_meta *meta)
 {
 	static int cnt = 0;
+	const struct msgQ_rx_meta *hdr;
+
 	memset(recvPkt->msg.msg, 0, recvPkt->msg.msg_len);
 
 
@@ -108,10 +125,23 @@ int recvMQ(char *pkt)
 			syslog(LOG_INFO | LOG_LOCAL2, "[PAR] %dth MQ receive(len: %d)\n", cnt, recvPkt->msg.msg_len);
 		}
 #endif
-		memcpy(pkt, recvPkt->msg.msg, recvPkt->msg.msg_len);
+		hdr = (const struct msgQ_rx_meta *)recvPkt->msg.msg;
+		if( (recvPkt->msg.msg_len < sizeof(struct msgQ_rx_meta)) ||
+			(hdr->version != MSGQ_RX_META_VERSION) ||
+			(hdr->hdr_len < sizeof(struct msgQ_rx_meta)) ||
+			(hdr->hdr_len > recvPkt->msg.msg_len) )
+		{
+			syslog(LOG_ERR | LOG_LOCAL3, "[PAR] MQ receive error : invalid rx meta header(len: %u)", recvPkt->msg.msg_len);
+			return -1;
+		}
+		if( meta != NULL )
+		{
+			memcpy(meta, hdr, sizeof(struct msgQ_rx_meta));
+		}
+		memcpy(pkt, recvPkt->msg.msg + hdr->hdr_len, recvPkt->msg.msg_len - hdr->hdr_len);
 	}
 
-	return recvPkt->msg.msg_len;
+	return recvPkt->msg.msg_len - hdr->hdr_len;
 }
 
 void sendMQ(uint8_t *pPkt, uint32_t len)
@@ -53,8 +53,8 @@ struct PAR_Packet_t{
 	int rsuID;//prcsWSM으로부터 받은 RSU_ID
 	int32_t RLatitude; //prcsWSM으로부터 받은 위도 int32_t int; 4Byte
 	int32_t RLongitude;//prcsWSM으로부터 받은 경도
-	int16_t rxpower; //prcsWSM으로부터 받은 RXPOWER int16_t short int 2Byte
-	uint8_t rcpi; // prcsWSM으로부터 받은 rcpi uint8_t unsigned char 1Byte
+	int16_t rxpower; //prcsWSM 수신 메타데이터의 RXPOWER (dBm)
+	uint8_t rcpi; // prcsWSM 수신 메타데이터의 rcpi
 
 };
 
@@ -146,7 +146,7 @@ static void* rxThread(void *notused);
 /* msgQ.c */
 int initMQ(void);
 void releaseMQ(void);
-int recvMQ(char *pkt);
+int recvMQ(char *pkt, struct msgQ_rx_meta *meta);
 void sendMQ(uint8_t *pPkt, uint32_t len);
 
 /* shm.c */
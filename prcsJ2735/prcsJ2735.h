@@ -7,6 +7,7 @@
 #include <gps.h>
 #include <hexdump.h>
 #include <syslog.h>
+#include <msgQ.h>
 
 #define ADDRSIZE 20
 
@@ -89,7 +90,7 @@ void asn1_xer_printf(const ASN1CType *msg_type, void* msg);
 /* msgQ.c */
 int initMQ(void);
 void releaseMQ(void);
-int recvMQ(char *pkt);
+int recvMQ(char *pkt, struct msgQ_rx_meta *meta);
 void sendMQ(uint8_t *pPkt, uint32_t len);
 /* txJ2735.c */ 
 void setJ2735tx();
@@ -62,6 +62,7 @@ void setJ2735rx()
     void *msg;
     ASN1Error err;
     char pkt[kMpduMaxSize] = {0, };
+    struct msgQ_rx_meta meta;
     int timeCheck = 0;
 
     /* 현재 시간 획득 */
@@ -155,7 +156,7 @@ void setJ2735rx()
         }
 #endif
         /* msgQ read */
-        result = recvMQ(pkt);
+        result = recvMQ(pkt, &meta);
         if(result < 0 )
             continue;
         else
@@ -175,6 +176,9 @@ void setJ2735rx()
                     //printf("[prcsJ2735] Decoding success\n");
                     //asn1_xer_printf(asn1_type_MessageFrame, msg);
                     syslog(LOG_INFO | LOG_LOCAL0, "[prcsJ2735] Decoding success\n");
+                    syslog(LOG_INFO | LOG_LOCAL0, "[prcsJ2735]   if%u ch%u ts%u rxpower: %d(0.5dBm), rcpi: %u, src: %02X:%02X:%02X:%02X:%02X:%02X\n",
+                            meta.ifindex, meta.channel, meta.timeslot, meta.rxpower, meta.rcpi,
+                            meta.src_mac[0], meta.src_mac[1], meta.src_mac[2], meta.src_mac[3], meta.src_mac[4], meta.src_mac[5]);
                 }
 
                 /* 1초 계산 획득 */
@@ -0,0 +1,423 @@
+/**
+ * @file v2x-obu-bench.c
+ * @date 2026-10-19
+ * @author gyun
+ * @brief prcsWSM 송수신 처리성능 측정 프로그램
+ *
+ * 하드웨어 없이 prcsWSM 의 송수신 경로 처리성능을 측정한다. 모의 액세스계층 라이브러리(libwlanaccess, TARGET_DEVICE=fake)와 링크한다.
+ *  - rx : 생성한 WSM MPDU 를 V2X_OBU_ProcessRxMpdu() 로 직접 처리하며 MPDU 별 처리시간을 측정한다.
+ *  - tx : 송신 메시지큐에 WSM body 를 넣고, 메시지큐 수신쓰레드 -> 송신 스케줄러 -> 송신쓰레드 -> Al_TransmitMpdu()
+ *         -> 송신결과 콜백까지의 처리성능을 측정한다. (지연시간 분포는 송신 통계의 히스토그램으로부터 계산한다)
+ * 결과로 초당 처리 개수, 프레임 당 CPU 시간, 지연시간 백분위수를 출력한다.
+ */
+
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <inttypes.h>
+#include <time.h>
+#include <sys/ipc.h>
+#include <sys/msg.h>
+
+#include "v2x-obu.h"
+
+
+/// 측정 동작
+enum eBenchMode {
+  kBenchMode_rx,
+  kBenchMode_tx,
+};
+
+/// 측정 설정
+struct BenchConfig {
+  int mode;
+  uint32_t count;             ///< 측정할 프레임 개수
+  uint32_t warmup;            ///< 측정 전 처리할 프레임 개수 (rx)
+  uint32_t sizes[8];          ///< WSM body 길이분포
+  uint32_t size_num;
+  Dot3Psid psid;              ///< WSM PSID
+  bool deliver;               ///< 수신 WSM 을 메시지큐로 전달할지 여부 (rx)
+  Dot3TimeSlot timeslot;      ///< 송신 TimeSlot (tx)
+  uint32_t rate;              ///< 초당 송신요청 개수 (tx, 0 이면 메시지큐가 허용하는 최대 속도)
+  uint32_t timeout;           ///< 송신결과 대기시간 (msec, tx)
+};
+
+static struct BenchConfig g_bench;
+
+
+/**
+ * 현재 프로세스의 CPU 사용시간을 반환한다.
+ *
+ * @return  CLOCK_PROCESS_CPUTIME_ID 시각 (나노초)
+ */
+static uint64_t Bench_GetCpuTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * 64비트 정수 비교함수 (qsort 용)
+ */
+static int Bench_CompareU64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+
+/**
+ * 정렬된 표본에서 백분위수를 반환한다.
+ *
+ * @param sorted    오름차순 정렬된 표본
+ * @param num       표본 개수
+ * @param pct       백분위 (0~100)
+ * @return          백분위수
+ */
+static uint64_t Bench_Percentile(const uint64_t *sorted, const uint32_t num, const double pct)
+{
+    uint32_t idx = (uint32_t)((pct / 100.0) * (double)(num - 1) + 0.5);
+    return sorted[idx];
+}
+
+
+/**
+ * 쉼표로 구분된 WSM body 길이분포를 파싱한다.
+ *
+ * @param str   길이분포 문자열 (예: "100,300,1000")
+ * @return      성공 시 0, 실패 시 -1
+ */
+static int Bench_ParseSizes(const char *str)
+{
+    char buf[128];
+    char *saveptr, *tok;
+
+    snprintf(buf, sizeof(buf), "%s", str);
+    g_bench.size_num = 0;
+    for (tok = strtok_r(buf, ",", &saveptr); tok != NULL; tok = strtok_r(NULL, ",", &saveptr)) {
+        uint32_t size = (uint32_t)strtoul(tok, NULL, 0);
+        if ((size > kWsmBodySafeMaxSize) || (g_bench.size_num >= sizeof(g_bench.sizes) / sizeof(g_bench.sizes[0]))) {
+            fprintf(stderr, "Invalid size list %s\n", str);
+            return -1;
+        }
+        g_bench.sizes[g_bench.size_num++] = size;
+    }
+    return (g_bench.size_num > 0) ? 0 : -1;
+}
+
+
+/**
+ * 수신 WSM 을 전달받는 메시지큐를 비우는 쓰레드 함수 (prcsJ2735 역할)
+ */
+static void* Bench_DrainRxMQThread(void *arg)
+{
+    struct msgQ_elem_frame *frame = calloc(1, sizeof(struct msgQ_elem_frame));
+    int fd = msgget((key_t)KEY_RECV_J2735, IPC_CREAT | 0666);
+    (void)arg;
+    if ((frame == NULL) || (fd < 0)) {
+        return NULL;
+    }
+    while (1) {
+        msgrcv(fd, (char *)frame, sizeof(struct msgQ_elem_frame) - sizeof(long), 0, 0);
+    }
+    return NULL;
+}
+
+
+/**
+ * 수신 처리성능을 측정한다.
+ *  - 길이분포의 각 길이마다 WSM MPDU 를 생성하여 순서대로 V2X_OBU_ProcessRxMpdu() 를 호출한다.
+ *
+ * @return  성공 시 0, 실패 시 -1
+ */
+static int Bench_RunRx(void)
+{
+    static uint8_t mpdu[8][kMpduMaxSize];
+    static uint8_t payload[kMpduMaxSize];
+    int mpdu_size[8];
+    struct Dot3WsmMpduTxParams params;
+    struct msgQ_rx_meta meta;
+    pthread_t drain_thread;
+
+    g_mib.op = opRX;
+    if (g_bench.deliver) {
+        g_mib.psid = g_bench.psid;
+        if (initMQ() < 0) {
+            fprintf(stderr, "Fail to initialize message queue\n");
+            return -1;
+        }
+        pthread_create(&drain_thread, NULL, Bench_DrainRxMQThread, NULL);
+    }
+
+    /*
+     * 수신 MPDU 생성
+     */
+    memset(payload, 0xA5, sizeof(payload));
+    for (uint32_t i = 0; i < g_bench.size_num; i++) {
+        memset(&params, 0, sizeof(params));
+        params.hdr_extensions.chan_num = true;
+        params.hdr_extensions.datarate = true;
+        params.hdr_extensions.transmit_power = true;
+        params.chan_num = IF0_CHAN_NUM;
+        params.timeslot = kDot3TimeSlot_Continuous;
+        params.datarate = IF0_DATARATE;
+        params.transmit_power = IF0_POWER;
+        params.priority = 5;
+        params.psid = g_bench.psid;
+        memset(params.dst_mac_addr, 0xff, kDot3MacAddrSize);
+        memcpy(params.src_mac_addr, g_if1_mac_address, kDot3MacAddrSize);
+        mpdu_size[i] = Dot3_ConstructWsmMpdu(&params, payload, g_bench.sizes[i], mpdu[i], kMpduMaxSize);
+        if (mpdu_size[i] < 0) {
+            fprintf(stderr, "Fail to construct WSM MPDU(size: %u) - %d\n", g_bench.sizes[i], mpdu_size[i]);
+            return -1;
+        }
+    }
+
+    uint64_t *lat = malloc(sizeof(uint64_t) * g_bench.count);
+    if (lat == NULL) {
+        return -1;
+    }
+
+    memset(&meta, 0, sizeof(meta));
+    meta.version = MSGQ_RX_META_VERSION;
+    meta.hdr_len = sizeof(meta);
+    meta.channel = IF0_CHAN_NUM;
+    meta.datarate = IF0_DATARATE;
+
+    for (uint32_t n = 0; n < g_bench.warmup; n++) {
+        uint32_t i = n % g_bench.size_num;
+        V2X_OBU_ProcessRxMpdu(mpdu[i], (uint16_t)mpdu_size[i], &meta);
+    }
+
+    /*
+     * 측정
+     */
+    uint64_t bytes = 0;
+    uint64_t cpu_start = Bench_GetCpuTimeNs();
+    uint64_t start = V2X_OBU_GetMonoTimeNs();
+    for (uint32_t n = 0; n < g_bench.count; n++) {
+        uint32_t i = n % g_bench.size_num;
+        uint64_t t0 = V2X_OBU_GetMonoTimeNs();
+        meta.mono_ns = t0;
+        V2X_OBU_ProcessRxMpdu(mpdu[i], (uint16_t)mpdu_size[i], &meta);
+        lat[n] = V2X_OBU_GetMonoTimeNs() - t0;
+        bytes += (uint64_t)mpdu_size[i];
+    }
+    uint64_t elapsed = V2X_OBU_GetMonoTimeNs() - start;
+    uint64_t cpu = Bench_GetCpuTimeNs() - cpu_start;
+
+    qsort(lat, g_bench.count, sizeof(uint64_t), Bench_CompareU64);
+    printf("rx: %u frames in %.3f s (psid %u, %s)\n", g_bench.count, (double)elapsed / 1e9, g_bench.psid,
+           g_bench.deliver ? "delivered to message queue" : "parse only");
+    printf("  throughput : %.0f frames/s, %.1f Mbps\n",
+           (double)g_bench.count * 1e9 / (double)elapsed, (double)bytes * 8.0 * 1e3 / (double)elapsed);
+    printf("  cpu        : %.0f ns/frame\n", (double)cpu / (double)g_bench.count);
+    printf("  latency(ns): p50 %"PRIu64", p90 %"PRIu64", p99 %"PRIu64", p99.9 %"PRIu64", max %"PRIu64"\n",
+           Bench_Percentile(lat, g_bench.count, 50.0), Bench_Percentile(lat, g_bench.count, 90.0),
+           Bench_Percentile(lat, g_bench.count, 99.0), Bench_Percentile(lat, g_bench.count, 99.9),
+           lat[g_bench.count - 1]);
+    printf("  counters   : parse_fail %"PRIu64", rx_ipc %"PRIu64", rx_ipc_fail %"PRIu64"\n",
+           g_cnt[0].rx_parse_fail, g_cnt[0].rx_ipc, g_cnt[0].rx_ipc_fail);
+    free(lat);
+    return 0;
+}
+
+
+/**
+ * 송신 지연 히스토그램에서 백분위수 구간의 상한을 반환한다.
+ *
+ * @param hist      히스토그램 (구간 i = [2^i, 2^(i+1)) usec)
+ * @param pct       백분위 (0~100)
+ * @return          백분위수가 속한 구간의 상한 (usec)
+ */
+static uint64_t Bench_HistPercentile(const uint32_t *hist, const double pct)
+{
+    uint64_t total = 0, acc = 0;
+    for (int i = 0; i < V2X_OBU_LATENCY_HIST_BIN_NUM; i++) {
+        total += hist[i];
+    }
+    for (int i = 0; i < V2X_OBU_LATENCY_HIST_BIN_NUM; i++) {
+        acc += hist[i];
+        if ((double)acc >= (pct / 100.0) * (double)total) {
+            return 1ULL << (i + 1);
+        }
+    }
+    return 1ULL << V2X_OBU_LATENCY_HIST_BIN_NUM;
+}
+
+
+/**
+ * 송신 처리성능을 측정한다.
+ *  - 송신 요청 속도가 지정되지 않으면, 송신 메시지큐가 허용하는 최대 속도로 요청을 넣는다.
+ *    (메시지큐가 가득 차면 msgsnd() 가 대기한다. 송신 스케줄러 큐가 가득 차면 요청이 버려진다)
+ *  - 모든 요청이 송신결과를 받거나 버려질 때까지 대기한다.
+ *
+ * @return  성공 시 0, 실패 시 -1
+ */
+static int Bench_RunTx(void)
+{
+    struct V2X_OBU_TxStats if_stats[V2X_OBU_IF_MAX_NUM];
+    struct V2X_OBU_TxStats psid_stats[V2X_OBU_TX_STATS_PSID_MAX_NUM];
+    Dot3Psid psid[V2X_OBU_TX_STATS_PSID_MAX_NUM];
+    struct V2X_OBU_TxSchedStats sched_stats[kV2XObuAc_Num];
+    static struct msgQ_elem_frame frame;
+    uint32_t done = 0, dropped = 0;
+
+    g_mib.op = opTX;
+    g_mib.psid = g_bench.psid;
+    g_mib.ifs[0].timeSlot = g_bench.timeslot;
+    if (V2X_OBU_OpenAccessLibrary(0) < 0) {
+        return -1;
+    }
+    if (initMQ() < 0) {
+        fprintf(stderr, "Fail to initialize message queue\n");
+        return -1;
+    }
+    if (V2X_OBU_InitWsmTx(WSM_TX_INTERVAL) < 0) {
+        return -1;
+    }
+    int fd = msgget((key_t)KEY_SEND_J2735, IPC_CREAT | 0666);
+    if (fd < 0) {
+        return -1;
+    }
+
+    uint64_t bytes = 0;
+    uint64_t cpu_start = Bench_GetCpuTimeNs();
+    uint64_t start = V2X_OBU_GetMonoTimeNs();
+    memset(frame.msg.msg, 0x5A, sizeof(frame.msg.msg));
+    frame.msgtype = 1; // 인터페이스 0
+    for (uint32_t n = 0; n < g_bench.count; n++) {
+        if (g_bench.rate) {
+            uint64_t due = start + ((uint64_t)n * 1000000000ULL) / g_bench.rate;
+            struct timespec ts = { .tv_sec = (time_t)(due / 1000000000ULL), .tv_nsec = (long)(due % 1000000000ULL) };
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        }
+        frame.msg.msg_len = g_bench.sizes[n % g_bench.size_num];
+        if (msgsnd(fd, (char *)&frame, sizeof(struct msgQ_elem_frame) - sizeof(long), 0) < 0) {
+            fprintf(stderr, "Fail to msgsnd() - %s\n", strerror(errno));
+            return -1;
+        }
+        bytes += frame.msg.msg_len;
+    }
+
+    uint64_t deadline = V2X_OBU_GetMonoTimeNs() + (uint64_t)g_bench.timeout * 1000000ULL;
+    do {
+        V2X_OBU_GetTxStats(if_stats, psid, psid_stats);
+        V2X_OBU_GetTxSchedStats(0, sched_stats, NULL);
+        dropped = 0;
+        for (int ac = 0; ac < kV2XObuAc_Num; ac++) {
+            dropped += sched_stats[ac].expire_cnt + sched_stats[ac].overflow_cnt;
+        }
+        done = if_stats[0].complete_cnt + if_stats[0].submit_fail_cnt + if_stats[0].untracked_cnt + if_stats[0].lost_cnt + dropped;
+        if (done >= g_bench.count) {
+            break;
+        }
+        usleep(1000);
+    } while (V2X_OBU_GetMonoTimeNs() < deadline);
+    uint64_t elapsed = V2X_OBU_GetMonoTimeNs() - start;
+    uint64_t cpu = Bench_GetCpuTimeNs() - cpu_start;
+
+    const struct V2X_OBU_TxStats *s = &if_stats[0];
+    printf("tx: %u frames in %.3f s (psid %u, timeslot %u)%s\n", g_bench.count, (double)elapsed / 1e9,
+           g_bench.psid, g_bench.timeslot, (done < g_bench.count) ? " - timed out" : "");
+    printf("  throughput : %.0f frames/s, %.1f Mbps (WSM body)\n",
+           (double)s->complete_cnt * 1e9 / (double)elapsed, (double)bytes * 8.0 * 1e3 / (double)elapsed);
+    printf("  cpu        : %.0f ns/frame (all threads)\n", (double)cpu / (double)g_bench.count);
+    printf("  latency(us): p50 <%"PRIu64", p90 <%"PRIu64", p99 <%"PRIu64", p99.9 <%"PRIu64" (message queue ~ tx result)\n",
+           Bench_HistPercentile(s->hist_total, 50.0), Bench_HistPercentile(s->hist_total, 90.0),
+           Bench_HistPercentile(s->hist_total, 99.0), Bench_HistPercentile(s->hist_total, 99.9));
+    printf("  results    : complete %u (fail %u), submit_fail %u, untracked %u, lost %u, sched drop %u\n",
+           s->complete_cnt, s->complete_fail_cnt, s->submit_fail_cnt, s->untracked_cnt, s->lost_cnt, dropped);
+    return 0;
+}
+
+
+/**
+ * 사용법을 출력한다.
+ */
+static void Bench_Usage(const char *prog)
+{
+    printf("Usage: %s [options]\n", prog);
+    printf("  -m <rx|tx>    benchmark mode (default: rx)\n");
+    printf("  -n <count>    number of frames (default: 100000)\n");
+    printf("  -w <count>    number of warm-up frames, rx only (default: 1000)\n");
+    printf("  -s <sizes>    comma separated WSM body sizes (default: 100,300,1000)\n");
+    printf("  -p <psid>     WSM PSID (default: 32)\n");
+    printf("  -d            deliver received WSMs to message queue, rx only (PSID is subscribed)\n");
+    printf("  -t <slot>     tx timeslot, 0/1/2(continuous) (default: 2)\n");
+    printf("  -r <fps>      tx request rate, 0 for maximum (default: 0)\n");
+    printf("  -o <msec>     tx result wait timeout (default: 10000)\n");
+    printf("Access layer behavior is set by AL_FAKE_* environment variables of the fake libwlanaccess.\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+    int c;
+
+    memset(&g_mib, 0, sizeof(g_mib));
+    memset(g_mib.destMac, 0xff, kDot3MacAddrSize);
+    g_mib.ifs[0].enable = true;
+    g_mib.ifs[0].channel = IF0_CHAN_NUM;
+    g_mib.ifs[0].priority = 7;
+    g_mib.ifs[0].dataRate = IF0_DATARATE;
+    g_mib.ifs[0].power = IF0_POWER;
+    g_mib.ifs[0].lifetime = V2X_OBU_TX_DEFAULT_LIFETIME;
+    g_mib.ifs[0].macAddr = g_if_mac_address[0];
+    g_mib.ifs[0].txCpu = CPU_NOT_SPECIFIED;
+    g_mib.ifs[0].rxCpu = CPU_NOT_SPECIFIED;
+
+    memset(&g_bench, 0, sizeof(g_bench));
+    g_bench.mode = kBenchMode_rx;
+    g_bench.count = 100000;
+    g_bench.warmup = 1000;
+    g_bench.psid = 32;
+    g_bench.timeslot = kDot3TimeSlot_Continuous;
+    g_bench.timeout = 10000;
+    Bench_ParseSizes("100,300,1000");
+
+    while ((c = getopt(argc, argv, "m:n:w:s:p:dt:r:o:h")) != -1) {
+        switch (c) {
+            case 'm':
+                if (!strcmp(optarg, "rx")) {
+                    g_bench.mode = kBenchMode_rx;
+                } else if (!strcmp(optarg, "tx")) {
+                    g_bench.mode = kBenchMode_tx;
+                } else {
+                    Bench_Usage(argv[0]);
+                    return -1;
+                }
+                break;
+            case 'n': g_bench.count = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'w': g_bench.warmup = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 's':
+                if (Bench_ParseSizes(optarg) < 0) {
+                    return -1;
+                }
+                break;
+            case 'p': g_bench.psid = (Dot3Psid)strtoul(optarg, NULL, 0); break;
+            case 'd': g_bench.deliver = true; break;
+            case 't': g_bench.timeslot = (Dot3TimeSlot)strtoul(optarg, NULL, 0); break;
+            case 'r': g_bench.rate = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'o': g_bench.timeout = (uint32_t)strtoul(optarg, NULL, 0); break;
+            default:
+                Bench_Usage(argv[0]);
+                return 0;
+        }
+    }
+    if ((g_bench.count == 0) || (g_bench.timeslot > kDot3TimeSlot_Continuous)) {
+        Bench_Usage(argv[0]);
+        return -1;
+    }
+
+    if (V2X_OBU_InitDot3Library(0) < 0) {
+        fprintf(stderr, "Fail to initialize dot3 library\n");
+        return -1;
+    }
+
+    if (g_bench.mode == kBenchMode_rx) {
+        return Bench_RunRx();
+    }
+    return Bench_RunTx();
+}
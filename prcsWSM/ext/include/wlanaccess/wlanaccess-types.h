@@ -112,6 +112,18 @@ struct AlMpduRxParams {
   uint8_t datarate;     /// MPDU 수신 데이터레이트
 };
 
+/// @brief 일괄 수신처리 콜백함수로 한 번에 전달되는 최대 MPDU 개수
+enum eAlRxBatch {
+  kAlRxBatch_MaxNum = 64,
+};
+
+/// @brief 일괄 수신처리 콜백함수로 전달되는 수신 MPDU 정보
+struct AlRxMpdu {
+  const uint8_t *mpdu;              /// 수신 MPDU (CRC 불포함)
+  AlMpduSize mpdu_size;             /// 수신 MPDU 길이
+  struct AlMpduRxParams rxparams;   /// 수신 파라미터
+};
+
 /// @brief MAC 주소 형식
 typedef uint8_t AlMacAddress[6];
 
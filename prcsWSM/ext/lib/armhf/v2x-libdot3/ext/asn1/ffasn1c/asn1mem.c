@@ -1,4 +1,3 @@
-
 /**
  * @file asn-base.h
  * @date 2019-080-92
@@ -16,9 +15,111 @@
  * void *asn1_realloc(void *ptr, size_t size);
  * void asn1_free(void *ptr);
  * @endcode
+ *
+ * 인코딩/디코딩 1회 동안 발생하는 할당은 쓰레드 별 bump 아레나에서 처리된다.
+ *  - dot3_FFAsn1c_BeginArena() ~ dot3_FFAsn1c_EndArena() 구간에서의 할당은 아레나의 사용 위치를 증가시키는 것으로 끝나며,
+ *    다음 dot3_FFAsn1c_BeginArena() 호출 시 O(1)로 초기화된다. malloc 경합과 장시간 동작 시의 힙 단편화가 발생하지 않는다.
+ *  - 아레나 공간이 부족하면 힙(malloc)에서 할당한다. 해당 메모리는 ffasn1c 의 asn1_free() 호출 시 해제된다.
+ *  - asn1_free() 는 아레나 내부 주소에 대해서는 아무것도 하지 않으므로, ffasn1c 의 해제 절차(asn1_free_value() 등)는
+ *    아레나 사용 여부와 관계없이 그대로 유지된다.
+ *  - 아레나는 쓰레드 별로 존재하므로, 여러 쓰레드에서 동시에 인코딩/디코딩해도 잠금이 필요 없다.
+ *  - 아레나는 쓰레드가 처음 dot3_FFAsn1c_BeginArena() 를 호출할 때 힙에 할당되고, 쓰레드 종료 시 해제된다.
+ *    (TLS 에는 포인터만 두므로, 인코딩/디코딩하지 않는 쓰레드는 아레나 메모리를 사용하지 않는다)
+ *    할당에 실패하면 아레나 없이 힙에서 할당한다.
  */
 
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include "dot3-ffasn1c.h"
+
+
+/// 쓰레드 별 아레나 크기
+///  - 최대 길이 WSA(2279바이트, Service info 31개, 모든 확장필드 포함) 인코딩 시 사용량(약 54KB, 할당 995회)의 2배 이상
+#define DOT3_FFASN1C_ARENA_SIZE (128 * 1024)
+/// 아레나 할당 단위 정렬 크기
+#define DOT3_FFASN1C_ARENA_ALIGN (2 * sizeof(void *))
+
+/**
+ * 아레나에서 할당된 메모리 블록의 헤더 (재할당 시 복사할 크기를 알기 위해 사용된다)
+ */
+struct Dot3FFAsn1cArenaHdr
+{
+  size_t size;
+} __attribute__((aligned(DOT3_FFASN1C_ARENA_ALIGN)));
+
+/**
+ * 쓰레드 별 아레나
+ */
+struct Dot3FFAsn1cArena
+{
+  bool active;        ///< dot3_FFAsn1c_BeginArena() ~ dot3_FFAsn1c_EndArena() 구간인지 여부
+  size_t used;        ///< 현재 사용 위치
+  uint8_t *last;      ///< 마지막으로 할당된 블록 (제자리 재할당에 사용)
+  uint8_t buf[DOT3_FFASN1C_ARENA_SIZE] __attribute__((aligned(DOT3_FFASN1C_ARENA_ALIGN)));
+};
+
+static pthread_key_t g_arena_key;                       ///< 쓰레드 종료 시 아레나 해제를 위한 키
+static pthread_once_t g_arena_once = PTHREAD_ONCE_INIT;
+static __thread struct Dot3FFAsn1cArena *t_arena;       ///< 호출 쓰레드의 아레나 (처음 사용할 때 할당된다)
+static __thread struct Dot3FFAsn1cArenaStats t_stats;   ///< 호출 쓰레드의 마지막 인코딩/디코딩 메모리 할당 통계
+
+
+/**
+ * @brief 쓰레드 종료 시 해당 쓰레드의 아레나를 해제한다.
+ * @param arena 해제할 아레나
+ */
+static void dot3_FFAsn1c_FreeArena(void *arena)
+{
+  free(arena);
+}
+
+
+/**
+ * @brief 아레나 해제를 위한 키를 생성한다. (프로세스 당 한번)
+ */
+static void dot3_FFAsn1c_CreateArenaKey(void)
+{
+  pthread_key_create(&g_arena_key, dot3_FFAsn1c_FreeArena);
+}
+
+
+/**
+ * @brief 메모리가 아레나 내부에 있는지 확인한다.
+ * @param ptr 확인할 메모리 주소
+ * @return 아레나 내부이면 true
+ */
+static inline bool dot3_FFAsn1c_IsArenaPtr(const void *const ptr)
+{
+  return t_arena &&
+         ((const uint8_t *)ptr >= t_arena->buf) && ((const uint8_t *)ptr < t_arena->buf + DOT3_FFASN1C_ARENA_SIZE);
+}
+
+
+/**
+ * @brief 아레나에서 메모리 공간을 할당한다.
+ * @param size 할당할 크기
+ * @return 할당된 메모리 공간 주소, 아레나 공간이 부족하면 NULL
+ */
+static void *dot3_FFAsn1c_AllocFromArena(size_t size)
+{
+  size_t need = sizeof(struct Dot3FFAsn1cArenaHdr) +
+                ((size + DOT3_FFASN1C_ARENA_ALIGN - 1) & ~(DOT3_FFASN1C_ARENA_ALIGN - 1));
+  if ((size > DOT3_FFASN1C_ARENA_SIZE) || (need > DOT3_FFASN1C_ARENA_SIZE - t_arena->used)) {
+    return NULL;
+  }
+  struct Dot3FFAsn1cArenaHdr *hdr = (struct Dot3FFAsn1cArenaHdr *)(t_arena->buf + t_arena->used);
+  hdr->size = size;
+  t_arena->last = (uint8_t *)(hdr + 1);
+  t_arena->used += need;
+  if (t_arena->used > t_stats.peak_size) {
+    t_stats.peak_size = t_arena->used;
+  }
+  t_stats.alloc_cnt++;
+  return t_arena->last;
+}
+
 
 /**
  * @brief 메모리 공간을 할당한다.
@@ -27,6 +128,13 @@
  */
 void *asn1_malloc(size_t size)
 {
+  if (t_arena && t_arena->active) {
+    void *ptr = dot3_FFAsn1c_AllocFromArena(size);
+    if (ptr) {
+      return ptr;
+    }
+    t_stats.heap_alloc_cnt++;
+  }
   return malloc(size);
 }
 
@@ -35,17 +143,95 @@ void *asn1_malloc(size_t size)
  * @param ptr 할당되어 있는 메모리 공간 주소
  * @param size 재할당할 크기
  * @return 재할당된 메모리 공간 주소
+ *
+ * 아레나에서 할당된 메모리는, 마지막으로 할당된 블록이면 제자리에서 늘리고 그렇지 않으면 새로 할당하여 복사한다.
  */
 void *asn1_realloc(void *ptr, size_t size)
 {
-  return realloc(ptr, size);
+  if (!ptr) {
+    return asn1_malloc(size);
+  }
+  if (!dot3_FFAsn1c_IsArenaPtr(ptr)) {
+    return realloc(ptr, size);
+  }
+
+  struct Dot3FFAsn1cArenaHdr *hdr = (struct Dot3FFAsn1cArenaHdr *)ptr - 1;
+  if ((uint8_t *)ptr == t_arena->last) {
+    size_t start = (uint8_t *)hdr - t_arena->buf;
+    t_arena->used = start;
+    if (dot3_FFAsn1c_AllocFromArena(size)) {
+      t_stats.alloc_cnt--; // 제자리 재할당은 할당 횟수에 포함하지 않는다.
+      return ptr;
+    }
+    t_arena->used = start + sizeof(struct Dot3FFAsn1cArenaHdr) +
+                   ((hdr->size + DOT3_FFASN1C_ARENA_ALIGN - 1) & ~(DOT3_FFASN1C_ARENA_ALIGN - 1));
+  }
+  if (size <= hdr->size) {
+    return ptr;
+  }
+  void *new_ptr = asn1_malloc(size);
+  if (new_ptr) {
+    memcpy(new_ptr, ptr, hdr->size);
+  }
+  return new_ptr;
 }
 
 /**
  * @brief 할당된 메모리 공간을 해제한다.
  * @param ptr 해제할 메모리 공간 주소
+ *
+ * 아레나에서 할당된 메모리는 dot3_FFAsn1c_BeginArena() 호출 시 일괄 해제되므로 여기서는 해제하지 않는다.
  */
 void asn1_free(void *ptr)
 {
-  free(ptr);
+  if (!dot3_FFAsn1c_IsArenaPtr(ptr)) {
+    free(ptr);
+  }
+}
+
+
+/**
+ * @brief 호출 쓰레드의 아레나를 초기화하고, 이후의 ffasn1c 메모리 할당이 아레나에서 처리되도록 한다.
+ *
+ * 인코딩/디코딩 함수(dot3_FFAsn1c_EncodeWsm() 등) 호출 직전에 호출된다.
+ * 이전 인코딩/디코딩에서 아레나에 할당된 메모리는 모두 해제된다.
+ * 호출 쓰레드에서 처음 호출되면 아레나를 할당한다.
+ */
+void INTERNAL dot3_FFAsn1c_BeginArena(void)
+{
+  memset(&t_stats, 0, sizeof(t_stats));
+  if (!t_arena) {
+    pthread_once(&g_arena_once, dot3_FFAsn1c_CreateArenaKey);
+    t_arena = (struct Dot3FFAsn1cArena *)malloc(sizeof(struct Dot3FFAsn1cArena));
+    if (!t_arena) {
+      return; // 아레나 없이 힙에서 할당한다.
+    }
+    pthread_setspecific(g_arena_key, t_arena);
+  }
+  t_arena->used = 0;
+  t_arena->last = NULL;
+  t_arena->active = true;
+}
+
+
+/**
+ * @brief 호출 쓰레드의 ffasn1c 메모리 할당이 다시 힙에서 처리되도록 한다.
+ *
+ * 인코딩/디코딩 함수 호출 직후에 호출된다. 아레나 내용은 다음 dot3_FFAsn1c_BeginArena() 호출 시까지 유지된다.
+ */
+void INTERNAL dot3_FFAsn1c_EndArena(void)
+{
+  if (t_arena) {
+    t_arena->active = false;
+  }
+}
+
+
+/**
+ * @brief 호출 쓰레드에서 마지막으로 수행된 인코딩/디코딩의 메모리 할당 통계를 반환한다.
+ * @param stats 통계가 저장될 구조체의 주소
+ */
+void INTERNAL dot3_FFAsn1c_GetArenaStats(struct Dot3FFAsn1cArenaStats *const stats)
+{
+  *stats = t_stats;
 }
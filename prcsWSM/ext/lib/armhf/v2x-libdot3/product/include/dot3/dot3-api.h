@@ -11,11 +11,27 @@ extern "C" {
 
 #include "dot3-types.h"
 
+/*
+ * 쓰레드 안전성
+ *  - Dot3_Init() 은 다른 모든 API 와 동시에 호출될 수 없다. (다른 쓰레드들이 API 를 사용하기 전에 한번 호출한다)
+ *  - 인코딩/디코딩 API (Dot3_ConstructWsmMpdu*(), Dot3_Parse*WsmMpdu*(), Dot3_ConstructWsa(), Dot3_ParseWsa())는
+ *    재진입 가능하며, 여러 쓰레드에서 잠금 없이 동시에 호출할 수 있다.
+ *    인코딩/디코딩 중에 변경되는 상태(asn.1 아레나, WSA 인코딩 캐시, 통계)는 쓰레드 별 코덱 컨텍스트에 존재하며,
+ *    쓰레드가 처음 사용할 때 할당되고 쓰레드 종료 시 해제된다.
+ *    WSA 인코딩 캐시도 쓰레드 별로 존재하므로, 동일한 WSA 를 여러 쓰레드에서 생성하면 각 쓰레드에서 한번씩 인코딩된다.
+ *  - 쓰레드 간에 공유되는 상태는 PSR/WSR 테이블뿐이다. 인코딩/디코딩 API 는 이를 스냅샷(PSR) 또는 seqlock(WSR)으로 읽으므로,
+ *    테이블 변경 API (Dot3_Add*(), Dot3_Delete*(), Dot3_ChangePsr())와 동시에 호출되어도 이를 기다리지 않는다.
+ *  - 테이블 변경/조회 API 는 테이블 별 뮤텍스로 직렬화되며, 어느 쓰레드에서나 호출할 수 있다.
+ */
+
 /**
  * @brief dot3 라이브러리를 초기화한다. 다른 모든 dot3 API 호출 전에 호출되어야 한다.
  * @param log_level 로그출력레벨
  * @return 성공시 0, 실패시 음수(-Dot3ResultCode)
  *
+ * 다른 API 와 동시에 호출될 수 없다. 다시 호출되면 PSR/WSR 테이블이 초기화되며, 각 쓰레드의 WSA 인코딩 캐시는
+ * 해당 쓰레드의 다음 Dot3_ConstructWsa() 호출 시 무효화된다.
+ *
  * 로그출력레벨
  *  0 : 아무 로그도 출력하지 않는다.
  *  1 : 에러 로그
@@ -57,6 +73,51 @@ int Dot3_ConstructWsmMpdu(
   uint8_t *const outbuf,
   const Dot3PduSize outbuf_size);
 
+/**
+ * @brief 여러 개의 페이로드 조각으로 구성된 WSM body 를 갖는 WSM MPDU 의 생성을 요청한다.
+ * @param params        @ref Dot3_ConstructWsmMpdu
+ * @param frags         WSM body 를 구성할 페이로드 조각 배열을 전달한다. 배열 순서대로 WSM body 에 수납된다.
+ *                      frag_num 이 0 인 경우 NULL 을 전달할 수 있다.
+ * @param frag_num      frags 배열 내 페이로드 조각의 개수를 전달한다.
+ *                      0 을 전달할 경우, WSM body 가 없는 WSM MPDU 가 생성된다.
+ * @param outbuf        @ref Dot3_ConstructWsmMpdu
+ * @param outbuf_size   @ref Dot3_ConstructWsmMpdu (payload_size 대신 모든 페이로드 조각 길이의 합을 기준으로 한다)
+ * @return              성공시 생성된 MPDU의 길이, 실패시 음수(-Dot3ResultCode)
+ *
+ * Dot3_ConstructWsmMpdu() 와 동일한 MPDU 를 생성하되, 페이로드 조각들을 하나의 버퍼로 미리 합칠 필요 없이
+ * 각 조각을 outbuf 내 WSM body 위치에 바로 복사한다. (예: J2735 메시지 + 뒤에 붙는 보안/메타데이터 블록)
+ * WSMP 헤더는 빌드 옵션(WSMP_CODEC)과 관계없이 자체 코덱으로 인코딩된다.
+ */
+int Dot3_ConstructWsmMpduV(
+  struct Dot3WsmMpduTxParams *const params,
+  const struct Dot3PayloadFragment *const frags,
+  const unsigned int frag_num,
+  uint8_t *const outbuf,
+  const Dot3PduSize outbuf_size);
+
+/**
+ * @brief 버퍼에 이미 저장되어 있는 페이로드 앞의 여유공간(headroom)에 헤더들을 채워 WSM MPDU 를 생성한다.
+ * @param params        @ref Dot3_ConstructWsmMpdu
+ * @param buf           앞쪽 headroom 바이트를 비워두고, 그 뒤에 페이로드(=WSM body)를 저장한 버퍼 포인터를 전달한다.
+ *                      NULL 은 전달할 수 없다.
+ * @param headroom      buf 내 페이로드 앞 여유공간의 크기를 전달한다.
+ *                      실제 필요한 크기는 송신파라미터에 따라 32~46 바이트이며, 되도록 kWsmMpduHdrMaxSize(46) 이상으로 한다.
+ * @param payload_size  buf + headroom 위치에 저장된 페이로드의 길이를 전달한다. 0 인 경우 WSM body 가 없는 WSM MPDU 가 생성된다.
+ * @param mpdu_offset   생성된 MPDU 의 buf 내 시작 위치가 저장될 변수 포인터를 전달한다.
+ *                      NULL 은 전달할 수 없다.
+ * @return              성공시 생성된 MPDU의 길이, 실패시 음수(-Dot3ResultCode)
+ *
+ * 페이로드를 복사하지 않으며, MAC/LLC/WSMP 헤더만 페이로드 바로 앞에 기록된다.
+ * 생성된 MPDU 는 buf + *mpdu_offset 위치에서 시작하며, 페이로드 뒤쪽의 buf 내용은 변경되지 않는다.
+ * WSMP 헤더는 빌드 옵션(WSMP_CODEC)과 관계없이 자체 코덱으로 인코딩된다.
+ */
+int Dot3_ConstructWsmMpduInPlace(
+  struct Dot3WsmMpduTxParams *const params,
+  uint8_t *const buf,
+  const Dot3PduSize headroom,
+  const Dot3PduSize payload_size,
+  Dot3PduSize *const mpdu_offset);
+
 /**
  * @brief 수신된 WSM(WAVE Short Message) MPDU(MAC Protocol Data Unit)에 대한 파싱을 요청한다.
  * @param mpdu              WSM MPDU(MAC CRC 필드 포함)가 저장된 버퍼 포인터를 전달한다.
@@ -87,12 +148,59 @@ int Dot3_ParseWsmMpdu(
   struct Dot3WsmMpduRxParams *const params,
   bool *const wsr_registered);
 
+/**
+ * @brief 수신된 WSM MPDU 를 파싱하여, WSM body 를 복사하지 않고 MPDU 내 위치와 길이로 반환한다.
+ * @param mpdu              WSM MPDU(MAC CRC 필드 포함)가 저장된 버퍼 포인터를 전달한다.
+ *                          NULL 은 사용할 수 없다.
+ * @param mpdu_size         mpdu 버퍼에 담긴 실제 MPDU 의 길이 (MAC CRC 필드 불포함)
+ * @param params            WSM 수신파라미터정보 구조체의 포인터를 전달한다
+ *                          WSM 관련 수신파라미터정보가 업데이트되어 반환된다.
+ *                          NULL 은 사용할 수 없다.
+ * @param payload_offset    mpdu 내 페이로드(=WSM body)의 시작 위치가 저장될 변수 포인터를 전달한다.
+ *                          NULL 은 사용할 수 없다.
+ * @param wsr_registered    @ref Dot3_ParseWsmMpdu
+ * @return                  성공시 페이로드의 길이, 실패시 음수(-Dot3ResultCode)
+ *
+ * Dot3_ParseWsmMpdu() 와 동일하게 파싱하되, 페이로드를 별도 버퍼에 복사하지 않는다.
+ * 페이로드는 mpdu + *payload_offset 위치에 있으며, mpdu 버퍼가 유효한 동안에만 접근할 수 있다.
+ * WSMP 헤더는 빌드 옵션(WSMP_CODEC)과 관계없이 자체 코덱으로 디코딩되며, 메모리 할당이 발생하지 않는다.
+ */
+int Dot3_ParseWsmMpduView(
+  const uint8_t *const mpdu,
+  const Dot3PduSize mpdu_size,
+  struct Dot3WsmMpduRxParams *const params,
+  Dot3PduSize *const payload_offset,
+  bool *const wsr_registered);
+
+/**
+ * @brief 수신된 WSM MPDU 중, WSR 테이블에 등록된 PSID 를 갖는 WSM 에 대해서만 페이로드를 반환한다.
+ * @param mpdu              @ref Dot3_ParseWsmMpdu
+ * @param mpdu_size         @ref Dot3_ParseWsmMpdu
+ * @param outbuf            @ref Dot3_ParseWsmMpdu
+ * @param outbuf_size       @ref Dot3_ParseWsmMpdu
+ * @param params            @ref Dot3_ParseWsmMpdu
+ * @param wsr_registered    @ref Dot3_ParseWsmMpdu
+ * @return                  성공시 outbuf 에 저장된 페이로드의 길이(등록되지 않은 PSID 인 경우 0), 실패시 음수(-Dot3ResultCode)
+ *
+ * WSMP 헤더까지만 디코딩하여 PSID 를 확인하고, WSR 테이블에 등록되지 않은 PSID 인 경우 페이로드를 복사하지 않고 바로 반환한다.
+ * 이 경우 *wsr_registered 에는 false 가 저장되며, outbuf 의 내용은 변경되지 않는다. (params 는 WSMP 헤더까지의 정보로 업데이트된다)
+ * 등록된 PSID 인 경우 Dot3_ParseWsmMpdu() 와 동일한 결과를 반환한다.
+ */
+int Dot3_ParseInterestedWsmMpdu(
+  const uint8_t *const mpdu,
+  const Dot3PduSize mpdu_size,
+  uint8_t *const outbuf,
+  const Dot3PduSize outbuf_size,
+  struct Dot3WsmMpduRxParams *const params,
+  bool *const wsr_registered);
+
 /**
  * @brief WSR(WAVE Service Request = 수신하고자 하는 WSM의 PSID)를 등록한다.
  * @param psid 관심 있는 PSID
  * @return 성공시 0, 실패시 음수(-Dot3ResultCode)
  *
- * 등록 요청된 PSID는 dot3 라이브러리 내부에서 관리되는 WSR 테이블에 저장된다.
+ * 등록 요청된 PSID는 dot3 라이브러리 내부에서 관리되는 WSR 테이블에 저장된다. (최대 kDot3WsrNum_MaxNum 개)
+ * WSR 테이블은 Dot3_ParseWsmMpdu() 등의 wsr_registered 반환값과 Dot3_ParseInterestedWsmMpdu() 의 필터링에 사용된다.
  */
 int Dot3_AddWsr(const Dot3Psid psid);
 
@@ -121,7 +229,7 @@ int Dot3_GetWsrNum(void);
 
 /**
  * @brief 등록되어 있는 모든 WSR들을 반환한다.
- * @param wsrs WSR들이 반환된다.
+ * @param wsrs WSR들이 등록된 순서대로 반환된다. kDot3WsrNum_MaxNum 개 이상의 크기를 갖는 배열이어야 한다.
  * @return 성공시 반환된 WSR의 개수(0 이상), 실패시 음수(-Dot3ResultCode)
  */
 int Dot3_GetAllWsrs(struct Dot3Wsr wsrs[]);
@@ -191,6 +299,10 @@ int Dot3_GetAllPsrs(struct Dot3Psr *psrs_array, const Dot3PsrNum psrs_array_size
 
 /**
  * WSA 생성을 요청한다.
+ *  - 마지막 생성 이후 PSR 테이블과 params 가 변경되지 않았으면 다시 인코딩하지 않고 이전에 생성된 WSA 를 반환한다.
+ *    content count 나 위치정보 값만 변경된 경우에도 이전에 생성된 WSA 의 해당 필드만 수정하여 반환한다.
+ *  - content count 는 params 에 전달된 값이 그대로 수납된다. 내용이 변경될 때 증가시키는 것은 호출자의 몫이다.
+ *  - 이전에 생성된 WSA 는 호출 쓰레드 별로 캐시되므로, 여러 쓰레드에서 잠금 없이 동시에 호출할 수 있다.
  *
  * @param params        WSA 생성을 위해 전달되는 정보
  * @param outbuf        생성된 WSA가 저장될 버퍼의 포인터
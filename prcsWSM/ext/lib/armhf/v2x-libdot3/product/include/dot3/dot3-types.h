@@ -65,6 +65,9 @@ enum eDot3ResultCode {
 
   kDot3Result_Fail_NotSupportedYet, ///< 아직 지원하지 않음
 
+  kDot3Result_Fail_NoSuchWsr, ///< 해당 WSR이 테이블에 존재하지 않음.
+  kDot3Result_Fail_WsrTableFull, ///< WSR 테이블이 꽉 참.
+  kDot3Result_Fail_SamePsidWsr, ///< 동일한 PSID를 갖는 WSR이 존재함.
 };
 /// @copydoc eDot3ResultCode
 typedef int Dot3ResultCode;
@@ -92,6 +95,7 @@ enum eDot3PduSize {
   kMpduMaxSizeWithCrc = (kQoSMacHdrSize + kMsduMaxSize + kMacCrcSize), ///< CRC 포함한 MPDU 최대크기(=2334)
   kWsmMpduMinSize = (kNonQosMacHdrSize + kLLCHdrSize + kWsmpHdrMinSize), ///< CRC 제외한 MPDU 최소크기(=32)
   kWsmMpduMinSizeWithCrc = (kNonQosMacHdrSize + kLLCHdrSize + kWsmpHdrMinSize + kMacCrcSize), ///< CRC 포함한 MPDU 최소크기(=36)
+  kWsmMpduHdrMaxSize = (kQoSMacHdrSize + kLLCHdrSize + kWsmpHdrMaxSize), ///< WSM MPDU 내 WSM body 앞 헤더들의 최대크기(=46)
   kPduSize_Max = kMpduMaxSize
 };
 /// @copydoc ePduSize
@@ -122,6 +126,16 @@ enum eDot3PsrNum
 typedef unsigned int Dot3PsrNum;  ///< @copydoc eDot3PsrNum
 
 
+/**
+ * WSR 관련 수
+ */
+enum eDot3WsrNum
+{
+  kDot3WsrNum_MaxNum = 128, ///< WSR 테이블 내 엔트리 최대 개수
+};
+typedef unsigned int Dot3WsrNum;  ///< @copydoc eDot3WsrNum
+
+
 /**
  * Provider Channel Info 관련 수
  */
@@ -587,6 +601,16 @@ struct Dot3WsmMpduRxParams
   Dot3Psid psid; ///< PSID
 };
 
+/**
+ * WSM body 를 구성하는 페이로드 조각 (Dot3_ConstructWsmMpduV() API 파라미터)
+ * 조각들은 배열 순서대로 이어 붙여져 하나의 WSM body 가 된다. (예: J2735 메시지 + 보안/메타데이터 블록)
+ */
+struct Dot3PayloadFragment
+{
+  const uint8_t *buf; ///< 페이로드 조각이 저장된 버퍼 (len 이 0 인 경우 NULL 가능)
+  Dot3PduSize len;  ///< 페이로드 조각의 길이
+};
+
 /// WSR 정보
 struct Dot3Wsr
 {
@@ -130,12 +130,10 @@ int OPEN_API Dot3_GetPsrWithPsid(const Dot3Psid psid, struct Dot3Psr *const psr)
   }
 
   /*
-   * PSR 확인
+   * PSR 확인 - 스냅샷을 참조하므로 뮤텍스 락이 필요하지 않다.
    */
   struct Dot3ProviderInfo *pinfo = &(g_dot3_mib.provider_info);
-  pthread_mutex_lock(&(pinfo->mtx));
   int ret = dot3_GetPsrWithPsid(pinfo, psid, psr);
-  pthread_mutex_unlock(&(pinfo->mtx));
   return ret;
 }
 
@@ -167,8 +165,6 @@ int OPEN_API Dot3_GetAllPsrs(struct Dot3Psr *psrs_array, const Dot3PsrNum psrs_a
   }
 
   struct Dot3ProviderInfo *pinfo = &(g_dot3_mib.provider_info);
-  pthread_mutex_lock(&(pinfo->mtx));
   int ret = dot3_GetAllPsrs(pinfo, psrs_array, psrs_array_size);
-  pthread_mutex_unlock(&(pinfo->mtx));
   return ret;
 }
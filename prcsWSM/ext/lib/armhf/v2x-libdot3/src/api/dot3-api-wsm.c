@@ -3,6 +3,7 @@
 //
 
 #include <stddef.h>
+#include <string.h>
 
 #include "dot3/dot3.h"
 #include "dot3-internal.h"
@@ -138,6 +139,130 @@ int OPEN_API Dot3_ConstructWsmMpdu(
   return mpdu_size;
 }
 
+/*
+ * 페이로드 조각들과 송신파라미터를 전달 받아 WSM MPDU를 생성하여 반환한다.
+ *
+ * 각 인자와 반환값에 대한 설명은 API 선언부 참조.
+ */
+int OPEN_API Dot3_ConstructWsmMpduV(
+  struct Dot3WsmMpduTxParams *const params,
+  const struct Dot3PayloadFragment *const frags,
+  const unsigned int frag_num,
+  uint8_t *const outbuf,
+  const Dot3PduSize outbuf_size)
+{
+  Log(kDot3LogLevel_event, "Constructing WSM MPDU - %u payload fragments\n", frag_num);
+
+  /*
+   * 페이로드 조각 유효성 체크 및 전체 페이로드 길이 계산
+   */
+  if (frag_num && !frags) {
+    Err("Fail to construct WSM MPDU - null fragments\n");
+    return -kDot3Result_Fail_NullParameters;
+  }
+  uint32_t payload_size = 0;
+  for (unsigned int i = 0; i < frag_num; i++) {
+    if (frags[i].len && !frags[i].buf) {
+      Err("Fail to construct WSM MPDU - null fragment %u\n", i);
+      return -kDot3Result_Fail_NullParameters;
+    }
+    payload_size += frags[i].len;
+    if (payload_size > kMsduMaxSize) {
+      Err("Fail to construct WSM MPDU - too long payload fragments\n");
+      return -kDot3Result_Fail_TooLongPayload;
+    }
+  }
+
+  /*
+   * 파라미터 체크
+   */
+  int ret = dot3_CheckAndAdjustApiParameters_ConstructWsmMpdu(params, NULL, (Dot3PduSize)payload_size,
+                                                             outbuf, outbuf_size);
+  if (ret < 0) {
+    Err("Fail to construct WSM MPDU - invalid parameter\n");
+    return ret;
+  }
+  int hdr_size = dot3_GetWsmpHdrSize(params, (Dot3PduSize)payload_size);
+  if (hdr_size < 0) {
+    Err("Fail to construct WSM MPDU - fail to construct WSM\n");
+    return hdr_size;
+  }
+  uint32_t mpdu_size = kQoSMacHdrSize + kLLCHdrSize + hdr_size + payload_size;
+  if (mpdu_size > outbuf_size) {
+    Err("Fail to construct WSM MPDU - insufficient outbuf %u < %u\n", outbuf_size, mpdu_size);
+    return -kDot3Result_Fail_InsufficientBuf;
+  }
+
+  /*
+   * MPDU 생성 - 헤더들을 채운 후, 페이로드 조각들을 WSM body 위치에 순서대로 복사한다.
+   */
+  dot3_ConstructMpdu(params, outbuf);
+  uint8_t *p = outbuf + kQoSMacHdrSize + kLLCHdrSize;
+  dot3_EncodeWsmpHdr(params, (Dot3PduSize)payload_size, p);
+  p += hdr_size;
+  for (unsigned int i = 0; i < frag_num; i++) {
+    if (frags[i].len) {
+      memcpy(p, frags[i].buf, frags[i].len);
+      p += frags[i].len;
+    }
+  }
+
+  Log(kDot3LogLevel_event, "Success to construct %u-bytes WSM MPDU\n", mpdu_size);
+  return (int)mpdu_size;
+}
+
+/*
+ * 버퍼 내 페이로드 앞 여유공간에 헤더들을 채워 WSM MPDU를 생성한다.
+ *
+ * 각 인자와 반환값에 대한 설명은 API 선언부 참조.
+ */
+int OPEN_API Dot3_ConstructWsmMpduInPlace(
+  struct Dot3WsmMpduTxParams *const params,
+  uint8_t *const buf,
+  const Dot3PduSize headroom,
+  const Dot3PduSize payload_size,
+  Dot3PduSize *const mpdu_offset)
+{
+  Log(kDot3LogLevel_event, "Constructing WSM MPDU in place - payload size is %u, headroom is %u\n",
+      payload_size, headroom);
+
+  /*
+   * 파라미터 체크
+   *  - 공통 체크함수의 outbuf 크기 체크는 headroom 기준으로 아래에서 별도로 수행하므로, 최대크기를 전달한다.
+   */
+  if (!mpdu_offset) {
+    Err("Fail to construct WSM MPDU in place - null parameters\n");
+    return -kDot3Result_Fail_NullParameters;
+  }
+  int ret = dot3_CheckAndAdjustApiParameters_ConstructWsmMpdu(params, NULL, payload_size, buf, kMpduMaxSize);
+  if (ret < 0) {
+    Err("Fail to construct WSM MPDU in place - invalid parameter\n");
+    return ret;
+  }
+  int hdr_size = dot3_GetWsmpHdrSize(params, payload_size);
+  if (hdr_size < 0) {
+    Err("Fail to construct WSM MPDU in place - fail to construct WSM\n");
+    return hdr_size;
+  }
+  Dot3PduSize hdrs_size = (Dot3PduSize)(kQoSMacHdrSize + kLLCHdrSize + hdr_size);
+  if (headroom < hdrs_size) {
+    Err("Fail to construct WSM MPDU in place - insufficient headroom %u < %u\n", headroom, hdrs_size);
+    return -kDot3Result_Fail_InsufficientBuf;
+  }
+
+  /*
+   * 페이로드 바로 앞에 MAC/LLC/WSMP 헤더를 채운다.
+   */
+  uint8_t *mpdu = buf + headroom - hdrs_size;
+  dot3_ConstructMpdu(params, mpdu);
+  dot3_EncodeWsmpHdr(params, payload_size, mpdu + kQoSMacHdrSize + kLLCHdrSize);
+  *mpdu_offset = headroom - hdrs_size;
+
+  int mpdu_size = hdrs_size + payload_size;
+  Log(kDot3LogLevel_event, "Success to construct %d-bytes WSM MPDU at offset %u\n", mpdu_size, *mpdu_offset);
+  return mpdu_size;
+}
+
 /**
  * @brief Dot3_ParseWsmMpdu()와 Dot3_ParseInterestedWsmMpdu() API에 전달된 인자들의 유효성을 체크한다.
  * @param mpdu MPDU 버퍼 포인터
@@ -233,11 +358,136 @@ int OPEN_API Dot3_ParseWsmMpdu(
 
   /*
    * 해당 PSID가 WSR 테이블에 등록되어 있는지 확인
-   * TODO::
    */
-  *wsr_registered = true;
-
+  *wsr_registered = dot3_IsWsrRegistered(&(g_dot3_mib.user_info), params->psid);
 
   Log(kDot3LogLevel_event, "Success to parse WSM MPDU - payload size is %u\n", payload_size);
   return payload_size;
 }
+
+/*
+ * WSM MPDU 를 파싱하여 페이로드(=WSM body)의 위치/길이와 수신파라미터들을 반환한다.
+ *
+ * 각 인자와 반환값에 대한 설명은 API 선언부 참조.
+ */
+int OPEN_API Dot3_ParseWsmMpduView(
+  const uint8_t *const mpdu,
+  const Dot3PduSize mpdu_size,
+  struct Dot3WsmMpduRxParams *const params,
+  Dot3PduSize *const payload_offset,
+  bool *const wsr_registered)
+{
+  int ret, payload_size;
+  Log(kDot3LogLevel_event, "Parsing %u-bytes WSM MPDU view\n", mpdu_size);
+
+  /*
+   * 파라미터 체크
+   *  - 페이로드를 복사할 outbuf 가 없으므로, 공통 체크함수에는 outbuf 대신 mpdu 를 전달하고 payload_offset 을 별도로 확인한다.
+   */
+  if (!payload_offset) {
+    Err("Invalid Dot3_ParseWsmMpduView() parameters - null parameters\n");
+    return -kDot3Result_Fail_NullParameters;
+  }
+  ret = dot3_CheckAndAdjustApiParameters_ParseWsmMpdu(mpdu, mpdu_size, (uint8_t *)mpdu, params, wsr_registered);
+  if (ret < 0) {
+    Err("Fail to parse WSM MPDU view - invalid parameter\n");
+    return ret;
+  }
+
+  /*
+   * MPDU 파싱 - 하위계층(MAC, LLC) 헤더들의 크기가 반환된다.
+   */
+  ret = dot3_ParseMpdu(mpdu, mpdu_size, params);
+  if (ret < 0) {
+    Err("Fail to parse WSM MPDU view - fail to parse MPDU\n");
+    return ret;
+  }
+  Dot3PduSize lower_layer_hdr_size = (Dot3PduSize)ret;
+
+  /*
+   * WSMP 헤더 파싱 - 페이로드(WSM body)의 위치 및 수신파라미터정보가 반환된다.
+   */
+  Dot3PduSize body_offset;
+  payload_size = dot3_DecodeWsmpHdr(mpdu + lower_layer_hdr_size, mpdu_size - lower_layer_hdr_size, params, &body_offset);
+  if (payload_size < 0) {
+    Err("Fail to parse WSM MPDU view - fail to decode WSMP header\n");
+    return payload_size;
+  }
+  *payload_offset = lower_layer_hdr_size + body_offset;
+
+  /*
+   * 해당 PSID가 WSR 테이블에 등록되어 있는지 확인
+   */
+  *wsr_registered = dot3_IsWsrRegistered(&(g_dot3_mib.user_info), params->psid);
+
+  Log(kDot3LogLevel_event, "Success to parse WSM MPDU view - payload size is %u\n", payload_size);
+  return payload_size;
+}
+
+/*
+ * WSM MPDU 의 헤더만 먼저 파싱하여, WSR 테이블에 등록된 PSID 인 경우에만 페이로드(=WSM body)를 반환한다.
+ *
+ * 각 인자와 반환값에 대한 설명은 API 선언부 참조.
+ */
+int OPEN_API Dot3_ParseInterestedWsmMpdu(
+  const uint8_t *const mpdu,
+  const Dot3PduSize mpdu_size,
+  uint8_t *const outbuf,
+  const Dot3PduSize outbuf_size,
+  struct Dot3WsmMpduRxParams *const params,
+  bool *const wsr_registered)
+{
+  int ret, payload_size;
+  Log(kDot3LogLevel_event, "Parsing %u-bytes interested WSM MPDU\n", mpdu_size);
+
+  /*
+   * 파라미터 체크
+   *  - outbuf_size는 여기서 체크하지 않고, WSMP 헤더 디코딩 후 실제 WSM body의 길이와 직접 비교된다.
+   */
+  ret = dot3_CheckAndAdjustApiParameters_ParseWsmMpdu(mpdu, mpdu_size, outbuf, params, wsr_registered);
+  if (ret < 0) {
+    Err("Fail to parse interested WSM MPDU - invalid parameter\n");
+    return ret;
+  }
+
+  /*
+   * MPDU 파싱 - 하위계층(MAC, LLC) 헤더들의 크기가 반환된다.
+   */
+  ret = dot3_ParseMpdu(mpdu, mpdu_size, params);
+  if (ret < 0) {
+    Err("Fail to parse interested WSM MPDU - fail to parse MPDU\n");
+    return ret;
+  }
+  Dot3PduSize lower_layer_hdr_size = (Dot3PduSize)ret;
+
+  /*
+   * WSMP 헤더 파싱 - PSID 를 포함한 수신파라미터정보와 페이로드(WSM body)의 위치가 반환된다.
+   */
+  Dot3PduSize body_offset;
+  payload_size = dot3_DecodeWsmpHdr(mpdu + lower_layer_hdr_size, mpdu_size - lower_layer_hdr_size, params, &body_offset);
+  if (payload_size < 0) {
+    Err("Fail to parse interested WSM MPDU - fail to decode WSMP header\n");
+    return payload_size;
+  }
+
+  /*
+   * 해당 PSID가 WSR 테이블에 등록되어 있지 않으면, 페이로드를 복사하지 않고 바로 반환한다.
+   */
+  *wsr_registered = dot3_IsWsrRegistered(&(g_dot3_mib.user_info), params->psid);
+  if (*wsr_registered == false) {
+    Log(kDot3LogLevel_event, "Skip WSM body - psid %u is not registered in WSR table\n", params->psid);
+    return 0;
+  }
+
+  /*
+   * 페이로드(WSM body) 복사
+   */
+  if ((Dot3PduSize)payload_size > outbuf_size) {
+    Err("Fail to parse interested WSM MPDU - insufficient buffer for payload %d > %u\n", payload_size, outbuf_size);
+    return -kDot3Result_Fail_InsufficientBuf;
+  }
+  memcpy(outbuf, mpdu + lower_layer_hdr_size + body_offset, payload_size);
+
+  Log(kDot3LogLevel_event, "Success to parse interested WSM MPDU - payload size is %u\n", payload_size);
+  return payload_size;
+}
@@ -1,31 +1,113 @@
-//
-// Created by gyun on 2019-06-06.
-//
+/**
+ * @file dot3-api-wsr.c
+ * @date 2019-06-06
+ * @author gyun
+ * @brief WSR 관련 API들을 구현한 파일
+ */
+
+#include "dot3/dot3-types.h"
 
-#include "dot3/dot3.h"
 #include "dot3-internal.h"
 
+
+/**
+ * @copydoc Dot3_AddWsr
+ */
 int OPEN_API Dot3_AddWsr(const Dot3Psid psid)
 {
-  return kDot3Result_Success;
+  Log(kDot3LogLevel_config, "Adding WSR\n");
+
+  /*
+   * 파라미터 유효성 체크
+   */
+  if (false == dot3_IsValidPsidValue(psid)) {
+    Err("Fail to add WSR - invalid psid %u\n", psid);
+    return -kDot3Result_Fail_InvalidPsidValue;
+  }
+
+  /*
+   * WSR 추가
+   */
+  struct Dot3UserInfo *uinfo = &(g_dot3_mib.user_info);
+  pthread_mutex_lock(&(uinfo->mtx));
+  int ret = dot3_AddWsr(uinfo, psid);
+  pthread_mutex_unlock(&(uinfo->mtx));
+  return ret;
 }
 
+
+/**
+ * @copydoc Dot3_DeleteWsr
+ */
 int OPEN_API Dot3_DeleteWsr(const Dot3Psid psid)
 {
-  return kDot3Result_Success;
+  Log(kDot3LogLevel_config, "Deleting WSR\n");
+
+  /*
+   * 파라미터 유효성 체크
+   */
+  if (false == dot3_IsValidPsidValue(psid)) {
+    Err("Fail to delete WSR - invalid psid %u\n", psid);
+    return -kDot3Result_Fail_InvalidPsidValue;
+  }
+
+  /*
+   * WSR 삭제
+   */
+  struct Dot3UserInfo *uinfo = &(g_dot3_mib.user_info);
+  pthread_mutex_lock(&(uinfo->mtx));
+  int ret = dot3_DeleteWsr(uinfo, psid);
+  pthread_mutex_unlock(&(uinfo->mtx));
+  return ret;
 }
 
+
+/**
+ * @copydoc Dot3_DeleteAllWsrs
+ */
 int OPEN_API Dot3_DeleteAllWsrs(void)
 {
+  Log(kDot3LogLevel_config, "Deleting all WSRs\n");
+  struct Dot3UserInfo *uinfo = &(g_dot3_mib.user_info);
+  pthread_mutex_lock(&(uinfo->mtx));
+  dot3_DeleteAllWsrs(uinfo);
+  pthread_mutex_unlock(&(uinfo->mtx));
   return kDot3Result_Success;
 }
 
+
+/**
+ * @copydoc Dot3_GetWsrNum
+ */
 int OPEN_API Dot3_GetWsrNum(void)
 {
-  return kDot3Result_Success;
+  Log(kDot3LogLevel_config, "Get the number of WSRs\n");
+  struct Dot3UserInfo *uinfo = &(g_dot3_mib.user_info);
+  pthread_mutex_lock(&(uinfo->mtx));
+  int ret = dot3_GetWsrNum(uinfo);
+  pthread_mutex_unlock(&(uinfo->mtx));
+  return ret;
 }
 
+
+/**
+ * @copydoc Dot3_GetAllWsrs
+ */
 int OPEN_API Dot3_GetAllWsrs(struct Dot3Wsr wsrs[])
 {
-  return kDot3Result_Success;
+  Log(kDot3LogLevel_config, "Get all WSRs\n");
+
+  /*
+   * 파라미터 유효성 체크
+   */
+  if (!wsrs) {
+    Err("Fail to get all WSRs - null parameters\n");
+    return -kDot3Result_Fail_NullParameters;
+  }
+
+  struct Dot3UserInfo *uinfo = &(g_dot3_mib.user_info);
+  pthread_mutex_lock(&(uinfo->mtx));
+  int ret = dot3_GetAllWsrs(uinfo, wsrs);
+  pthread_mutex_unlock(&(uinfo->mtx));
+  return ret;
 }
@@ -165,14 +165,13 @@ dot3_FFAsn1c_FillWsaHeader(const struct Dot3ConstructWsaParams *const params, st
 
 /**
  * 하나의 Service info instance 의 내용을 채운다.
- *  - PSR 테이블 뮤텍스 락 내에서 호출된다.
  *
- * @param entry                     PSR 정보 테이블 엔트리
+ * @param entry                     PSR 테이블 스냅샷 엔트리
  * @param service_info_instance     정보를 채울 service info 정보 구조체
  * @return                          성공시 0, 실패시 음수(-Dot3ResultCode)
  */
 static int dot3_FFAsn1c_AddWsaServiceInfoInstance(
-  const struct Dot3PsrTableEntry *const entry,
+  const struct Dot3PsrSnapshotEntry *const entry,
   struct ServiceInfo *const service_info_instance)
 {
   Log(kDot3LogLevel_event, "Adding WSA service info instance for psid %u\n", entry->psr.psid);
@@ -335,52 +334,19 @@ static int dot3_FFAsn1c_AddWsaServiceInfoInstance(
 }
 
 
-/**
- * WSA asn.1 정보구조체 내에 수납되어 있는 Channel info 중 원하는 채널을 갖는 channel info 의 index를 반환한다.
- *
- * @param infos         WSA asn.1 정보구조체의 Channel info 들의 리스트 포인터
- * @param info_count    현재 WSA asn.1 정보구조체에 저장되어 있는 Channel info 의 수
- * @param chan_num      찾고자 하는 채널번호
- * @return              Channel info의 인덱스(표준에 따라 1번부터 시작), 해당되는 정보가 없을 경우 0
- */
-static int dot3_FFAsn1c_GetWsaChannelInfoIndexWithChannelNumber(
-  const struct ChannelInfo *const infos,
-  const uint32_t info_count,
-  const Dot3ChannelNumber chan_num)
-{
-  struct ChannelInfo *cinfo = NULL;
-
-  uint32_t count = (info_count > _WSA_CHAN_INFO_MAX_NUM_) ? _WSA_CHAN_INFO_MAX_NUM_ : info_count;
-
-  for (int i = 0; i < count; i++) {
-    cinfo = (struct ChannelInfo *)(infos + i);
-    if (cinfo->channelNumber == chan_num) {
-      return i + 1;
-    }
-  }
-  return 0;
-}
-
-
 /**
  * WSA asn.1 정보구조체에 Channel info instance 를 추가한다.
  *
- * @param psr_entry             PSR 엔트리
+ * @param pci                   Provider Channel Info 테이블 내 해당 채널의 정보
  * @param chan_info_instance    추가할 Channel info instance 포인터
  * @return                      성공시 0, 실패시 음수(-Dot3ResultCode)
  */
 static int dot3_FFAsn1c_AddWsaChannelInfoInstance(
-  const struct Dot3PsrTableEntry *const psr_entry,
+  const struct Dot3Pci *const pci,
   struct ChannelInfo *const chan_info_instance)
 {
-  Log(kDot3LogLevel_event, "Adding WSA channel info instance for channel %d\n", psr_entry->psr.service_chan_num);
+  Log(kDot3LogLevel_event, "Adding WSA channel info instance for channel %d\n", pci->chan_num);
 
-  if (!(psr_entry->pci_entry)) {
-    Err("Fail to add WSA channel info instance - there is no channel info referenced by PSR\n");
-    return -kDot3Result_Fail_NoRelatedChannelInfo;
-  }
-
-  struct Dot3Pci *pci = &(psr_entry->pci_entry->pci);
   chan_info_instance->operatingClass = pci->operating_class;
   chan_info_instance->channelNumber = pci->chan_num;
   chan_info_instance->powerLevel = pci->transmit_power_level;
@@ -402,15 +368,16 @@ static int dot3_FFAsn1c_AddWsaChannelInfoInstance(
 
 /**
  * WSA asn1. 정보 구조체의 WSA Service info segment 와 Channel info segment 정보를 채운다.
- * provider 뮤텍스 락 상태에서 호출되어야 한다.
  *
  * @param pinfo     provider info MIB
+ * @param snapshot  PSR 테이블 스냅샷 (dot3_AcquirePsrSnapshot() 으로 참조 중이어야 한다)
  * @param params    @ref Dot3_ConstructWsa
  * @param wsa_msg   정보를 채울 정보구조체의 포인터
  * @return          성공시 0(kDot3Result_Success), 실패시 음수(-Dot3ResultCode)
  */
 static int dot3_FFAsn1c_FillWsaServiceInfoSegmentAndChannelInfoSegment(
   const struct Dot3ProviderInfo *const pinfo,
+  const struct Dot3PsrSnapshot *const snapshot,
   const struct Dot3ConstructWsaParams *const params,
   struct SrvAdvMsg *const wsa_msg)
 {
@@ -418,8 +385,10 @@ static int dot3_FFAsn1c_FillWsaServiceInfoSegmentAndChannelInfoSegment(
 
   /*
    * 일단 PSR 개수 또는 WSA 최대수납가능수 만큼의 Service Info, Channel Info 메모리를 할당한다.
+   *  - 스냅샷이 NULL 이면 빈 테이블이다.
    */
-  int max_num = (pinfo->psr_table.num > _WSA_SERVICE_INFO_MAX_NUM_) ? _WSA_SERVICE_INFO_MAX_NUM_:pinfo->psr_table.num;
+  Dot3PsrNum psr_num = snapshot ? snapshot->num : 0;
+  int max_num = (psr_num > _WSA_SERVICE_INFO_MAX_NUM_) ? _WSA_SERVICE_INFO_MAX_NUM_:psr_num;
   wsa_msg->body.serviceInfos.tab = (struct ServiceInfo *)asn1_mallocz(asn1_get_size(asn1_type_ServiceInfo) * max_num);
   if (!wsa_msg->body.serviceInfos.tab) {
     Err("Fail to fill WSA service info and channel info - fail to asn1_malloc(serviceInfos.tab)\n");
@@ -436,11 +405,13 @@ static int dot3_FFAsn1c_FillWsaServiceInfoSegmentAndChannelInfoSegment(
    *  WSA 정보구조체 내에 Service Info 를 추가한다.
    *  WSA 정보구조체 내에 Channel Info 를 추가한다.
    */
-  struct Dot3PsrTableEntry *psr_entry;
+  const struct Dot3PsrSnapshotEntry *psr_entry;
   struct ServiceInfo *service_info_instance;
   int ret, service_info_cnt = 0, chan_info_cnt = 0;
-  TAILQ_FOREACH(psr_entry, &(pinfo->psr_table.head), entries)
+  uint8_t chan_indexes[DOT3_PCI_TABLE_SIZE] = {0}; // 채널별 channel info instance index (0: 아직 추가되지 않음)
+  for (Dot3PsrNum i = 0; i < psr_num; i++)
   {
+    psr_entry = &(snapshot->entries[i]);
     if (psr_entry->psr.wsa_id != params->hdr.wsa_id) {
       continue;
     }
@@ -456,19 +427,24 @@ static int dot3_FFAsn1c_FillWsaServiceInfoSegmentAndChannelInfoSegment(
     // PSR 의 채널번호와 동일한 channel info instance가 이미 채워져 있는지 확인하여,
     //  - 채워져 있는 경우(!0), 해당 channel info instance의 index를 service info instance의 channel index 값으로 설정한다.
     //  - 채워져 있지 않은 경우(0), 새로운 channel info instance를 추가하고, service info instance의 channel index 값을 설정한다.
-    int chan_index = dot3_FFAsn1c_GetWsaChannelInfoIndexWithChannelNumber(wsa_msg->body.channelInfos.tab,
-                                                                          chan_info_cnt,
-                                                                          psr_entry->psr.service_chan_num);
-    if (chan_index) {
-      service_info_instance->channelIndex = chan_index;
+    const struct Dot3PciTableEntry *pci_entry = dot3_GetPciTableEntry(pinfo, psr_entry->psr.service_chan_num);
+    if (!pci_entry) {
+      Err("Fail to fill WSA service info and channel info - there is no channel info for channel %d\n",
+          psr_entry->psr.service_chan_num);
+      return -kDot3Result_Fail_NoRelatedChannelInfo;
+    }
+    uint8_t *chan_index = &(chan_indexes[psr_entry->psr.service_chan_num - kDot3Channel_KoreaV2XMin]);
+    if (*chan_index) {
+      service_info_instance->channelIndex = *chan_index;
     }
     else {
-      ret = dot3_FFAsn1c_AddWsaChannelInfoInstance(psr_entry, (wsa_msg->body.channelInfos.tab + chan_info_cnt));
+      ret = dot3_FFAsn1c_AddWsaChannelInfoInstance(&(pci_entry->pci), (wsa_msg->body.channelInfos.tab + chan_info_cnt));
       if (ret < 0) {
         return ret;
       }
       chan_info_cnt++;
       service_info_instance->channelIndex = chan_info_cnt;
+      *chan_index = (uint8_t)chan_info_cnt;
     }
 
     // 각 instance가 WSA에 실을 수 있는 개수를 초과하면 중단한다.
@@ -540,6 +516,7 @@ dot3_FFAsn1c_FillWra(const struct Dot3ConstructWsaParams *const params, struct S
  * ffasn1c 라이브러리를 이용하여 WSA를 인코딩한다.
  *
  * @param pinfo         provider info MIB
+ * @param snapshot      WSA 에 수납할 PSR 테이블 스냅샷 (NULL 이면 빈 테이블)
  * @param params        @ref Dot3_ConstructWsa
  * @param outbuf        @ref Dot3_ConstructWsa
  * @param outbuf_size   @ref Dot3_ConstructWsa
@@ -547,6 +524,7 @@ dot3_FFAsn1c_FillWra(const struct Dot3ConstructWsaParams *const params, struct S
  */
 int INTERNAL dot3_FFAsn1c_EncodeWsa(
   struct Dot3ProviderInfo *const pinfo,
+  const struct Dot3PsrSnapshot *const snapshot,
   const struct Dot3ConstructWsaParams *const params,
   uint8_t *const outbuf,
   const Dot3PduSize outbuf_size)
@@ -576,9 +554,7 @@ int INTERNAL dot3_FFAsn1c_EncodeWsa(
   /*
    * asn.1 정보 구조체의 Service info segment 와 Channel info segment 를 채운다.
    */
-  pthread_mutex_lock(&(pinfo->mtx));
-  ret = dot3_FFAsn1c_FillWsaServiceInfoSegmentAndChannelInfoSegment(pinfo, params, wsa_msg);
-  pthread_mutex_unlock(&(pinfo->mtx));
+  ret = dot3_FFAsn1c_FillWsaServiceInfoSegmentAndChannelInfoSegment(pinfo, snapshot, params, wsa_msg);
   if (ret < 0) {
     asn1_free_value(asn1_type_SrvAdvMsg, wsa_msg);
     return ret;
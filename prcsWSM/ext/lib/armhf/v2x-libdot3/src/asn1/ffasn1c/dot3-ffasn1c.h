@@ -47,9 +47,24 @@ enum eDot3ExtensionId
 };
 typedef int Dot3ExtensionId;  /// @copydoc eDot3ExtensionId
 
+/**
+ * @brief ffasn1c 인코딩/디코딩 1회 동안의 메모리 할당 통계 (쓰레드 별)
+ */
+struct Dot3FFAsn1cArenaStats
+{
+  uint32_t alloc_cnt;       ///< 아레나에서 할당된 횟수
+  uint32_t heap_alloc_cnt;  ///< 아레나 공간 부족으로 힙에서 할당된 횟수
+  size_t peak_size;         ///< 아레나 최대 사용량 (바이트)
+};
+
 /*
  * 함수 원형(들)
  */
+// asn1mem.c
+void INTERNAL dot3_FFAsn1c_BeginArena(void);
+void INTERNAL dot3_FFAsn1c_EndArena(void);
+void INTERNAL dot3_FFAsn1c_GetArenaStats(struct Dot3FFAsn1cArenaStats *const stats);
+
 // dot3-ffasn1c.c
 int INTERNAL dot3_FFAsn1c_FillVarLengthNumber(Dot3Psid psid, VarLengthNumber *const var_len_num);
 int INTERNAL dot3_FFAsn1c_ParseVarLengthNumber(const VarLengthNumber *const var_len_num);
@@ -62,6 +77,7 @@ int INTERNAL dot3_FFAsn1c_DecodeWsa(
 // dot3-ffasn1c-wsa-encode.c
 int INTERNAL dot3_FFAsn1c_EncodeWsa(
   struct Dot3ProviderInfo *const pinfo,
+  const struct Dot3PsrSnapshot *const snapshot,
   const struct Dot3ConstructWsaParams *const params,
   uint8_t *const outbuf,
   const Dot3PduSize outbuf_size);
@@ -7,7 +7,6 @@
 
 
 #include <stdio.h>
-#include <stdlib.h>
 
 #include "dot3-internal.h"
 #include "dot3-mib.h"
@@ -37,59 +36,24 @@ dot3_SetDefaultChannelInfoTableEntry(struct Dot3PciTableEntry *const entry, cons
 
 /**
  * Provider Channel Info 테이블을 초기화한다.
+ *  - 테이블은 MIB 내 배열이므로 별도의 메모리 할당 없이, 각 채널에 대한 엔트리를 기본값으로 설정한다.
  *
  * @param pinfo     provider info MIB
- * @return          성공시 0, 실패시 음수(-Dot3ResultCode)
  */
-int INTERNAL dot3_InitPciTable(struct Dot3ProviderInfo *const pinfo)
+void INTERNAL dot3_InitPciTable(struct Dot3ProviderInfo *const pinfo)
 {
   Log(kDot3LogLevel_init, "Initializing channel info table\n");
 
   /*
-   * 테이블 정보 구조체 초기화
+   * 각 채널에 대한 기본 Channel info 정보들을 채널번호 순으로 테이블에 설정
    */
-  TAILQ_INIT(&(pinfo->pci_table.head));
-  pinfo->pci_table.num = 0;
-
-  /*
-   * 각 채널에 대한 기본 Channel info 정보들을 테이블에 추가
-   *  10MHz 채널에 대한 정보를 테이블 앞에 둔다.
-   */
-    // 10MHz/20MHz 채널들에 대한 기본 Channel info 정보 생성
-  struct Dot3PciTableEntry *entry;
   for (int i = kDot3Channel_KoreaV2XMin; i <= kDot3Channel_KoreaV2XMax; i++) {
-    entry = (struct Dot3PciTableEntry *)calloc(1, sizeof(struct Dot3PciTableEntry));
-    if (!entry) {
-      Err("Fail to initialize channel info table - no memory\n");
-      return -kDot3Result_Fail_NoMemory;
-    }
-    dot3_SetDefaultChannelInfoTableEntry(entry, i);
-    TAILQ_INSERT_TAIL(&(pinfo->pci_table.head), entry, entries);
-    (pinfo->pci_table.num)++;
+    dot3_SetDefaultChannelInfoTableEntry(&(pinfo->pci_table.entries[i - kDot3Channel_KoreaV2XMin]), i);
   }
+  pinfo->pci_table.num = DOT3_PCI_TABLE_SIZE;
 
   Log(kDot3LogLevel_event, "Success to initialize channel info table\n");
-  TAILQ_FOREACH(entry, &(pinfo->pci_table.head), entries) {
-    dot3_PrintPciTableEntry(kDot3LogLevel_init, entry);
-  }
-
-  return kDot3Result_Success;
-}
-
-
-/**
- * Provider Channel Info 테이블을 비운다.
- * provider_mtx 락 상태에서 호출되어야 한다.
- *
- * @param pinfo     provider info MIB
- */
-void INTERNAL dot3_FlushPciTable(struct Dot3ProviderInfo *const pinfo)
-{
-  struct Dot3PciTableEntry *entry, *tmp;
-  TAILQ_FOREACH_SAFE(entry, &(pinfo->pci_table.head), entries, tmp) {
-    TAILQ_REMOVE(&(pinfo->pci_table.head), entry, entries);
-    free(entry);
-  }
+  dot3_PrintPciTable(kDot3LogLevel_init, pinfo);
 }
 
 
@@ -137,9 +101,8 @@ void INTERNAL dot3_PrintPciContents(const Dot3LogLevel log_level, const struct D
 void INTERNAL dot3_PrintPciTable(const Dot3LogLevel log_level, const struct Dot3ProviderInfo *const pinfo)
 {
   if (g_dot3_log >= log_level) {
-    struct Dot3PciTableEntry *entry;
-    TAILQ_FOREACH(entry, &(pinfo->pci_table.head), entries) {
-      dot3_PrintPciTableEntry(log_level, entry);
+    for (Dot3PciNum i = 0; i < pinfo->pci_table.num; i++) {
+      dot3_PrintPciTableEntry(log_level, &(pinfo->pci_table.entries[i]));
     }
   }
 }
@@ -0,0 +1,93 @@
+/**
+ * @file dot3-codec-ctx.c
+ * @date 2026-10-19
+ * @author gyun
+ * @brief 쓰레드 별 코덱 컨텍스트 관련 함수들을 구현한 파일
+ *
+ * 인코딩/디코딩 경로에서 변경되는 상태는 모두 쓰레드 별로 두어, 여러 쓰레드가 잠금 없이 동시에 인코딩/디코딩할 수 있도록 한다.
+ *  - asn.1 아레나 및 그 통계 : asn1mem.c (ffasn1c 사용 시)
+ *  - WSA 인코딩 캐시(인코딩된 WSA 저장 버퍼) 및 코덱 통계 : 본 파일의 struct Dot3CodecCtx
+ * 코덱 컨텍스트는 쓰레드가 처음 사용할 때 할당되며, 쓰레드 종료 시 해제된다.
+ * 쓰레드 간에 공유되는 상태는 provider/user 테이블뿐이며, 인코딩/디코딩 경로에서는 이를 스냅샷(PSR) 또는 seqlock(WSR)으로 읽는다.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "dot3-internal.h"
+
+
+static pthread_key_t g_codec_ctx_key;                         ///< 쓰레드 종료 시 코덱 컨텍스트 해제를 위한 키
+static pthread_once_t g_codec_ctx_once = PTHREAD_ONCE_INIT;
+static __thread struct Dot3CodecCtx *t_codec_ctx;             ///< 호출 쓰레드의 코덱 컨텍스트
+
+
+/**
+ * 쓰레드 종료 시 해당 쓰레드의 코덱 컨텍스트를 해제한다.
+ *
+ * @param ctx   해제할 코덱 컨텍스트
+ */
+static void dot3_FreeCodecCtx(void *ctx)
+{
+  free(ctx);
+}
+
+
+/**
+ * 코덱 컨텍스트 해제를 위한 키를 생성한다. (프로세스 당 한번)
+ */
+static void dot3_CreateCodecCtxKey(void)
+{
+  pthread_key_create(&g_codec_ctx_key, dot3_FreeCodecCtx);
+}
+
+
+/**
+ * 호출 쓰레드의 코덱 컨텍스트를 반환한다.
+ *  - 처음 호출 시 할당된다.
+ *  - 라이브러리가 다시 초기화(Dot3_Init())되었으면, 이전 PSR 테이블로 인코딩된 WSA 캐시를 무효화한다.
+ *    (재초기화 후의 PSR 테이블 스냅샷 세대는 이전 세대와 겹칠 수 있다)
+ *
+ * @return  코덱 컨텍스트, 할당에 실패하면 NULL
+ */
+struct Dot3CodecCtx INTERNAL *dot3_GetCodecCtx(void)
+{
+  struct Dot3CodecCtx *ctx = t_codec_ctx;
+  if (!ctx) {
+    pthread_once(&g_codec_ctx_once, dot3_CreateCodecCtxKey);
+    ctx = (struct Dot3CodecCtx *)calloc(1, sizeof(struct Dot3CodecCtx));
+    if (!ctx) {
+      Err("Fail to allocate codec context\n");
+      return NULL;
+    }
+    pthread_setspecific(g_codec_ctx_key, ctx);
+    ctx->mib_epoch = __atomic_load_n(&(g_dot3_mib.epoch), __ATOMIC_ACQUIRE);
+    t_codec_ctx = ctx;
+    return ctx;
+  }
+
+  uint32_t epoch = __atomic_load_n(&(g_dot3_mib.epoch), __ATOMIC_ACQUIRE);
+  if (ctx->mib_epoch != epoch) {
+    for (unsigned int i = 0; i <= kDot3WsaMaxId; i++) {
+      ctx->wsa_cache[i].valid = false;
+    }
+    ctx->mib_epoch = epoch;
+  }
+  return ctx;
+}
+
+
+/**
+ * 호출 쓰레드의 코덱 통계를 반환한다.
+ *
+ * @param stats     통계가 저장될 구조체의 주소
+ */
+void INTERNAL dot3_GetCodecStats(struct Dot3CodecStats *const stats)
+{
+  struct Dot3CodecCtx *ctx = dot3_GetCodecCtx();
+  if (ctx) {
+    *stats = ctx->stats;
+  } else {
+    memset(stats, 0, sizeof(*stats));
+  }
+}
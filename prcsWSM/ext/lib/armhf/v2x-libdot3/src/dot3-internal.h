@@ -42,6 +42,29 @@ enum eDot3LogLevel
 typedef int Dot3LogLevel;  ///< @copydoc eDot3LogLevel
 
 
+/**
+ * 쓰레드 별 코덱 통계
+ */
+struct Dot3CodecStats
+{
+  uint32_t wsa_encode_cnt;      ///< WSA 를 (캐시 없이) 인코딩한 횟수
+  uint32_t wsa_cache_hit_cnt;   ///< 캐시된 WSA 를 (필요 시 수정하여) 재사용한 횟수
+  uint32_t wsa_decode_cnt;      ///< WSA 를 디코딩한 횟수
+};
+
+/**
+ * 쓰레드 별 코덱 컨텍스트
+ *  - 인코딩/디코딩 경로에서 변경되는 상태를 쓰레드 별로 두어, 쓰레드 간 잠금 없이 동시에 인코딩/디코딩할 수 있도록 한다.
+ *  - asn.1 아레나는 asn.1 라이브러리 별 메모리 함수 구현(asn1mem.c)에 쓰레드 별로 존재한다.
+ */
+struct Dot3CodecCtx
+{
+  uint32_t mib_epoch;                                   ///< WSA 캐시를 채운 시점의 라이브러리 초기화 세대
+  struct Dot3CodecStats stats;                          ///< 코덱 통계
+  struct Dot3WsaCacheEntry wsa_cache[kDot3WsaMaxId + 1]; ///< WSA 인코딩 캐시 (WSA ID 로 인덱싱)
+};
+
+
 /*
  * 함수 원형(들)
  */
@@ -49,14 +72,17 @@ typedef int Dot3LogLevel;  ///< @copydoc eDot3LogLevel
 int INTERNAL dot3_InitDot3(void);
 
 // dot3-chaninfo.c
-int INTERNAL dot3_InitPciTable(struct Dot3ProviderInfo *const pinfo);
-void INTERNAL dot3_FlushPciTable(struct Dot3ProviderInfo *const pinfo);
+void INTERNAL dot3_InitPciTable(struct Dot3ProviderInfo *const pinfo);
 void INTERNAL dot3_PrintPciTableEntry(
   const Dot3LogLevel log_level,
   const struct Dot3PciTableEntry *const entry);
 void INTERNAL dot3_PrintPciContents(const Dot3LogLevel log_level, const struct Dot3Pci *const info);
 void INTERNAL dot3_PrintPciTable(const Dot3LogLevel log_level, const struct Dot3ProviderInfo *const pinfo);
 
+// dot3-codec-ctx.c
+struct Dot3CodecCtx INTERNAL *dot3_GetCodecCtx(void);
+void INTERNAL dot3_GetCodecStats(struct Dot3CodecStats *const stats);
+
 // dot3-check-validity.c
 bool INTERNAL dot3_IsValidPsidValue(const Dot3Psid psid);
 bool INTERNAL dot3_IsValidPriorityValue(const Dot3Priority priority);
@@ -87,16 +113,21 @@ int dot3_ParseMpdu(const uint8_t *const mpdu, const Dot3PduSize mpdu_size, struc
 
 // dot3-psr.c
 void INTERNAL dot3_InitPsrTable(struct Dot3ProviderInfo *const pinfo);
+const struct Dot3PsrSnapshotEntry INTERNAL *dot3_FindPsrInSnapshot(
+  const struct Dot3PsrSnapshot *const snapshot,
+  const Dot3Psid psid);
+const struct Dot3PsrSnapshot INTERNAL *dot3_AcquirePsrSnapshot(struct Dot3ProviderInfo *const pinfo);
+void INTERNAL dot3_ReleasePsrSnapshot(struct Dot3ProviderInfo *const pinfo);
 int INTERNAL dot3_AddPsr(struct Dot3ProviderInfo *const pinfo, const struct Dot3Psr *const psr);
 int INTERNAL dot3_DeletePsr(struct Dot3ProviderInfo *const pinfo, const Dot3Psid psid);
 void INTERNAL dot3_DeleteAllPsrs(struct Dot3ProviderInfo *const pinfo);
 int INTERNAL dot3_GetPsrWithPsid(
-  const struct Dot3ProviderInfo *const pinfo,
+  struct Dot3ProviderInfo *const pinfo,
   const Dot3Psid psid,
   struct Dot3Psr *const psr);
-int INTERNAL dot3_GetPsrNum(const struct Dot3ProviderInfo *const pinfo);
+int INTERNAL dot3_GetPsrNum(struct Dot3ProviderInfo *const pinfo);
 int INTERNAL dot3_GetAllPsrs(
-  const struct Dot3ProviderInfo *const pinfo,
+  struct Dot3ProviderInfo *const pinfo,
   struct Dot3Psr *psrs_array,
   const Dot3PsrNum psrs_array_size);
 void INTERNAL dot3_PrintPsrContents(const Dot3LogLevel log_level, const struct Dot3Psr *const psr);
@@ -126,6 +157,33 @@ int dot3_ParseWsm(
   const Dot3PduSize outbuf_size,
   struct Dot3WsmMpduRxParams *const params);
 
+// dot3-wsmp.c
+int INTERNAL dot3_DecodeWsmpHdr(
+  const uint8_t *const msdu,
+  const Dot3PduSize msdu_size,
+  struct Dot3WsmMpduRxParams *const params,
+  Dot3PduSize *const body_offset);
+int INTERNAL dot3_GetWsmpHdrSize(const struct Dot3WsmMpduTxParams *const params, const Dot3PduSize body_size);
+void INTERNAL dot3_EncodeWsmpHdr(
+  const struct Dot3WsmMpduTxParams *const params,
+  const Dot3PduSize body_size,
+  uint8_t *const outbuf);
+int INTERNAL dot3_EncodeWsmp(
+  struct Dot3WsmMpduTxParams *const params,
+  const uint8_t *const payload,
+  const Dot3PduSize payload_size,
+  uint8_t *const outbuf,
+  const Dot3PduSize outbuf_size);
+
+// dot3-wsr.c
+void INTERNAL dot3_InitWsrTable(struct Dot3UserInfo *const uinfo);
+int INTERNAL dot3_AddWsr(struct Dot3UserInfo *const uinfo, const Dot3Psid psid);
+int INTERNAL dot3_DeleteWsr(struct Dot3UserInfo *const uinfo, const Dot3Psid psid);
+void INTERNAL dot3_DeleteAllWsrs(struct Dot3UserInfo *const uinfo);
+int INTERNAL dot3_GetWsrNum(const struct Dot3UserInfo *const uinfo);
+int INTERNAL dot3_GetAllWsrs(const struct Dot3UserInfo *const uinfo, struct Dot3Wsr *const wsrs);
+bool INTERNAL dot3_IsWsrRegistered(const struct Dot3UserInfo *const uinfo, const Dot3Psid psid);
+
 /*
  * 로그출력 매크로
  */
@@ -16,6 +16,10 @@
 #include "dot3/dot3-types.h"
 
 
+/// Provider Channel Info 테이블 크기 (V2X 주파수 대역의 채널 개수)
+#define DOT3_PCI_TABLE_SIZE (kDot3Channel_KoreaV2XMax - kDot3Channel_KoreaV2XMin + 1)
+
+
 /**
  * Provider Channel Info 테이블 엔트리
  *  - dot3 라이브러리 초기화 시, V2X 주파수 대역의 각 채널에 대한 초기 테이블이 생성되며, WSA 의 channel info 에 수납된다.
@@ -25,9 +29,13 @@ struct Dot3PciTableEntry
 {
   struct Dot3Pci pci;   ///< Provider Channel Info 정보
   /// (현재 미사용) Dot3ProviderChannelAccess chan_access;  ///< 채널접속 방식 (continous, alternating) TODO:: 삭제 검토
-  TAILQ_ENTRY(Dot3PciTableEntry) entries;
 };
-TAILQ_HEAD(Dot3PciTableEntryHead, Dot3PciTableEntry);
+
+
+/// PSR 테이블의 PSID 해시 인덱스 크기 (2의 거듭제곱이며, 스냅샷 인덱스의 빈 슬롯 확보를 위해 PSR 최대개수보다 커야 한다)
+#define DOT3_PSR_HASH_SIZE 256
+/// PSID 해시 값을 인덱스로 변환하기 위한 시프트 값 (= 32 - log2(DOT3_PSR_HASH_SIZE))
+#define DOT3_PSR_HASH_SHIFT 24
 
 
 /**
@@ -37,10 +45,55 @@ struct Dot3PsrTableEntry/*type*/
 {
   struct Dot3Psr psr;               ///< Provider Service Request 정보
   unsigned int option_cnt;          ///< Provider Service Request 내 옵션필드 존재 개수
-  struct Dot3PciTableEntry *pci_entry;  ///< 서비스채널과 연관된 Provider Channel Info 참조
   TAILQ_ENTRY(Dot3PsrTableEntry/*type*/)	entries/*field*/;
+  TAILQ_ENTRY(Dot3PsrTableEntry) hash_entries; ///< PSID 해시 버킷 연결
 };
 TAILQ_HEAD(Dot3PsrTableEntryHead/*headname*/, Dot3PsrTableEntry/*type*/);
+TAILQ_HEAD(Dot3PsrHashBucketHead, Dot3PsrTableEntry);
+
+
+/**
+ * Provider Service Request 테이블 스냅샷 엔트리
+ */
+struct Dot3PsrSnapshotEntry
+{
+  struct Dot3Psr psr;               ///< Provider Service Request 정보
+  unsigned int option_cnt;          ///< Provider Service Request 내 옵션필드 존재 개수
+};
+
+
+/**
+ * Provider Service Request 테이블 스냅샷
+ *  - PSR 테이블이 변경될 때마다 provider 뮤텍스 락 상태에서 새로 생성되어 게시되며, 게시된 이후에는 변경되지 않는다.
+ *  - 읽기 측(WSA 생성, PSR 조회)은 dot3_AcquirePsrSnapshot() ~ dot3_ReleasePsrSnapshot() 구간에서 뮤텍스 없이 참조한다.
+ *  - 엔트리는 PSR 테이블(TAILQ)과 동일한 순서로 저장된다.
+ */
+struct Dot3PsrSnapshot
+{
+  uint32_t gen;                             ///< 스냅샷 세대 (PSR 테이블 변경 시마다 1씩 증가)
+  Dot3PsrNum num;                           ///< 엔트리 개수
+  struct Dot3PsrSnapshot *retired_next;     ///< 회수 대기 목록 연결
+  uint16_t index[DOT3_PSR_HASH_SIZE];       ///< PSID 해시 인덱스 (선형 탐사, 엔트리 인덱스 + 1. 0은 빈 슬롯)
+  struct Dot3PsrSnapshotEntry entries[kDot3PsrNum_MaxNum];  ///< PSR 엔트리들
+};
+
+
+/**
+ * WSA 인코딩 캐시 엔트리 (쓰레드 별 코덱 컨텍스트에 WSA ID 별로 존재한다)
+ *  - 마지막으로 인코딩된 WSA 와, 인코딩에 사용된 입력(파라미터, PSR 테이블 스냅샷 세대)을 저장한다.
+ *  - 입력이 같으면 저장된 WSA 를 그대로 사용하고, content count 나 위치정보 값만 다르면 해당 비트만 수정하여 사용한다.
+ */
+struct Dot3WsaCacheEntry
+{
+  bool valid;                             ///< 저장된 WSA 의 유효 여부
+  uint32_t psr_gen;                       ///< 인코딩에 사용된 PSR 테이블 스냅샷 세대 (빈 테이블이면 0)
+  struct Dot3ConstructWsaParams params;   ///< 인코딩에 사용된 파라미터
+  int content_count_bitpos;               ///< WSA 내 content count 필드의 비트 위치 (음수이면 수정 불가)
+  int twod_location_bitpos;               ///< WSA 내 2D 위치정보의 비트 위치 (음수이면 수정 불가)
+  int threed_location_bitpos;             ///< WSA 내 3D 위치정보의 비트 위치 (음수이면 수정 불가)
+  Dot3PduSize wsa_size;                   ///< 저장된 WSA 의 길이
+  uint8_t wsa[kWsmBodySafeMaxSize];       ///< 저장된 WSA
+};
 
 
 /**
@@ -52,25 +105,81 @@ struct Dot3ProviderInfo
   pthread_mutex_t mtx;
 
   /// Provider Service Request 테이블
+  ///  - num, head, hash, retired 는 provider 뮤텍스로 보호된다.
+  ///  - snapshot, reader_cnt 는 원자적으로 접근된다.
   struct {
     Dot3PsrNum num;
     struct Dot3PsrTableEntryHead head;
+    struct Dot3PsrHashBucketHead hash[DOT3_PSR_HASH_SIZE];  ///< PSID 해시 인덱스
+    uint32_t gen;                         ///< 마지막으로 게시된 스냅샷의 세대
+    struct Dot3PsrSnapshot *snapshot;     ///< 현재 게시된 스냅샷 (NULL 이면 빈 테이블)
+    struct Dot3PsrSnapshot *retired;      ///< 읽기 측 참조가 끝나기를 기다리는 이전 스냅샷 목록
+    unsigned int reader_cnt;              ///< 스냅샷을 참조 중인 읽기 측 개수
   } psr_table;
 
   /// Provider Channel Info 테이블
+  ///  - 엔트리는 초기화 시 한번 설정되며, 이후에는 제자리에서 갱신된다.
+  ///  - 채널번호에 해당하는 엔트리는 dot3_GetPciTableEntry() 로 참조한다.
   struct {
     Dot3PciNum num;
-    struct Dot3PciTableEntryHead head;
+    struct Dot3PciTableEntry entries[DOT3_PCI_TABLE_SIZE] __attribute__((aligned(64)));  ///< 채널번호 순 배열
   } pci_table;
 };
 
 
+/**
+ * 특정 채널에 대한 Provider Channel Info 테이블 엔트리를 반환한다.
+ *
+ * @param pinfo     provider info MIB
+ * @param chan_num  채널번호
+ * @return          해당 채널의 엔트리, 테이블에 없는 채널이면 NULL
+ */
+static inline const struct Dot3PciTableEntry *
+dot3_GetPciTableEntry(const struct Dot3ProviderInfo *const pinfo, const Dot3ChannelNumber chan_num)
+{
+  if ((chan_num < kDot3Channel_KoreaV2XMin) || (chan_num > kDot3Channel_KoreaV2XMax)) {
+    return NULL;
+  }
+  return &(pinfo->pci_table.entries[chan_num - kDot3Channel_KoreaV2XMin]);
+}
+
+
+/// WSR 테이블의 PSID 해시 인덱스 크기 (2의 거듭제곱이며, 빈 슬롯 확보를 위해 WSR 최대개수보다 커야 한다)
+#define DOT3_WSR_HASH_SIZE 256
+/// PSID 해시 값을 인덱스로 변환하기 위한 시프트 값 (= 32 - log2(DOT3_WSR_HASH_SIZE))
+#define DOT3_WSR_HASH_SHIFT 24
+/// WSR 테이블 해시 인덱스의 빈 슬롯 값 (유효한 PSID 범위를 벗어나는 값)
+#define DOT3_WSR_HASH_EMPTY 0xFFFFFFFFU
+
+
+/**
+ * User 관련 정보
+ */
+struct Dot3UserInfo
+{
+  /// User 관련정보 동기화를 위한 뮤텍스
+  pthread_mutex_t mtx;
+
+  /// WAVE Service Request 테이블
+  ///  - num, psids 는 user 뮤텍스로 보호된다.
+  ///  - hash 는 user 뮤텍스 락 상태에서 변경되며, 수신 경로에서는 seq 를 이용하여 뮤텍스 없이 읽는다. (seqlock)
+  struct {
+    Dot3WsrNum num;
+    Dot3Psid psids[kDot3WsrNum_MaxNum];   ///< 등록된 PSID 들 (등록 순)
+    unsigned int seq;                     ///< hash 변경 중에는 홀수
+    Dot3Psid hash[DOT3_WSR_HASH_SIZE];    ///< PSID 해시 인덱스 (선형 탐사, DOT3_WSR_HASH_EMPTY 는 빈 슬롯)
+  } wsr_table;
+};
+
+
 /**
  * Management Information Base (MIB)
  */
 struct Dot3Mib
 {
   struct Dot3ProviderInfo provider_info;  ///< Provider 관련 정보
+  struct Dot3UserInfo user_info;  ///< User 관련 정보
+  uint32_t epoch;  ///< 초기화 세대 (초기화 시마다 1씩 증가. 쓰레드 별 WSA 캐시 무효화에 사용된다)
 };
 
 
@@ -19,6 +19,22 @@
 #include "dot3-mib.h"
 
 
+_Static_assert(DOT3_PSR_HASH_SIZE > kDot3PsrNum_MaxNum, "DOT3_PSR_HASH_SIZE must be larger than kDot3PsrNum_MaxNum");
+_Static_assert((1U << (32 - DOT3_PSR_HASH_SHIFT)) == DOT3_PSR_HASH_SIZE, "DOT3_PSR_HASH_SHIFT mismatch");
+
+
+/**
+ * PSID 에 대한 해시 인덱스를 반환한다.
+ *
+ * @param psid      PSID
+ * @return          해시 인덱스 (0 ~ DOT3_PSR_HASH_SIZE-1)
+ */
+static inline unsigned int dot3_GetPsrHashIndex(const Dot3Psid psid)
+{
+  return ((uint32_t)psid * 0x9E3779B1U) >> DOT3_PSR_HASH_SHIFT;
+}
+
+
 /**
  * PSR 테이블을 초기화한다.
  *
@@ -27,12 +43,20 @@
 void INTERNAL dot3_InitPsrTable(struct Dot3ProviderInfo *const pinfo)
 {
   TAILQ_INIT(&(pinfo->psr_table.head));
+  for (unsigned int i = 0; i < DOT3_PSR_HASH_SIZE; i++) {
+    TAILQ_INIT(&(pinfo->psr_table.hash[i]));
+  }
   pinfo->psr_table.num = 0;
+  pinfo->psr_table.gen = 0;
+  pinfo->psr_table.snapshot = NULL;
+  pinfo->psr_table.retired = NULL;
+  pinfo->psr_table.reader_cnt = 0;
 }
 
 
 /**
  * PSR 테이블에서 특정 PSID를 갖는 PSR을 찾아 반환한다.
+ * provider 뮤텍스 락 상태에서 호출되어야 한다.
  *
  * @param pinfo     provider info MIB
  * @param psid      찾고자 하는 PSID
@@ -41,7 +65,7 @@ void INTERNAL dot3_InitPsrTable(struct Dot3ProviderInfo *const pinfo)
 static struct Dot3PsrTableEntry* dot3_FindPsrWithPsid(const struct Dot3ProviderInfo *const pinfo, const Dot3Psid psid)
 {
   struct Dot3PsrTableEntry *psr_entry;
-  TAILQ_FOREACH(psr_entry, &(pinfo->psr_table.head), entries) {
+  TAILQ_FOREACH(psr_entry, &(pinfo->psr_table.hash[dot3_GetPsrHashIndex(psid)]), hash_entries) {
     if (psr_entry->psr.psid == psid) {
       return psr_entry;
     }
@@ -50,6 +74,119 @@ static struct Dot3PsrTableEntry* dot3_FindPsrWithPsid(const struct Dot3ProviderI
 }
 
 
+/**
+ * PSR 테이블 스냅샷에서 특정 PSID를 갖는 PSR을 찾아 반환한다.
+ *
+ * @param snapshot  PSR 테이블 스냅샷 (NULL 이면 빈 테이블)
+ * @param psid      찾고자 하는 PSID
+ * @return          성공 시 해당 엔트리의 포인터, 실패 시 NULL
+ */
+const struct Dot3PsrSnapshotEntry INTERNAL *dot3_FindPsrInSnapshot(const struct Dot3PsrSnapshot *const snapshot, const Dot3Psid psid)
+{
+  if (!snapshot) {
+    return NULL;
+  }
+  for (unsigned int i = dot3_GetPsrHashIndex(psid); snapshot->index[i]; i = (i + 1) & (DOT3_PSR_HASH_SIZE - 1)) {
+    const struct Dot3PsrSnapshotEntry *entry = &(snapshot->entries[snapshot->index[i] - 1]);
+    if (entry->psr.psid == psid) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+
+/**
+ * 읽기 측 참조가 끝난 이전 스냅샷들을 해제한다.
+ * provider 뮤텍스 락 상태에서 호출되어야 한다.
+ *
+ * 스냅샷 교체 이후 참조 중인 읽기 측이 없음이 확인되면, 교체 이전에 게시되었던 스냅샷은 더 이상 참조될 수 없다.
+ * 읽기 측이 있으면 다음 테이블 변경 시에 다시 시도한다. (쓰기 측은 읽기 측을 기다리지 않는다)
+ *
+ * @param pinfo     provider info MIB
+ */
+static void dot3_ReclaimPsrSnapshots(struct Dot3ProviderInfo *const pinfo)
+{
+  if (__atomic_load_n(&(pinfo->psr_table.reader_cnt), __ATOMIC_SEQ_CST) != 0) {
+    return;
+  }
+  struct Dot3PsrSnapshot *snapshot = pinfo->psr_table.retired, *next;
+  while (snapshot) {
+    next = snapshot->retired_next;
+    free(snapshot);
+    snapshot = next;
+  }
+  pinfo->psr_table.retired = NULL;
+}
+
+
+/**
+ * 현재 PSR 테이블 내용으로 스냅샷을 채워 게시한다.
+ * provider 뮤텍스 락 상태에서 호출되어야 한다.
+ *
+ * @param pinfo     provider info MIB
+ * @param snapshot  내용을 채워 게시할 스냅샷 (테이블 변경 전에 미리 할당된다). NULL 이면 빈 테이블이 게시된다.
+ */
+static void dot3_PublishPsrSnapshot(struct Dot3ProviderInfo *const pinfo, struct Dot3PsrSnapshot *const snapshot)
+{
+  uint32_t gen = ++(pinfo->psr_table.gen);
+  if (snapshot) {
+    snapshot->gen = gen;
+    snapshot->num = 0;
+    snapshot->retired_next = NULL;
+    memset(snapshot->index, 0, sizeof(snapshot->index));
+    struct Dot3PsrTableEntry *psr_entry;
+    TAILQ_FOREACH(psr_entry, &(pinfo->psr_table.head), entries) {
+      struct Dot3PsrSnapshotEntry *entry = &(snapshot->entries[snapshot->num++]);
+      memcpy(&(entry->psr), &(psr_entry->psr), sizeof(struct Dot3Psr));
+      entry->option_cnt = psr_entry->option_cnt;
+      unsigned int i = dot3_GetPsrHashIndex(psr_entry->psr.psid);
+      while (snapshot->index[i]) {
+        i = (i + 1) & (DOT3_PSR_HASH_SIZE - 1);
+      }
+      snapshot->index[i] = (uint16_t)snapshot->num;
+    }
+  }
+
+  /*
+   * 새 스냅샷으로 교체하고, 이전 스냅샷은 회수 대기 목록에 넣는다.
+   */
+  struct Dot3PsrSnapshot *old = __atomic_exchange_n(&(pinfo->psr_table.snapshot), snapshot, __ATOMIC_SEQ_CST);
+  if (old) {
+    old->retired_next = pinfo->psr_table.retired;
+    pinfo->psr_table.retired = old;
+  }
+  dot3_ReclaimPsrSnapshots(pinfo);
+  Log(kDot3LogLevel_event, "PSR table snapshot(gen: %u) is published\n", gen);
+}
+
+
+/**
+ * 현재 게시된 PSR 테이블 스냅샷의 참조를 시작한다.
+ * 뮤텍스를 사용하지 않으며, 동시에 수행되는 PSR 추가/삭제를 기다리게 하지 않는다.
+ * 반환된 스냅샷은 dot3_ReleasePsrSnapshot() 호출 전까지 유효하며, 그 내용은 변경되지 않는다.
+ *
+ * @param pinfo     provider info MIB
+ * @return          현재 게시된 스냅샷 (NULL 이면 빈 테이블)
+ */
+const struct Dot3PsrSnapshot INTERNAL *dot3_AcquirePsrSnapshot(struct Dot3ProviderInfo *const pinfo)
+{
+  __atomic_add_fetch(&(pinfo->psr_table.reader_cnt), 1, __ATOMIC_SEQ_CST);
+  return __atomic_load_n(&(pinfo->psr_table.snapshot), __ATOMIC_SEQ_CST);
+}
+
+
+/**
+ * PSR 테이블 스냅샷의 참조를 종료한다.
+ *
+ * @param pinfo     provider info MIB
+ */
+void INTERNAL dot3_ReleasePsrSnapshot(struct Dot3ProviderInfo *const pinfo)
+{
+  __atomic_sub_fetch(&(pinfo->psr_table.reader_cnt), 1, __ATOMIC_SEQ_CST);
+}
+
+
 /**
  * PSR을 테이블에 추가한다.
  * provider 뮤텍스 락 상태에서 호출되어야 한다.
@@ -82,10 +219,13 @@ int INTERNAL dot3_AddPsr(struct Dot3ProviderInfo *const pinfo, const struct Dot3
    */
   int ret;
   {
-    // PSR 엔트리 할당 및 값 저장
+    // PSR 엔트리 및 게시할 스냅샷 할당, 값 저장
     struct Dot3PsrTableEntry *psr_entry = (struct Dot3PsrTableEntry *)calloc(1, sizeof(struct Dot3PsrTableEntry));
-    if (!psr_entry) {
+    struct Dot3PsrSnapshot *snapshot = (struct Dot3PsrSnapshot *)malloc(sizeof(struct Dot3PsrSnapshot));
+    if (!psr_entry || !snapshot) {
       Err("Fail to add PSR - %s\n", strerror(errno));
+      free(psr_entry);
+      free(snapshot);
       return -kDot3Result_Fail_NoMemory;
     }
     memcpy(&psr_entry->psr, psr, sizeof(struct Dot3Psr));
@@ -96,27 +236,19 @@ int INTERNAL dot3_AddPsr(struct Dot3ProviderInfo *const pinfo, const struct Dot3
     if (psr->present.wsa_cnt_threshold) { psr_entry->option_cnt++; }
     if (psr->present.wsa_cnt_threshold_interval) { psr_entry->option_cnt++; }
 
-    // Channel info 정보 참조
-    bool found = false;
-    struct Dot3PciTableEntry *pci_entry;
-    TAILQ_FOREACH(pci_entry, &(pinfo->pci_table.head), entries) {
-      if (psr->service_chan_num == pci_entry->pci.chan_num) {
-        psr_entry->pci_entry = pci_entry;
-        Log(kDot3LogLevel_config, "Channel info for channel %d is referenced - %p\n",
-            psr->service_chan_num, psr_entry->pci_entry);
-        found = true;
-        break;
-      }
-    }
-    if (!found) {
+    // 서비스채널에 대한 Channel info 정보 존재 여부 확인
+    if (!dot3_GetPciTableEntry(pinfo, psr->service_chan_num)) {
       Err("Fail to add PSR - cannot find channel info for service channel %d\n", psr->service_chan_num);
       free(psr_entry);
+      free(snapshot);
       return -kDot3Result_Fail_NoRelatedChannelInfo;
     }
 
-    // 테이블에 추가
+    // 테이블에 추가하고 스냅샷을 게시
     TAILQ_INSERT_TAIL(&(pinfo->psr_table.head), psr_entry, entries);
+    TAILQ_INSERT_TAIL(&(pinfo->psr_table.hash[dot3_GetPsrHashIndex(psr->psid)]), psr_entry, hash_entries);
     ret = ++(pinfo->psr_table.num);
+    dot3_PublishPsrSnapshot(pinfo, snapshot);
   }
 
   /*
@@ -140,27 +272,27 @@ int INTERNAL dot3_DeletePsr(struct Dot3ProviderInfo *const pinfo, const Dot3Psid
   Log(kDot3LogLevel_config, "Deleting PSR with psid %u\n", psid);
 
   /*
-   * PSR 엔트리를 탐색하여 삭제
+   * PSR 엔트리를 탐색한다. 못 찾으면 실패
    */
-  struct Dot3PsrTableEntry *entry, *tmp, *del = NULL;
-  TAILQ_FOREACH_SAFE(entry, &(pinfo->psr_table.head), entries, tmp) {
-    if (entry->psr.psid == psid) {
-      TAILQ_REMOVE(&(pinfo->psr_table.head), entry, entries);
-      ret = --(pinfo->psr_table.num);
-      del = entry;
-      break;
-    }
+  struct Dot3PsrTableEntry *entry = dot3_FindPsrWithPsid(pinfo, psid);
+  if (!entry) {
+    Err("Fail to delete PSR - no such PSR with psid %u\n", psid);
+    return -kDot3Result_Fail_NoSuchPsr;
   }
 
   /*
-   * 찾으면 삭제, 못 찾으면 실패
+   * 찾으면 삭제하고 스냅샷을 게시한다.
    */
-  if (del) {
-    free(del);
-  } else {
-    Err("Fail to delete PSR - no such PSR with psid %u\n", psid);
-    return -kDot3Result_Fail_NoSuchPsr;
+  struct Dot3PsrSnapshot *snapshot = (struct Dot3PsrSnapshot *)malloc(sizeof(struct Dot3PsrSnapshot));
+  if (!snapshot) {
+    Err("Fail to delete PSR - %s\n", strerror(errno));
+    return -kDot3Result_Fail_NoMemory;
   }
+  TAILQ_REMOVE(&(pinfo->psr_table.head), entry, entries);
+  TAILQ_REMOVE(&(pinfo->psr_table.hash[dot3_GetPsrHashIndex(entry->psr.psid)]), entry, hash_entries);
+  ret = --(pinfo->psr_table.num);
+  free(entry);
+  dot3_PublishPsrSnapshot(pinfo, snapshot);
 
   Log(kDot3LogLevel_config, "Success to delete PSR - %d entries present\n", ret);
   return ret;
@@ -183,42 +315,40 @@ void INTERNAL dot3_DeleteAllPsrs(struct Dot3ProviderInfo *const pinfo)
   struct Dot3PsrTableEntry *entry, *tmp;
   TAILQ_FOREACH_SAFE(entry, &(pinfo->psr_table.head), entries, tmp) {
     TAILQ_REMOVE(&(pinfo->psr_table.head), entry, entries);
+    TAILQ_REMOVE(&(pinfo->psr_table.hash[dot3_GetPsrHashIndex(entry->psr.psid)]), entry, hash_entries);
     free(entry);
   }
   pinfo->psr_table.num = 0;
+
+  /*
+   * 빈 테이블을 게시한다.
+   */
+  dot3_PublishPsrSnapshot(pinfo, NULL);
 }
 
 
 /**
  * 특정 PSID를 갖는 PSR 정보를 반환한다.
- * provider 뮤텍스 락 상태에서 호출되어야 한다.
+ * 현재 게시된 스냅샷을 참조하므로 provider 뮤텍스 락이 필요하지 않다.
  *
  * @param pinfo     provider info MIB
  * @param psid      @ref Dot3_GetPsrWithPsid
  * @param psr       @ref Dot3_GetPsrWithPsid
  */
-int INTERNAL dot3_GetPsrWithPsid(const struct Dot3ProviderInfo *const pinfo, const Dot3Psid psid, struct Dot3Psr *const psr)
+int INTERNAL dot3_GetPsrWithPsid(struct Dot3ProviderInfo *const pinfo, const Dot3Psid psid, struct Dot3Psr *const psr)
 {
   Log(kDot3LogLevel_config, "Get PSR with psid %u\n", psid);
 
   /*
-   * 테이블을 탐색한다.
+   * 스냅샷을 탐색하여, 찾으면 반환, 못 찾으면 실패
    */
-  bool found = false;
-  struct Dot3PsrTableEntry *entry;
-  TAILQ_FOREACH(entry, &(pinfo->psr_table.head), entries) {
-    if (entry->psr.psid == psid) {
-      found = true;
-      break;
-    }
-  }
-
-  /*
-   * 찾으면 반환, 못 찾으면 실패
-   */
-  if (found) {
+  const struct Dot3PsrSnapshot *snapshot = dot3_AcquirePsrSnapshot(pinfo);
+  const struct Dot3PsrSnapshotEntry *entry = dot3_FindPsrInSnapshot(snapshot, psid);
+  if (entry) {
     memcpy(psr, &entry->psr, sizeof(struct Dot3Psr));
-  } else {
+  }
+  dot3_ReleasePsrSnapshot(pinfo);
+  if (!entry) {
     Err("Fail to get PSR - no such PSR with psid %u\n", psid);
     return -kDot3Result_Fail_NoSuchPsr;
   }
@@ -230,12 +360,15 @@ int INTERNAL dot3_GetPsrWithPsid(const struct Dot3ProviderInfo *const pinfo, con
 
 /**
  * 현재 테이블에 저장되어 있는 PSR의 개수를 반환한다.
+ * 현재 게시된 스냅샷을 참조하므로 provider 뮤텍스 락이 필요하지 않다.
  *
  * @param pinfo     provider info MIB
  */
-int INTERNAL dot3_GetPsrNum(const struct Dot3ProviderInfo *const pinfo)
+int INTERNAL dot3_GetPsrNum(struct Dot3ProviderInfo *const pinfo)
 {
-  int ret = pinfo->psr_table.num;
+  const struct Dot3PsrSnapshot *snapshot = dot3_AcquirePsrSnapshot(pinfo);
+  int ret = snapshot ? (int)(snapshot->num) : 0;
+  dot3_ReleasePsrSnapshot(pinfo);
   Log(kDot3LogLevel_config, "Get the number of PSR - %d\n", ret);
   return ret;
 }
@@ -243,32 +376,28 @@ int INTERNAL dot3_GetPsrNum(const struct Dot3ProviderInfo *const pinfo)
 
 /**
  * 테이블 내 모든 PSR의 정보를 반환한다.
- * provider 뮤텍스 락 상태에서 호출되어야 한다.
+ * 현재 게시된 스냅샷을 참조하므로 provider 뮤텍스 락이 필요하지 않다.
  *
  * @param pinfo             provider info MIB
  * @param psrs_array        @ref Dot3_GetAllPsrs
  * @param psrs_array_size   @ref Dot3_GetAllPsrs
  */
 int INTERNAL dot3_GetAllPsrs(
-  const struct Dot3ProviderInfo *const pinfo,
+  struct Dot3ProviderInfo *const pinfo,
   struct Dot3Psr *psrs_array,
   const Dot3PsrNum psrs_array_size)
 {
   /*
-   * 테이블 내 모든 PSR 정보를 반환 배열에 복사한다.
+   * 스냅샷 내 모든 PSR 정보를 반환 배열에 복사한다.
    *  - 배열 크기와 엔트리 개수 중 작은 값만큼만 반환한다. (오버플로우 방지)
    */
-  uint32_t min_cnt = (psrs_array_size > pinfo->psr_table.num) ? pinfo->psr_table.num : psrs_array_size;
-  struct Dot3Psr *ptr;
-  struct Dot3PsrTableEntry *entry;
-  uint32_t copied = 0;
-  TAILQ_FOREACH(entry, &(pinfo->psr_table.head), entries) {
-    ptr = psrs_array + copied++;
-    memcpy(ptr, &entry->psr, sizeof(struct Dot3Psr));
-    if (copied == min_cnt) {
-      break;
-    }
+  const struct Dot3PsrSnapshot *snapshot = dot3_AcquirePsrSnapshot(pinfo);
+  uint32_t num = snapshot ? snapshot->num : 0;
+  uint32_t copied = (psrs_array_size > num) ? num : psrs_array_size;
+  for (uint32_t i = 0; i < copied; i++) {
+    memcpy(psrs_array + i, &(snapshot->entries[i].psr), sizeof(struct Dot3Psr));
   }
+  dot3_ReleasePsrSnapshot(pinfo);
 
   /*
    * 복사된 개수를 반환한다.
@@ -3,8 +3,18 @@
  * @date 2019-08-17
  * @author gyun
  * @brief WSA 관련 함수들을 구현한 파일
+ *
+ * WSA 는 반복주기마다 생성되지만 그 내용(PSR 테이블, 헤더 파라미터)은 거의 변하지 않으므로,
+ * WSA ID 별로 마지막 인코딩 결과를 캐시하여 입력이 같으면 다시 인코딩하지 않는다.
+ *  - 캐시는 쓰레드 별 코덱 컨텍스트에 있으므로, 여러 쓰레드에서 동시에 WSA 를 생성해도 잠금이 필요 없다.
+ *  - PSR 테이블 변경은 PSR 테이블 스냅샷 세대로 감지한다.
+ *    PCI 테이블은 초기화 이후 변경되지 않으므로 별도의 세대를 두지 않는다.
+ *  - content count 와 위치정보(2D/3D location) 값은 UPER 인코딩 시 고정 길이이므로, 이들만 바뀐 경우에는
+ *    캐시된 WSA 의 해당 비트만 수정한다. (그 외의 입력이 바뀌면 전체를 다시 인코딩한다)
  */
 
+#include <string.h>
+
 #include "dot3-internal.h"
 #if defined(OBJASN1C_)
   #include "dot3-objasn1c.h"
@@ -13,6 +23,278 @@
 #endif
 
 
+/*
+ * UPER 인코딩된 WSA 내 고정 길이 필드의 비트 위치/길이
+ *  - WSA 는 SrvAdvPrtVersion(4비트), SrvAdvBody 옵션필드 비트맵(4비트), saID(4비트), contentCount(4비트) 순으로 시작한다.
+ *  - 위치정보는 Latitude(fill 1비트 + lat 31비트), Longitude(32비트), Elevation(16비트) 순으로 인코딩된다.
+ */
+#define DOT3_WSA_ID_BITPOS 8              ///< saID 필드의 비트 위치
+#define DOT3_WSA_CONTENT_COUNT_BITPOS 12  ///< contentCount 필드의 비트 위치
+#define DOT3_WSA_ID_BITS 4                ///< saID 필드의 비트 길이
+#define DOT3_WSA_CONTENT_COUNT_BITS 4     ///< contentCount 필드의 비트 길이
+#define DOT3_WSA_LATITUDE_BITS 32         ///< Latitude 의 비트 길이 (fill 포함)
+#define DOT3_WSA_LONGITUDE_BITS 32        ///< Longitude 의 비트 길이
+#define DOT3_WSA_ELEVATION_BITS 16        ///< Elevation 의 비트 길이
+#define DOT3_WSA_LONGITUDE_MIN (-1799999999) ///< asn.1 정의 상 Longitude 최소값 (kDot3Longitude_Min 과 다름)
+
+
+/**
+ * 버퍼 내 특정 비트 위치에 값을 MSB 부터 기록한다.
+ *
+ * @param buf       버퍼
+ * @param bitpos    기록할 비트 위치
+ * @param value     기록할 값
+ * @param bits      기록할 비트 길이 (32 이하)
+ */
+static void dot3_WriteWsaBits(uint8_t *const buf, const unsigned int bitpos, const uint32_t value, const unsigned int bits)
+{
+  for (unsigned int i = 0; i < bits; i++) {
+    unsigned int pos = bitpos + i;
+    uint8_t mask = (uint8_t)(0x80 >> (pos & 7));
+    if ((value >> (bits - 1 - i)) & 1) {
+      buf[pos >> 3] |= mask;
+    } else {
+      buf[pos >> 3] &= (uint8_t)~mask;
+    }
+  }
+}
+
+
+/**
+ * 버퍼 내 특정 비트 위치의 값을 읽는다.
+ *
+ * @param buf       버퍼
+ * @param bitpos    읽을 비트 위치
+ * @param bits      읽을 비트 길이 (32 이하)
+ * @return          읽은 값
+ */
+static uint32_t dot3_ReadWsaBits(const uint8_t *const buf, const unsigned int bitpos, const unsigned int bits)
+{
+  uint32_t value = 0;
+  for (unsigned int i = 0; i < bits; i++) {
+    unsigned int pos = bitpos + i;
+    value = (value << 1) | ((buf[pos >> 3] >> (7 - (pos & 7))) & 1);
+  }
+  return value;
+}
+
+
+/**
+ * 위치정보를 UPER 인코딩 형식의 비트열로 변환한다.
+ *
+ * @param latitude      위도
+ * @param longitude     경도
+ * @param elevation     고도 (NULL 이면 2D 위치정보)
+ * @param bits          비트열이 저장될 버퍼 (10바이트 이상)
+ * @return              비트열의 길이, asn.1 정의 상 인코딩할 수 없는 값이면 0
+ */
+static unsigned int dot3_MakeWsaLocationBits(
+  const Dot3Latitude latitude,
+  const Dot3Longitude longitude,
+  const Dot3Elevation *const elevation,
+  uint8_t *const bits)
+{
+  if ((latitude < kDot3Latitude_Min) || (latitude > kDot3Latitude_Max) ||
+      (longitude < DOT3_WSA_LONGITUDE_MIN) || (longitude > kDot3Longitude_Max) ||
+      (elevation && ((*elevation < kDot3Elevation_Min) || (*elevation > kDot3Elevation_Max)))) {
+    return 0;
+  }
+  unsigned int len = 0;
+  dot3_WriteWsaBits(bits, len, (uint32_t)((int64_t)latitude - kDot3Latitude_Min), DOT3_WSA_LATITUDE_BITS); // fill 비트(0) 포함
+  len += DOT3_WSA_LATITUDE_BITS;
+  dot3_WriteWsaBits(bits, len, (uint32_t)((int64_t)longitude - DOT3_WSA_LONGITUDE_MIN), DOT3_WSA_LONGITUDE_BITS);
+  len += DOT3_WSA_LONGITUDE_BITS;
+  if (elevation) {
+    dot3_WriteWsaBits(bits, len, (uint32_t)(*elevation - kDot3Elevation_Min), DOT3_WSA_ELEVATION_BITS);
+    len += DOT3_WSA_ELEVATION_BITS;
+  }
+  return len;
+}
+
+
+/**
+ * 인코딩된 WSA 내에서 비트열의 위치를 찾는다.
+ *  - WSA 전체에서 한 곳에만 존재해야 위치를 반환한다. (여러 곳에 존재하면 어느 것이 해당 필드인지 알 수 없다)
+ *
+ * @param wsa       인코딩된 WSA
+ * @param wsa_size  인코딩된 WSA 의 길이
+ * @param bits      찾을 비트열
+ * @param len       찾을 비트열의 길이
+ * @return          비트 위치, 찾지 못했거나 여러 곳에 존재하면 -1
+ */
+static int dot3_FindWsaBits(const uint8_t *const wsa, const Dot3PduSize wsa_size, const uint8_t *const bits, const unsigned int len)
+{
+  int found = -1;
+  if (!len || (len > (unsigned int)wsa_size * 8)) {
+    return -1;
+  }
+  for (unsigned int pos = 0; pos <= ((unsigned int)wsa_size * 8) - len; pos++) {
+    unsigned int i;
+    for (i = 0; i < len; i++) {
+      if (dot3_ReadWsaBits(wsa, pos + i, 1) != dot3_ReadWsaBits(bits, i, 1)) {
+        break;
+      }
+    }
+    if (i == len) {
+      if (found >= 0) {
+        return -1;
+      }
+      found = (int)pos;
+    }
+  }
+  return found;
+}
+
+
+/**
+ * 두 WSA 파라미터가, content count 와 위치정보 값을 제외하고 동일한 WSA 를 생성하는지 확인한다.
+ *  - WSA 에 수납되지 않는 필드(존재하지 않는 확장필드의 값 등)는 비교하지 않는다.
+ *
+ * @param a     WSA 파라미터
+ * @param b     WSA 파라미터
+ * @return      동일하면 true
+ */
+static bool dot3_IsSameWsaContents(const struct Dot3ConstructWsaParams *const a, const struct Dot3ConstructWsaParams *const b)
+{
+  if ((a->hdr.wsa_id != b->hdr.wsa_id) ||
+      (a->hdr.extensions.repeat_rate != b->hdr.extensions.repeat_rate) ||
+      (a->hdr.extensions.twod_location != b->hdr.extensions.twod_location) ||
+      (a->hdr.extensions.threed_location != b->hdr.extensions.threed_location) ||
+      (a->hdr.extensions.advertiser_id != b->hdr.extensions.advertiser_id) ||
+      (a->present.wra != b->present.wra)) {
+    return false;
+  }
+  if (a->hdr.extensions.repeat_rate && (a->hdr.repeat_rate != b->hdr.repeat_rate)) {
+    return false;
+  }
+  if (a->hdr.extensions.advertiser_id &&
+      ((a->hdr.advertiser_id.len != b->hdr.advertiser_id.len) ||
+       memcmp(a->hdr.advertiser_id.id, b->hdr.advertiser_id.id, a->hdr.advertiser_id.len))) {
+    return false;
+  }
+  if (a->present.wra &&
+      ((a->wra.router_lifetime != b->wra.router_lifetime) ||
+       (a->wra.ip_prefix_len != b->wra.ip_prefix_len) ||
+       memcmp(a->wra.ip_prefix, b->wra.ip_prefix, sizeof(a->wra.ip_prefix)) ||
+       memcmp(a->wra.default_gw, b->wra.default_gw, sizeof(a->wra.default_gw)) ||
+       memcmp(a->wra.primary_dns, b->wra.primary_dns, sizeof(a->wra.primary_dns)))) {
+    return false;
+  }
+  return true;
+}
+
+
+/**
+ * 새로 인코딩된 WSA 를 캐시 엔트리에 등록한다.
+ *  - 이후 비트 단위 수정을 위해 content count 및 위치정보 필드의 비트 위치를 찾아 둔다.
+ *
+ * @param entry     WSA 인코딩 캐시 엔트리 (wsa 에 인코딩된 WSA 가 저장되어 있다)
+ * @param psr_gen   인코딩에 사용된 PSR 테이블 스냅샷 세대
+ * @param params    인코딩에 사용된 파라미터
+ * @param wsa_size  인코딩된 WSA 의 길이
+ */
+static void dot3_FillWsaCacheEntry(
+  struct Dot3WsaCacheEntry *const entry,
+  const uint32_t psr_gen,
+  const struct Dot3ConstructWsaParams *const params,
+  const Dot3PduSize wsa_size)
+{
+  uint8_t bits[16];
+  unsigned int len;
+
+  entry->psr_gen = psr_gen;
+  memcpy(&(entry->params), params, sizeof(entry->params));
+  entry->wsa_size = wsa_size;
+
+  entry->content_count_bitpos = -1;
+  if ((wsa_size >= 2) &&
+      (dot3_ReadWsaBits(entry->wsa, DOT3_WSA_ID_BITPOS, DOT3_WSA_ID_BITS) == params->hdr.wsa_id) &&
+      (dot3_ReadWsaBits(entry->wsa, DOT3_WSA_CONTENT_COUNT_BITPOS, DOT3_WSA_CONTENT_COUNT_BITS) == params->hdr.content_count)) {
+    entry->content_count_bitpos = DOT3_WSA_CONTENT_COUNT_BITPOS;
+  }
+  entry->twod_location_bitpos = -1;
+  if (params->hdr.extensions.twod_location) {
+    len = dot3_MakeWsaLocationBits(params->hdr.twod_location.latitude, params->hdr.twod_location.longitude, NULL, bits);
+    entry->twod_location_bitpos = dot3_FindWsaBits(entry->wsa, wsa_size, bits, len);
+  }
+  entry->threed_location_bitpos = -1;
+  if (params->hdr.extensions.threed_location) {
+    len = dot3_MakeWsaLocationBits(params->hdr.threed_location.latitude, params->hdr.threed_location.longitude,
+                                   &(params->hdr.threed_location.elevation), bits);
+    entry->threed_location_bitpos = dot3_FindWsaBits(entry->wsa, wsa_size, bits, len);
+  }
+  entry->valid = true;
+}
+
+
+/**
+ * 캐시된 WSA 를 새 파라미터에 맞게 수정한다.
+ *  - content count 와 위치정보 값 외의 입력이 다르거나, 수정할 필드의 위치를 모르면 수정하지 않는다.
+ *
+ * @param entry     WSA 인코딩 캐시 엔트리
+ * @param params    @ref Dot3_ConstructWsa
+ * @return          캐시된 WSA 가 새 파라미터에 맞게 수정되었으면(또는 수정할 필요가 없으면) true
+ */
+static bool dot3_PatchCachedWsa(struct Dot3WsaCacheEntry *const entry, const struct Dot3ConstructWsaParams *const params)
+{
+  const struct Dot3WsaHdr *const hdr = &(params->hdr);
+  struct Dot3WsaHdr *const cached = &(entry->params.hdr);
+  uint8_t twod_bits[16], threed_bits[16];
+  unsigned int twod_len = 0, threed_len = 0;
+
+  if (!dot3_IsSameWsaContents(&(entry->params), params)) {
+    return false;
+  }
+
+  /*
+   * 수정할 필드들을 먼저 확인한다. (하나라도 수정할 수 없으면 캐시된 WSA 를 변경하지 않는다)
+   */
+  bool count_changed = (hdr->content_count != cached->content_count);
+  if (count_changed && (entry->content_count_bitpos < 0)) {
+    return false;
+  }
+  if (hdr->extensions.twod_location &&
+      ((hdr->twod_location.latitude != cached->twod_location.latitude) ||
+       (hdr->twod_location.longitude != cached->twod_location.longitude))) {
+    twod_len = dot3_MakeWsaLocationBits(hdr->twod_location.latitude, hdr->twod_location.longitude, NULL, twod_bits);
+    if ((entry->twod_location_bitpos < 0) || !twod_len) {
+      return false;
+    }
+  }
+  if (hdr->extensions.threed_location &&
+      ((hdr->threed_location.latitude != cached->threed_location.latitude) ||
+       (hdr->threed_location.longitude != cached->threed_location.longitude) ||
+       (hdr->threed_location.elevation != cached->threed_location.elevation))) {
+    threed_len = dot3_MakeWsaLocationBits(hdr->threed_location.latitude, hdr->threed_location.longitude,
+                                          &(hdr->threed_location.elevation), threed_bits);
+    if ((entry->threed_location_bitpos < 0) || !threed_len) {
+      return false;
+    }
+  }
+
+  /*
+   * 변경된 필드의 비트만 수정한다.
+   */
+  if (count_changed) {
+    dot3_WriteWsaBits(entry->wsa, (unsigned int)entry->content_count_bitpos, hdr->content_count, DOT3_WSA_CONTENT_COUNT_BITS);
+    cached->content_count = hdr->content_count;
+  }
+  for (unsigned int i = 0; i < twod_len; i++) {
+    dot3_WriteWsaBits(entry->wsa, (unsigned int)entry->twod_location_bitpos + i, dot3_ReadWsaBits(twod_bits, i, 1), 1);
+  }
+  if (twod_len) {
+    cached->twod_location = hdr->twod_location;
+  }
+  for (unsigned int i = 0; i < threed_len; i++) {
+    dot3_WriteWsaBits(entry->wsa, (unsigned int)entry->threed_location_bitpos + i, dot3_ReadWsaBits(threed_bits, i, 1), 1);
+  }
+  if (threed_len) {
+    cached->threed_location = hdr->threed_location;
+  }
+  return true;
+}
+
+
 /**
  * @copydoc Dot3_ConstructWsa
  */
@@ -26,7 +308,59 @@ int INTERNAL dot3_ConstructWsa(
   return dot3_ObjAsn1c_EncodeWsa(pinfo, params, outbuf, outbuf_size);
   #error "WSA encoding function using ObjAsn1c is not implemented yet"
 #elif defined(FFASN1C_)
-  return dot3_FFAsn1c_EncodeWsa(pinfo, params, outbuf, outbuf_size);
+  struct Dot3CodecCtx *ctx = dot3_GetCodecCtx();
+  struct Dot3WsaCacheEntry tmp, *entry;
+  int ret;
+
+  /*
+   * 코덱 컨텍스트를 할당하지 못하면 캐시 없이 인코딩한다.
+   */
+  if (ctx) {
+    entry = &(ctx->wsa_cache[params->hdr.wsa_id]);
+  } else {
+    entry = &tmp;
+    entry->valid = false;
+  }
+
+  /*
+   * PSR 테이블 스냅샷을 참조하므로, 동시에 수행되는 PSR 추가/삭제를 기다리게 하지 않는다.
+   */
+  const struct Dot3PsrSnapshot *snapshot = dot3_AcquirePsrSnapshot(pinfo);
+  uint32_t psr_gen = snapshot ? snapshot->gen : 0;
+
+  /*
+   * PSR 테이블과 파라미터가 마지막 인코딩 때와 같으면 캐시된 WSA 를 (필요 시 수정하여) 사용한다.
+   * 그렇지 않으면 다시 인코딩하여 캐시한다.
+   */
+  if (entry->valid && (entry->psr_gen == psr_gen) && dot3_PatchCachedWsa(entry, params)) {
+    Log(kDot3LogLevel_event, "Use cached %u-bytes WSA (psr gen: %u)\n", entry->wsa_size, psr_gen);
+    ctx->stats.wsa_cache_hit_cnt++;  // 캐시 엔트리는 코덱 컨텍스트가 있을 때만 유효하다.
+  }
+  else {
+    entry->valid = false;
+    dot3_FFAsn1c_BeginArena();
+    ret = dot3_FFAsn1c_EncodeWsa(pinfo, snapshot, params, entry->wsa, sizeof(entry->wsa));
+    dot3_FFAsn1c_EndArena();
+    if (ret < 0) {
+      dot3_ReleasePsrSnapshot(pinfo);
+      return ret;
+    }
+    dot3_FillWsaCacheEntry(entry, psr_gen, params, (Dot3PduSize)ret);
+    if (ctx) {
+      ctx->stats.wsa_encode_cnt++;
+    }
+  }
+  dot3_ReleasePsrSnapshot(pinfo);
+
+  /*
+   * 인코딩 데이터 반환
+   */
+  if (entry->wsa_size > outbuf_size) {
+    Err("Fail to construct WSA - Insufficient buffer size than encoded: %d < %d\n", outbuf_size, entry->wsa_size);
+    return -kDot3Result_Fail_InsufficientBuf;
+  }
+  memcpy(outbuf, entry->wsa, entry->wsa_size);
+  return (int)(entry->wsa_size);
 #else
   #error "3rd party asn.1 library is not defined"
 #endif
@@ -44,7 +378,14 @@ int INTERNAL dot3_ParseWsa(
   return dot3_ObjAsn1c_DecodeWsa(inbuf, inbuf_size, params);
   #error "WSA decoding function using ObjAsn1c is not implemented yet"
 #elif defined(FFASN1C_)
-  return dot3_FFAsn1c_DecodeWsa(encoded_wsa, encoded_wsa_size, params);
+  dot3_FFAsn1c_BeginArena();
+  int ret = dot3_FFAsn1c_DecodeWsa(encoded_wsa, encoded_wsa_size, params);
+  dot3_FFAsn1c_EndArena();
+  struct Dot3CodecCtx *ctx = dot3_GetCodecCtx();
+  if (ctx) {
+    ctx->stats.wsa_decode_cnt++;
+  }
+  return ret;
 #else
   #error "3rd party asn.1 library is not defined"
 #endif
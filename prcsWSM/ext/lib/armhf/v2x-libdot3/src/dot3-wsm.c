@@ -2,6 +2,8 @@
 // Created by gyun on 2019-06-27.
 //
 
+#include <string.h>
+
 #include "dot3-internal.h"
 #if defined(OBJASN1C_)
   #include "dot3-objasn1c.h"
@@ -24,7 +26,8 @@
  *                      payload_size 인자보다 최소 4~18바이트(=모든 옵션필드 비활성화/활성화시 WSM 헤더 길이) 이상 커야 한다.
  * @return              성공시 생성된 WSM의 길이, 실패시 음수(-Dot3ResultCode)
  *
- * UPER 인코딩된 WSM을 생성한다. 빌드 옵션(CMakeLists.txt 참조)에 따라 ASN.1 컴파일러/라이브러리가 다르게 적용된다.
+ * UPER 인코딩된 WSM을 생성한다. 빌드 옵션(CMakeLists.txt 참조)에 따라 자체 코덱(dot3-wsmp.c) 또는
+ * ASN.1 컴파일러/라이브러리가 적용된다.
  */
 int dot3_ConstructWsm(
   struct Dot3WsmMpduTxParams *const params,
@@ -33,10 +36,15 @@ int dot3_ConstructWsm(
   uint8_t *const outbuf,
   const Dot3PduSize outbuf_size)
 {
-#if defined(OBJASN1C_)
+#if defined(_NATIVE_WSMP_CODEC_)
+  return dot3_EncodeWsmp(params, payload, payload_size, outbuf, outbuf_size);
+#elif defined(OBJASN1C_)
   return dot3_ObjAsn1c_EncodeWsm(params, payload, payload_size, outbuf, outbuf_size);
 #elif defined(FFASN1C_)
-  return dot3_FFAsn1c_EncodeWsm(params, payload, payload_size, outbuf, outbuf_size);
+  dot3_FFAsn1c_BeginArena();
+  int ret = dot3_FFAsn1c_EncodeWsm(params, payload, payload_size, outbuf, outbuf_size);
+  dot3_FFAsn1c_EndArena();
+  return ret;
 #else
   #error "3rd party asn.1 library is not defined"
 #endif
@@ -58,11 +66,26 @@ int dot3_ParseWsm(
   const Dot3PduSize outbuf_size,
   struct Dot3WsmMpduRxParams *const params)
 {
-#if defined(OBJASN1C_)
+#if defined(_NATIVE_WSMP_CODEC_)
+  Dot3PduSize body_offset;
+  int payload_size = dot3_DecodeWsmpHdr(msdu, msdu_size, params, &body_offset);
+  if (payload_size <= 0) {
+    return payload_size;
+  }
+  if (payload_size > outbuf_size) {
+    Err("Fail to parse WSM - insufficient buffer for payload %d > %u\n", payload_size, outbuf_size);
+    return -kDot3Result_Fail_InsufficientBuf;
+  }
+  memcpy(outbuf, msdu + body_offset, payload_size);
+  return payload_size;
+#elif defined(OBJASN1C_)
   //return dot3_ObjAsn1c_DecodeWsm(msdu, msdu_size, outbuf, outbuf_size, params);
 #error "WSM decoding function using ObjAsn1c is not implemented yet"
 #elif defined(FFASN1C_)
-  return dot3_FFAsn1c_DecodeWsm(msdu, msdu_size, outbuf, outbuf_size, params);
+  dot3_FFAsn1c_BeginArena();
+  int ret = dot3_FFAsn1c_DecodeWsm(msdu, msdu_size, outbuf, outbuf_size, params);
+  dot3_FFAsn1c_EndArena();
+  return ret;
 #else
 #error "3rd party asn.1 library is not defined"
 #endif
@@ -0,0 +1,442 @@
+/**
+ * @file dot3-wsmp.c
+ * @date 2026-10-19
+ * @author gyun
+ * @brief WSMP 헤더 자체 UPER 코덱 구현 파일
+ *
+ * WSMP-N-Header, WSMP-T-Header(p-encoded PSID), WSM Length 필드를 ASN.1 라이브러리 없이 직접 인코딩/디코딩한다.
+ * 헤더는 최대 18바이트이고 모든 필드가 옥텟 경계에 정렬되므로(1609.3 Annex), 범용 ASN.1 런타임을 거치지 않고
+ * 바이트 단위로 처리한다. 인코딩/디코딩 결과는 ASN.1 라이브러리(ffasn1c)를 사용하는 경우와 비트 단위로 동일하다.
+ *  - 디코딩 시 메모리 할당이나 WSM body 복사가 없으며, WSM body 는 msdu 내 오프셋/길이로 반환된다.
+ *  - 빌드 옵션 WSMP_CODEC(CMakeLists.txt 참조)이 native 인 경우 dot3_ConstructWsm(), dot3_ParseWsm() 에서 사용되며,
+ *    Dot3_ParseWsmMpduView(), Dot3_ConstructWsmMpduV(), Dot3_ConstructWsmMpduInPlace() API 는 빌드 옵션과 관계없이 항상 사용한다.
+ *
+ * 인코딩 형식 (옥텟 단위)
+ *  - [subtype(4b)|nExtensions 존재(1b)|version(3b)]
+ *  - nExtensions 존재 시 : [개수] + 개수 x [ExtensionId][길이=1][값]
+ *  - [TPID(7b)|tExtensions 존재(1b)]
+ *  - tExtensions 존재 시 : [개수] + 개수 x [ExtensionId][길이][값]
+ *  - PSID : 1~4 바이트 p-encoded 값
+ *  - WSM Length : 1바이트(127 이하) 또는 2바이트([10|상위 6비트][하위 8비트])
+ */
+
+
+#include <string.h>
+
+#include "dot3-internal.h"
+
+
+#define DOT3_WSMP_VERSION (3) ///< WSMP version = 3
+#define DOT3_WSMP_SUBTYPE_NULL_NETWORKING (0) ///< subtype = nullNetworking
+#define DOT3_WSMP_TPID_BC_MODE (0) ///< TPID = bcMode
+#define DOT3_WSMP_N_EXT_MAX_NUM (3) ///< WSMP-N-Header 에 수납될 수 있는 확장필드의 최대 개수
+
+// WSMP-N-Header 확장필드 식별자
+#define DOT3_WSMP_EXT_ID_TX_POWER_USED (4)
+#define DOT3_WSMP_EXT_ID_CHANNEL_NUMBER (15)
+#define DOT3_WSMP_EXT_ID_DATARATE (16)
+
+// p-encoded PSID 길이 별 최소값
+#define DOT3_PSID_2BYTE_MIN (128U)
+#define DOT3_PSID_3BYTE_MIN (16512U)
+#define DOT3_PSID_4BYTE_MIN (2113664U)
+
+
+/**
+ * @brief UPER 길이결정자(length determinant)를 디코딩한다.
+ * @param ptr       디코딩할 위치 (디코딩 후 다음 위치로 갱신된다)
+ * @param end       버퍼의 끝
+ * @return          성공시 디코딩된 길이, 실패시 음수(-Dot3ResultCode)
+ *
+ * 16383 보다 큰 길이(fragmentation)는 WSM 에 존재할 수 없으므로 지원하지 않는다.
+ */
+static inline int dot3_DecodeWsmpLength(const uint8_t **const ptr, const uint8_t *const end)
+{
+  const uint8_t *p = *ptr;
+  if (p >= end) {
+    return -kDot3Result_Fail_Asn1Decode;
+  }
+  if (!(p[0] & 0x80)) {
+    *ptr = p + 1;
+    return p[0];
+  }
+  if (((p[0] & 0xC0) != 0x80) || (p + 2 > end)) {
+    return -kDot3Result_Fail_Asn1Decode;
+  }
+  *ptr = p + 2;
+  return ((p[0] & 0x3F) << 8) | p[1];
+}
+
+
+/**
+ * @brief p-encoded PSID 를 디코딩한다.
+ * @param ptr       디코딩할 위치 (디코딩 후 다음 위치로 갱신된다)
+ * @param end       버퍼의 끝
+ * @param psid      디코딩된 PSID 가 저장될 변수의 주소
+ * @return          성공시 0(kDot3Result_Success), 실패시 음수(-Dot3ResultCode)
+ */
+static inline int dot3_DecodeWsmpPsid(const uint8_t **const ptr, const uint8_t *const end, Dot3Psid *const psid)
+{
+  const uint8_t *p = *ptr;
+  if (p >= end) {
+    return -kDot3Result_Fail_Asn1Decode;
+  }
+  if (!(p[0] & 0x80)) {
+    *psid = p[0];
+    *ptr = p + 1;
+  } else if ((p[0] & 0xC0) == 0x80) {
+    if (p + 2 > end) {
+      return -kDot3Result_Fail_Asn1Decode;
+    }
+    *psid = ((((uint32_t)p[0] & 0x3F) << 8) | p[1]) + DOT3_PSID_2BYTE_MIN;
+    *ptr = p + 2;
+  } else if ((p[0] & 0xE0) == 0xC0) {
+    if (p + 3 > end) {
+      return -kDot3Result_Fail_Asn1Decode;
+    }
+    *psid = ((((uint32_t)p[0] & 0x1F) << 16) | ((uint32_t)p[1] << 8) | p[2]) + DOT3_PSID_3BYTE_MIN;
+    *ptr = p + 3;
+  } else if ((p[0] & 0xF0) == 0xE0) {
+    if (p + 4 > end) {
+      return -kDot3Result_Fail_Asn1Decode;
+    }
+    *psid = ((((uint32_t)p[0] & 0x0F) << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]) +
+            DOT3_PSID_4BYTE_MIN;
+    *ptr = p + 4;
+  } else {
+    // Ext3 의 확장값(4바이트 p-encoded 범위 밖의 값)
+    Err("Fail to decode PSID - too large psid (0x%02X)\n", p[0]);
+    return -kDot3Result_Fail_InvalidPsidValue;
+  }
+  return kDot3Result_Success;
+}
+
+
+/**
+ * @brief WSMP 헤더를 디코딩하여 수신파라미터정보에 저장하고, WSM body 의 위치와 길이를 반환한다.
+ * @param msdu          디코딩할 MSDU(=WSM)가 저장된 버퍼의 주소. NULL 은 사용할 수 없다.
+ * @param msdu_size     msdu 의 길이
+ * @param params        헤더 정보(version, tx_chan_num, tx_datarate, tx_power, psid)가 저장될 수신파라미터정보 구조체의 주소
+ * @param body_offset   msdu 내 WSM body 의 시작 위치가 저장될 변수의 주소
+ * @return              성공시 WSM body 의 길이, 실패시 음수(-Dot3ResultCode)
+ *
+ * WSM body 는 복사되지 않는다. 호출자는 msdu + *body_offset 위치에서 WSM body 에 직접 접근할 수 있다.
+ * 에러코드는 ffasn1c 기반 디코딩(dot3_FFAsn1c_DecodeWsm())과 동일하다.
+ */
+int INTERNAL dot3_DecodeWsmpHdr(
+  const uint8_t *const msdu,
+  const Dot3PduSize msdu_size,
+  struct Dot3WsmMpduRxParams *const params,
+  Dot3PduSize *const body_offset)
+{
+  const uint8_t *p = msdu, *end = msdu + msdu_size;
+  int ret, len;
+
+  if (msdu_size < kWsmpHdrMinSize) {
+    Err("Fail to decode WSMP header - too short msdu %u\n", msdu_size);
+    return -kDot3Result_Fail_Asn1Decode;
+  }
+
+  /*
+   * WSMP-N-Header - subtype, version
+   */
+  if ((p[0] >> 4) != DOT3_WSMP_SUBTYPE_NULL_NETWORKING) {
+    Err("Fail to decode WSMP-N-Header - invalid subtype %d\n", p[0] >> 4);
+    return -kDot3Result_Fail_InvalidWsmpNHeaderSubType;
+  }
+  if ((p[0] & 0x07) != DOT3_WSMP_VERSION) {
+    Err("Fail to decode WSMP-N-Header - invalid WSMP version %u\n", p[0] & 0x07);
+    return -kDot3Result_Fail_InvalidWsmpNHeaderWsmpVersion;
+  }
+  params->version = DOT3_WSMP_VERSION;
+  bool n_ext = (p[0] & 0x08) ? true : false;
+  p++;
+
+  /*
+   * WSMP-N-Header - 확장필드 (ChannelNumber, DataRate, TransmitPowerUsed)
+   *  - 확장필드가 없는 경우, Unknown 값으로 설정된다.
+   */
+  params->tx_chan_num = kDot3Channel_Unknown;
+  params->tx_datarate = kDot3DataRate_Unknown;
+  params->tx_power = kDot3Power_Unknown;
+  if (n_ext) {
+    int ext_cnt = dot3_DecodeWsmpLength(&p, end);
+    if (ext_cnt < 0) {
+      Err("Fail to decode WSMP-N-Header - invalid extension count\n");
+      return ext_cnt;
+    }
+    if (ext_cnt > DOT3_WSMP_N_EXT_MAX_NUM) {
+      Err("Fail to decode WSMP-N-Header - too many ext field - %d\n", ext_cnt);
+      return -kDot3Result_Fail_Asn1AbnormalOp;
+    }
+    for (int i = 0; i < ext_cnt; i++) {
+      if (p + 1 > end) {
+        return -kDot3Result_Fail_Asn1Decode;
+      }
+      uint8_t ext_id = *p++;
+      len = dot3_DecodeWsmpLength(&p, end);
+      if ((len < 0) || (p + len > end)) {
+        Err("Fail to decode WSMP-N-Header - invalid extension %u length\n", ext_id);
+        return -kDot3Result_Fail_Asn1Decode;
+      }
+      switch (ext_id) {
+        case DOT3_WSMP_EXT_ID_CHANNEL_NUMBER:
+        case DOT3_WSMP_EXT_ID_DATARATE:
+        case DOT3_WSMP_EXT_ID_TX_POWER_USED: {
+          // 값은 1바이트이며, ffasn1c 와 동일하게 open type 내 나머지 바이트는 무시한다.
+          if (len < 1) {
+            Err("Fail to decode WSMP-N-Header - invalid extension %u length %d\n", ext_id, len);
+            return -kDot3Result_Fail_Asn1Decode;
+          }
+          if (ext_id == DOT3_WSMP_EXT_ID_CHANNEL_NUMBER) {
+            params->tx_chan_num = p[0];
+          } else if (ext_id == DOT3_WSMP_EXT_ID_DATARATE) {
+            params->tx_datarate = p[0];
+          } else {
+            params->tx_power = (int)p[0] + kDot3Power_Min;
+          }
+          break;
+        }
+        default: {
+          Err("Fail to decode WSMP-N-Header - invalid extension id %u\n", ext_id);
+          return -kDot3Result_Fail_InvalidWsmpNHeaderExtensionId;
+        }
+      }
+      p += len;
+    }
+  }
+
+  /*
+   * WSMP-N-Header - TPID
+   */
+  if (p >= end) {
+    return -kDot3Result_Fail_Asn1Decode;
+  }
+  if ((p[0] >> 1) != DOT3_WSMP_TPID_BC_MODE) {
+    Err("Fail to decode WSMP-N-Header - invalid TPID %d\n", p[0] >> 1);
+    return -kDot3Result_Fail_InvalidWsmpNHeaderTpid;
+  }
+  bool t_ext = (p[0] & 0x01) ? true : false;
+  p++;
+
+  /*
+   * WSMP-T-Header - PSID, 확장필드(현재 정의된 확장필드가 없으므로 건너뛴다)
+   */
+  ret = dot3_DecodeWsmpPsid(&p, end, &params->psid);
+  if (ret < 0) {
+    Err("Fail to decode WSMP-T-Header - invalid PSID\n");
+    return ret;
+  }
+  if (t_ext) {
+    int ext_cnt = dot3_DecodeWsmpLength(&p, end);
+    if (ext_cnt < 0) {
+      return ext_cnt;
+    }
+    for (int i = 0; i < ext_cnt; i++) {
+      if (p + 1 > end) {
+        return -kDot3Result_Fail_Asn1Decode;
+      }
+      p++;
+      len = dot3_DecodeWsmpLength(&p, end);
+      if ((len < 0) || (p + len > end)) {
+        return -kDot3Result_Fail_Asn1Decode;
+      }
+      p += len;
+    }
+  }
+
+  /*
+   * WSM Length, WSM body
+   */
+  len = dot3_DecodeWsmpLength(&p, end);
+  if ((len < 0) || (p + len > end)) {
+    Err("Fail to decode WSMP-T-Header - invalid WSM length\n");
+    return -kDot3Result_Fail_Asn1Decode;
+  }
+  if (len > kWsmBodyMaxSize) {
+    Err("Fail to decode WSMP-T-Header - too long payload %d > %d(kWsmBodyMaxSize)\n", len, kWsmBodyMaxSize);
+    return -kDot3Result_Fail_TooLongPayload;
+  }
+  *body_offset = (Dot3PduSize)(p - msdu);
+
+  Log(kDot3LogLevel_event, "Success to decode WSMP header - psid: %u, body: %d bytes at %u\n",
+      params->psid, len, *body_offset);
+  return len;
+}
+
+
+/**
+ * @brief 전달된 송신파라미터들과 WSM body 길이에 따른 WSMP 헤더의 길이를 계산한다.
+ * @param params        @ref dot3_ConstructWsm
+ * @param body_size     WSM body 의 길이
+ * @return              성공시 WSMP 헤더의 길이(kWsmpHdrMinSize ~ kWsmpHdrMaxSize), 실패시 음수(-Dot3ResultCode)
+ *
+ * 헤더를 실제로 인코딩하기 전에 헤더 길이를 알아야 하는 경우(예: 페이로드 앞 여유공간에 헤더를 채우는 경우)에 사용된다.
+ */
+int INTERNAL dot3_GetWsmpHdrSize(const struct Dot3WsmMpduTxParams *const params, const Dot3PduSize body_size)
+{
+  /*
+   * 각 필드 값 범위 확인 및 헤더 길이 계산
+   */
+  uint32_t psid = params->psid, psid_len;
+  if (psid < DOT3_PSID_2BYTE_MIN) {
+    psid_len = 1;
+  } else if (psid < DOT3_PSID_3BYTE_MIN) {
+    psid_len = 2;
+  } else if (psid < DOT3_PSID_4BYTE_MIN) {
+    psid_len = 3;
+  } else if (psid <= kDot3Psid_Max) {
+    psid_len = 4;
+  } else {
+    Err("Fail to encode WSM - invalid Psid %u\n", psid);
+    return -kDot3Result_Fail_InvalidPsidValue;
+  }
+  uint32_t ext_cnt = 0;
+  if (params->hdr_extensions.chan_num) {
+    if ((params->chan_num < 0) || (params->chan_num > 255)) {
+      Err("Fail to encode WSM - invalid ChannelNumber %d\n", params->chan_num);
+      return -kDot3Result_Fail_Asn1Encode;
+    }
+    ext_cnt++;
+  }
+  if (params->hdr_extensions.datarate) {
+    if ((params->datarate < 0) || (params->datarate > 255)) {
+      Err("Fail to encode WSM - invalid DataRate %d\n", params->datarate);
+      return -kDot3Result_Fail_Asn1Encode;
+    }
+    ext_cnt++;
+  }
+  if (params->hdr_extensions.transmit_power) {
+    if ((params->transmit_power < kDot3Power_Min) || (params->transmit_power > kDot3Power_Max)) {
+      Err("Fail to encode WSM - invalid TransmitPowerUsed %d\n", params->transmit_power);
+      return -kDot3Result_Fail_Asn1Encode;
+    }
+    ext_cnt++;
+  }
+  uint32_t hdr_size = 1 + (ext_cnt ? (1 + (3 * ext_cnt)) : 0) + 1 + psid_len + ((body_size < 128) ? 1 : 2);
+  uint32_t wsm_size = hdr_size + body_size;
+  if (wsm_size > kWsmMaxSize) {
+    Err("Fail to encode WSM - Too long encoded WSM: %u\n", wsm_size);
+    return -kDot3Result_Fail_TooLongWsm;
+  }
+  return (int)hdr_size;
+}
+
+
+/**
+ * @brief 전달된 송신파라미터들과 WSM body 길이를 이용하여 WSMP 헤더만 인코딩한다.
+ * @param params        @ref dot3_ConstructWsm
+ * @param body_size     WSM body 의 길이
+ * @param outbuf        WSMP 헤더가 저장될 버퍼 포인터. dot3_GetWsmpHdrSize() 가 반환한 길이 이상의 공간이 있어야 한다.
+ *
+ * dot3_GetWsmpHdrSize() 로 유효성이 확인된 송신파라미터에 대해서만 호출되어야 한다.
+ * 확장필드는 ffasn1c 기반 인코딩(dot3_FFAsn1c_EncodeWsm())과 동일하게 채널번호, 데이터레이트, 전송파워 순서대로 추가된다.
+ */
+void INTERNAL dot3_EncodeWsmpHdr(
+  const struct Dot3WsmMpduTxParams *const params,
+  const Dot3PduSize body_size,
+  uint8_t *const outbuf)
+{
+  bool ext = params->hdr_extensions.chan_num || params->hdr_extensions.datarate ||
+             params->hdr_extensions.transmit_power;
+
+  /*
+   * WSMP-N-Header
+   */
+  uint8_t *p = outbuf;
+  *p++ = (DOT3_WSMP_SUBTYPE_NULL_NETWORKING << 4) | (ext ? 0x08 : 0x00) | DOT3_WSMP_VERSION;
+  if (ext) {
+    uint8_t *ext_cnt = p++;
+    *ext_cnt = 0;
+    if (params->hdr_extensions.chan_num) {
+      *p++ = DOT3_WSMP_EXT_ID_CHANNEL_NUMBER;
+      *p++ = 1;
+      *p++ = (uint8_t)params->chan_num;
+      (*ext_cnt)++;
+    }
+    if (params->hdr_extensions.datarate) {
+      *p++ = DOT3_WSMP_EXT_ID_DATARATE;
+      *p++ = 1;
+      *p++ = (uint8_t)params->datarate;
+      (*ext_cnt)++;
+    }
+    if (params->hdr_extensions.transmit_power) {
+      *p++ = DOT3_WSMP_EXT_ID_TX_POWER_USED;
+      *p++ = 1;
+      *p++ = (uint8_t)(params->transmit_power - kDot3Power_Min);
+      (*ext_cnt)++;
+    }
+  }
+  *p++ = (DOT3_WSMP_TPID_BC_MODE << 1); // 표준에 따르면, 아직까지는 T-헤더에 확장필드는 없다.
+
+  /*
+   * WSMP-T-Header - PSID, WSM Length
+   */
+  uint32_t psid = params->psid;
+  if (psid < DOT3_PSID_2BYTE_MIN) {
+    *p++ = (uint8_t)psid;
+  } else if (psid < DOT3_PSID_3BYTE_MIN) {
+    psid -= DOT3_PSID_2BYTE_MIN;
+    *p++ = (uint8_t)(0x80 | (psid >> 8));
+    *p++ = (uint8_t)psid;
+  } else if (psid < DOT3_PSID_4BYTE_MIN) {
+    psid -= DOT3_PSID_3BYTE_MIN;
+    *p++ = (uint8_t)(0xC0 | (psid >> 16));
+    *p++ = (uint8_t)(psid >> 8);
+    *p++ = (uint8_t)psid;
+  } else {
+    psid -= DOT3_PSID_4BYTE_MIN;
+    *p++ = (uint8_t)(0xE0 | (psid >> 24));
+    *p++ = (uint8_t)(psid >> 16);
+    *p++ = (uint8_t)(psid >> 8);
+    *p++ = (uint8_t)psid;
+  }
+  if (body_size < 128) {
+    *p = (uint8_t)body_size;
+  } else {
+    *p++ = (uint8_t)(0x80 | (body_size >> 8));
+    *p = (uint8_t)body_size;
+  }
+}
+
+
+/**
+ * @brief 전달된 송신파라미터들과 페이로드를 이용하여 UPER 인코딩된 WSM을 생성한다.
+ * @param params        @ref dot3_ConstructWsm
+ * @param payload       @ref dot3_ConstructWsm
+ * @param payload_size  @ref dot3_ConstructWsm
+ * @param outbuf        @ref dot3_ConstructWsm
+ * @param outbuf_size   @ref dot3_ConstructWsm
+ * @return              @ref dot3_ConstructWsm
+ */
+int INTERNAL dot3_EncodeWsmp(
+  struct Dot3WsmMpduTxParams *const params,
+  const uint8_t *const payload,
+  const Dot3PduSize payload_size,
+  uint8_t *const outbuf,
+  const Dot3PduSize outbuf_size)
+{
+  Dot3PduSize body_size = payload ? payload_size : 0;
+  Log(kDot3LogLevel_event, "Encoding WSM - psid: %u, WSM length: %u\n", params->psid, body_size);
+
+  int hdr_size = dot3_GetWsmpHdrSize(params, body_size);
+  if (hdr_size < 0) {
+    return hdr_size;
+  }
+  uint32_t wsm_size = (uint32_t)hdr_size + body_size;
+  if (wsm_size > outbuf_size) {
+    Err("Fail to encode WSM - Insufficient buffer size than encoded: %u < %u\n", outbuf_size, wsm_size);
+    return -kDot3Result_Fail_InsufficientBuf;
+  }
+
+  /*
+   * WSMP 헤더 및 WSM body
+   */
+  dot3_EncodeWsmpHdr(params, body_size, outbuf);
+  if (body_size) {
+    memcpy(outbuf + hdr_size, payload, body_size);
+  }
+
+  Log(kDot3LogLevel_event, "Success to encode %u-bytes WSM\n", wsm_size);
+  return (int)wsm_size;
+}
@@ -0,0 +1,239 @@
+/**
+ * @file dot3-wsr.c
+ * @date 2026-10-19
+ * @author gyun
+ * @brief WAVE Service Request 관련 기능 구현 파일
+ *
+ * WSR 테이블은 수신 경로에서 WSM 마다 조회된다. (수신된 WSM 의 PSID 가 등록되어 있는지 확인)
+ * 조회는 PSID 해시 인덱스를 seqlock 으로 읽으므로 뮤텍스를 사용하지 않으며, 등록/삭제를 기다리게 하지 않는다.
+ * 등록/삭제는 user 뮤텍스 락 상태에서 수행되며, 해시 인덱스를 변경하는 동안 seq 를 홀수로 유지한다.
+ */
+
+#include <string.h>
+
+#include "dot3-internal.h"
+#include "dot3-mib.h"
+
+
+_Static_assert(DOT3_WSR_HASH_SIZE > kDot3WsrNum_MaxNum, "DOT3_WSR_HASH_SIZE must be larger than kDot3WsrNum_MaxNum");
+_Static_assert((1U << (32 - DOT3_WSR_HASH_SHIFT)) == DOT3_WSR_HASH_SIZE, "DOT3_WSR_HASH_SHIFT mismatch");
+
+
+/**
+ * PSID 에 대한 해시 인덱스를 반환한다.
+ *
+ * @param psid      PSID
+ * @return          해시 인덱스 (0 ~ DOT3_WSR_HASH_SIZE-1)
+ */
+static inline unsigned int dot3_GetWsrHashIndex(const Dot3Psid psid)
+{
+  return ((uint32_t)psid * 0x9E3779B1U) >> DOT3_WSR_HASH_SHIFT;
+}
+
+
+/**
+ * 등록된 PSID 들로 WSR 해시 인덱스를 다시 생성한다.
+ * user 뮤텍스 락 상태에서 호출되어야 한다.
+ *
+ * @param uinfo     user info MIB
+ */
+static void dot3_RebuildWsrHash(struct Dot3UserInfo *const uinfo)
+{
+  /*
+   * 변경 시작 - seq 를 홀수로 만든다. (이 동안의 조회는 재시도된다)
+   */
+  unsigned int seq = uinfo->wsr_table.seq;
+  __atomic_store_n(&(uinfo->wsr_table.seq), seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  for (unsigned int i = 0; i < DOT3_WSR_HASH_SIZE; i++) {
+    __atomic_store_n(&(uinfo->wsr_table.hash[i]), DOT3_WSR_HASH_EMPTY, __ATOMIC_RELAXED);
+  }
+  for (Dot3WsrNum n = 0; n < uinfo->wsr_table.num; n++) {
+    unsigned int i = dot3_GetWsrHashIndex(uinfo->wsr_table.psids[n]);
+    while (uinfo->wsr_table.hash[i] != DOT3_WSR_HASH_EMPTY) {
+      i = (i + 1) & (DOT3_WSR_HASH_SIZE - 1);
+    }
+    __atomic_store_n(&(uinfo->wsr_table.hash[i]), uinfo->wsr_table.psids[n], __ATOMIC_RELAXED);
+  }
+
+  /*
+   * 변경 완료 - seq 를 다시 짝수로 만든다.
+   */
+  __atomic_store_n(&(uinfo->wsr_table.seq), seq + 2, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * WSR 테이블을 초기화한다.
+ *
+ * @param uinfo     user info MIB
+ */
+void INTERNAL dot3_InitWsrTable(struct Dot3UserInfo *const uinfo)
+{
+  uinfo->wsr_table.num = 0;
+  uinfo->wsr_table.seq = 0;
+  for (unsigned int i = 0; i < DOT3_WSR_HASH_SIZE; i++) {
+    uinfo->wsr_table.hash[i] = DOT3_WSR_HASH_EMPTY;
+  }
+}
+
+
+/**
+ * 특정 PSID가 WSR 테이블에 등록되어 있는지 확인한다.
+ * 뮤텍스를 사용하지 않으며, 수신 경로에서 WSM 마다 호출될 수 있다.
+ *
+ * @param uinfo     user info MIB
+ * @param psid      확인할 PSID
+ * @return          등록되어 있으면 true, 등록되어 있지 않으면 false
+ */
+bool INTERNAL dot3_IsWsrRegistered(const struct Dot3UserInfo *const uinfo, const Dot3Psid psid)
+{
+  unsigned int seq1, seq2;
+  bool found;
+  do {
+    seq1 = __atomic_load_n(&(uinfo->wsr_table.seq), __ATOMIC_ACQUIRE);
+    found = false;
+    if ((seq1 & 1) == 0) {
+      unsigned int i = dot3_GetWsrHashIndex(psid);
+      for (unsigned int n = 0; n < DOT3_WSR_HASH_SIZE; n++) {
+        Dot3Psid slot = __atomic_load_n(&(uinfo->wsr_table.hash[i]), __ATOMIC_RELAXED);
+        if (slot == psid) {
+          found = true;
+          break;
+        }
+        if (slot == DOT3_WSR_HASH_EMPTY) {
+          break;
+        }
+        i = (i + 1) & (DOT3_WSR_HASH_SIZE - 1);
+      }
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    seq2 = __atomic_load_n(&(uinfo->wsr_table.seq), __ATOMIC_RELAXED);
+  } while ((seq1 & 1) || (seq1 != seq2));
+  return found;
+}
+
+
+/**
+ * WSR을 테이블에 추가한다.
+ * user 뮤텍스 락 상태에서 호출되어야 한다.
+ *
+ * @param uinfo     user info MIB
+ * @param psid      @ref Dot3_AddWsr
+ * @return          성공 시 0, 실패 시 음수(-Dot3ResultCode)
+ */
+int INTERNAL dot3_AddWsr(struct Dot3UserInfo *const uinfo, const Dot3Psid psid)
+{
+  Log(kDot3LogLevel_config, "Adding WSR with psid: %u\n", psid);
+
+  /*
+   * 최대 개수 초과 확인
+   */
+  if (uinfo->wsr_table.num == kDot3WsrNum_MaxNum) {
+    Err("Fail to add WSR - table is full (%u)\n", uinfo->wsr_table.num);
+    return -kDot3Result_Fail_WsrTableFull;
+  }
+
+  /*
+   * 중복 WSR 여부 확인
+   */
+  if (dot3_IsWsrRegistered(uinfo, psid)) {
+    Err("Fail to add WSR - WSR with same psid %u exists in table\n", psid);
+    return -kDot3Result_Fail_SamePsidWsr;
+  }
+
+  /*
+   * WSR 추가 - 해시 인덱스의 빈 슬롯 하나만 채우면 되므로, 인덱스를 다시 생성하지 않는다.
+   */
+  uinfo->wsr_table.psids[(uinfo->wsr_table.num)++] = psid;
+  unsigned int seq = uinfo->wsr_table.seq;
+  __atomic_store_n(&(uinfo->wsr_table.seq), seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  unsigned int i = dot3_GetWsrHashIndex(psid);
+  while (uinfo->wsr_table.hash[i] != DOT3_WSR_HASH_EMPTY) {
+    i = (i + 1) & (DOT3_WSR_HASH_SIZE - 1);
+  }
+  __atomic_store_n(&(uinfo->wsr_table.hash[i]), psid, __ATOMIC_RELAXED);
+  __atomic_store_n(&(uinfo->wsr_table.seq), seq + 2, __ATOMIC_RELEASE);
+
+  Log(kDot3LogLevel_config, "Success to add WSR - %u entries present\n", uinfo->wsr_table.num);
+  return kDot3Result_Success;
+}
+
+
+/**
+ * WSR을 테이블에서 삭제한다.
+ * user 뮤텍스 락 상태에서 호출되어야 한다.
+ *
+ * @param uinfo     user info MIB
+ * @param psid      @ref Dot3_DeleteWsr
+ * @return          성공 시 0, 실패 시 음수(-Dot3ResultCode)
+ */
+int INTERNAL dot3_DeleteWsr(struct Dot3UserInfo *const uinfo, const Dot3Psid psid)
+{
+  Log(kDot3LogLevel_config, "Deleting WSR with psid %u\n", psid);
+
+  /*
+   * WSR 을 탐색하여 삭제한다. 못 찾으면 실패
+   *  - 선형 탐사 해시 인덱스에서는 슬롯을 비우는 것만으로 삭제할 수 없으므로, 인덱스를 다시 생성한다.
+   */
+  for (Dot3WsrNum n = 0; n < uinfo->wsr_table.num; n++) {
+    if (uinfo->wsr_table.psids[n] == psid) {
+      memmove(&(uinfo->wsr_table.psids[n]), &(uinfo->wsr_table.psids[n + 1]),
+              sizeof(Dot3Psid) * (uinfo->wsr_table.num - n - 1));
+      (uinfo->wsr_table.num)--;
+      dot3_RebuildWsrHash(uinfo);
+      Log(kDot3LogLevel_config, "Success to delete WSR - %u entries present\n", uinfo->wsr_table.num);
+      return kDot3Result_Success;
+    }
+  }
+  Err("Fail to delete WSR - no such WSR with psid %u\n", psid);
+  return -kDot3Result_Fail_NoSuchWsr;
+}
+
+
+/**
+ * 테이블 내 모든 WSR을 삭제한다.
+ * user 뮤텍스 락 상태에서 호출되어야 한다.
+ *
+ * @param uinfo     user info MIB
+ */
+void INTERNAL dot3_DeleteAllWsrs(struct Dot3UserInfo *const uinfo)
+{
+  Log(kDot3LogLevel_config, "Deleting all WSRs\n");
+  uinfo->wsr_table.num = 0;
+  dot3_RebuildWsrHash(uinfo);
+}
+
+
+/**
+ * 현재 테이블에 저장되어 있는 WSR의 개수를 반환한다.
+ *
+ * @param uinfo     user info MIB
+ * @return          WSR 의 개수
+ */
+int INTERNAL dot3_GetWsrNum(const struct Dot3UserInfo *const uinfo)
+{
+  int ret = (int)(uinfo->wsr_table.num);
+  Log(kDot3LogLevel_config, "Get the number of WSR - %d\n", ret);
+  return ret;
+}
+
+
+/**
+ * 테이블 내 모든 WSR의 정보를 등록된 순서대로 반환한다.
+ * user 뮤텍스 락 상태에서 호출되어야 한다.
+ *
+ * @param uinfo     user info MIB
+ * @param wsrs      @ref Dot3_GetAllWsrs
+ * @return          반환된 WSR 의 개수
+ */
+int INTERNAL dot3_GetAllWsrs(const struct Dot3UserInfo *const uinfo, struct Dot3Wsr *const wsrs)
+{
+  for (Dot3WsrNum n = 0; n < uinfo->wsr_table.num; n++) {
+    wsrs[n].psid = uinfo->wsr_table.psids[n];
+  }
+  Log(kDot3LogLevel_config, "Get all WSRs - there are %u entries\n", uinfo->wsr_table.num);
+  return (int)(uinfo->wsr_table.num);
+}
@@ -30,17 +30,32 @@ static int dot3_InitProviderInfo(struct Dot3ProviderInfo *const pinfo)
   /*
    * Channel info 테이블 초기화
    */
-  int ret = dot3_InitPciTable(pinfo);
-  if (ret < 0) {
-    dot3_FlushPciTable(pinfo);
-    return ret;
-  }
+  dot3_InitPciTable(pinfo);
 
   Log(kDot3LogLevel_init, "Success to initialize provider info\n");
   return kDot3Result_Success;
 }
 
 
+/**
+ * User info MIB 를 초기화한다.
+ *
+ * @param uinfo 초기화할 user info MIB
+ */
+static void dot3_InitUserInfo(struct Dot3UserInfo *const uinfo)
+{
+  Log(kDot3LogLevel_init, "Initializing user info\n");
+  pthread_mutex_init(&(uinfo->mtx), NULL);
+
+  /*
+   * WSR 테이블 초기화
+   */
+  dot3_InitWsrTable(uinfo);
+
+  Log(kDot3LogLevel_init, "Success to initialize user info\n");
+}
+
+
 /**
  * dot3 라이브러리 내부를 초기화한다.
  *
@@ -49,6 +64,7 @@ static int dot3_InitProviderInfo(struct Dot3ProviderInfo *const pinfo)
 int INTERNAL dot3_InitDot3(void)
 {
   Log(kDot3LogLevel_init, "Initializing dot3\n");
+  uint32_t epoch = g_dot3_mib.epoch + 1;
   memset(&g_dot3_mib, 0, sizeof(g_dot3_mib));
 
   /*
@@ -59,6 +75,16 @@ int INTERNAL dot3_InitDot3(void)
     return ret;
   }
 
+  /*
+   * User 정보 초기화
+   */
+  dot3_InitUserInfo(&g_dot3_mib.user_info);
+
+  /*
+   * 쓰레드 별 WSA 인코딩 캐시는 다음 사용 시 초기화 세대를 비교하여 무효화된다.
+   */
+  __atomic_store_n(&(g_dot3_mib.epoch), epoch, __ATOMIC_RELEASE);
+
   Log(kDot3LogLevel_init, "Success to initialize dot3\n");
   return kDot3Result_Success;
 }
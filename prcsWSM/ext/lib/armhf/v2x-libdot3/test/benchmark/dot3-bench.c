@@ -0,0 +1,560 @@
+/**
+ * @file dot3-bench.c
+ * @date 2026-10-19
+ * @author gyun
+ * @brief libdot3 API 처리성능 측정 프로그램
+ *
+ * WSM MPDU 생성/파싱, WSA 생성/파싱, PSR 관리 API 의 1회 당 처리성능을 측정한다.
+ *  - 각 측정항목은 배치 반복횟수를 두 배씩 늘려가며, 배치 수행시간이 최소 측정시간(-t) 이상이 된 배치의 결과를 사용한다.
+ *  - 힙 할당 횟수는 glibc 의 malloc(), calloc(), realloc() 을 가로채어 센다. (glibc 가 아니면 측정하지 않는다)
+ *  - asn.1 아레나 할당 횟수는 ffasn1c 를 사용하고 내부함수가 노출된 빌드(BUILD_UNIT_TEST_INTERNAL_FUNC)에서만 측정한다.
+ *  - 바이트 수는 API 가 호출자의 버퍼에 복사한 PDU/페이로드의 길이이다.
+ *    Dot3_ParseWsa() 는 디코딩한 WSA 의 길이, Dot3_GetPsrWithPsid() 는 반환된 PSR 정보 구조체의 크기이다.
+ *    (WSM 수신파라미터정보 구조체는 제외)
+ * 결과는 표 형식(기본) 또는 측정항목 당 한 줄의 JSON(-j)으로 출력된다. JSON 출력은 커밋 별 성능 추이 기록에 사용한다.
+ *
+ * 측정 데이터는 단위테스트와 동일한 형태로 생성한다.
+ *  - WSM : 모든 WSMP 확장헤더 포함, 페이로드 32(small)/300(typical)/kWsmBodySafeMaxSize(max) 바이트
+ *  - WSA : 모든 헤더 확장필드와 WRA 포함, 모든 확장필드를 포함한 Service info 1/8/31 개
+ */
+
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/utsname.h>
+
+#include "dot3/dot3.h"
+
+#if defined(FFASN1C_) && defined(_EXPORT_INTERNAL_FUNC_)
+#define BENCH_ARENA_STATS
+#include "dot3-ffasn1c.h"
+#endif
+
+
+/// 할당 횟수 및 바이트 수 측정 시 반복횟수
+#define BENCH_ACCOUNT_ITERS 100
+/// 측정 전 반복횟수
+#define BENCH_WARMUP_ITERS 100
+/// 배치 최대 반복횟수
+#define BENCH_MAX_ITERS (1U << 26)
+
+
+/**
+ * 측정항목
+ */
+struct BenchCase
+{
+  const char *name;                     ///< 측정항목 이름
+  const char *variant;                  ///< 측정 데이터 이름
+  unsigned int param;                   ///< 페이로드 길이, Service info 개수 또는 PSR 개수
+  int (*prepare)(unsigned int param);   ///< 측정 데이터 준비 함수 (성공 시 0)
+  int (*op)(void);                      ///< 측정 대상 함수 (성공 시 복사한 바이트 수, 실패 시 음수)
+};
+
+/**
+ * 측정결과
+ */
+struct BenchResult
+{
+  uint64_t iters;               ///< 측정 배치의 반복횟수
+  double ns_per_op;             ///< 1회 당 수행시간 (나노초)
+  double heap_allocs_per_op;    ///< 1회 당 힙 할당 횟수 (측정하지 않으면 음수)
+  double arena_allocs_per_op;   ///< 1회 당 asn.1 아레나 할당 횟수 (측정하지 않으면 음수)
+  double bytes_per_op;          ///< 1회 당 복사한 바이트 수
+};
+
+/**
+ * 측정 설정
+ */
+struct BenchConfig
+{
+  uint64_t min_ns;              ///< 배치 최소 수행시간 (나노초)
+  bool json;                    ///< JSON 출력 여부
+  const char *label;            ///< JSON 출력에 포함될 라벨 (예: 커밋 해시)
+  const char *filter;           ///< 측정항목 이름 필터 (포함된 항목만 측정)
+};
+
+static struct BenchConfig g_bench;
+
+static uint8_t g_payload[kMpduMaxSize];
+static uint8_t g_mpdu[kMpduMaxSize];
+static uint8_t g_outbuf[kMpduMaxSize];
+static Dot3PduSize g_payload_size;
+static int g_mpdu_size;
+static struct Dot3WsmMpduTxParams g_wsm_params;
+static struct Dot3ConstructWsaParams g_wsa_params;
+static struct Dot3ParseWsaParams g_parsed_wsa;
+static uint8_t g_wsa[kMpduMaxSize];
+static int g_wsa_size;
+static Dot3PsrNum g_psr_num;
+
+static const uint8_t g_test_ipv6_address[IPV6_ALEN] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t g_test_mac_address[MAC_ALEN] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 };
+
+
+#if defined(__GLIBC__)
+/*
+ * 힙 할당 횟수 측정을 위해 glibc 의 할당 함수들을 가로챈다.
+ */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static uint64_t g_heap_alloc_cnt; ///< 힙 할당 횟수
+
+void *malloc(size_t size)
+{
+  __atomic_fetch_add(&g_heap_alloc_cnt, 1, __ATOMIC_RELAXED);
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+  __atomic_fetch_add(&g_heap_alloc_cnt, 1, __ATOMIC_RELAXED);
+  return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+  __atomic_fetch_add(&g_heap_alloc_cnt, 1, __ATOMIC_RELAXED);
+  return __libc_realloc(ptr, size);
+}
+#endif
+
+
+/**
+ * 현재 시각을 반환한다.
+ *
+ * @return  CLOCK_MONOTONIC 시각 (나노초)
+ */
+static uint64_t Bench_GetTimeNs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * WSM 측정 데이터를 준비한다.
+ *  - 모든 WSMP 확장헤더를 포함한 WSM MPDU 를 생성하고, PSID 를 WSR 로 등록한다.
+ *
+ * @param param     페이로드 길이
+ * @return          성공 시 0, 실패 시 -1
+ */
+static int Bench_PrepareWsm(unsigned int param)
+{
+  Dot3_Init(0);
+
+  g_payload_size = (Dot3PduSize)param;
+  for (unsigned int i = 0; i < sizeof(g_payload); i++) {
+    g_payload[i] = (uint8_t)i;
+  }
+
+  memset(&g_wsm_params, 0, sizeof(g_wsm_params));
+  g_wsm_params.hdr_extensions.chan_num = true;
+  g_wsm_params.hdr_extensions.datarate = true;
+  g_wsm_params.hdr_extensions.transmit_power = true;
+  g_wsm_params.chan_num = 172;
+  g_wsm_params.timeslot = kDot3TimeSlot_Continuous;
+  g_wsm_params.datarate = kDot3DataRate_6Mbps;
+  g_wsm_params.transmit_power = 20;
+  g_wsm_params.priority = 7;
+  g_wsm_params.psid = 32;
+  memset(g_wsm_params.dst_mac_addr, 0xff, kDot3MacAddrSize);
+  memcpy(g_wsm_params.src_mac_addr, g_test_mac_address, kDot3MacAddrSize);
+
+  g_mpdu_size = Dot3_ConstructWsmMpdu(&g_wsm_params, g_payload, g_payload_size, g_mpdu, sizeof(g_mpdu));
+  if (g_mpdu_size < 0) {
+    fprintf(stderr, "Fail to Dot3_ConstructWsmMpdu() - %d\n", g_mpdu_size);
+    return -1;
+  }
+  if (Dot3_AddWsr(g_wsm_params.psid) < 0) {
+    return -1;
+  }
+  return 0;
+}
+
+
+/**
+ * PSR 테이블에 모든 확장필드를 포함한 PSR 들을 등록한다.
+ *
+ * @param num       등록할 PSR 개수
+ * @param wsa_id    PSR 의 WSA ID
+ * @return          성공 시 0, 실패 시 -1
+ */
+static int Bench_AddPsrs(const unsigned int num, const Dot3WsaIdentifier wsa_id)
+{
+  struct Dot3Psr psr;
+  for (unsigned int i = 0; i < num; i++) {
+    memset(&psr, 0, sizeof(psr));
+    psr.wsa_id = wsa_id;
+    psr.psid = i;
+    psr.service_chan_num = 172 + (i % 13);
+    psr.chan_access = kDot3ProviderChannelAccess_Any;
+    psr.present.psc = true;
+    psr.present.provider_mac_addr = true;
+    psr.present.rcpi_threshold = true;
+    psr.present.wsa_cnt_threshold = true;
+    psr.present.wsa_cnt_threshold_interval = true;
+    psr.ip_service = true;
+    psr.psc.len = 23; // 31개 수납 시 WSA 길이가 kWsmBodySafeMaxSize 를 넘지 않는 최대 PSC 길이
+    memset(psr.psc.psc, 'A' + (i % 26), psr.psc.len);
+    memcpy(psr.ipv6_address, g_test_ipv6_address, IPV6_ALEN);
+    psr.service_port = 200;
+    memcpy(psr.provider_mac_addr, g_test_mac_address, MAC_ALEN);
+    psr.rcpi_threshold = 200;
+    psr.wsa_cnt_threshold = 200;
+    psr.wsa_cnt_threshold_interval = 200;
+    int ret = Dot3_AddPsr(&psr);
+    if (ret < 0) {
+      fprintf(stderr, "Fail to Dot3_AddPsr() - %d\n", ret);
+      return -1;
+    }
+  }
+  g_psr_num = (Dot3PsrNum)num;
+  return 0;
+}
+
+
+/**
+ * WSA 측정 데이터를 준비한다.
+ *  - Service info 개수만큼 PSR 을 등록하고, 모든 헤더 확장필드와 WRA 를 포함한 WSA 를 생성한다.
+ *
+ * @param param     Service info 개수
+ * @return          성공 시 0, 실패 시 -1
+ */
+static int Bench_PrepareWsa(unsigned int param)
+{
+  Dot3_Init(0);
+  if (Bench_AddPsrs(param, 1) < 0) {
+    return -1;
+  }
+
+  memset(&g_wsa_params, 0, sizeof(g_wsa_params));
+  g_wsa_params.hdr.version = kDot3WsaVersion_Current;
+  g_wsa_params.hdr.wsa_id = 1;
+  g_wsa_params.hdr.extensions.repeat_rate = true;
+  g_wsa_params.hdr.extensions.twod_location = true;
+  g_wsa_params.hdr.extensions.threed_location = true;
+  g_wsa_params.hdr.extensions.advertiser_id = true;
+  g_wsa_params.hdr.repeat_rate = 50;
+  g_wsa_params.hdr.twod_location.latitude = 374000000;
+  g_wsa_params.hdr.twod_location.longitude = 1270000000;
+  g_wsa_params.hdr.threed_location.latitude = 374000001;
+  g_wsa_params.hdr.threed_location.longitude = 1270000001;
+  g_wsa_params.hdr.threed_location.elevation = 100;
+  g_wsa_params.hdr.advertiser_id.len = strlen("Advertiser Identifier");
+  memcpy(g_wsa_params.hdr.advertiser_id.id, "Advertiser Identifier", g_wsa_params.hdr.advertiser_id.len);
+  g_wsa_params.present.wra = true;
+  g_wsa_params.wra.router_lifetime = 100;
+  memcpy(g_wsa_params.wra.ip_prefix, g_test_ipv6_address, IPV6_ALEN);
+  g_wsa_params.wra.ip_prefix_len = 64;
+  memcpy(g_wsa_params.wra.default_gw, g_test_ipv6_address, IPV6_ALEN);
+  memcpy(g_wsa_params.wra.primary_dns, g_test_ipv6_address, IPV6_ALEN);
+
+  g_wsa_size = Dot3_ConstructWsa(&g_wsa_params, g_wsa, sizeof(g_wsa));
+  if (g_wsa_size < 0) {
+    fprintf(stderr, "Fail to Dot3_ConstructWsa() - %d\n", g_wsa_size);
+    return -1;
+  }
+  return 0;
+}
+
+
+/**
+ * PSR 측정 데이터를 준비한다.
+ *
+ * @param param     PSR 테이블에 미리 등록할 PSR 개수
+ * @return          성공 시 0, 실패 시 -1
+ */
+static int Bench_PreparePsr(unsigned int param)
+{
+  Dot3_Init(0);
+  return Bench_AddPsrs(param, 1);
+}
+
+
+/*
+ * 측정 대상 함수들
+ */
+static int Bench_ConstructWsmMpdu(void)
+{
+  return Dot3_ConstructWsmMpdu(&g_wsm_params, g_payload, g_payload_size, g_outbuf, sizeof(g_outbuf));
+}
+
+static int Bench_ConstructWsmMpduInPlace(void)
+{
+  Dot3PduSize mpdu_offset;
+  int ret = Dot3_ConstructWsmMpduInPlace(&g_wsm_params, g_outbuf, kQoSMacHdrSize + kLLCHdrSize + kWsmpHdrMaxSize,
+                                         g_payload_size, &mpdu_offset);
+  return (ret < 0) ? ret : (ret - g_payload_size); // 페이로드는 복사되지 않는다.
+}
+
+static int Bench_ParseWsmMpdu(void)
+{
+  struct Dot3WsmMpduRxParams params;
+  bool wsr_registered;
+  return Dot3_ParseWsmMpdu(g_mpdu, (Dot3PduSize)g_mpdu_size, g_outbuf, sizeof(g_outbuf), &params, &wsr_registered);
+}
+
+static int Bench_ParseWsmMpduView(void)
+{
+  struct Dot3WsmMpduRxParams params;
+  Dot3PduSize payload_offset;
+  bool wsr_registered;
+  int ret = Dot3_ParseWsmMpduView(g_mpdu, (Dot3PduSize)g_mpdu_size, &params, &payload_offset, &wsr_registered);
+  return (ret < 0) ? ret : 0; // 페이로드는 복사되지 않는다.
+}
+
+static int Bench_ConstructWsaCached(void)
+{
+  return Dot3_ConstructWsa(&g_wsa_params, g_outbuf, sizeof(g_outbuf));
+}
+
+static int Bench_ConstructWsaUpdated(void)
+{
+  // content count 와 위치만 변경 (캐시된 WSA 수정)
+  g_wsa_params.hdr.content_count = (Dot3WsaContentCount)((g_wsa_params.hdr.content_count + 1) % (kDot3WsaMaxContentCount + 1));
+  g_wsa_params.hdr.threed_location.elevation = (g_wsa_params.hdr.threed_location.elevation == 100) ? 101 : 100;
+  return Dot3_ConstructWsa(&g_wsa_params, g_outbuf, sizeof(g_outbuf));
+}
+
+static int Bench_ConstructWsaFull(void)
+{
+  // 캐시된 WSA 를 수정할 수 없는 필드를 변경 (전체 인코딩)
+  g_wsa_params.hdr.repeat_rate = (g_wsa_params.hdr.repeat_rate == 50) ? 51 : 50;
+  return Dot3_ConstructWsa(&g_wsa_params, g_outbuf, sizeof(g_outbuf));
+}
+
+static int Bench_ParseWsa(void)
+{
+  int ret = Dot3_ParseWsa(g_wsa, (Dot3PduSize)g_wsa_size, &g_parsed_wsa);
+  return (ret < 0) ? ret : (int)g_wsa_size; // 디코딩한 WSA 의 길이
+}
+
+static int Bench_AddDeletePsr(void)
+{
+  struct Dot3Psr psr;
+  memset(&psr, 0, sizeof(psr));
+  psr.wsa_id = 1;
+  psr.psid = kDot3Psid_Max;
+  psr.service_chan_num = 172;
+  psr.chan_access = kDot3ProviderChannelAccess_Any;
+  int ret = Dot3_AddPsr(&psr);
+  if (ret < 0) {
+    return ret;
+  }
+  ret = Dot3_DeletePsr(psr.psid);
+  return (ret < 0) ? ret : 0;
+}
+
+static int Bench_GetPsrWithPsid(void)
+{
+  static unsigned int n;
+  struct Dot3Psr psr;
+  int ret = Dot3_GetPsrWithPsid((Dot3Psid)(n++ % g_psr_num), &psr);
+  return (ret < 0) ? ret : (int)sizeof(psr);
+}
+
+
+/// 측정항목 목록
+static const struct BenchCase g_cases[] = {
+  { "wsm_construct", "small", 32, Bench_PrepareWsm, Bench_ConstructWsmMpdu },
+  { "wsm_construct", "typical", 300, Bench_PrepareWsm, Bench_ConstructWsmMpdu },
+  { "wsm_construct", "max", kWsmBodySafeMaxSize, Bench_PrepareWsm, Bench_ConstructWsmMpdu },
+  { "wsm_construct_inplace", "small", 32, Bench_PrepareWsm, Bench_ConstructWsmMpduInPlace },
+  { "wsm_construct_inplace", "typical", 300, Bench_PrepareWsm, Bench_ConstructWsmMpduInPlace },
+  { "wsm_construct_inplace", "max", kWsmBodySafeMaxSize, Bench_PrepareWsm, Bench_ConstructWsmMpduInPlace },
+  { "wsm_parse", "small", 32, Bench_PrepareWsm, Bench_ParseWsmMpdu },
+  { "wsm_parse", "typical", 300, Bench_PrepareWsm, Bench_ParseWsmMpdu },
+  { "wsm_parse", "max", kWsmBodySafeMaxSize, Bench_PrepareWsm, Bench_ParseWsmMpdu },
+  { "wsm_parse_view", "small", 32, Bench_PrepareWsm, Bench_ParseWsmMpduView },
+  { "wsm_parse_view", "typical", 300, Bench_PrepareWsm, Bench_ParseWsmMpduView },
+  { "wsm_parse_view", "max", kWsmBodySafeMaxSize, Bench_PrepareWsm, Bench_ParseWsmMpduView },
+  { "wsa_construct_cached", "1svc", 1, Bench_PrepareWsa, Bench_ConstructWsaCached },
+  { "wsa_construct_cached", "8svc", 8, Bench_PrepareWsa, Bench_ConstructWsaCached },
+  { "wsa_construct_cached", "31svc", 31, Bench_PrepareWsa, Bench_ConstructWsaCached },
+  { "wsa_construct_updated", "1svc", 1, Bench_PrepareWsa, Bench_ConstructWsaUpdated },
+  { "wsa_construct_updated", "8svc", 8, Bench_PrepareWsa, Bench_ConstructWsaUpdated },
+  { "wsa_construct_updated", "31svc", 31, Bench_PrepareWsa, Bench_ConstructWsaUpdated },
+  { "wsa_construct_full", "1svc", 1, Bench_PrepareWsa, Bench_ConstructWsaFull },
+  { "wsa_construct_full", "8svc", 8, Bench_PrepareWsa, Bench_ConstructWsaFull },
+  { "wsa_construct_full", "31svc", 31, Bench_PrepareWsa, Bench_ConstructWsaFull },
+  { "wsa_parse", "1svc", 1, Bench_PrepareWsa, Bench_ParseWsa },
+  { "wsa_parse", "8svc", 8, Bench_PrepareWsa, Bench_ParseWsa },
+  { "wsa_parse", "31svc", 31, Bench_PrepareWsa, Bench_ParseWsa },
+  { "psr_add_delete", "31psr", 31, Bench_PreparePsr, Bench_AddDeletePsr },
+  { "psr_add_delete", "127psr", kDot3PsrNum_MaxNum - 1, Bench_PreparePsr, Bench_AddDeletePsr },
+  { "psr_get", "31psr", 31, Bench_PreparePsr, Bench_GetPsrWithPsid },
+  { "psr_get", "127psr", kDot3PsrNum_MaxNum - 1, Bench_PreparePsr, Bench_GetPsrWithPsid },
+};
+
+
+/**
+ * 하나의 측정항목을 측정한다.
+ *
+ * @param c     측정항목
+ * @param r     측정결과가 저장될 구조체
+ * @return      성공 시 0, 실패 시 -1
+ */
+static int Bench_Run(const struct BenchCase *const c, struct BenchResult *const r)
+{
+  int ret;
+
+  if (c->prepare(c->param) < 0) {
+    fprintf(stderr, "Fail to prepare %s/%s\n", c->name, c->variant);
+    return -1;
+  }
+  for (unsigned int i = 0; i < BENCH_WARMUP_ITERS; i++) {
+    ret = c->op();
+    if (ret < 0) {
+      fprintf(stderr, "Fail to run %s/%s - %d\n", c->name, c->variant, ret);
+      return -1;
+    }
+  }
+
+  /*
+   * 할당 횟수 및 바이트 수 측정
+   */
+  uint64_t bytes = 0, arena_allocs = 0;
+#if defined(__GLIBC__)
+  uint64_t heap_allocs = __atomic_load_n(&g_heap_alloc_cnt, __ATOMIC_RELAXED);
+#endif
+  for (unsigned int i = 0; i < BENCH_ACCOUNT_ITERS; i++) {
+#if defined(BENCH_ARENA_STATS)
+    struct Dot3FFAsn1cArenaStats stats;
+    dot3_FFAsn1c_BeginArena();  // 아레나를 사용하지 않는 경우를 위해 통계를 초기화한다.
+    dot3_FFAsn1c_EndArena();
+#endif
+    ret = c->op();
+    if (ret < 0) {
+      fprintf(stderr, "Fail to run %s/%s - %d\n", c->name, c->variant, ret);
+      return -1;
+    }
+    bytes += (uint64_t)ret;
+#if defined(BENCH_ARENA_STATS)
+    dot3_FFAsn1c_GetArenaStats(&stats);
+    arena_allocs += stats.alloc_cnt;
+#endif
+  }
+#if defined(__GLIBC__)
+  heap_allocs = __atomic_load_n(&g_heap_alloc_cnt, __ATOMIC_RELAXED) - heap_allocs;
+  r->heap_allocs_per_op = (double)heap_allocs / BENCH_ACCOUNT_ITERS;
+#else
+  r->heap_allocs_per_op = -1.0;
+#endif
+#if defined(BENCH_ARENA_STATS)
+  r->arena_allocs_per_op = (double)arena_allocs / BENCH_ACCOUNT_ITERS;
+#else
+  (void)arena_allocs;
+  r->arena_allocs_per_op = -1.0;
+#endif
+  r->bytes_per_op = (double)bytes / BENCH_ACCOUNT_ITERS;
+
+  /*
+   * 수행시간 측정 - 배치 수행시간이 최소 측정시간 이상이 될 때까지 반복횟수를 늘린다.
+   */
+  uint64_t elapsed;
+  for (r->iters = 16; ; r->iters *= 2) {
+    uint64_t start = Bench_GetTimeNs();
+    for (uint64_t i = 0; i < r->iters; i++) {
+      c->op();
+    }
+    elapsed = Bench_GetTimeNs() - start;
+    if ((elapsed >= g_bench.min_ns) || (r->iters >= BENCH_MAX_ITERS)) {
+      break;
+    }
+  }
+  r->ns_per_op = (double)elapsed / (double)r->iters;
+  return 0;
+}
+
+
+/**
+ * 측정결과를 출력한다.
+ *
+ * @param c         측정항목
+ * @param r         측정결과
+ * @param machine   측정 머신 아키텍처 (uname -m)
+ */
+static void Bench_PrintResult(const struct BenchCase *const c, const struct BenchResult *const r, const char *machine)
+{
+  if (g_bench.json) {
+    printf("{\"label\":\"%s\",\"arch\":\"%s\",\"bench\":\"%s/%s\",\"param\":%u,\"iters\":%"PRIu64","
+           "\"ns_per_op\":%.1f,\"heap_allocs_per_op\":%.2f,\"arena_allocs_per_op\":%.2f,\"bytes_per_op\":%.1f}\n",
+           g_bench.label, machine, c->name, c->variant, c->param, r->iters,
+           r->ns_per_op, r->heap_allocs_per_op, r->arena_allocs_per_op, r->bytes_per_op);
+  } else {
+    char name[64];
+    snprintf(name, sizeof(name), "%s/%s", c->name, c->variant);
+    printf("%-32s %12.1f %10.2f %10.2f %10.1f\n",
+           name, r->ns_per_op, r->heap_allocs_per_op, r->arena_allocs_per_op, r->bytes_per_op);
+  }
+  fflush(stdout);
+}
+
+
+/**
+ * 사용법을 출력한다.
+ */
+static void Bench_Usage(const char *prog)
+{
+  printf("Usage: %s [options]\n", prog);
+  printf("  -t <msec>     minimum measuring time of a batch (default: 200)\n");
+  printf("  -f <name>     run only benchmarks whose name contains <name>\n");
+  printf("  -j            print results as JSON lines\n");
+  printf("  -l <label>    label included in JSON results (e.g. commit hash)\n");
+  printf("  -h            print this message\n");
+  printf("Allocation counts are -1 if not measured (heap: glibc only, arena: ffasn1c with internal functions exported).\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+  struct BenchResult r;
+  struct utsname uts;
+  int c, fail = 0;
+
+  memset(&g_bench, 0, sizeof(g_bench));
+  g_bench.min_ns = 200ULL * 1000000ULL;
+  g_bench.label = "";
+  while ((c = getopt(argc, argv, "t:f:jl:h")) != -1) {
+    switch (c) {
+      case 't': g_bench.min_ns = strtoull(optarg, NULL, 0) * 1000000ULL; break;
+      case 'f': g_bench.filter = optarg; break;
+      case 'j': g_bench.json = true; break;
+      case 'l': g_bench.label = optarg; break;
+      default:
+        Bench_Usage(argv[0]);
+        return (c == 'h') ? 0 : -1;
+    }
+  }
+  if (uname(&uts) < 0) {
+    snprintf(uts.machine, sizeof(uts.machine), "unknown");
+  }
+
+  if (!g_bench.json) {
+    printf("libdot3 benchmark (%s)\n", uts.machine);
+    printf("%-32s %12s %10s %10s %10s\n", "benchmark", "ns/op", "heap/op", "arena/op", "bytes/op");
+  }
+  for (unsigned int i = 0; i < sizeof(g_cases) / sizeof(g_cases[0]); i++) {
+    const struct BenchCase *bc = &g_cases[i];
+    if (g_bench.filter && !strstr(bc->name, g_bench.filter)) {
+      continue;
+    }
+    memset(&r, 0, sizeof(r));
+    if (Bench_Run(bc, &r) < 0) {
+      fail = 1;
+      continue;
+    }
+    Bench_PrintResult(bc, &r, uts.machine);
+  }
+  return fail ? -1 : 0;
+}
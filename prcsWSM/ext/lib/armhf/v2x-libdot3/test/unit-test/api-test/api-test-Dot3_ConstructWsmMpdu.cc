@@ -47,6 +47,8 @@ extern uint8_t g_max_size_wsm_mpdu_with_max_wsmp_hdr[kMpduMaxSize];
  *  10) payload_size 값에 따라 정확한 결과 데이터를 반환하거나 실패를 반환해야 한다.
  *  11) outbuf=NULL이거나 outbuf_size=0인 경우, 실패를 반환해야 한다.
  *  12) payload_size 값과 outbuf_size 값에 따라 정확한 결과 데이터를 반환하거나 실패를 반환해야 한다.
+ *  13) Dot3_ConstructWsmMpduV() 는 페이로드 조각들을 합친 페이로드에 대한 Dot3_ConstructWsmMpdu() 결과와 동일해야 한다.
+ *  14) Dot3_ConstructWsmMpduInPlace() 는 headroom 에 헤더를 채워 Dot3_ConstructWsmMpdu() 결과와 동일한 MPDU 를 생성해야 한다.
  *
  *  위 테스트 케이스들에서 정확한 결과 데이터를 확인하는 경우, MAC 헤더와 LLC 헤더만을 확인한다.
  */
@@ -1044,3 +1046,156 @@ TEST(Dot3_ConstructWsmMpdu, payload_size_between_outbuf_size)
     EXPECT_TRUE(!(memcmp(outbuf, g_max_size_wsm_mpdu_with_max_wsmp_hdr, kQoSMacHdrSize + kLLCHdrSize)));
   }
 }
+
+
+/*
+ * 13), 14) 테스트를 위한 송신파라미터를 설정한다.
+ */
+static void PrepareSampleTxParams(struct Dot3WsmMpduTxParams *const params, const bool max_hdr)
+{
+  memset(params, 0, sizeof(*params));
+  params->hdr_extensions.chan_num = max_hdr;
+  params->hdr_extensions.datarate = max_hdr;
+  params->hdr_extensions.transmit_power = max_hdr;
+  params->chan_num = 172;
+  params->datarate = kDot3DataRate_6Mbps;
+  params->transmit_power = 30;
+  params->priority = kDot3Priority_Max;
+  memcpy(params->dst_mac_addr, bcast_addr, sizeof(params->dst_mac_addr));
+  memcpy(params->src_mac_addr, my_addr, sizeof(params->src_mac_addr));
+  params->psid = max_hdr ? kDot3Psid_Max : 0;
+}
+
+
+/*
+ * 13) Dot3_ConstructWsmMpduV() 는 페이로드 조각들을 합친 페이로드에 대한 Dot3_ConstructWsmMpdu() 결과와 동일해야 한다.
+ */
+TEST(Dot3_ConstructWsmMpdu, fragments)
+{
+  Dot3_Init(0);  // 테스트 실패 원인 확인 시에는 6 으로 변경
+
+  struct Dot3WsmMpduTxParams params;
+  uint8_t payload[kMpduMaxSize];
+  uint8_t outbuf[kMpduMaxSize], outbuf_v[kMpduMaxSize];
+  int mpdu_size, mpdu_size_v;
+  for (unsigned int i = 0; i < sizeof(payload); i++) {
+    payload[i] = (uint8_t)i;
+  }
+
+  const Dot3PduSize payload_sizes[] = { 0, 1, 100, 127, 128, 1000, kWsmBodySafeMaxSize };
+  for (int max_hdr = 0; max_hdr <= 1; max_hdr++) {
+    PrepareSampleTxParams(&params, max_hdr);
+    for (unsigned int i = 0; i < sizeof(payload_sizes) / sizeof(payload_sizes[0]); i++) {
+      Dot3PduSize payload_size = payload_sizes[i];
+      mpdu_size = Dot3_ConstructWsmMpdu(&params, payload, payload_size, outbuf, sizeof(outbuf));
+      ASSERT_GT(mpdu_size, 0);
+
+      /*
+       * 3개 조각(중간 조각은 길이 0)으로 나누어 생성
+       */
+      struct Dot3PayloadFragment frags[3];
+      frags[0].buf = payload;
+      frags[0].len = payload_size / 3;
+      frags[1].buf = NULL;
+      frags[1].len = 0;
+      frags[2].buf = payload + frags[0].len;
+      frags[2].len = payload_size - frags[0].len;
+      memset(outbuf_v, 0, sizeof(outbuf_v));
+      mpdu_size_v = Dot3_ConstructWsmMpduV(&params, frags, 3, outbuf_v, sizeof(outbuf_v));
+      EXPECT_EQ(mpdu_size_v, mpdu_size);
+      EXPECT_TRUE(!memcmp(outbuf, outbuf_v, mpdu_size));
+
+      /*
+       * outbuf 크기가 부족하면 실패
+       */
+      EXPECT_EQ(Dot3_ConstructWsmMpduV(&params, frags, 3, outbuf_v, mpdu_size - 1), -kDot3Result_Fail_InsufficientBuf);
+    }
+
+    /*
+     * 조각이 없으면 WSM body 가 없는 MPDU 가 생성된다.
+     */
+    mpdu_size = Dot3_ConstructWsmMpdu(&params, NULL, 0, outbuf, sizeof(outbuf));
+    EXPECT_EQ(Dot3_ConstructWsmMpduV(&params, NULL, 0, outbuf_v, sizeof(outbuf_v)), mpdu_size);
+    EXPECT_TRUE(!memcmp(outbuf, outbuf_v, mpdu_size));
+  }
+
+  /*
+   * 파라미터 유효성
+   */
+  PrepareSampleTxParams(&params, false);
+  struct Dot3PayloadFragment frags[2] = { { payload, 10 }, { NULL, 10 } };
+  EXPECT_EQ(Dot3_ConstructWsmMpduV(NULL, frags, 1, outbuf_v, sizeof(outbuf_v)), -kDot3Result_Fail_NullParameters);
+  EXPECT_EQ(Dot3_ConstructWsmMpduV(&params, NULL, 1, outbuf_v, sizeof(outbuf_v)), -kDot3Result_Fail_NullParameters);
+  EXPECT_EQ(Dot3_ConstructWsmMpduV(&params, frags, 2, outbuf_v, sizeof(outbuf_v)), -kDot3Result_Fail_NullParameters);
+  EXPECT_EQ(Dot3_ConstructWsmMpduV(&params, frags, 1, NULL, sizeof(outbuf_v)), -kDot3Result_Fail_NullParameters);
+  struct Dot3PayloadFragment long_frags[2] = { { payload, kWsmBodyMaxSize }, { payload, kWsmBodyMaxSize } };
+  EXPECT_EQ(Dot3_ConstructWsmMpduV(&params, long_frags, 2, outbuf_v, sizeof(outbuf_v)),
+            -kDot3Result_Fail_TooLongPayload);
+}
+
+
+/*
+ * 14) Dot3_ConstructWsmMpduInPlace() 는 headroom 에 헤더를 채워 Dot3_ConstructWsmMpdu() 결과와 동일한 MPDU 를 생성해야 한다.
+ */
+TEST(Dot3_ConstructWsmMpdu, in_place)
+{
+  Dot3_Init(0);  // 테스트 실패 원인 확인 시에는 6 으로 변경
+
+  struct Dot3WsmMpduTxParams params;
+  uint8_t payload[kMpduMaxSize];
+  uint8_t outbuf[kMpduMaxSize], buf[kWsmMpduHdrMaxSize + kMpduMaxSize + 4];
+  Dot3PduSize mpdu_offset;
+  int mpdu_size, mpdu_size_in_place;
+  for (unsigned int i = 0; i < sizeof(payload); i++) {
+    payload[i] = (uint8_t)(i * 7);
+  }
+
+  const Dot3PduSize payload_sizes[] = { 0, 1, 100, 127, 128, 1000, kWsmBodySafeMaxSize };
+  for (int max_hdr = 0; max_hdr <= 1; max_hdr++) {
+    PrepareSampleTxParams(&params, max_hdr);
+    for (unsigned int i = 0; i < sizeof(payload_sizes) / sizeof(payload_sizes[0]); i++) {
+      Dot3PduSize payload_size = payload_sizes[i];
+      mpdu_size = Dot3_ConstructWsmMpdu(&params, payload, payload_size, outbuf, sizeof(outbuf));
+      ASSERT_GT(mpdu_size, 0);
+      Dot3PduSize hdrs_size = mpdu_size - payload_size;
+
+      /*
+       * headroom 이 충분하면(필요한 크기 또는 최대크기) 페이로드 바로 앞에 헤더가 채워진다.
+       */
+      const Dot3PduSize headrooms[] = { hdrs_size, kWsmMpduHdrMaxSize };
+      for (int j = 0; j < 2; j++) {
+        Dot3PduSize headroom = headrooms[j];
+        memset(buf, 0xA5, sizeof(buf));
+        memcpy(buf + headroom, payload, payload_size);
+        mpdu_size_in_place = Dot3_ConstructWsmMpduInPlace(&params, buf, headroom, payload_size, &mpdu_offset);
+        EXPECT_EQ(mpdu_size_in_place, mpdu_size);
+        EXPECT_EQ(mpdu_offset, headroom - hdrs_size);
+        EXPECT_TRUE(!memcmp(buf + mpdu_offset, outbuf, mpdu_size));
+        // 헤더 앞쪽 및 페이로드 뒤쪽 버퍼는 변경되지 않는다.
+        for (Dot3PduSize k = 0; k < mpdu_offset; k++) {
+          EXPECT_EQ(buf[k], 0xA5);
+        }
+        EXPECT_EQ(buf[headroom + payload_size], 0xA5);
+      }
+
+      /*
+       * headroom 이 부족하면 실패
+       */
+      EXPECT_EQ(Dot3_ConstructWsmMpduInPlace(&params, buf, hdrs_size - 1, payload_size, &mpdu_offset),
+                -kDot3Result_Fail_InsufficientBuf);
+    }
+  }
+
+  /*
+   * 파라미터 유효성
+   */
+  PrepareSampleTxParams(&params, false);
+  EXPECT_EQ(Dot3_ConstructWsmMpduInPlace(NULL, buf, kWsmMpduHdrMaxSize, 10, &mpdu_offset),
+            -kDot3Result_Fail_NullParameters);
+  EXPECT_EQ(Dot3_ConstructWsmMpduInPlace(&params, NULL, kWsmMpduHdrMaxSize, 10, &mpdu_offset),
+            -kDot3Result_Fail_NullParameters);
+  EXPECT_EQ(Dot3_ConstructWsmMpduInPlace(&params, buf, kWsmMpduHdrMaxSize, 10, NULL),
+            -kDot3Result_Fail_NullParameters);
+  EXPECT_EQ(Dot3_ConstructWsmMpduInPlace(&params, buf, kWsmMpduHdrMaxSize, kWsmBodyMaxSize + 10, &mpdu_offset),
+            -kDot3Result_Fail_TooLongPayload);
+}
@@ -42,6 +42,8 @@ extern uint8_t g_max_size_wsm_mpdu_with_max_wsmp_hdr[kMpduMaxSize];
  *  9) MAC 헤더 priority 에 따른 동작 확인
  *  10) LLC 헤더 EtherType 에 따른 동작 확인
  *  11) WSM 정보에 따른 params 값, 페이로드 확인
+ *  12) Dot3_ParseWsmMpduView() 결과가 Dot3_ParseWsmMpdu() 결과와 동일한지 확인
+ *  13) WSR 등록 여부에 따른 wsr_registered 값 및 Dot3_ParseInterestedWsmMpdu() 동작 확인
  */
 
 
@@ -901,3 +903,152 @@ TEST(Dot3_ParseWsmMpdu, wsm_data)
    * "2) mpdu_size 값 범위에 따른 동작 확인" 과 시나리오가 동일하여 생략
    */
 }
+
+
+/*
+ * 12) Dot3_ParseWsmMpduView() 결과가 Dot3_ParseWsmMpdu() 결과와 동일한지 확인
+ *  - 반환되는 페이로드 길이, params 값이 동일하고, 페이로드 위치의 데이터가 outbuf 에 복사된 페이로드와 동일해야 한다.
+ */
+TEST(Dot3_ParseWsmMpdu, view)
+{
+  Dot3_Init(0);  // 테스트 실패 원인 확인 시에는 6 으로 변경
+
+  struct Dot3WsmMpduRxParams params, view_params;
+  uint8_t outbuf[kMpduMaxSize];
+  Dot3PduSize payload_offset;
+  bool wsr_registered;
+  int payload_size, view_payload_size;
+
+  const uint8_t *mpdus[] = {
+    g_min_size_wsm_mpdu_with_min_wsmp_hdr,
+    g_min_size_wsm_mpdu_with_max_wsmp_hdr,
+    g_max_size_wsm_mpdu_with_min_wsmp_hdr,
+    g_max_size_wsm_mpdu_with_max_wsmp_hdr
+  };
+  const Dot3PduSize mpdu_sizes[] = {
+    sizeof(g_min_size_wsm_mpdu_with_min_wsmp_hdr),
+    sizeof(g_min_size_wsm_mpdu_with_max_wsmp_hdr),
+    sizeof(g_max_size_wsm_mpdu_with_min_wsmp_hdr),
+    sizeof(g_max_size_wsm_mpdu_with_max_wsmp_hdr)
+  };
+  for (int i = 0; i < 4; i++) {
+    memset(&params, 0, sizeof(params));
+    memset(&view_params, 0, sizeof(view_params));
+    payload_size = Dot3_ParseWsmMpdu(mpdus[i], mpdu_sizes[i], outbuf, sizeof(outbuf), &params, &wsr_registered);
+    view_payload_size = Dot3_ParseWsmMpduView(mpdus[i], mpdu_sizes[i], &view_params, &payload_offset, &wsr_registered);
+    EXPECT_GE(view_payload_size, 0);
+    EXPECT_EQ(view_payload_size, payload_size);
+    EXPECT_TRUE(!memcmp(&params, &view_params, sizeof(params)));
+    EXPECT_EQ(payload_offset + view_payload_size, mpdu_sizes[i]);
+    EXPECT_TRUE(!memcmp(mpdus[i] + payload_offset, outbuf, view_payload_size));
+  }
+
+  /*
+   * NULL 파라미터
+   */
+  const uint8_t *mpdu = g_min_size_wsm_mpdu_with_min_wsmp_hdr;
+  Dot3PduSize mpdu_size = sizeof(g_min_size_wsm_mpdu_with_min_wsmp_hdr);
+  EXPECT_EQ(Dot3_ParseWsmMpduView(NULL, mpdu_size, &params, &payload_offset, &wsr_registered),
+            -kDot3Result_Fail_NullParameters);
+  EXPECT_EQ(Dot3_ParseWsmMpduView(mpdu, mpdu_size, NULL, &payload_offset, &wsr_registered),
+            -kDot3Result_Fail_NullParameters);
+  EXPECT_EQ(Dot3_ParseWsmMpduView(mpdu, mpdu_size, &params, NULL, &wsr_registered),
+            -kDot3Result_Fail_NullParameters);
+  EXPECT_EQ(Dot3_ParseWsmMpduView(mpdu, mpdu_size, &params, &payload_offset, NULL),
+            -kDot3Result_Fail_NullParameters);
+}
+
+
+/*
+ * 13) WSR 등록 여부에 따른 wsr_registered 값 및 Dot3_ParseInterestedWsmMpdu() 동작 확인
+ *  - 등록되지 않은 PSID 의 WSM 은 0 이 반환되고 outbuf 가 변경되지 않아야 한다.
+ *  - 등록된 PSID 의 WSM 은 Dot3_ParseWsmMpdu() 결과와 동일해야 한다.
+ */
+TEST(Dot3_ParseWsmMpdu, interested)
+{
+  Dot3_Init(0);  // 테스트 실패 원인 확인 시에는 6 으로 변경
+
+  struct Dot3WsmMpduRxParams params, interested_params;
+  uint8_t outbuf[kMpduMaxSize], interested_outbuf[kMpduMaxSize];
+  bool wsr_registered;
+  int payload_size, interested_payload_size;
+
+  const uint8_t *mpdus[] = {
+    g_min_size_wsm_mpdu_with_min_wsmp_hdr,
+    g_min_size_wsm_mpdu_with_max_wsmp_hdr,
+    g_max_size_wsm_mpdu_with_min_wsmp_hdr,
+    g_max_size_wsm_mpdu_with_max_wsmp_hdr
+  };
+  const Dot3PduSize mpdu_sizes[] = {
+    sizeof(g_min_size_wsm_mpdu_with_min_wsmp_hdr),
+    sizeof(g_min_size_wsm_mpdu_with_max_wsmp_hdr),
+    sizeof(g_max_size_wsm_mpdu_with_min_wsmp_hdr),
+    sizeof(g_max_size_wsm_mpdu_with_max_wsmp_hdr)
+  };
+  for (int i = 0; i < 4; i++) {
+    /*
+     * WSR 미등록 상태
+     */
+    Dot3_DeleteAllWsrs();
+    memset(&params, 0, sizeof(params));
+    wsr_registered = true;
+    payload_size = Dot3_ParseWsmMpdu(mpdus[i], mpdu_sizes[i], outbuf, sizeof(outbuf), &params, &wsr_registered);
+    EXPECT_GE(payload_size, 0);
+    EXPECT_FALSE(wsr_registered);
+
+    memset(&interested_params, 0, sizeof(interested_params));
+    memset(interested_outbuf, 0xA5, sizeof(interested_outbuf));
+    wsr_registered = true;
+    interested_payload_size = Dot3_ParseInterestedWsmMpdu(mpdus[i], mpdu_sizes[i], interested_outbuf,
+                                                          sizeof(interested_outbuf), &interested_params,
+                                                          &wsr_registered);
+    EXPECT_EQ(interested_payload_size, 0);
+    EXPECT_FALSE(wsr_registered);
+    EXPECT_EQ(interested_params.psid, params.psid);
+    for (size_t j = 0; j < sizeof(interested_outbuf); j++) {
+      ASSERT_EQ(interested_outbuf[j], 0xA5);
+    }
+
+    /*
+     * WSR 등록 상태
+     */
+    ASSERT_EQ(Dot3_AddWsr(params.psid), kDot3Result_Success);
+    wsr_registered = false;
+    payload_size = Dot3_ParseWsmMpdu(mpdus[i], mpdu_sizes[i], outbuf, sizeof(outbuf), &params, &wsr_registered);
+    EXPECT_TRUE(wsr_registered);
+
+    memset(&interested_params, 0, sizeof(interested_params));
+    wsr_registered = false;
+    interested_payload_size = Dot3_ParseInterestedWsmMpdu(mpdus[i], mpdu_sizes[i], interested_outbuf,
+                                                          sizeof(interested_outbuf), &interested_params,
+                                                          &wsr_registered);
+    EXPECT_TRUE(wsr_registered);
+    EXPECT_EQ(interested_payload_size, payload_size);
+    EXPECT_TRUE(!memcmp(&params, &interested_params, sizeof(params)));
+    EXPECT_TRUE(!memcmp(outbuf, interested_outbuf, payload_size));
+
+    /*
+     * 등록된 경우에는 outbuf 크기가 체크된다.
+     */
+    if (payload_size > 0) {
+      EXPECT_EQ(Dot3_ParseInterestedWsmMpdu(mpdus[i], mpdu_sizes[i], interested_outbuf, payload_size - 1,
+                                            &interested_params, &wsr_registered),
+                -kDot3Result_Fail_InsufficientBuf);
+    }
+  }
+  Dot3_DeleteAllWsrs();
+
+  /*
+   * NULL 파라미터
+   */
+  const uint8_t *mpdu = g_min_size_wsm_mpdu_with_min_wsmp_hdr;
+  Dot3PduSize mpdu_size = sizeof(g_min_size_wsm_mpdu_with_min_wsmp_hdr);
+  EXPECT_EQ(Dot3_ParseInterestedWsmMpdu(NULL, mpdu_size, outbuf, sizeof(outbuf), &params, &wsr_registered),
+            -kDot3Result_Fail_NullParameters);
+  EXPECT_EQ(Dot3_ParseInterestedWsmMpdu(mpdu, mpdu_size, NULL, sizeof(outbuf), &params, &wsr_registered),
+            -kDot3Result_Fail_NullParameters);
+  EXPECT_EQ(Dot3_ParseInterestedWsmMpdu(mpdu, mpdu_size, outbuf, sizeof(outbuf), NULL, &wsr_registered),
+            -kDot3Result_Fail_NullParameters);
+  EXPECT_EQ(Dot3_ParseInterestedWsmMpdu(mpdu, mpdu_size, outbuf, sizeof(outbuf), &params, NULL),
+            -kDot3Result_Fail_NullParameters);
+}
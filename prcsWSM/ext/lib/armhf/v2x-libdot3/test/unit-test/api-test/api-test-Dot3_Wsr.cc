@@ -0,0 +1,135 @@
+/**
+ * @file api-test-Dot3_Wsr.cc
+ * @date 2026-10-19
+ * @author gyun
+ * @brief WSR 관련 모든 Open API에 대한 단위테스트
+ *
+ * 본 파일은 모든 WSR 관련 Open API (Dot3_***Wsr())에 대한 단위테스트를 수행한다.
+ * 파라미터 유효성, 크기, 결과값 등에 대해 테스트한다.
+ */
+
+
+#include "gtest/gtest.h"
+
+#include "dot3/dot3.h"
+
+
+/*
+ * Test case
+ *  * Dot3_AddWsr() 동작 및 파라미터 유효성
+ *  * Dot3_DeleteWsr() 동작 및 파라미터 유효성
+ *  * Dot3_DeleteAllWsrs() 동작 유효성
+ *  * Dot3_GetWsrNum(), Dot3_GetAllWsrs() 동작 및 파라미터 유효성
+ */
+
+
+/*
+ * Dot3_AddWsr() 동작 및 파라미터 유효성
+ */
+TEST(Dot3_AddWsr, NORMAL)
+{
+  Dot3_Init(0);  // 테스트 실패 원인 확인 시에는 6 으로 변경
+
+  /*
+   * 최대 개수만큼 등록 - 해시 충돌이 발생하도록 연속되지 않은 값도 포함한다.
+   */
+  for (unsigned int i = 0; i < kDot3WsrNum_MaxNum; i++) {
+    Dot3Psid psid = (i % 2) ? i : (kDot3Psid_Max - i);
+    EXPECT_EQ(Dot3_AddWsr(psid), kDot3Result_Success);
+    EXPECT_EQ(Dot3_GetWsrNum(), (int)(i + 1));
+  }
+
+  /*
+   * 테이블이 꽉 찬 경우
+   */
+  EXPECT_EQ(Dot3_AddWsr(kDot3WsrNum_MaxNum + 1000), -kDot3Result_Fail_WsrTableFull);
+  EXPECT_EQ(Dot3_GetWsrNum(), kDot3WsrNum_MaxNum);
+
+  /*
+   * 중복 등록
+   */
+  EXPECT_EQ(Dot3_DeleteWsr(1), kDot3Result_Success);
+  EXPECT_EQ(Dot3_AddWsr(3), -kDot3Result_Fail_SamePsidWsr);
+  EXPECT_EQ(Dot3_AddWsr(kDot3Psid_Max), -kDot3Result_Fail_SamePsidWsr);
+  EXPECT_EQ(Dot3_GetWsrNum(), kDot3WsrNum_MaxNum - 1);
+
+  /*
+   * 유효하지 않은 PSID
+   */
+  EXPECT_EQ(Dot3_AddWsr(kDot3Psid_Max + 1), -kDot3Result_Fail_InvalidPsidValue);
+  EXPECT_EQ(Dot3_GetWsrNum(), kDot3WsrNum_MaxNum - 1);
+
+  Dot3_DeleteAllWsrs();
+}
+
+
+/*
+ * Dot3_DeleteWsr() 동작 및 파라미터 유효성
+ */
+TEST(Dot3_DeleteWsr, NORMAL)
+{
+  Dot3_Init(0);  // 테스트 실패 원인 확인 시에는 6 으로 변경
+
+  for (Dot3Psid psid = 0; psid < 10; psid++) {
+    ASSERT_EQ(Dot3_AddWsr(psid), kDot3Result_Success);
+  }
+
+  /*
+   * 중간 엔트리 삭제 후에도 나머지 엔트리는 그대로 조회되어야 한다.
+   */
+  EXPECT_EQ(Dot3_DeleteWsr(5), kDot3Result_Success);
+  EXPECT_EQ(Dot3_GetWsrNum(), 9);
+  EXPECT_EQ(Dot3_DeleteWsr(5), -kDot3Result_Fail_NoSuchWsr);
+  EXPECT_EQ(Dot3_AddWsr(6), -kDot3Result_Fail_SamePsidWsr);
+  EXPECT_EQ(Dot3_AddWsr(5), kDot3Result_Success);
+
+  /*
+   * 등록되지 않은 PSID, 유효하지 않은 PSID
+   */
+  EXPECT_EQ(Dot3_DeleteWsr(100), -kDot3Result_Fail_NoSuchWsr);
+  EXPECT_EQ(Dot3_DeleteWsr(kDot3Psid_Max + 1), -kDot3Result_Fail_InvalidPsidValue);
+  EXPECT_EQ(Dot3_GetWsrNum(), 10);
+
+  /*
+   * 전체 삭제
+   */
+  EXPECT_EQ(Dot3_DeleteAllWsrs(), kDot3Result_Success);
+  EXPECT_EQ(Dot3_GetWsrNum(), 0);
+  EXPECT_EQ(Dot3_DeleteWsr(0), -kDot3Result_Fail_NoSuchWsr);
+  EXPECT_EQ(Dot3_AddWsr(0), kDot3Result_Success);
+
+  Dot3_DeleteAllWsrs();
+}
+
+
+/*
+ * Dot3_GetWsrNum(), Dot3_GetAllWsrs() 동작 및 파라미터 유효성
+ */
+TEST(Dot3_GetAllWsrs, NORMAL)
+{
+  Dot3_Init(0);  // 테스트 실패 원인 확인 시에는 6 으로 변경
+
+  struct Dot3Wsr wsrs[kDot3WsrNum_MaxNum];
+
+  EXPECT_EQ(Dot3_GetWsrNum(), 0);
+  EXPECT_EQ(Dot3_GetAllWsrs(wsrs), 0);
+  EXPECT_EQ(Dot3_GetAllWsrs(NULL), -kDot3Result_Fail_NullParameters);
+
+  /*
+   * 등록된 순서대로 반환된다. (삭제된 엔트리는 제외)
+   */
+  const Dot3Psid psids[] = { 32, 0, kDot3Psid_Max, 135, 0x8003 };
+  for (unsigned int i = 0; i < sizeof(psids) / sizeof(psids[0]); i++) {
+    ASSERT_EQ(Dot3_AddWsr(psids[i]), kDot3Result_Success);
+  }
+  ASSERT_EQ(Dot3_DeleteWsr(kDot3Psid_Max), kDot3Result_Success);
+
+  EXPECT_EQ(Dot3_GetWsrNum(), 4);
+  EXPECT_EQ(Dot3_GetAllWsrs(wsrs), 4);
+  EXPECT_EQ(wsrs[0].psid, 32U);
+  EXPECT_EQ(wsrs[1].psid, 0U);
+  EXPECT_EQ(wsrs[2].psid, 135U);
+  EXPECT_EQ(wsrs[3].psid, 0x8003U);
+
+  Dot3_DeleteAllWsrs();
+}
@@ -0,0 +1,250 @@
+
+/**
+ * @file internal-func-test-Asn1Arena.cc
+ * @date 2026-10-19
+ * @author gyun
+ * @brief ffasn1c 메모리 할당 아레나(asn1mem.c)에 대한 단위테스트
+ *
+ * 본 파일은 ffasn1c 메모리 할당 함수(asn1_malloc(), asn1_realloc(), asn1_free())의 아레나 동작과,
+ * WSA/WSM 인코딩/디코딩 1회 당 메모리 할당 횟수를 확인한다.
+ * 인코딩/디코딩 1회 당 할당 횟수는 테스트 결과(RecordProperty)로 출력된다.
+ */
+
+#include <stdio.h>  // for printf()
+
+#include "gtest/gtest.h"
+
+#include "dot3/dot3.h"
+#include "dot3-internal.h"
+
+#if defined(FFASN1C_)
+extern "C" {
+#include "dot3-ffasn1c.h"
+}
+
+/*
+ * Test case
+ *  1) 아레나 할당/재할당/해제 및 공간 부족 시 힙 할당 동작 확인
+ *  2) 최대 크기 WSA 인코딩/디코딩 시 할당 횟수 및 힙 할당이 없음을 확인
+ *  3) WSM 인코딩/디코딩 시 할당 횟수 및 힙 할당이 없음을 확인
+ */
+
+static uint8_t g_test_ipv6_address[IPV6_ALEN] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static uint8_t g_test_mac_address[MAC_ALEN] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05 };
+static struct Dot3ProviderInfo *g_pinfo = &(g_dot3_mib.provider_info);
+
+
+/*
+ * 1) 아레나 할당/재할당/해제 및 공간 부족 시 힙 할당 동작 확인
+ */
+TEST(dot3_FFAsn1cArena, ALLOC)
+{
+  struct Dot3FFAsn1cArenaStats stats;
+
+  dot3_FFAsn1c_BeginArena();
+
+  // 아레나 할당 - 정렬된 주소가 반환되어야 한다.
+  uint8_t *p1 = (uint8_t *)asn1_malloc(3);
+  uint8_t *p2 = (uint8_t *)asn1_malloc(0);
+  ASSERT_TRUE(p1 && p2);
+  EXPECT_EQ((uintptr_t)p1 % (2 * sizeof(void *)), 0U);
+  EXPECT_EQ((uintptr_t)p2 % (2 * sizeof(void *)), 0U);
+  memcpy(p1, "abc", 3);
+
+  // 마지막 블록 재할당 - 제자리에서 늘어나야 한다.
+  uint8_t *p3 = (uint8_t *)asn1_malloc(16);
+  memset(p3, 0x5A, 16);
+  EXPECT_EQ(asn1_realloc(p3, 1024), p3);
+  EXPECT_EQ(p3[15], 0x5A);
+
+  // 마지막이 아닌 블록 재할당 - 새로 할당되고 내용이 복사되어야 한다.
+  uint8_t *p4 = (uint8_t *)asn1_realloc(p1, 100);
+  ASSERT_TRUE(p4);
+  EXPECT_NE(p4, p1);
+  EXPECT_TRUE(!memcmp(p4, "abc", 3));
+  asn1_free(p1);
+  asn1_free(p2);
+
+  // 아레나 공간 부족 - 힙에서 할당되어야 하며, asn1_free() 로 해제된다.
+  uint8_t *big = (uint8_t *)asn1_malloc(1024 * 1024);
+  ASSERT_TRUE(big);
+  memset(big, 0, 1024 * 1024);
+  uint8_t *p5 = (uint8_t *)asn1_realloc(p3, 1024 * 1024);
+  ASSERT_TRUE(p5);
+  EXPECT_EQ(p5[15], 0x5A);
+  asn1_free(big);
+  asn1_free(p5);
+
+  dot3_FFAsn1c_GetArenaStats(&stats);
+  EXPECT_EQ(stats.alloc_cnt, 4U);
+  EXPECT_EQ(stats.heap_alloc_cnt, 2U);
+  EXPECT_GT(stats.peak_size, 1024U);
+
+  dot3_FFAsn1c_EndArena();
+
+  // 아레나 구간 밖에서는 힙에서 할당되며, 통계는 변하지 않는다.
+  void *p6 = asn1_malloc(8);
+  ASSERT_TRUE(p6);
+  asn1_free(p6);
+  dot3_FFAsn1c_GetArenaStats(&stats);
+  EXPECT_EQ(stats.alloc_cnt, 4U);
+  EXPECT_EQ(stats.heap_alloc_cnt, 2U);
+
+  // 다음 아레나 구간 시작 시 통계가 초기화된다.
+  dot3_FFAsn1c_BeginArena();
+  dot3_FFAsn1c_EndArena();
+  dot3_FFAsn1c_GetArenaStats(&stats);
+  EXPECT_EQ(stats.alloc_cnt, 0U);
+  EXPECT_EQ(stats.peak_size, 0U);
+}
+
+
+/*
+ * 2) 최대 크기 WSA 인코딩/디코딩 시 할당 횟수 및 힙 할당이 없음을 확인
+ *  - 모든 확장필드를 포함한 PSR 을 최대개수만큼 등록하고, 모든 헤더 확장필드와 WRA 를 포함한 WSA 를 생성한다.
+ *    (PSC 길이는 WSA 길이가 허용되는 최대길이(kWsmBodySafeMaxSize)를 넘지 않도록 설정한다 -> 2279 바이트 WSA)
+ *  - 반복 수행 시에도 아레나 사용량이 동일해야 한다. (누적되지 않아야 한다)
+ *    dot3_ConstructWsa() 는 두번째부터 캐시된 WSA 를 반환하므로, 반복 인코딩은 인코딩 함수를 직접 호출한다.
+ */
+TEST(dot3_FFAsn1cArena, WSA_ALLOC_COUNT)
+{
+  int ret;
+  struct Dot3ConstructWsaParams params;
+  struct Dot3FFAsn1cArenaStats enc_stats, dec_stats, stats;
+  uint8_t outbuf[kMpduMaxSize];
+
+  Dot3_Init(kDot3LogLevel_none);
+
+  struct Dot3Psr psr;
+  for (int i = 0; i < kDot3WsiNum_MaxNum; i++) {
+    memset(&psr, 0, sizeof(psr));
+    psr.psid = i;
+    psr.service_chan_num = 172 + (i % 13);
+    psr.present.psc = true;
+    psr.present.provider_mac_addr = true;
+    psr.present.rcpi_threshold = true;
+    psr.present.wsa_cnt_threshold = true;
+    psr.present.wsa_cnt_threshold_interval = true;
+    psr.ip_service = true;
+    psr.psc.len = 23; // WSA 길이가 kWsmBodySafeMaxSize 를 넘지 않는 최대 PSC 길이
+    memset(psr.psc.psc, 'A' + (i % 26), psr.psc.len);
+    memcpy(psr.ipv6_address, g_test_ipv6_address, IPV6_ALEN);
+    psr.service_port = 200;
+    memcpy(psr.provider_mac_addr, g_test_mac_address, MAC_ALEN);
+    psr.rcpi_threshold = 200;
+    psr.wsa_cnt_threshold = 200;
+    psr.wsa_cnt_threshold_interval = 200;
+    ret = dot3_AddPsr(g_pinfo, &psr);
+    ASSERT_EQ(ret, i + 1);
+  }
+
+  memset(&params, 0, sizeof(params));
+  params.hdr.extensions.repeat_rate = true;
+  params.hdr.extensions.twod_location = true;
+  params.hdr.extensions.threed_location = true;
+  params.hdr.extensions.advertiser_id = true;
+  params.hdr.repeat_rate = 50;
+  params.hdr.twod_location.latitude = 900000001;
+  params.hdr.twod_location.longitude = 1800000001;
+  params.hdr.threed_location.latitude = 900000001;
+  params.hdr.threed_location.longitude = 1800000001;
+  params.hdr.threed_location.elevation = 61439;
+  params.hdr.advertiser_id.len = strlen("Advertiser Identifier");
+  memcpy(params.hdr.advertiser_id.id, "Advertiser Identifier", params.hdr.advertiser_id.len);
+  params.present.wra = true;
+  params.wra.router_lifetime = 100;
+  memcpy(params.wra.ip_prefix, g_test_ipv6_address, IPV6_ALEN);
+  params.wra.ip_prefix_len = 100;
+  memcpy(params.wra.default_gw, g_test_ipv6_address, IPV6_ALEN);
+  memcpy(params.wra.primary_dns, g_test_ipv6_address, IPV6_ALEN);
+
+  struct Dot3ParseWsaParams *parsed = (struct Dot3ParseWsaParams *)malloc(sizeof(struct Dot3ParseWsaParams));
+  ASSERT_TRUE(parsed);
+
+  int wsa_size = dot3_ConstructWsa(g_pinfo, &params, outbuf, sizeof(outbuf));
+  ASSERT_GT(wsa_size, 0);
+  dot3_FFAsn1c_GetArenaStats(&enc_stats);
+  EXPECT_GT(enc_stats.alloc_cnt, 0U);
+  EXPECT_EQ(enc_stats.heap_alloc_cnt, 0U);
+
+  memset(parsed, 0, sizeof(*parsed));
+  ret = dot3_ParseWsa(outbuf, wsa_size, parsed);
+  ASSERT_EQ(ret, kDot3Result_Success);
+  dot3_FFAsn1c_GetArenaStats(&dec_stats);
+  EXPECT_GT(dec_stats.alloc_cnt, 0U);
+  EXPECT_EQ(dec_stats.heap_alloc_cnt, 0U);
+  EXPECT_EQ(parsed->wsi_num, kDot3WsiNum_MaxNum);
+
+  for (int i = 0; i < 100; i++) {
+    const struct Dot3PsrSnapshot *snapshot = dot3_AcquirePsrSnapshot(g_pinfo);
+    dot3_FFAsn1c_BeginArena();
+    ret = dot3_FFAsn1c_EncodeWsa(g_pinfo, snapshot, &params, outbuf, sizeof(outbuf));
+    dot3_FFAsn1c_EndArena();
+    dot3_ReleasePsrSnapshot(g_pinfo);
+    ASSERT_EQ(ret, wsa_size);
+    dot3_FFAsn1c_GetArenaStats(&stats);
+    EXPECT_TRUE(!memcmp(&stats, &enc_stats, sizeof(stats)));
+    ASSERT_EQ(dot3_ParseWsa(outbuf, wsa_size, parsed), kDot3Result_Success);
+    dot3_FFAsn1c_GetArenaStats(&stats);
+    EXPECT_TRUE(!memcmp(&stats, &dec_stats, sizeof(stats)));
+  }
+
+  RecordProperty("WsaEncodeAllocCount", enc_stats.alloc_cnt);
+  RecordProperty("WsaEncodeArenaPeak", (int)enc_stats.peak_size);
+  RecordProperty("WsaDecodeAllocCount", dec_stats.alloc_cnt);
+  RecordProperty("WsaDecodeArenaPeak", (int)dec_stats.peak_size);
+  printf("%d-bytes WSA encode: %u allocs, %zu bytes / decode: %u allocs, %zu bytes\n",
+         wsa_size, enc_stats.alloc_cnt, enc_stats.peak_size, dec_stats.alloc_cnt, dec_stats.peak_size);
+
+  free(parsed);
+  dot3_DeleteAllPsrs(g_pinfo);
+}
+
+
+/*
+ * 3) WSM 인코딩/디코딩 시 할당 횟수 및 힙 할당이 없음을 확인
+ *  - ffasn1c 기반 WSM 인코딩/디코딩 함수를 직접 호출한다. (빌드 옵션 WSMP_CODEC 과 관계없이 확인하기 위함)
+ */
+TEST(dot3_FFAsn1cArena, WSM_ALLOC_COUNT)
+{
+  struct Dot3WsmMpduTxParams tx_params;
+  struct Dot3WsmMpduRxParams rx_params;
+  struct Dot3FFAsn1cArenaStats enc_stats, dec_stats;
+  uint8_t payload[kWsmBodySafeMaxSize] = {0};
+  uint8_t wsm[kMpduMaxSize], outbuf[kMpduMaxSize];
+
+  Dot3_Init(kDot3LogLevel_none);
+
+  memset(&tx_params, 0, sizeof(tx_params));
+  tx_params.hdr_extensions.chan_num = true;
+  tx_params.hdr_extensions.datarate = true;
+  tx_params.hdr_extensions.transmit_power = true;
+  tx_params.chan_num = 172;
+  tx_params.datarate = kDot3DataRate_6Mbps;
+  tx_params.transmit_power = 20;
+  tx_params.psid = kDot3Psid_Max;
+
+  dot3_FFAsn1c_BeginArena();
+  int wsm_size = dot3_FFAsn1c_EncodeWsm(&tx_params, payload, sizeof(payload), wsm, sizeof(wsm));
+  dot3_FFAsn1c_EndArena();
+  ASSERT_GT(wsm_size, 0);
+  dot3_FFAsn1c_GetArenaStats(&enc_stats);
+  EXPECT_GT(enc_stats.alloc_cnt, 0U);
+  EXPECT_EQ(enc_stats.heap_alloc_cnt, 0U);
+
+  dot3_FFAsn1c_BeginArena();
+  int payload_size = dot3_FFAsn1c_DecodeWsm(wsm, wsm_size, outbuf, sizeof(outbuf), &rx_params);
+  dot3_FFAsn1c_EndArena();
+  ASSERT_EQ(payload_size, (int)sizeof(payload));
+  dot3_FFAsn1c_GetArenaStats(&dec_stats);
+  EXPECT_GT(dec_stats.alloc_cnt, 0U);
+  EXPECT_EQ(dec_stats.heap_alloc_cnt, 0U);
+
+  RecordProperty("WsmEncodeAllocCount", enc_stats.alloc_cnt);
+  RecordProperty("WsmDecodeAllocCount", dec_stats.alloc_cnt);
+  printf("%d-bytes WSM encode: %u allocs, %zu bytes / decode: %u allocs, %zu bytes\n",
+         wsm_size, enc_stats.alloc_cnt, enc_stats.peak_size, dec_stats.alloc_cnt, dec_stats.peak_size);
+}
+#endif
@@ -14,6 +14,7 @@
 
 
 #include <stdio.h>  // for printf()
+#include <pthread.h>
 
 #include "gtest/gtest.h"
 
@@ -30,6 +31,9 @@
  *  - 수납 가능한 최대의 Service info 와 이에 관련된 Channel info 가 포함된 WSA 인코딩 동작을 확인하며,
  *    일부 Service info (0번, 30번)는 확장필드를 포함하도록 한다.
  *   - WSA id 가 동일한 PSR만 WSA에 수납되는 것을 확인한다.
+ *  - WSA 인코딩 캐시 사용 시(content count/위치정보 비트 수정, PSR 테이블 변경 시 재인코딩)에도
+ *    캐시 없이 인코딩한 결과와 동일한 WSA 가 생성되는 것을 확인한다.
+ *  - 여러 쓰레드에서 동시에 WSA 를 생성해도 각 쓰레드의 코덱 컨텍스트(캐시, 통계)가 독립적으로 동작하는 것을 확인한다.
  */
 
 static uint8_t g_test_ipv6_address[16] = {
@@ -895,3 +899,233 @@ TEST(dot3_ConstructWsa, WRA)
   EXPECT_EQ(ret, expected_encoded_size);
   EXPECT_TRUE(!(memcmp(outbuf, expected_output, expected_encoded_size)));
 }
+
+
+/*
+ * 호출 쓰레드의 WSA 인코딩 캐시를 무효화한다.
+ */
+static void InvalidateWsaCache(void)
+{
+  struct Dot3CodecCtx *ctx = dot3_GetCodecCtx();
+  ASSERT_TRUE(ctx != NULL);
+  for (unsigned int i = 0; i <= kDot3WsaMaxId; i++) {
+    ctx->wsa_cache[i].valid = false;
+  }
+}
+
+
+/*
+ * WSA 인코딩 캐시 사용 시에도 캐시 없이 인코딩한 결과와 동일한 WSA 가 생성되는 것을 확인한다.
+ *  - 캐시 없이 인코딩한 결과는 캐시를 무효화(InvalidateWsaCache())한 후 생성하여 얻는다.
+ */
+TEST(dot3_ConstructWsa, CACHE)
+{
+  int ret, expected_ret;
+  struct Dot3ConstructWsaParams params;
+  uint8_t outbuf[kMpduMaxSize], expected_output[kMpduMaxSize];
+  struct Dot3Psr psrs[10];
+
+  Dot3_Init(kDot3LogLevel_none);
+  const struct Dot3WsaCacheEntry *entry = &(dot3_GetCodecCtx()->wsa_cache[1]);
+
+  memset(psrs, 0, sizeof(psrs));
+  PrepareSamplePsrs(psrs, 10, 1);
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(dot3_AddPsr(g_pinfo, &psrs[i]), i + 1);
+  }
+
+  memset(&params, 0, sizeof(params));
+  params.hdr.wsa_id = 1;
+  params.hdr.extensions.repeat_rate = true;
+  params.hdr.extensions.twod_location = true;
+  params.hdr.extensions.threed_location = true;
+  params.hdr.extensions.advertiser_id = true;
+  params.hdr.repeat_rate = 50;
+  params.hdr.twod_location.latitude = 374000000;
+  params.hdr.twod_location.longitude = 1270000000;
+  params.hdr.threed_location.latitude = 374000001;
+  params.hdr.threed_location.longitude = 1270000001;
+  params.hdr.threed_location.elevation = 100;
+  params.hdr.advertiser_id.len = strlen("Advertiser Identifier");
+  memcpy(params.hdr.advertiser_id.id, "Advertiser Identifier", params.hdr.advertiser_id.len);
+
+  /*
+   * 최초 생성 시 인코딩되며, content count 및 위치정보 필드의 위치가 확인된다.
+   * 입력이 같으면 동일한 WSA 가 반환된다.
+   */
+  expected_ret = dot3_ConstructWsa(g_pinfo, &params, expected_output, sizeof(expected_output));
+  ASSERT_GT(expected_ret, 0);
+  EXPECT_TRUE(entry->valid);
+  EXPECT_GE(entry->content_count_bitpos, 0);
+  EXPECT_GE(entry->twod_location_bitpos, 0);
+  EXPECT_GE(entry->threed_location_bitpos, 0);
+  ret = dot3_ConstructWsa(g_pinfo, &params, outbuf, sizeof(outbuf));
+  EXPECT_EQ(ret, expected_ret);
+  EXPECT_TRUE(!memcmp(outbuf, expected_output, ret));
+
+  /*
+   * content count 와 위치정보만 변경되면 캐시된 WSA 가 수정된다. (경계값 포함)
+   */
+  const struct {
+    Dot3WsaContentCount content_count;
+    struct Dot3WsaTwoDLocation twod;
+    struct Dot3WsaThreeDLocation threed;
+  } changes[] = {
+    { 1, { 374000000, 1270000000 }, { 374000001, 1270000001, 100 } },
+    { 2, { 374000100, 1270000200 }, { 374000101, 1270000201, 100 } },
+    { 3, { -900000000, -1799999999 }, { 900000001, 1800000001, -4096 } },
+    { 15, { 900000001, 1800000001 }, { -900000000, -1799999999, 61439 } },
+    { 0, { 0, 0 }, { 1, 1, 0 } },
+    { 0, { 374000000, 1270000000 }, { 374000001, 1270000001, 100 } },
+  };
+  for (unsigned int i = 0; i < sizeof(changes) / sizeof(changes[0]); i++) {
+    params.hdr.content_count = changes[i].content_count;
+    params.hdr.twod_location = changes[i].twod;
+    params.hdr.threed_location = changes[i].threed;
+    ret = dot3_ConstructWsa(g_pinfo, &params, outbuf, sizeof(outbuf));
+
+    InvalidateWsaCache();
+    expected_ret = dot3_ConstructWsa(g_pinfo, &params, expected_output, sizeof(expected_output));
+    ASSERT_GT(expected_ret, 0);
+    EXPECT_EQ(ret, expected_ret);
+    EXPECT_TRUE(!memcmp(outbuf, expected_output, expected_ret));
+  }
+
+  /*
+   * PSR 테이블이나 다른 헤더필드가 변경되면 다시 인코딩된다.
+   */
+  uint32_t gen = entry->psr_gen;
+  ASSERT_EQ(dot3_DeletePsr(g_pinfo, 5), 9);
+  ret = dot3_ConstructWsa(g_pinfo, &params, outbuf, sizeof(outbuf));
+  EXPECT_NE(entry->psr_gen, gen);
+  InvalidateWsaCache();
+  expected_ret = dot3_ConstructWsa(g_pinfo, &params, expected_output, sizeof(expected_output));
+  EXPECT_EQ(ret, expected_ret);
+  EXPECT_TRUE(!memcmp(outbuf, expected_output, expected_ret));
+
+  params.hdr.repeat_rate = 100;
+  params.hdr.content_count = 1;
+  ret = dot3_ConstructWsa(g_pinfo, &params, outbuf, sizeof(outbuf));
+  InvalidateWsaCache();
+  expected_ret = dot3_ConstructWsa(g_pinfo, &params, expected_output, sizeof(expected_output));
+  EXPECT_EQ(ret, expected_ret);
+  EXPECT_TRUE(!memcmp(outbuf, expected_output, expected_ret));
+
+  /*
+   * 출력버퍼가 부족하면 캐시된 WSA 가 있더라도 실패한다.
+   */
+  EXPECT_EQ(dot3_ConstructWsa(g_pinfo, &params, outbuf, expected_ret - 1), -kDot3Result_Fail_InsufficientBuf);
+  EXPECT_EQ(dot3_ConstructWsa(g_pinfo, &params, outbuf, sizeof(outbuf)), expected_ret);
+
+  dot3_DeleteAllPsrs(g_pinfo);
+}
+
+
+/*
+ * 동시 WSA 생성 쓰레드의 입출력
+ */
+struct ConstructWsaThreadArg
+{
+  struct Dot3ConstructWsaParams params;
+  int loop;
+  int ret;
+  uint8_t outbuf[kMpduMaxSize];
+  struct Dot3CodecStats stats;
+};
+
+/*
+ * WSA 를 반복 생성한다. 매 반복마다 content count 가 바뀌므로 캐시된 WSA 가 수정되어 사용된다.
+ */
+static void *ConstructWsaThread(void *arg)
+{
+  struct ConstructWsaThreadArg *a = (struct ConstructWsaThreadArg *)arg;
+  for (int i = 0; i < a->loop; i++) {
+    a->params.hdr.content_count = (Dot3WsaContentCount)(i % (kDot3WsaMaxContentCount + 1));
+    a->ret = dot3_ConstructWsa(g_pinfo, &(a->params), a->outbuf, sizeof(a->outbuf));
+    if (a->ret < 0) {
+      break;
+    }
+  }
+  dot3_GetCodecStats(&(a->stats));
+  return NULL;
+}
+
+
+/*
+ * 여러 쓰레드에서 동시에 WSA 를 생성해도 단일 쓰레드에서 생성한 결과와 동일하며, 캐시와 통계는 쓰레드 별로 유지되는 것을 확인한다.
+ * 라이브러리가 다시 초기화되면 쓰레드 별 캐시가 무효화되는 것을 확인한다.
+ */
+TEST(dot3_ConstructWsa, THREADS)
+{
+  const int thread_num = 4, loop = 200;
+  struct Dot3Psr psrs[10];
+  struct ConstructWsaThreadArg args[thread_num];
+  pthread_t threads[thread_num];
+  uint8_t expected_output[thread_num][kMpduMaxSize];
+  int expected_ret[thread_num];
+  struct Dot3CodecStats stats, base_stats;
+
+  Dot3_Init(kDot3LogLevel_none);
+  dot3_GetCodecStats(&base_stats);  // 호출 쓰레드의 통계는 이전 테스트들에서 누적되어 있다.
+
+  /*
+   * WSA ID 1, 2 에 각각 5개씩 PSR 을 등록한다.
+   */
+  memset(psrs, 0, sizeof(psrs));
+  PrepareSamplePsrs(psrs, 10, 1);
+  for (int i = 0; i < 10; i++) {
+    psrs[i].wsa_id = (i < 5) ? 1 : 2;
+    ASSERT_EQ(dot3_AddPsr(g_pinfo, &psrs[i]), i + 1);
+  }
+
+  /*
+   * 쓰레드 별로 WSA ID 와 헤더가 다른 WSA 를 생성하도록 하고, 기대값은 단일 쓰레드에서 생성한다.
+   */
+  memset(args, 0, sizeof(args));
+  for (int i = 0; i < thread_num; i++) {
+    struct Dot3ConstructWsaParams *params = &(args[i].params);
+    params->hdr.wsa_id = (i % 2) + 1;
+    params->hdr.extensions.repeat_rate = true;
+    params->hdr.repeat_rate = 50 + i;
+    params->hdr.content_count = (Dot3WsaContentCount)((loop - 1) % (kDot3WsaMaxContentCount + 1));
+    args[i].loop = loop;
+    InvalidateWsaCache();
+    expected_ret[i] = dot3_ConstructWsa(g_pinfo, params, expected_output[i], sizeof(expected_output[i]));
+    ASSERT_GT(expected_ret[i], 0);
+  }
+  dot3_GetCodecStats(&stats);
+  EXPECT_EQ(stats.wsa_encode_cnt - base_stats.wsa_encode_cnt, (uint32_t)thread_num);
+
+  for (int i = 0; i < thread_num; i++) {
+    ASSERT_EQ(pthread_create(&threads[i], NULL, ConstructWsaThread, &args[i]), 0);
+  }
+  for (int i = 0; i < thread_num; i++) {
+    pthread_join(threads[i], NULL);
+    EXPECT_EQ(args[i].ret, expected_ret[i]);
+    EXPECT_TRUE(!memcmp(args[i].outbuf, expected_output[i], expected_ret[i]));
+    // 각 쓰레드는 자신의 캐시를 사용하므로, 다른 쓰레드의 생성과 관계없이 한 번만 인코딩한다.
+    EXPECT_EQ(args[i].stats.wsa_encode_cnt, 1U);
+    EXPECT_EQ(args[i].stats.wsa_cache_hit_cnt, (uint32_t)(loop - 1));
+  }
+  // 다른 쓰레드의 생성은 호출 쓰레드의 통계에 반영되지 않는다.
+  dot3_GetCodecStats(&stats);
+  EXPECT_EQ(stats.wsa_encode_cnt - base_stats.wsa_encode_cnt, (uint32_t)thread_num);
+
+  /*
+   * 다시 초기화되면, PSR 테이블 스냅샷 세대가 같더라도 캐시된 WSA 를 사용하지 않는다.
+   */
+  args[0].params.hdr.content_count = 0;
+  ASSERT_GT(dot3_ConstructWsa(g_pinfo, &(args[0].params), args[0].outbuf, sizeof(args[0].outbuf)), 0);
+  uint32_t gen = dot3_GetCodecCtx()->wsa_cache[1].psr_gen;
+  Dot3_Init(kDot3LogLevel_none);
+  for (int i = 0; i < 10; i++) {
+    psrs[i].wsa_id = 1;
+    ASSERT_EQ(dot3_AddPsr(g_pinfo, &psrs[i]), i + 1);
+  }
+  EXPECT_FALSE(dot3_GetCodecCtx()->wsa_cache[1].valid);
+  int ret = dot3_ConstructWsa(g_pinfo, &(args[0].params), args[0].outbuf, sizeof(args[0].outbuf));
+  EXPECT_GT(ret, expected_ret[0]);  // 10개의 Service info 가 수납된다.
+  EXPECT_EQ(dot3_GetCodecCtx()->wsa_cache[1].psr_gen, gen);
+
+  dot3_DeleteAllPsrs(g_pinfo);
+}
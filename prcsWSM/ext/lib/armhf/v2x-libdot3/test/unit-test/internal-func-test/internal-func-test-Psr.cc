@@ -13,6 +13,9 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -32,6 +35,9 @@ static struct Dot3ProviderInfo *g_pinfo = &(g_dot3_mib.provider_info);
  *  1) PSR을 순차적으로 최대치까지 등록해 가면서, 저장정보를 확인한다.
  *  2) PSR을 최대개수만큼 등록된 상태에서 하나씩 순차적으로 삭제해 가면서, 저장정보를 확인한다.
  *  3) PSR 개수별로 한번에 삭제 후 저장정보를 확인한다.
+ *  4) PSR 테이블 변경 시 새 스냅샷이 게시되고, 참조 중인 이전 스냅샷은 변경되지 않음을 확인한다.
+ *  5) PSR 추가/삭제와 동시에 수행되는 (뮤텍스 없는) 읽기 측이 항상 일관된 스냅샷을 참조함을 확인한다.
+ *  6) 채널번호로 Provider Channel Info 테이블 엔트리를 참조하고, 테이블에 없는 서비스채널의 PSR 등록이 실패함을 확인한다.
  */
 
 
@@ -361,3 +367,189 @@ TEST(dot3_PSR, DELETE_ALL_PSR)
   }
 }
 
+
+
+/*
+ * 4) PSR 테이블 변경 시 새 스냅샷이 게시되고, 참조 중인 이전 스냅샷은 변경되지 않음을 확인한다.
+ */
+TEST(dot3_PSR, SNAPSHOT)
+{
+  Dot3_Init(kDot3LogLevel_none);
+
+  struct Dot3Psr psrs[kDot3PsrNum_MaxNum];
+  memset(psrs, 0, sizeof(psrs));
+  PrepareSamplePsrs(psrs, kDot3PsrNum_MaxNum);
+
+  // 빈 테이블
+  const struct Dot3PsrSnapshot *snapshot1 = dot3_AcquirePsrSnapshot(g_pinfo);
+  EXPECT_TRUE(snapshot1 == NULL);
+  EXPECT_TRUE(dot3_FindPsrInSnapshot(snapshot1, 0) == NULL);
+  dot3_ReleasePsrSnapshot(g_pinfo);
+
+  // 10개 등록 후 스냅샷 참조 시작
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(dot3_AddPsr(g_pinfo, &psrs[i]), i + 1);
+  }
+  snapshot1 = dot3_AcquirePsrSnapshot(g_pinfo);
+  ASSERT_TRUE(snapshot1 != NULL);
+  uint32_t gen1 = snapshot1->gen;
+  EXPECT_EQ(snapshot1->num, 10U);
+
+  // 참조 중에 테이블을 변경한다. (PSID 0 삭제, PSID 10 추가)
+  EXPECT_EQ(dot3_DeletePsr(g_pinfo, 0), 9);
+  EXPECT_EQ(dot3_AddPsr(g_pinfo, &psrs[10]), 10);
+
+  // 참조 중인 스냅샷은 변경되지 않는다.
+  EXPECT_EQ(snapshot1->gen, gen1);
+  EXPECT_EQ(snapshot1->num, 10U);
+  for (int i = 0; i < 10; i++) {
+    const struct Dot3PsrSnapshotEntry *entry = dot3_FindPsrInSnapshot(snapshot1, i);
+    ASSERT_TRUE(entry != NULL);
+    EXPECT_TRUE(!memcmp(&(entry->psr), &psrs[i], sizeof(struct Dot3Psr)));
+    EXPECT_TRUE(entry == &(snapshot1->entries[i])); // 테이블과 동일한 순서
+  }
+  EXPECT_TRUE(dot3_FindPsrInSnapshot(snapshot1, 10) == NULL);
+
+  // 새로 참조한 스냅샷에는 변경사항이 반영되어 있다.
+  const struct Dot3PsrSnapshot *snapshot2 = dot3_AcquirePsrSnapshot(g_pinfo);
+  ASSERT_TRUE(snapshot2 != NULL);
+  EXPECT_EQ(snapshot2->gen, gen1 + 2);
+  EXPECT_EQ(snapshot2->num, 10U);
+  EXPECT_TRUE(dot3_FindPsrInSnapshot(snapshot2, 0) == NULL);
+  for (int i = 1; i <= 10; i++) {
+    const struct Dot3PsrSnapshotEntry *entry = dot3_FindPsrInSnapshot(snapshot2, i);
+    ASSERT_TRUE(entry != NULL);
+    EXPECT_TRUE(!memcmp(&(entry->psr), &psrs[i], sizeof(struct Dot3Psr)));
+  }
+  dot3_ReleasePsrSnapshot(g_pinfo);
+  dot3_ReleasePsrSnapshot(g_pinfo);
+
+  // 참조 중이던 이전 스냅샷들은 회수 대기 중이며, 참조가 끝난 후의 테이블 변경 시 해제된다.
+  EXPECT_TRUE(g_pinfo->psr_table.retired != NULL);
+  dot3_DeleteAllPsrs(g_pinfo);
+  EXPECT_TRUE(g_pinfo->psr_table.retired == NULL);
+  EXPECT_TRUE(dot3_AcquirePsrSnapshot(g_pinfo) == NULL);
+  dot3_ReleasePsrSnapshot(g_pinfo);
+  EXPECT_EQ(dot3_GetPsrNum(g_pinfo), 0);
+}
+
+
+/*
+ * 5) PSR 추가/삭제와 동시에 수행되는 (뮤텍스 없는) 읽기 측이 항상 일관된 스냅샷을 참조함을 확인한다.
+ *  - 쓰기 측은 API(Dot3_AddPsr(), Dot3_DeletePsr())를 통해 provider 뮤텍스 락 상태에서 PSR을 반복하여 삭제/추가한다.
+ *  - 읽기 측은 스냅샷 참조, PSR 조회, WSA 생성을 반복하며 내용의 일관성과 세대 증가를 확인한다.
+ */
+TEST(dot3_PSR, SNAPSHOT_CONCURRENT_READERS)
+{
+  Dot3_Init(kDot3LogLevel_none);
+
+  static struct Dot3Psr psrs[kDot3PsrNum_MaxNum];
+  memset(psrs, 0, sizeof(psrs));
+  PrepareSamplePsrs(psrs, kDot3PsrNum_MaxNum);
+  for (int i = 0; i < kDot3PsrNum_MaxNum; i++) {
+    ASSERT_EQ(Dot3_AddPsr(&psrs[i]), i + 1);
+  }
+
+  std::atomic<bool> stop(false);
+  std::atomic<unsigned int> errors(0), reads(0);
+
+  // 스냅샷 참조 - 모든 엔트리가 등록된 PSR 과 동일하고 인덱스로 찾을 수 있어야 하며, 세대는 감소하지 않아야 한다.
+  auto snapshot_reader = [&]() {
+    uint32_t last_gen = 0;
+    while (!stop.load()) {
+      const struct Dot3PsrSnapshot *snapshot = dot3_AcquirePsrSnapshot(g_pinfo);
+      if (snapshot) {
+        if ((snapshot->gen < last_gen) || (snapshot->num > kDot3PsrNum_MaxNum)) {
+          errors++;
+        }
+        last_gen = snapshot->gen;
+        for (Dot3PsrNum i = 0; i < snapshot->num; i++) {
+          const struct Dot3PsrSnapshotEntry *entry = &(snapshot->entries[i]);
+          if ((entry->psr.psid >= kDot3PsrNum_MaxNum) ||
+              memcmp(&(entry->psr), &psrs[entry->psr.psid], sizeof(struct Dot3Psr)) ||
+              (dot3_FindPsrInSnapshot(snapshot, entry->psr.psid) != entry)) {
+            errors++;
+          }
+        }
+      }
+      dot3_ReleasePsrSnapshot(g_pinfo);
+      reads++;
+    }
+  };
+
+  // PSR 조회 및 WSA 생성
+  auto api_reader = [&]() {
+    struct Dot3Psr psr;
+    struct Dot3ConstructWsaParams params;
+    uint8_t outbuf[kWsmMaxSize];
+    memset(&params, 0, sizeof(params));
+    for (unsigned int n = 0; !stop.load(); n++) {
+      Dot3Psid psid = n % kDot3PsrNum_MaxNum;
+      int ret = dot3_GetPsrWithPsid(g_pinfo, psid, &psr);
+      if ((ret == kDot3Result_Success) && memcmp(&psr, &psrs[psid], sizeof(psr))) {
+        errors++;
+      } else if ((ret != kDot3Result_Success) && (ret != -kDot3Result_Fail_NoSuchPsr)) {
+        errors++;
+      }
+      params.hdr.wsa_id = psid % (kDot3WsaMaxId + 1);
+      if (dot3_ConstructWsa(g_pinfo, &params, outbuf, sizeof(outbuf)) < 0) {
+        errors++;
+      }
+      reads++;
+    }
+  };
+
+  std::vector<std::thread> readers;
+  readers.emplace_back(snapshot_reader);
+  readers.emplace_back(snapshot_reader);
+  readers.emplace_back(api_reader);
+
+  // 쓰기 측 - 앞 절반의 PSR 을 반복하여 삭제/추가한다.
+  for (int round = 0; round < 50; round++) {
+    for (int i = 0; i < kDot3PsrNum_MaxNum / 2; i++) {
+      EXPECT_EQ(Dot3_DeletePsr(i), kDot3PsrNum_MaxNum - 1);
+      EXPECT_EQ(Dot3_AddPsr(&psrs[i]), kDot3PsrNum_MaxNum);
+    }
+  }
+  stop.store(true);
+  for (auto &t : readers) {
+    t.join();
+  }
+
+  EXPECT_EQ(errors.load(), 0U);
+  EXPECT_GT(reads.load(), 0U);
+  EXPECT_EQ(dot3_GetPsrNum(g_pinfo), kDot3PsrNum_MaxNum);
+  Dot3_DeleteAllPsrs();
+  EXPECT_TRUE(g_pinfo->psr_table.retired == NULL);
+}
+
+
+/*
+ * 6) 채널번호로 Provider Channel Info 테이블 엔트리를 참조하고, 테이블에 없는 서비스채널의 PSR 등록이 실패함을 확인한다.
+ */
+TEST(dot3_PSR, CHANNEL_INFO)
+{
+  Dot3_Init(kDot3LogLevel_none);
+
+  EXPECT_EQ(g_pinfo->pci_table.num, (Dot3PciNum)DOT3_PCI_TABLE_SIZE);
+  for (int chan = kDot3Channel_KoreaV2XMin; chan <= kDot3Channel_KoreaV2XMax; chan++) {
+    const struct Dot3PciTableEntry *entry = dot3_GetPciTableEntry(g_pinfo, chan);
+    ASSERT_TRUE(entry != NULL);
+    EXPECT_EQ(entry->pci.chan_num, chan);
+    EXPECT_EQ(entry->pci.operating_class, (chan % 2) ? kDot3OperatingClass_5G_20mhz : kDot3OperatingClass_5G_10mhz);
+    EXPECT_EQ(entry->pci.transmit_power_level, kDot3Power_MaxEirpInClassC);
+    EXPECT_EQ(entry->pci.datarate, kDot3DataRate_TxDefault);
+    EXPECT_TRUE(entry->pci.adaptable_datarate);
+  }
+  EXPECT_TRUE(dot3_GetPciTableEntry(g_pinfo, kDot3Channel_KoreaV2XMin - 1) == NULL);
+  EXPECT_TRUE(dot3_GetPciTableEntry(g_pinfo, kDot3Channel_KoreaV2XMax + 1) == NULL);
+  EXPECT_TRUE(dot3_GetPciTableEntry(g_pinfo, kDot3Channel_Any) == NULL);
+
+  struct Dot3Psr psr;
+  memset(&psr, 0, sizeof(psr));
+  psr.service_chan_num = kDot3Channel_KoreaV2XMax + 1;
+  EXPECT_EQ(dot3_AddPsr(g_pinfo, &psr), -kDot3Result_Fail_NoRelatedChannelInfo);
+  psr.service_chan_num = kDot3Channel_KoreaV2XMax;
+  EXPECT_EQ(dot3_AddPsr(g_pinfo, &psr), 1);
+  dot3_DeleteAllPsrs(g_pinfo);
+}
@@ -0,0 +1,227 @@
+
+/**
+ * @file internal-func-test-WsmpCodec.cc
+ * @date 2026-10-19
+ * @author gyun
+ * @brief 자체 WSMP 코덱(dot3_EncodeWsmp(), dot3_DecodeWsmpHdr())에 대한 단위테스트
+ *
+ * 본 파일은 자체 WSMP 코덱의 인코딩/디코딩 결과가 ffasn1c 라이브러리를 이용한 결과와 동일한지 확인한다.
+ * 각 필드 값에 대한 기대값 확인은 internal-func-test-ConstructWsm.cc, internal-func-test-ParseWsm.cc 에서 수행된다.
+ * (빌드 옵션 WSMP_CODEC 이 native 인 경우 해당 테스트들도 자체 코덱으로 수행된다)
+ */
+
+#include "gtest/gtest.h"
+
+#include "dot3/dot3.h"
+#include "dot3-internal.h"
+
+#if defined(FFASN1C_)
+extern "C" {
+int dot3_FFAsn1c_EncodeWsm(
+  struct Dot3WsmMpduTxParams *const params,
+  const uint8_t *const payload,
+  const Dot3PduSize payload_size,
+  uint8_t *const outbuf,
+  const Dot3PduSize outbuf_size);
+int dot3_FFAsn1c_DecodeWsm(
+  const uint8_t *const msdu,
+  const Dot3PduSize msdu_size,
+  uint8_t *const outbuf,
+  const Dot3PduSize outbuf_size,
+  struct Dot3WsmMpduRxParams *const params);
+}
+
+/*
+ * Test case
+ *  1) 확장필드/PSID/페이로드길이 조합에 대한 인코딩 결과 동일성 확인
+ *  2) 유효하지 않은 값에 대한 인코딩 에러코드 동일성 확인
+ *  3) 인코딩된 WSM 에 대한 디코딩 결과 동일성 및 WSM body 위치 확인
+ *  4) 잘린 WSM, 변조된 WSM 에 대한 디코딩 에러코드 동일성 확인
+ */
+
+static const Dot3Psid psids[] = {0, 127, 128, 16511, 16512, 2113663, 2113664, kDot3Psid_Max};
+static const Dot3PduSize payload_sizes[] = {0, 1, 127, 128, 1000, kWsmBodySafeMaxSize};
+
+
+/**
+ * 테스트용 송신파라미터를 채운다.
+ *  - ext_mask bit 0/1/2 : ChannelNumber/DataRate/TransmitPowerUsed 확장필드 포함 여부
+ */
+static void FillTxParams(struct Dot3WsmMpduTxParams *params, int ext_mask, Dot3Psid psid)
+{
+  memset(params, 0, sizeof(*params));
+  params->hdr_extensions.chan_num = (ext_mask & 1) ? true : false;
+  params->hdr_extensions.datarate = (ext_mask & 2) ? true : false;
+  params->hdr_extensions.transmit_power = (ext_mask & 4) ? true : false;
+  params->chan_num = 172 + ext_mask;
+  params->datarate = kDot3DataRate_6Mbps + ext_mask;
+  params->transmit_power = kDot3Power_Min + (ext_mask * 36);
+  params->psid = psid;
+}
+
+
+/*
+ * 1) 확장필드/PSID/페이로드길이 조합에 대한 인코딩 결과 동일성 확인
+ */
+TEST(dot3_WsmpCodec, ENCODE_EQUIVALENCE)
+{
+  Dot3_Init(kDot3LogLevel_none);  // 테스트 실패 원인 확인 시에는 kDot3LogLevel_max 로 변경
+
+  struct Dot3WsmMpduTxParams params;
+  uint8_t payload[kWsmBodyMaxSize];
+  uint8_t native[kMpduMaxSize], asn1[kMpduMaxSize];
+  for (size_t i = 0; i < sizeof(payload); i++) {
+    payload[i] = (uint8_t)i;
+  }
+
+  for (int ext_mask = 0; ext_mask < 8; ext_mask++) {
+    for (size_t p = 0; p < sizeof(psids) / sizeof(psids[0]); p++) {
+      for (size_t s = 0; s < sizeof(payload_sizes) / sizeof(payload_sizes[0]); s++) {
+        FillTxParams(&params, ext_mask, psids[p]);
+        int native_size = dot3_EncodeWsmp(&params, payload, payload_sizes[s], native, sizeof(native));
+        int asn1_size = dot3_FFAsn1c_EncodeWsm(&params, payload, payload_sizes[s], asn1, sizeof(asn1));
+        ASSERT_GT(native_size, 0);
+        ASSERT_EQ(native_size, asn1_size) << "ext " << ext_mask << " psid " << psids[p] << " size " << payload_sizes[s];
+        EXPECT_TRUE(!memcmp(native, asn1, native_size));
+      }
+    }
+  }
+
+  /*
+   * 최소길이(4) 헤더일 때 최대길이(2297) WSM body
+   */
+  FillTxParams(&params, 0, 0);
+  EXPECT_EQ(dot3_EncodeWsmp(&params, payload, kWsmBodyMaxSize, native, sizeof(native)),
+            dot3_FFAsn1c_EncodeWsm(&params, payload, kWsmBodyMaxSize, asn1, sizeof(asn1)));
+  EXPECT_TRUE(!memcmp(native, asn1, kWsmMaxSize));
+}
+
+
+/*
+ * 2) 유효하지 않은 값에 대한 인코딩 에러코드 동일성 확인
+ */
+TEST(dot3_WsmpCodec, ENCODE_ERROR_EQUIVALENCE)
+{
+  Dot3_Init(kDot3LogLevel_none);
+
+  struct Dot3WsmMpduTxParams params;
+  uint8_t payload[kWsmBodyMaxSize + 1] = {0};
+  uint8_t native[kMpduMaxSize], asn1[kMpduMaxSize];
+
+  // 유효하지 않은 PSID
+  FillTxParams(&params, 7, kDot3Psid_Max + 1);
+  EXPECT_EQ(dot3_EncodeWsmp(&params, NULL, 0, native, sizeof(native)), -kDot3Result_Fail_InvalidPsidValue);
+  EXPECT_EQ(dot3_FFAsn1c_EncodeWsm(&params, NULL, 0, asn1, sizeof(asn1)), -kDot3Result_Fail_InvalidPsidValue);
+
+  // 유효하지 않은 확장필드 값
+  FillTxParams(&params, 1, 0);
+  params.chan_num = 256;
+  EXPECT_EQ(dot3_EncodeWsmp(&params, NULL, 0, native, sizeof(native)),
+            dot3_FFAsn1c_EncodeWsm(&params, NULL, 0, asn1, sizeof(asn1)));
+  FillTxParams(&params, 2, 0);
+  params.datarate = -1;
+  EXPECT_EQ(dot3_EncodeWsmp(&params, NULL, 0, native, sizeof(native)),
+            dot3_FFAsn1c_EncodeWsm(&params, NULL, 0, asn1, sizeof(asn1)));
+  FillTxParams(&params, 4, 0);
+  params.transmit_power = kDot3Power_Max + 1;
+  EXPECT_EQ(dot3_EncodeWsmp(&params, NULL, 0, native, sizeof(native)),
+            dot3_FFAsn1c_EncodeWsm(&params, NULL, 0, asn1, sizeof(asn1)));
+
+  // 너무 긴 WSM
+  FillTxParams(&params, 0, 0);
+  EXPECT_EQ(dot3_EncodeWsmp(&params, payload, kWsmBodyMaxSize + 1, native, sizeof(native)),
+            -kDot3Result_Fail_TooLongWsm);
+  EXPECT_EQ(dot3_FFAsn1c_EncodeWsm(&params, payload, kWsmBodyMaxSize + 1, asn1, sizeof(asn1)),
+            -kDot3Result_Fail_TooLongWsm);
+
+  // 부족한 버퍼
+  FillTxParams(&params, 7, kDot3Psid_Max);
+  EXPECT_EQ(dot3_EncodeWsmp(&params, payload, 100, native, 100), -kDot3Result_Fail_InsufficientBuf);
+  EXPECT_EQ(dot3_FFAsn1c_EncodeWsm(&params, payload, 100, asn1, 100), -kDot3Result_Fail_InsufficientBuf);
+}
+
+
+/*
+ * 3) 인코딩된 WSM 에 대한 디코딩 결과 동일성 및 WSM body 위치 확인
+ */
+TEST(dot3_WsmpCodec, DECODE_EQUIVALENCE)
+{
+  Dot3_Init(kDot3LogLevel_none);
+
+  struct Dot3WsmMpduTxParams tx_params;
+  struct Dot3WsmMpduRxParams native_params, asn1_params;
+  uint8_t payload[kWsmBodyMaxSize];
+  uint8_t wsm[kMpduMaxSize], asn1_outbuf[kMpduMaxSize];
+  Dot3PduSize body_offset;
+  for (size_t i = 0; i < sizeof(payload); i++) {
+    payload[i] = (uint8_t)(i * 7);
+  }
+
+  for (int ext_mask = 0; ext_mask < 8; ext_mask++) {
+    for (size_t p = 0; p < sizeof(psids) / sizeof(psids[0]); p++) {
+      for (size_t s = 0; s < sizeof(payload_sizes) / sizeof(payload_sizes[0]); s++) {
+        FillTxParams(&tx_params, ext_mask, psids[p]);
+        int wsm_size = dot3_FFAsn1c_EncodeWsm(&tx_params, payload, payload_sizes[s], wsm, sizeof(wsm));
+        ASSERT_GT(wsm_size, 0);
+        memset(&native_params, 0, sizeof(native_params));
+        memset(&asn1_params, 0, sizeof(asn1_params));
+        int native_size = dot3_DecodeWsmpHdr(wsm, wsm_size, &native_params, &body_offset);
+        int asn1_size = dot3_FFAsn1c_DecodeWsm(wsm, wsm_size, asn1_outbuf, sizeof(asn1_outbuf), &asn1_params);
+        ASSERT_EQ(native_size, asn1_size);
+        ASSERT_EQ(native_size, payload_sizes[s]);
+        EXPECT_TRUE(!memcmp(&native_params, &asn1_params, sizeof(native_params)));
+        EXPECT_EQ(body_offset + native_size, wsm_size);
+        EXPECT_TRUE(!memcmp(wsm + body_offset, asn1_outbuf, native_size));
+        EXPECT_TRUE(!memcmp(wsm + body_offset, payload, native_size));
+      }
+    }
+  }
+}
+
+
+/*
+ * 4) 잘린 WSM, 변조된 WSM 에 대한 디코딩 에러코드 동일성 확인
+ */
+TEST(dot3_WsmpCodec, DECODE_ERROR_EQUIVALENCE)
+{
+  Dot3_Init(kDot3LogLevel_none);
+
+  struct Dot3WsmMpduTxParams tx_params;
+  struct Dot3WsmMpduRxParams params;
+  uint8_t payload[200] = {0};
+  uint8_t wsm[kMpduMaxSize], mutated[kMpduMaxSize], outbuf[kMpduMaxSize];
+  Dot3PduSize body_offset;
+
+  FillTxParams(&tx_params, 7, kDot3Psid_Max);
+  int wsm_size = dot3_FFAsn1c_EncodeWsm(&tx_params, payload, sizeof(payload), wsm, sizeof(wsm));
+  ASSERT_GT(wsm_size, 0);
+
+  /*
+   * 잘린 WSM - 모든 길이에서 실패해야 한다.
+   */
+  for (int len = 0; len < wsm_size; len++) {
+    int native_ret = dot3_DecodeWsmpHdr(wsm, len, &params, &body_offset);
+    int asn1_ret = dot3_FFAsn1c_DecodeWsm(wsm, len, outbuf, sizeof(outbuf), &params);
+    EXPECT_LT(native_ret, 0) << "len " << len;
+    EXPECT_LT(asn1_ret, 0) << "len " << len;
+  }
+
+  /*
+   * 헤더 바이트 변조 - 결과(성공 시 페이로드길이, 실패 시 에러코드)가 동일해야 한다.
+   */
+  int hdr_size = wsm_size - (int)sizeof(payload) - 2;
+  for (int pos = 0; pos < hdr_size; pos++) {
+    for (int val = 0; val < 256; val++) {
+      memcpy(mutated, wsm, wsm_size);
+      mutated[pos] = (uint8_t)val;
+      struct Dot3WsmMpduRxParams native_params = {}, asn1_params = {};
+      int native_ret = dot3_DecodeWsmpHdr(mutated, wsm_size, &native_params, &body_offset);
+      int asn1_ret = dot3_FFAsn1c_DecodeWsm(mutated, wsm_size, outbuf, sizeof(outbuf), &asn1_params);
+      if ((native_ret >= 0) || (asn1_ret >= 0)) {
+        EXPECT_EQ(native_ret, asn1_ret) << "pos " << pos << " val " << val;
+        EXPECT_TRUE(!memcmp(&native_params, &asn1_params, sizeof(native_params))) << "pos " << pos << " val " << val;
+      }
+    }
+  }
+}
+#endif
@@ -216,6 +216,23 @@ void Al_RegisterCallbackRxMpdu(
     const AlMpduSize mpdu_size,
     const struct AlMpduRxParams *const rxparams));
 
+/**
+ * @brief MPDU 일괄 수신처리 콜백함수를 등록한다.
+ * @param ProcessRxMpduBatchCallback 콜백함수 포인터 (NULL 이면 등록 해제)
+ *
+ * 액세스계층은 이벤트 폴링 시점에 디바이스에 쌓여 있는 수신 MPDU 들을 모아(최대 kAlRxBatch_MaxNum 개)
+ * 한 번의 콜백함수 호출로 전달한다. 수신율이 높은 경우 MPDU 당 콜백 호출 및 처리 비용을 줄이기 위해 사용한다.
+ * 본 콜백함수가 등록되어 있으면 Al_RegisterCallbackRxMpdu() 로 등록된 콜백함수는 호출되지 않는다.
+ *
+ * 콜백함수의 각 파라미터의 의미는 다음과 같다.
+ *   - mpdus : 수신된 MPDU 정보 배열 (수신 순서)
+ *   - num : 수신된 MPDU 개수 (1 ~ kAlRxBatch_MaxNum)
+ *
+ * 전달된 MPDU 및 수신패킷정보는 콜백함수가 종료되면 삭제되므로, 나중에 사용하려면 복사해 두어야 한다.
+ */
+void Al_RegisterCallbackRxMpduBatch(
+  void (*ProcessRxMpduBatchCallback)(const struct AlRxMpdu *const mpdus, const unsigned int num));
+
 /**
  * @brief TimeSlot1 -> TimeSlot0 시점에 호출될 콜백함수를 등록한다.
  * @param ProcessTimeSlot0EventCallback 콜백함수 포인터
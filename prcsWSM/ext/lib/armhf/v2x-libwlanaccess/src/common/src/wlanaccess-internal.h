@@ -110,6 +110,29 @@ struct AlPlatform {
   void (*ProcessRxMpduCallback)(const uint8_t *const mpdu,
                                 const AlMpduSize mpdu_size,
                                 const struct AlMpduRxParams *const rxparams);
+
+  /// @brief 수신 MPDU 일괄 전달 콜백함수 포인터. 등록되어 있으면 ProcessRxMpduCallback 대신 호출된다.
+  /// @param mpdus 수신 MPDU 정보 배열
+  /// @param num 수신 MPDU 개수
+  void (*ProcessRxMpduBatchCallback)(const struct AlRxMpdu *const mpdus, const unsigned int num);
+
+  /// @brief 일괄 전달 대기 중인 수신 MPDU 들 (폴링 쓰레드에서만 접근한다)
+  struct {
+    struct AlRxMpdu mpdu[kAlRxBatch_MaxNum];
+    void (*release[kAlRxBatch_MaxNum])(void *arg); ///< 전달 후 MPDU 버퍼 해제 함수 (NULL 이면 해제 불필요)
+    void *release_arg[kAlRxBatch_MaxNum];
+    unsigned int num;
+  } rx_batch;
+
+  /// @brief TimeSlot1 -> TimeSlot0 전환 이벤트 전달 콜백함수 포인터
+  void (*ProcessTimeSlot0EventCallback)(void);
+
+  /// @brief TimeSlot0 -> TimeSlot1 전환 이벤트 전달 콜백함수 포인터
+  void (*ProcessTimeSlot1EventCallback)(void);
+
+  /// @brief 에러 이벤트 전달 콜백함수 포인터
+  /// @param err 에러코드
+  void (*ProcessErrorEventCallback)(const AlErrorCode err);
 };
 
 /**
@@ -140,6 +163,14 @@ uint16_t INTERNAL al_ConvertChannelNumberToFreq(const AlChannel chan);
 uint8_t INTERNAL al_GetChannelNumberBandwidth(const AlChannel channel);
 void INTERNAL al_PrintLog(const char *dev, const char *func, const char *format, ...);
 void INTERNAL al_PrintPacketDump(const uint8_t *const pkt, const uint32_t pkt_size);
+void INTERNAL al_RxMpdu(
+  struct AlPlatform *const platform,
+  const uint8_t *const mpdu,
+  const AlMpduSize mpdu_size,
+  const struct AlMpduRxParams *const rxparams,
+  void (*release)(void *arg),
+  void *release_arg);
+void INTERNAL al_FlushRxMpdus(struct AlPlatform *const platform);
 
 
 #endif //LIBWLANACCESS_WLANACCESS_INTERNAL_H
@@ -189,6 +189,105 @@ void OPEN_API Al_RegisterCallbackRxMpdu(
 }
 
 
+/**
+ * @copydoc Al_RegisterCallbackRxMpduBatch
+ */
+void OPEN_API Al_RegisterCallbackRxMpduBatch(
+  void (*ProcessRxMpduBatchCallback)(const struct AlRxMpdu *const mpdus, const unsigned int num))
+{
+  g_al_platform.ProcessRxMpduBatchCallback = ProcessRxMpduBatchCallback;
+}
+
+
+/**
+ * @copydoc Al_RegisterCallbackTimeSlot0Event
+ */
+void OPEN_API Al_RegisterCallbackTimeSlot0Event(void (*ProcessTimeSlot0EventCallback)(void))
+{
+  g_al_platform.ProcessTimeSlot0EventCallback = ProcessTimeSlot0EventCallback;
+}
+
+
+/**
+ * @copydoc Al_RegisterCallbackTimeSlot1Event
+ */
+void OPEN_API Al_RegisterCallbackTimeSlot1Event(void (*ProcessTimeSlot1EventCallback)(void))
+{
+  g_al_platform.ProcessTimeSlot1EventCallback = ProcessTimeSlot1EventCallback;
+}
+
+
+/**
+ * @copydoc Al_RegisterCallbackErrorEvent
+ */
+void OPEN_API Al_RegisterCallbackErrorEvent(void (*ProcessErrorEventCallback)(const AlErrorCode err))
+{
+  g_al_platform.ProcessErrorEventCallback = ProcessErrorEventCallback;
+}
+
+
+/**
+ * @copydoc Al_GetTxStatistics
+ *
+ * 통계정보는 인터페이스/타임슬롯 별로 저장되며, 현재는 TimeSlot0 항목을 인터페이스의 통계정보로 반환한다.
+ */
+int OPEN_API Al_GetTxStatistics(const AlIfIndex ifindex, struct AlTxStatstics *const stats)
+{
+  if (ifindex >= _V2X_IF_NUM_) {
+    return -kAlResult_InvalidIfIndex;
+  }
+  if (stats == NULL) {
+    return -kAlResult_NullParameters;
+  }
+  memcpy(stats, &(g_al_platform.txstats[ifindex][kAlTimeSlot_0]), sizeof(struct AlTxStatstics));
+  return kAlResult_Success;
+}
+
+
+/**
+ * @copydoc Al_ClearTxStatistics
+ */
+int OPEN_API Al_ClearTxStatistics(const AlIfIndex ifindex)
+{
+  if (ifindex >= _V2X_IF_NUM_) {
+    return -kAlResult_InvalidIfIndex;
+  }
+  memset(g_al_platform.txstats[ifindex], 0, sizeof(g_al_platform.txstats[ifindex]));
+  return kAlResult_Success;
+}
+
+
+/**
+ * @copydoc Al_GetRxStatistics
+ *
+ * 통계정보는 인터페이스/타임슬롯 별로 저장되며, 현재는 TimeSlot0 항목을 인터페이스의 통계정보로 반환한다.
+ */
+int OPEN_API Al_GetRxStatistics(const AlIfIndex ifindex, struct AlRxStatstics *const stats)
+{
+  if (ifindex >= _V2X_IF_NUM_) {
+    return -kAlResult_InvalidIfIndex;
+  }
+  if (stats == NULL) {
+    return -kAlResult_NullParameters;
+  }
+  memcpy(stats, &(g_al_platform.rxstats[ifindex][kAlTimeSlot_0]), sizeof(struct AlRxStatstics));
+  return kAlResult_Success;
+}
+
+
+/**
+ * @copydoc Al_ClearRxStatistics
+ */
+int OPEN_API Al_ClearRxStatistics(const AlIfIndex ifindex)
+{
+  if (ifindex >= _V2X_IF_NUM_) {
+    return -kAlResult_InvalidIfIndex;
+  }
+  memset(g_al_platform.rxstats[ifindex], 0, sizeof(g_al_platform.rxstats[ifindex]));
+  return kAlResult_Success;
+}
+
+
 /**
  * @brief 0.5dBm 단위의 수신파워를 RCPI 값으로 변환한다.
  * @param rxpower 수신파워(0.5dBm 단위)
@@ -294,3 +393,72 @@ void INTERNAL al_PrintPacketDump(const uint8_t *const pkt, const uint32_t pkt_si
   }
   printf("\n");
 }
+
+
+/**
+ * @brief 수신된 MPDU 를 어플리케이션으로 전달한다. 각 플랫폼의 수신처리 함수에서 호출된다.
+ * @param platform 액세스계층 플랫폼 정보
+ * @param mpdu 수신 MPDU
+ * @param mpdu_size 수신 MPDU 크기
+ * @param rxparams 수신 파라미터 정보
+ * @param release MPDU 버퍼 해제 함수 (NULL 이면 해제하지 않는다)
+ * @param release_arg MPDU 버퍼 해제 함수의 인자
+ *
+ * 일괄 수신처리 콜백함수가 등록되어 있지 않으면, 수신처리 콜백함수를 바로 호출한 후 MPDU 버퍼를 해제한다.
+ * 등록되어 있으면, MPDU 를 일괄 전달 목록에 추가하고 al_FlushRxMpdus() 호출 시에 전달/해제한다.
+ * (목록이 가득 차면 먼저 전달한다) 따라서 MPDU 버퍼는 al_FlushRxMpdus() 호출 전까지 유효해야 한다.
+ */
+void INTERNAL al_RxMpdu(
+  struct AlPlatform *const platform,
+  const uint8_t *const mpdu,
+  const AlMpduSize mpdu_size,
+  const struct AlMpduRxParams *const rxparams,
+  void (*release)(void *arg),
+  void *release_arg)
+{
+  if (platform->ProcessRxMpduBatchCallback == NULL) {
+    if (platform->ProcessRxMpduCallback) {
+      platform->ProcessRxMpduCallback(mpdu, mpdu_size, rxparams);
+    } else {
+      Log(kAlLogLevel_event, "  No rx MPDU callback function\n");
+    }
+    if (release) {
+      release(release_arg);
+    }
+    return;
+  }
+
+  if (platform->rx_batch.num >= kAlRxBatch_MaxNum) {
+    al_FlushRxMpdus(platform);
+  }
+  unsigned int n = platform->rx_batch.num++;
+  platform->rx_batch.mpdu[n].mpdu = mpdu;
+  platform->rx_batch.mpdu[n].mpdu_size = mpdu_size;
+  platform->rx_batch.mpdu[n].rxparams = *rxparams;
+  platform->rx_batch.release[n] = release;
+  platform->rx_batch.release_arg[n] = release_arg;
+}
+
+
+/**
+ * @brief 일괄 전달 목록에 쌓인 수신 MPDU 들을 일괄 수신처리 콜백함수로 전달한 후 MPDU 버퍼들을 해제한다.
+ * @param platform 액세스계층 플랫폼 정보
+ *
+ * 각 플랫폼의 이벤트 폴링 함수에서, 폴링된 수신 MPDU 들을 모두 처리한 후(또는 MPDU 버퍼를 재사용하기 전에) 호출한다.
+ */
+void INTERNAL al_FlushRxMpdus(struct AlPlatform *const platform)
+{
+  unsigned int num = platform->rx_batch.num;
+  if (num == 0) {
+    return;
+  }
+  if (platform->ProcessRxMpduBatchCallback) {
+    platform->ProcessRxMpduBatchCallback(platform->rx_batch.mpdu, num);
+  }
+  for (unsigned int i = 0; i < num; i++) {
+    if (platform->rx_batch.release[i]) {
+      platform->rx_batch.release[i](platform->rx_batch.release_arg[i]);
+    }
+  }
+  platform->rx_batch.num = 0;
+}
@@ -0,0 +1,644 @@
+/**
+ * @file fake.c
+ * @date 2026-10-19
+ * @author gyun
+ * @brief 하드웨어 없이 동작하는 모의(fake) 플랫폼 구현 파일
+ *
+ * 리눅스 PC 등 V2X 칩디바이스가 없는 환경에서 어플리케이션의 송수신 성능을 측정하거나 시험하기 위해 사용된다.
+ * 설정은 환경변수(fake.h 참조)로 지정한다.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "wlanaccess-internal.h"
+
+#include "fake.h"
+
+
+struct FakePlatform g_al_fake_platform; ///< 모의 플랫폼 정보
+
+/// 모의 수신 MPDU 의 송신지 MAC 주소 (마지막 바이트에 수신 일련번호가 채워진다)
+static const AlMacAddress kFakeRxSrcMacAddr = { 0x02, 0x46, 0x41, 0x4B, 0x45, 0x00 };
+
+/// 모의 수신 MPDU 의 수신파워 (0.5dBm 단위)
+#define FAKE_RX_POWER (-120)
+/// 모의 수신 MPDU 의 데이터레이트 (500kbps 단위)
+#define FAKE_RX_DATARATE (12)
+/// 채널에 접속하지 않은 인터페이스의 모의 수신 채널번호
+#define FAKE_RX_DEFAULT_CHANNEL (172)
+
+
+/**
+ * 현재 시각을 반환한다.
+ *
+ * @return CLOCK_MONOTONIC 시각 (나노초)
+ */
+static inline uint64_t al_Fake_GetTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * 환경변수로 지정된 정수 설정값을 읽는다.
+ *
+ * @param name  환경변수 이름
+ * @param def   환경변수가 없을 때의 기본값
+ * @return      설정값
+ */
+static uint32_t al_Fake_GetEnvU32(const char *name, const uint32_t def)
+{
+  const char *str = getenv(name);
+  if ((str == NULL) || (*str == '\0')) {
+    return def;
+  }
+  return (uint32_t)strtoul(str, NULL, 0);
+}
+
+
+/**
+ * 모의 플랫폼 이벤트를 이벤트 큐에 넣는다. 이벤트는 요청 순서대로 폴링 쓰레드에서 전달된다.
+ *
+ * @param ev    이벤트
+ * @return      성공시 0, 큐가 가득 찬 경우 -kAlResult_NoMemory
+ */
+static int al_Fake_PushEvent(const struct FakeEvent *const ev)
+{
+  struct FakePlatform *fake = &g_al_fake_platform;
+
+  pthread_mutex_lock(&fake->mtx);
+  if ((fake->ev_tail - fake->ev_head) >= FAKE_EVENT_QUEUE_SIZE) {
+    pthread_mutex_unlock(&fake->mtx);
+    Err("Fail to push event %u - event queue is full\n", ev->type);
+    return -kAlResult_NoMemory;
+  }
+  fake->ev[fake->ev_tail & (FAKE_EVENT_QUEUE_SIZE - 1)] = *ev;
+  fake->ev_tail++;
+  pthread_cond_signal(&fake->cond);
+  pthread_mutex_unlock(&fake->mtx);
+  return kAlResult_Success;
+}
+
+
+/**
+ * 모의 플랫폼의 MPDU 전송 함수 구현부.
+ * 실제 전송하지 않고, 설정된 지연시간 후에 송신결과 콜백이 호출되도록 이벤트를 넣는다.
+ *
+ * @param priv          @ref TransmitMpdu
+ * @param ifindex       @ref TransmitMpdu
+ * @param mpdu          @ref TransmitMpdu
+ * @param mpdu_size     @ref TransmitMpdu
+ * @param txparams      @ref TransmitMpdu
+ * @return              @ref TransmitMpdu
+ *
+ * 채널접속 여부는 확인하지 않는다. (채널접속 없이 송신하는 어플리케이션도 시험할 수 있도록)
+ */
+static int al_Fake_TransmitMpdu(
+  const void *const priv,
+  const AlIfIndex ifindex,
+  const uint8_t *const mpdu,
+  const AlMpduSize mpdu_size,
+  const struct AlMpduTxParams *const txparams)
+{
+  struct FakePlatform *fake = (struct FakePlatform *)priv;
+
+  Log(kAlLogLevel_event, "Transmitting MPDU - ifindex: %u, mpdu_size: %u\n", ifindex, mpdu_size);
+
+  if (!mpdu || !txparams) {
+    Err("Fail to transmit MPDU. null parameters - mpdu: %p, txparams: %p\n", mpdu, txparams);
+    return -kAlResult_NullParameters;
+  }
+  if (ifindex >= fake->if_num) {
+    Err("Fail to transmit MPDU. Invalid ifindex: %u\n", ifindex);
+    return -kAlResult_InvalidIfIndex;
+  }
+  if ((mpdu_size < kAlMpduMinSize) || (mpdu_size > kAlMpduMaxSize)) {
+    Err("Fail to transmit MPDU. Invalid mpdu_size: %u\n", mpdu_size);
+    return -kAlResult_InvalidMpduSize;
+  }
+  if (txparams->timeslot > kAlTimeSlot_max) {
+    Err("Fail to transmit MPDU. Invalid timeslot: %u\n", txparams->timeslot);
+    return -kAlResult_InvalidTimeSlot;
+  }
+  if (g_al_log >= kAlLogLevel_dump) {
+    al_PrintPacketDump(mpdu, mpdu_size);
+  }
+
+  /*
+   * 송신결과를 결정한다.
+   *  - 송신지연시간이 유효기간보다 길면 만기로 실패한다.
+   *  - 그 외에는 설정된 확률로 실패한다.
+   */
+  struct FakeEvent ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.type = kFakeEvent_TxResult;
+  ev.ifindex = ifindex;
+  ev.result = kAlTxResult_Success;
+  ev.due = al_Fake_GetTime() + ((uint64_t)fake->tx_latency * 1000ULL);
+  if (txparams->expiry && (fake->tx_latency > txparams->expiry)) {
+    ev.result = kAlTxResult_DevSpecificErr;
+    ev.errcode = kFakeTxErr_Expired;
+  } else if (fake->tx_fail_permil) {
+    pthread_mutex_lock(&fake->mtx);
+    uint32_t r = (uint32_t)rand_r(&fake->rand_seed) % 1000;
+    pthread_mutex_unlock(&fake->mtx);
+    if (r < fake->tx_fail_permil) {
+      ev.result = kAlTxResult_DevSpecificErr;
+      ev.errcode = kFakeTxErr_Random;
+    }
+  }
+  return al_Fake_PushEvent(&ev);
+}
+
+
+/**
+ * 모의 플랫폼의 채널접속 함수 구현부.
+ *
+ * @param priv          @ref AccessChannel
+ * @param ifindex       @ref AccessChannel
+ * @param ts0_chan      @ref AccessChannel
+ * @param ts1_chan      @ref AccessChannel
+ * @return              @ref AccessChannel
+ */
+static int al_Fake_AccessChannel(
+  const void *const priv,
+  const AlIfIndex ifindex,
+  const AlChannel ts0_chan,
+  const AlChannel ts1_chan)
+{
+  struct FakePlatform *fake = (struct FakePlatform *)priv;
+
+  Log(kAlLogLevel_config, "Accessing channel - ifindex: %u, ts0_chan: %u, ts1_chan: %u\n", ifindex, ts0_chan, ts1_chan);
+
+  if (ifindex >= fake->if_num) {
+    Err("Fail to access channel. Invalid ifindex: %u\n", ifindex);
+    return -kAlResult_InvalidIfIndex;
+  }
+
+  pthread_mutex_lock(&fake->mtx);
+  fake->ifs[ifindex].chan[kAlTimeSlot_0] = ts0_chan;
+  fake->ifs[ifindex].chan[kAlTimeSlot_1] = ts1_chan;
+  pthread_mutex_unlock(&fake->mtx);
+
+  struct FakeEvent ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.type = kFakeEvent_AccessChannelResult;
+  ev.ifindex = ifindex;
+  ev.due = al_Fake_GetTime() + ((uint64_t)fake->tx_latency * 1000ULL);
+  return al_Fake_PushEvent(&ev);
+}
+
+
+/**
+ * 모의 플랫폼의 접속채널확인 함수 구현부.
+ *
+ * @param priv          @ref GetCurrentChannel
+ * @param ifindex       @ref GetCurrentChannel
+ * @param ts0_chan      @ref GetCurrentChannel
+ * @param ts1_chan      @ref GetCurrentChannel
+ * @return              @ref GetCurrentChannel
+ */
+static int al_Fake_GetCurrentChannel(
+  const void *const priv,
+  const AlIfIndex ifindex,
+  AlChannel *const ts0_chan,
+  AlChannel *const ts1_chan)
+{
+  struct FakePlatform *fake = (struct FakePlatform *)priv;
+
+  if (!ts0_chan || !ts1_chan) {
+    return -kAlResult_NullParameters;
+  }
+  if (ifindex >= fake->if_num) {
+    Err("Fail to get current channel. Invalid ifindex: %u\n", ifindex);
+    return -kAlResult_InvalidIfIndex;
+  }
+
+  pthread_mutex_lock(&fake->mtx);
+  *ts0_chan = fake->ifs[ifindex].chan[kAlTimeSlot_0];
+  *ts1_chan = fake->ifs[ifindex].chan[kAlTimeSlot_1];
+  pthread_mutex_unlock(&fake->mtx);
+  return kAlResult_Success;
+}
+
+
+/**
+ * 모의 플랫폼의 채널접속해제 함수 구현부.
+ *
+ * @param priv          @ref ReleaseChannel
+ * @param ifindex       @ref ReleaseChannel
+ * @param timeslot      @ref ReleaseChannel
+ * @return              @ref ReleaseChannel
+ */
+static int al_Fake_ReleaseChannel(const void *const priv, const AlIfIndex ifindex, const AlTimeSlot timeslot)
+{
+  struct FakePlatform *fake = (struct FakePlatform *)priv;
+
+  if (ifindex >= fake->if_num) {
+    Err("Fail to release channel. Invalid ifindex: %u\n", ifindex);
+    return -kAlResult_InvalidIfIndex;
+  }
+  if (timeslot > kAlTimeSlot_max) {
+    Err("Fail to release channel. Invalid timeslot: %u\n", timeslot);
+    return -kAlResult_InvalidTimeSlot;
+  }
+
+  pthread_mutex_lock(&fake->mtx);
+  if (timeslot != kAlTimeSlot_1) {
+    fake->ifs[ifindex].chan[kAlTimeSlot_0] = 0;
+  }
+  if (timeslot != kAlTimeSlot_0) {
+    fake->ifs[ifindex].chan[kAlTimeSlot_1] = 0;
+  }
+  pthread_mutex_unlock(&fake->mtx);
+  return kAlResult_Success;
+}
+
+
+/**
+ * 모의 플랫폼의 MAC 주소 설정 함수 구현부.
+ *
+ * @param priv          @ref SetIfMacAddress
+ * @param ifindex       @ref SetIfMacAddress
+ * @param addr          @ref SetIfMacAddress
+ * @return              @ref SetIfMacAddress
+ */
+static int al_Fake_SetIfMacAddress(const void *const priv, const AlIfIndex ifindex, const AlMacAddress addr)
+{
+  struct FakePlatform *fake = (struct FakePlatform *)priv;
+
+  if (!addr) {
+    return -kAlResult_NullParameters;
+  }
+  if (ifindex >= fake->if_num) {
+    Err("Fail to set MAC address. Invalid ifindex: %u\n", ifindex);
+    return -kAlResult_InvalidIfIndex;
+  }
+
+  pthread_mutex_lock(&fake->mtx);
+  memcpy(fake->ifs[ifindex].addr, addr, sizeof(AlMacAddress));
+  pthread_mutex_unlock(&fake->mtx);
+
+  struct FakeEvent ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.type = kFakeEvent_SetIfMacAddressResult;
+  ev.ifindex = ifindex;
+  ev.due = al_Fake_GetTime() + ((uint64_t)fake->tx_latency * 1000ULL);
+  return al_Fake_PushEvent(&ev);
+}
+
+
+/**
+ * 1609.3 p-encoding 형식으로 PSID 를 인코딩한다.
+ *
+ * @param psid      PSID
+ * @param buf       인코딩된 PSID 가 저장될 버퍼 (최소 4바이트)
+ * @return          인코딩된 길이
+ */
+static int al_Fake_EncodePsid(const uint32_t psid, uint8_t *const buf)
+{
+  if (psid < 0x80) {
+    buf[0] = (uint8_t)psid;
+    return 1;
+  } else if (psid < 0x4080) {
+    uint32_t v = psid - 0x80;
+    buf[0] = (uint8_t)(0x80 | (v >> 8));
+    buf[1] = (uint8_t)v;
+    return 2;
+  } else if (psid < 0x204080) {
+    uint32_t v = psid - 0x4080;
+    buf[0] = (uint8_t)(0xC0 | (v >> 16));
+    buf[1] = (uint8_t)(v >> 8);
+    buf[2] = (uint8_t)v;
+    return 3;
+  }
+  uint32_t v = psid - 0x204080;
+  buf[0] = (uint8_t)(0xE0 | ((v >> 24) & 0x0F));
+  buf[1] = (uint8_t)(v >> 16);
+  buf[2] = (uint8_t)(v >> 8);
+  buf[3] = (uint8_t)v;
+  return 4;
+}
+
+
+/**
+ * 모의 수신 MPDU 템플릿을 생성한다.
+ *  - QoS Data MAC 헤더(브로드캐스트) + LLC(0x88DC) + WSMP v3 헤더(확장필드 없음) + WSM body
+ *
+ * @param tmpl          템플릿이 저장될 정보구조체
+ * @param psid          WSM PSID
+ * @param body_size     WSM body 길이
+ * @return              성공시 0, 실패시 -1
+ */
+static int al_Fake_BuildRxTemplate(struct FakeRxTemplate *const tmpl, const uint32_t psid, const uint32_t body_size)
+{
+  uint8_t *p = tmpl->mpdu;
+
+  if ((body_size > 0x3FFF) ||
+      (body_size + kAlMacQoSHeaderSize + 2/*LLC*/ + 2/*N-Header+TPID*/ + 4/*PSID*/ + 2/*Length*/ > kAlMpduMaxSize)) {
+    return -1;
+  }
+
+  /* QoS Data MAC 헤더 - FC, Duration, Addr1(브로드캐스트), Addr2, Addr3(wildcard BSSID), SeqCtrl, QoSCtrl */
+  memset(p, 0, kAlMacQoSHeaderSize);
+  p[0] = 0x88;
+  memset(p + 4, 0xff, sizeof(AlMacAddress));
+  memcpy(p + 10, kFakeRxSrcMacAddr, sizeof(AlMacAddress));
+  memset(p + 16, 0xff, sizeof(AlMacAddress));
+  p[24] = 0x20 | 0x05; // NoAck, UP=5
+  p += kAlMacQoSHeaderSize;
+
+  /* LLC 헤더 - EtherType */
+  *p++ = 0x88;
+  *p++ = 0xDC;
+
+  /* WSMP N-Header(version 3, 확장필드 없음), TPID */
+  *p++ = 0x03;
+  *p++ = 0x00;
+
+  /* WSMP T-Header - PSID, Length */
+  p += al_Fake_EncodePsid(psid, p);
+  if (body_size < 0x80) {
+    *p++ = (uint8_t)body_size;
+  } else {
+    *p++ = (uint8_t)(0x80 | (body_size >> 8));
+    *p++ = (uint8_t)body_size;
+  }
+
+  /* WSM body */
+  for (uint32_t i = 0; i < body_size; i++) {
+    *p++ = (uint8_t)i;
+  }
+  tmpl->mpdu_size = (AlMpduSize)(p - tmpl->mpdu);
+  return 0;
+}
+
+
+/**
+ * 환경변수에 지정된 길이분포로 모의 수신 MPDU 템플릿들을 생성한다.
+ *
+ * @param fake  모의 플랫폼 정보
+ */
+static void al_Fake_LoadRxTemplates(struct FakePlatform *const fake)
+{
+  const char *str = getenv(FAKE_ENV_RX_SIZES);
+  char buf[128];
+  char *saveptr, *tok;
+
+  snprintf(buf, sizeof(buf), "%s", ((str != NULL) && (*str != '\0')) ? str : "100,300,1000");
+  fake->rx_tmpl_num = 0;
+  for (tok = strtok_r(buf, ",", &saveptr);
+       (tok != NULL) && (fake->rx_tmpl_num < FAKE_RX_SIZE_MAX_NUM);
+       tok = strtok_r(NULL, ",", &saveptr)) {
+    uint32_t size = (uint32_t)strtoul(tok, NULL, 0);
+    if (al_Fake_BuildRxTemplate(&fake->rx_tmpl[fake->rx_tmpl_num], fake->rx_psid, size) < 0) {
+      Err("Ignore invalid rx size %u\n", size);
+      continue;
+    }
+    fake->rx_tmpl_num++;
+  }
+}
+
+
+/**
+ * 한 인터페이스에 대해 MPDU 수신을 모사한다. 길이분포의 각 항목이 순서대로 사용된다.
+ * 일괄 수신처리 시에는 같은 템플릿을 사용한 MPDU 들이 버퍼를 공유하므로 송신지 MAC 주소가 같아질 수 있다.
+ *
+ * @param fake      모의 플랫폼 정보
+ * @param ifindex   수신 인터페이스 식별번호
+ */
+static void al_Fake_InjectRxMpdu(struct FakePlatform *const fake, const AlIfIndex ifindex)
+{
+  struct FakeInterface *fif = &fake->ifs[ifindex];
+  struct FakeRxTemplate *tmpl = &fake->rx_tmpl[fif->rx_seq % fake->rx_tmpl_num];
+  struct AlMpduRxParams rxparams;
+
+  tmpl->mpdu[15] = (uint8_t)fif->rx_seq; // 송신지 MAC 주소 마지막 바이트
+  fif->rx_seq++;
+
+  AlTimeSlot slot = fake->timeslot_enable ? fake->cur_slot : kAlTimeSlot_0;
+  rxparams.ifindex = ifindex;
+  rxparams.timeslot = slot;
+  rxparams.channel = fif->chan[slot] ? fif->chan[slot] : FAKE_RX_DEFAULT_CHANNEL;
+  rxparams.rxpower = FAKE_RX_POWER;
+  rxparams.rcpi = al_ConvertRxPowerToRcpi(FAKE_RX_POWER);
+  rxparams.datarate = FAKE_RX_DATARATE;
+
+  al_RxMpdu(fake->parent, tmpl->mpdu, tmpl->mpdu_size, &rxparams, NULL, NULL);
+}
+
+
+/**
+ * 전달시각이 된 이벤트의 콜백함수를 호출한다.
+ *
+ * @param fake  모의 플랫폼 정보
+ * @param ev    이벤트
+ */
+static void al_Fake_DispatchEvent(struct FakePlatform *const fake, const struct FakeEvent *const ev)
+{
+  struct AlPlatform *platform = fake->parent;
+
+  switch (ev->type) {
+    case kFakeEvent_TxResult:
+      if (platform->ProcessTransmitResultCallback) {
+        platform->ProcessTransmitResultCallback(ev->result, ev->errcode);
+      }
+      break;
+    case kFakeEvent_AccessChannelResult:
+      if (platform->ProcessAccessChannelResultCallback) {
+        platform->ProcessAccessChannelResultCallback(ev->ifindex);
+      }
+      break;
+    case kFakeEvent_SetIfMacAddressResult:
+      if (platform->ProcessSetIfMacAddressResultCallback) {
+        platform->ProcessSetIfMacAddressResultCallback(ev->ifindex);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+
+/**
+ * 모의 플랫폼의 이벤트 폴링 함수 구현부. 리턴하지 않는다.
+ *  - 전달시각이 된 이벤트(송신결과, 채널접속결과, MAC주소설정결과)를 전달한다.
+ *  - 설정된 속도로 MPDU 수신을 모사한다. (밀린 경우 한 루프에 최대 FAKE_RX_BURST_MAX_NUM 개까지 몰아서 전달한다)
+ *  - TimeSlot 전환 이벤트를 전달한다.
+ *  - 다음 이벤트 시각까지 대기한다. (대기 중에 새 이벤트가 들어오면 깨어난다)
+ *
+ * @param priv  모의 플랫폼 정보
+ */
+static void al_Fake_PollEvent(const void *const priv)
+{
+  struct FakePlatform *fake = (struct FakePlatform *)priv;
+  struct FakeEvent ev[FAKE_RX_BURST_MAX_NUM];
+  uint64_t rx_interval = fake->rx_rate ? (1000000000ULL / fake->rx_rate) : 0;
+  uint64_t now, wakeup;
+  struct timespec ts;
+  int ev_num;
+
+  now = al_Fake_GetTime();
+  fake->next_slot = now + (FAKE_TIMESLOT_INTERVAL * 1000ULL);
+  for (int i = 0; i < fake->if_num; i++) {
+    fake->ifs[i].next_rx = now;
+  }
+
+  while (1) {
+
+    /*
+     * 전달시각이 된 이벤트를 꺼낸다. (콜백함수는 잠금을 해제한 후 호출한다)
+     */
+    pthread_mutex_lock(&fake->mtx);
+    now = al_Fake_GetTime();
+    ev_num = 0;
+    while ((fake->ev_head != fake->ev_tail) && (ev_num < FAKE_RX_BURST_MAX_NUM)) {
+      struct FakeEvent *head = &fake->ev[fake->ev_head & (FAKE_EVENT_QUEUE_SIZE - 1)];
+      if (head->due > now) {
+        break;
+      }
+      ev[ev_num++] = *head;
+      fake->ev_head++;
+    }
+    pthread_mutex_unlock(&fake->mtx);
+    for (int i = 0; i < ev_num; i++) {
+      al_Fake_DispatchEvent(fake, &ev[i]);
+    }
+
+    /*
+     * TimeSlot 전환 이벤트
+     */
+    if (fake->timeslot_enable && (now >= fake->next_slot)) {
+      fake->cur_slot = (fake->cur_slot == kAlTimeSlot_0) ? kAlTimeSlot_1 : kAlTimeSlot_0;
+      fake->next_slot += (FAKE_TIMESLOT_INTERVAL * 1000ULL);
+      if (fake->next_slot <= now) {
+        fake->next_slot = now + (FAKE_TIMESLOT_INTERVAL * 1000ULL);
+      }
+      if ((fake->cur_slot == kAlTimeSlot_0) && fake->parent->ProcessTimeSlot0EventCallback) {
+        fake->parent->ProcessTimeSlot0EventCallback();
+      } else if ((fake->cur_slot == kAlTimeSlot_1) && fake->parent->ProcessTimeSlot1EventCallback) {
+        fake->parent->ProcessTimeSlot1EventCallback();
+      }
+    }
+
+    /*
+     * MPDU 수신 모사
+     *  - 1초 이상 밀리면 밀린 만큼은 버리고 현재 시각부터 다시 시작한다.
+     */
+    if (rx_interval && fake->rx_tmpl_num) {
+      for (int i = 0; i < fake->if_num; i++) {
+        struct FakeInterface *fif = &fake->ifs[i];
+        if (!(fake->rx_if_mask & (1U << i))) {
+          continue;
+        }
+        if ((now > fif->next_rx) && ((now - fif->next_rx) > 1000000000ULL)) {
+          fif->next_rx = now;
+        }
+        for (int j = 0; (j < FAKE_RX_BURST_MAX_NUM) && (fif->next_rx <= now); j++) {
+          al_Fake_InjectRxMpdu(fake, (AlIfIndex)i);
+          fif->next_rx += rx_interval;
+        }
+      }
+      al_FlushRxMpdus(fake->parent);
+    }
+
+    /*
+     * 다음 이벤트 시각까지 대기한다.
+     */
+    wakeup = UINT64_MAX;
+    if (fake->timeslot_enable) {
+      wakeup = fake->next_slot;
+    }
+    if (rx_interval && fake->rx_tmpl_num) {
+      for (int i = 0; i < fake->if_num; i++) {
+        if ((fake->rx_if_mask & (1U << i)) && (fake->ifs[i].next_rx < wakeup)) {
+          wakeup = fake->ifs[i].next_rx;
+        }
+      }
+    }
+    pthread_mutex_lock(&fake->mtx);
+    if (fake->ev_head != fake->ev_tail) {
+      uint64_t due = fake->ev[fake->ev_head & (FAKE_EVENT_QUEUE_SIZE - 1)].due;
+      if (due < wakeup) {
+        wakeup = due;
+      }
+    }
+    now = al_Fake_GetTime();
+    if (wakeup == UINT64_MAX) {
+      pthread_cond_wait(&fake->cond, &fake->mtx);
+    } else if (wakeup > now) {
+      ts.tv_sec = (time_t)(wakeup / 1000000000ULL);
+      ts.tv_nsec = (long)(wakeup % 1000000000ULL);
+      pthread_cond_timedwait(&fake->cond, &fake->mtx, &ts);
+    }
+    pthread_mutex_unlock(&fake->mtx);
+  }
+}
+
+
+/**
+ * 모의 플랫폼을 초기화한다.
+ *
+ * @param platform  액세스계층 플랫폼 정보
+ * @param reset     사용되지 않음 (초기화할 하드웨어가 없다)
+ * @return          성공시 지원하는 인터페이스의 수, 실패시 음수(-AlResultCode)
+ */
+int INTERNAL al_PlatformInit(struct AlPlatform *const platform, const bool reset)
+{
+  struct FakePlatform *fake = &g_al_fake_platform;
+  pthread_condattr_t cond_attr;
+
+  (void)reset;
+  Log(kAlLogLevel_init, "Initializing fake platform\n");
+
+  /*
+   * 플랫폼 의존정보 등록
+   */
+  struct AlPlatformSpecificData *platform_data = &(platform->platform_data);
+  platform_data->priv = (void *)&g_al_fake_platform;
+  platform_data->TransmitMpdu = al_Fake_TransmitMpdu;
+  platform_data->AccessChannel = al_Fake_AccessChannel;
+  platform_data->GetCurrentChannel = al_Fake_GetCurrentChannel;
+  platform_data->ReleaseChannel = al_Fake_ReleaseChannel;
+  platform_data->SetIfMacAddress = al_Fake_SetIfMacAddress;
+  platform_data->PollEvent = al_Fake_PollEvent;
+
+  /*
+   * 모의 플랫폼 정보 초기화 - 설정은 환경변수로부터 읽는다.
+   */
+  memset(fake, 0, sizeof(struct FakePlatform));
+  fake->parent = platform;
+  fake->if_num = (uint8_t)al_Fake_GetEnvU32(FAKE_ENV_IF_NUM, _V2X_IF_NUM_);
+  if ((fake->if_num == 0) || (fake->if_num > _V2X_IF_NUM_)) {
+    Err("Fail to initialize fake platform - invalid %s: %u\n", FAKE_ENV_IF_NUM, fake->if_num);
+    return -kAlResult_InvalidIfNum;
+  }
+  fake->rx_rate = al_Fake_GetEnvU32(FAKE_ENV_RX_RATE, 0);
+  fake->rx_if_mask = al_Fake_GetEnvU32(FAKE_ENV_RX_IF_MASK, 0x1);
+  fake->rx_psid = al_Fake_GetEnvU32(FAKE_ENV_RX_PSID, 32);
+  fake->tx_latency = al_Fake_GetEnvU32(FAKE_ENV_TX_LATENCY, 100);
+  fake->tx_fail_permil = al_Fake_GetEnvU32(FAKE_ENV_TX_FAIL_PERMIL, 0);
+  fake->timeslot_enable = (al_Fake_GetEnvU32(FAKE_ENV_TIMESLOT, 1) != 0);
+  fake->rand_seed = (uint32_t)time(NULL);
+  fake->cur_slot = kAlTimeSlot_0;
+  al_Fake_LoadRxTemplates(fake);
+
+  pthread_mutex_init(&fake->mtx, NULL);
+  pthread_condattr_init(&cond_attr);
+  pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&fake->cond, &cond_attr);
+  pthread_condattr_destroy(&cond_attr);
+
+  Log(kAlLogLevel_init, "Success to initialize fake platform - %u interface is supported\n"
+                        "  rx_rate: %u/s, rx_if_mask: 0x%X, rx_psid: %u, rx_size_num: %u\n"
+                        "  tx_latency: %uusec, tx_fail: %u/1000, timeslot: %u\n",
+      fake->if_num, fake->rx_rate, fake->rx_if_mask, fake->rx_psid, fake->rx_tmpl_num,
+      fake->tx_latency, fake->tx_fail_permil, fake->timeslot_enable);
+  return fake->if_num;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file fake.h
+ * @date 2026-10-19
+ * @author gyun
+ * @brief 하드웨어 없이 동작하는 모의(fake) 플랫폼 정의 헤더파일
+ *
+ * 실제 칩디바이스 대신 프로세스 내에서 액세스계층 동작을 모사한다.
+ *  - 송신요청은 설정된 지연시간 후 송신결과 콜백으로 완료된다. (설정된 확률로 실패한다)
+ *  - 설정된 속도/길이분포로 WSM MPDU 수신을 모사한다.
+ *  - 50msec 주기로 TimeSlot 전환 이벤트를 발생시킨다.
+ * 모든 콜백은 Al_PollEvent() 를 호출한 쓰레드에서 호출된다.
+ */
+
+
+#ifndef LIBWLANACCESS_FAKE_H
+#define LIBWLANACCESS_FAKE_H
+
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "wlanaccess-internal.h"
+
+
+#define FAKE_EVENT_QUEUE_SIZE (4096)      ///< 이벤트 큐 크기 (2의 거듭제곱)
+#define FAKE_RX_SIZE_MAX_NUM (8)          ///< 수신 WSM body 길이분포 최대 항목 수
+#define FAKE_RX_BURST_MAX_NUM (64)        ///< 한 번의 폴링 루프에서 모사하는 최대 수신 개수
+#define FAKE_TIMESLOT_INTERVAL (50000)    ///< TimeSlot 전환 주기 (usec 단위)
+
+/*
+ * 환경변수로 지정하는 모의 플랫폼 설정
+ */
+#define FAKE_ENV_IF_NUM "AL_FAKE_IF_NUM"                  ///< 지원 인터페이스 개수 (기본: _V2X_IF_NUM_)
+#define FAKE_ENV_RX_RATE "AL_FAKE_RX_RATE"                ///< 인터페이스 별 초당 수신 MPDU 개수 (기본: 0=수신 모사 안함)
+#define FAKE_ENV_RX_IF_MASK "AL_FAKE_RX_IF_MASK"          ///< 수신을 모사할 인터페이스 비트맵 (기본: 0x1)
+#define FAKE_ENV_RX_SIZES "AL_FAKE_RX_SIZES"              ///< 수신 WSM body 길이분포 (쉼표로 구분, 기본: 100,300,1000)
+#define FAKE_ENV_RX_PSID "AL_FAKE_RX_PSID"                ///< 수신 WSM PSID (기본: 32)
+#define FAKE_ENV_TX_LATENCY "AL_FAKE_TX_LATENCY_US"       ///< 송신요청~송신결과 지연시간 (usec 단위, 기본: 100)
+#define FAKE_ENV_TX_FAIL_PERMIL "AL_FAKE_TX_FAIL_PERMIL"  ///< 송신 실패 확률 (1/1000 단위, 기본: 0)
+#define FAKE_ENV_TIMESLOT "AL_FAKE_TIMESLOT"              ///< TimeSlot 전환 이벤트 발생 여부 (기본: 1)
+
+/**
+ * @brief 모의 플랫폼의 송신실패 에러코드 (송신결과 콜백의 플랫폼 의존적 에러코드로 전달된다)
+ */
+enum eFakeTxErr {
+  kFakeTxErr_Random = 1,  ///< 설정된 실패 확률에 의한 실패
+  kFakeTxErr_Expired,     ///< 송신지연시간이 요청의 유효기간보다 길어 만기된 경우
+};
+
+/**
+ * @brief 모의 플랫폼 이벤트 종류
+ */
+enum eFakeEventType {
+  kFakeEvent_TxResult,
+  kFakeEvent_AccessChannelResult,
+  kFakeEvent_SetIfMacAddressResult,
+};
+typedef uint8_t FakeEventType; ///< @copydoc eFakeEventType
+
+/**
+ * @brief 지연되어 전달되는 이벤트
+ */
+struct FakeEvent {
+  FakeEventType type;
+  AlIfIndex ifindex;
+  AlTxResultCode result;
+  int errcode;
+  uint64_t due;       ///< 전달시각 (CLOCK_MONOTONIC, 나노초)
+};
+
+/**
+ * @brief 모의 인터페이스 정보
+ */
+struct FakeInterface {
+  AlChannel chan[2];  ///< TimeSlot 별 접속채널 (0=미접속)
+  AlMacAddress addr;  ///< MAC 주소
+  uint64_t next_rx;   ///< 다음 수신 모사 시각 (CLOCK_MONOTONIC, 나노초)
+  uint32_t rx_seq;    ///< 수신 모사 일련번호
+};
+
+/**
+ * @brief 수신 모사 MPDU 템플릿 (길이분포의 각 항목마다 하나씩 생성된다)
+ */
+struct FakeRxTemplate {
+  uint8_t mpdu[kAlMpduMaxSize];
+  AlMpduSize mpdu_size;
+};
+
+/**
+ * @brief 모의 플랫폼 정보
+ */
+struct FakePlatform {
+  struct AlPlatform *parent;  ///< 부모 플랫폼 정보
+  uint8_t if_num;             ///< 지원 인터페이스 개수
+
+  /* 설정 */
+  uint32_t rx_rate;
+  uint32_t rx_if_mask;
+  uint32_t rx_psid;
+  uint32_t tx_latency;
+  uint32_t tx_fail_permil;
+  bool timeslot_enable;
+
+  struct FakeInterface ifs[_V2X_IF_NUM_];
+  struct FakeRxTemplate rx_tmpl[FAKE_RX_SIZE_MAX_NUM];
+  uint8_t rx_tmpl_num;
+
+  AlTimeSlot cur_slot;        ///< 현재 TimeSlot
+  uint64_t next_slot;         ///< 다음 TimeSlot 전환 시각 (CLOCK_MONOTONIC, 나노초)
+
+  /* 이벤트 큐 - 요청 쓰레드가 넣고 폴링 쓰레드가 꺼낸다. */
+  pthread_mutex_t mtx;
+  pthread_cond_t cond;
+  struct FakeEvent ev[FAKE_EVENT_QUEUE_SIZE];
+  uint32_t ev_head;
+  uint32_t ev_tail;
+  uint32_t rand_seed;
+};
+
+
+extern struct FakePlatform g_al_fake_platform;
+
+
+#endif //LIBWLANACCESS_FAKE_H
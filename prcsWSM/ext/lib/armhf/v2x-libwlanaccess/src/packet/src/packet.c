@@ -0,0 +1,749 @@
+/**
+ * @file packet.c
+ * @date 2026-10-19
+ * @author gyun
+ * @brief 리눅스 네트워크 인터페이스(AF_PACKET) 플랫폼 구현 파일
+ *
+ * veth 쌍이나 실험실 스위치로 연결된 여러 RSU/OBU 인스턴스가 무선 하드웨어 없이 서로 통신할 수 있도록 한다.
+ * 설정은 환경변수(packet.h 참조)로 지정한다.
+ */
+
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "wlanaccess-internal.h"
+
+#include "packet.h"
+
+
+struct PacketPlatform g_al_packet_platform; ///< AF_PACKET 플랫폼 정보
+
+/// 송신 링 프레임 내 데이터(이더넷 헤더) 오프셋
+#define PACKET_TX_DATA_OFFSET (TPACKET_ALIGN(sizeof(struct tpacket3_hdr)))
+/// 송신 링 내 프레임 주소
+#define PACKET_TX_FRAME(fif, n) ((struct tpacket3_hdr *)((fif)->tx_ring + (((n) % PACKET_TX_FRAME_NUM) * PACKET_TX_FRAME_SIZE)))
+/// 송신 링 블록 크기 (블록 경계에 프레임이 걸치지 않도록 프레임 크기의 배수)
+#define PACKET_TX_BLOCK_SIZE (PACKET_TX_FRAME_SIZE * 16)
+/// 수신 링 블록 주소
+#define PACKET_RX_BLOCK(fif, n) ((struct tpacket_block_desc *)((fif)->rx_ring + ((n) * PACKET_RX_BLOCK_SIZE)))
+/// 알 수 없는 수신파워
+#define PACKET_RX_POWER_UNKNOWN (-32768)
+/// 측정되지 않은 RCPI (IEEE 802.11)
+#define PACKET_RCPI_UNKNOWN (255)
+
+/*
+ * 송신결과는 인터페이스와 상관없이 송신요청 순서대로 전달되어야 한다. (송신결과 콜백에는 인터페이스 식별번호가 없다)
+ * 따라서 송신요청 순서를 별도로 기록하고, 그 순서대로 각 인터페이스 송신 링의 완료 여부를 확인한다.
+ */
+#define PACKET_TX_ORDER_SIZE (PACKET_TX_FRAME_NUM * _V2X_IF_NUM_)
+static AlIfIndex g_packet_tx_order[PACKET_TX_ORDER_SIZE]; ///< 송신요청 순서 (인터페이스 식별번호)
+static uint32_t g_packet_tx_order_head, g_packet_tx_order_tail;
+
+
+/**
+ * 폴링 쓰레드를 깨운다.
+ *
+ * @param packet    플랫폼 정보
+ */
+static inline void al_Packet_WakeUp(struct PacketPlatform *const packet)
+{
+  uint64_t one = 1;
+  if (write(packet->event_fd, &one, sizeof(one)) < 0) {
+    Err("Fail to wake up poll thread - %s\n", strerror(errno));
+  }
+}
+
+
+/**
+ * 제어요청 결과 이벤트를 이벤트 큐에 넣고 폴링 쓰레드를 깨운다.
+ *
+ * @param packet    플랫폼 정보
+ * @param type      이벤트 종류
+ * @param ifindex   인터페이스 식별번호
+ * @return          성공시 0, 큐가 가득 찬 경우 -kAlResult_NoMemory
+ */
+static int al_Packet_PushEvent(struct PacketPlatform *const packet, const PacketEventType type, const AlIfIndex ifindex)
+{
+  pthread_mutex_lock(&packet->mtx);
+  if ((packet->ev_tail - packet->ev_head) >= PACKET_EVENT_QUEUE_SIZE) {
+    pthread_mutex_unlock(&packet->mtx);
+    Err("Fail to push event %u - event queue is full\n", type);
+    return -kAlResult_NoMemory;
+  }
+  packet->ev[packet->ev_tail & (PACKET_EVENT_QUEUE_SIZE - 1)].type = type;
+  packet->ev[packet->ev_tail & (PACKET_EVENT_QUEUE_SIZE - 1)].ifindex = ifindex;
+  packet->ev_tail++;
+  pthread_mutex_unlock(&packet->mtx);
+  al_Packet_WakeUp(packet);
+  return kAlResult_Success;
+}
+
+
+/**
+ * AF_PACKET 플랫폼의 MPDU 전송 함수 구현부.
+ * 캡슐화한 프레임을 송신 링에 넣고 커널에 송신을 요청한다. 송신결과는 송신 링 프레임이 반환되면 폴링 쓰레드에서 전달된다.
+ *
+ * @param priv          @ref TransmitMpdu
+ * @param ifindex       @ref TransmitMpdu
+ * @param mpdu          @ref TransmitMpdu
+ * @param mpdu_size     @ref TransmitMpdu
+ * @param txparams      @ref TransmitMpdu
+ * @return              @ref TransmitMpdu
+ *
+ * 유효기간(expiry)은 적용되지 않는다. 채널접속 여부는 확인하지 않으며, 수신측에서 채널번호로 필터링한다.
+ */
+static int al_Packet_TransmitMpdu(
+  const void *const priv,
+  const AlIfIndex ifindex,
+  const uint8_t *const mpdu,
+  const AlMpduSize mpdu_size,
+  const struct AlMpduTxParams *const txparams)
+{
+  struct PacketPlatform *packet = (struct PacketPlatform *)priv;
+
+  Log(kAlLogLevel_event, "Transmitting MPDU - ifindex: %u, mpdu_size: %u\n", ifindex, mpdu_size);
+
+  if (!mpdu || !txparams) {
+    Err("Fail to transmit MPDU. null parameters - mpdu: %p, txparams: %p\n", mpdu, txparams);
+    return -kAlResult_NullParameters;
+  }
+  if (ifindex >= packet->if_num) {
+    Err("Fail to transmit MPDU. Invalid ifindex: %u\n", ifindex);
+    return -kAlResult_InvalidIfIndex;
+  }
+  struct PacketInterface *fif = &packet->ifs[ifindex];
+  uint32_t frame_len = PACKET_ETH_HDR_SIZE + sizeof(struct PacketRadiotapHdr) + mpdu_size;
+  if ((mpdu_size < kAlMpduMinSize) || (mpdu_size > kAlMpduMaxSize) ||
+      (frame_len > fif->mtu + PACKET_ETH_HDR_SIZE)) {
+    Err("Fail to transmit MPDU. Invalid mpdu_size: %u (%s mtu: %u)\n", mpdu_size, fif->ifname, fif->mtu);
+    return -kAlResult_InvalidMpduSize;
+  }
+  if (txparams->timeslot > kAlTimeSlot_max) {
+    Err("Fail to transmit MPDU. Invalid timeslot: %u\n", txparams->timeslot);
+    return -kAlResult_InvalidTimeSlot;
+  }
+
+  pthread_mutex_lock(&packet->mtx);
+
+  /*
+   * 송신 링에서 빈 프레임을 확보한다.
+   */
+  struct tpacket3_hdr *hdr = PACKET_TX_FRAME(fif, fif->tx_head);
+  if (((fif->tx_head - fif->tx_done) >= PACKET_TX_FRAME_NUM) ||
+      (__atomic_load_n(&hdr->tp_status, __ATOMIC_ACQUIRE) != TP_STATUS_AVAILABLE)) {
+    pthread_mutex_unlock(&packet->mtx);
+    Err("Fail to transmit MPDU. tx ring of %s is full\n", fif->ifname);
+    return -kAlResult_NoMemory;
+  }
+
+  /*
+   * 이더넷 헤더 + 의사 radiotap 헤더 + MPDU 를 채운다.
+   */
+  uint8_t *p = (uint8_t *)hdr + PACKET_TX_DATA_OFFSET;
+  memset(p, 0xff, ETH_ALEN);
+  memcpy(p + ETH_ALEN, fif->netif_addr, ETH_ALEN);
+  *(uint16_t *)(p + (2 * ETH_ALEN)) = htons(PACKET_ETHERTYPE);
+  struct PacketRadiotapHdr *rt = (struct PacketRadiotapHdr *)(p + PACKET_ETH_HDR_SIZE);
+  rt->version = PACKET_RADIOTAP_VERSION;
+  rt->hdr_len = sizeof(struct PacketRadiotapHdr);
+  rt->channel = txparams->channel;
+  rt->timeslot = txparams->timeslot;
+  rt->datarate = txparams->datarate;
+  rt->txpower = txparams->txpower;
+  rt->rxpower = (int16_t)htons((uint16_t)(txparams->txpower - packet->pathloss));
+  memcpy(p + PACKET_ETH_HDR_SIZE + sizeof(struct PacketRadiotapHdr), mpdu, mpdu_size);
+  if (g_al_log >= kAlLogLevel_dump) {
+    al_PrintPacketDump(mpdu, mpdu_size);
+  }
+
+  hdr->tp_next_offset = 0;
+  hdr->tp_len = frame_len;
+  hdr->tp_snaplen = frame_len;
+  __atomic_store_n(&hdr->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+  fif->tx_head++;
+  g_packet_tx_order[g_packet_tx_order_tail % PACKET_TX_ORDER_SIZE] = ifindex;
+  g_packet_tx_order_tail++;
+
+  /*
+   * 커널에 송신을 요청한다. 대기하지 않으며, 처리되지 못한 프레임은 폴링 쓰레드에서 다시 요청한다.
+   */
+  if ((send(fif->tx_fd, NULL, 0, MSG_DONTWAIT) < 0) && (errno != EAGAIN) && (errno != ENOBUFS)) {
+    Err("Fail to send on %s - %s\n", fif->ifname, strerror(errno));
+  }
+  pthread_mutex_unlock(&packet->mtx);
+
+  al_Packet_WakeUp(packet);
+  return kAlResult_Success;
+}
+
+
+/**
+ * AF_PACKET 플랫폼의 채널접속 함수 구현부.
+ * 접속한 채널로 수신 MPDU 를 필터링한다.
+ *
+ * @param priv          @ref AccessChannel
+ * @param ifindex       @ref AccessChannel
+ * @param ts0_chan      @ref AccessChannel
+ * @param ts1_chan      @ref AccessChannel
+ * @return              @ref AccessChannel
+ */
+static int al_Packet_AccessChannel(
+  const void *const priv,
+  const AlIfIndex ifindex,
+  const AlChannel ts0_chan,
+  const AlChannel ts1_chan)
+{
+  struct PacketPlatform *packet = (struct PacketPlatform *)priv;
+
+  Log(kAlLogLevel_config, "Accessing channel - ifindex: %u, ts0_chan: %u, ts1_chan: %u\n", ifindex, ts0_chan, ts1_chan);
+
+  if (ifindex >= packet->if_num) {
+    Err("Fail to access channel. Invalid ifindex: %u\n", ifindex);
+    return -kAlResult_InvalidIfIndex;
+  }
+
+  pthread_mutex_lock(&packet->mtx);
+  packet->ifs[ifindex].chan[kAlTimeSlot_0] = ts0_chan;
+  packet->ifs[ifindex].chan[kAlTimeSlot_1] = ts1_chan;
+  pthread_mutex_unlock(&packet->mtx);
+  return al_Packet_PushEvent(packet, kPacketEvent_AccessChannelResult, ifindex);
+}
+
+
+/**
+ * AF_PACKET 플랫폼의 접속채널확인 함수 구현부.
+ *
+ * @param priv          @ref GetCurrentChannel
+ * @param ifindex       @ref GetCurrentChannel
+ * @param ts0_chan      @ref GetCurrentChannel
+ * @param ts1_chan      @ref GetCurrentChannel
+ * @return              @ref GetCurrentChannel
+ */
+static int al_Packet_GetCurrentChannel(
+  const void *const priv,
+  const AlIfIndex ifindex,
+  AlChannel *const ts0_chan,
+  AlChannel *const ts1_chan)
+{
+  struct PacketPlatform *packet = (struct PacketPlatform *)priv;
+
+  if (!ts0_chan || !ts1_chan) {
+    return -kAlResult_NullParameters;
+  }
+  if (ifindex >= packet->if_num) {
+    Err("Fail to get current channel. Invalid ifindex: %u\n", ifindex);
+    return -kAlResult_InvalidIfIndex;
+  }
+
+  pthread_mutex_lock(&packet->mtx);
+  *ts0_chan = packet->ifs[ifindex].chan[kAlTimeSlot_0];
+  *ts1_chan = packet->ifs[ifindex].chan[kAlTimeSlot_1];
+  pthread_mutex_unlock(&packet->mtx);
+  return kAlResult_Success;
+}
+
+
+/**
+ * AF_PACKET 플랫폼의 채널접속해제 함수 구현부.
+ *
+ * @param priv          @ref ReleaseChannel
+ * @param ifindex       @ref ReleaseChannel
+ * @param timeslot      @ref ReleaseChannel
+ * @return              @ref ReleaseChannel
+ */
+static int al_Packet_ReleaseChannel(const void *const priv, const AlIfIndex ifindex, const AlTimeSlot timeslot)
+{
+  struct PacketPlatform *packet = (struct PacketPlatform *)priv;
+
+  if (ifindex >= packet->if_num) {
+    Err("Fail to release channel. Invalid ifindex: %u\n", ifindex);
+    return -kAlResult_InvalidIfIndex;
+  }
+  if (timeslot > kAlTimeSlot_max) {
+    Err("Fail to release channel. Invalid timeslot: %u\n", timeslot);
+    return -kAlResult_InvalidTimeSlot;
+  }
+
+  pthread_mutex_lock(&packet->mtx);
+  if (timeslot != kAlTimeSlot_1) {
+    packet->ifs[ifindex].chan[kAlTimeSlot_0] = 0;
+  }
+  if (timeslot != kAlTimeSlot_0) {
+    packet->ifs[ifindex].chan[kAlTimeSlot_1] = 0;
+  }
+  pthread_mutex_unlock(&packet->mtx);
+  return kAlResult_Success;
+}
+
+
+/**
+ * AF_PACKET 플랫폼의 MAC 주소 설정 함수 구현부.
+ * 설정된 MAC 주소는 개별주소 MPDU 수신 필터링에 사용된다. (네트워크 인터페이스의 MAC 주소는 변경하지 않는다)
+ *
+ * @param priv          @ref SetIfMacAddress
+ * @param ifindex       @ref SetIfMacAddress
+ * @param addr          @ref SetIfMacAddress
+ * @return              @ref SetIfMacAddress
+ */
+static int al_Packet_SetIfMacAddress(const void *const priv, const AlIfIndex ifindex, const AlMacAddress addr)
+{
+  struct PacketPlatform *packet = (struct PacketPlatform *)priv;
+
+  if (!addr) {
+    return -kAlResult_NullParameters;
+  }
+  if (ifindex >= packet->if_num) {
+    Err("Fail to set MAC address. Invalid ifindex: %u\n", ifindex);
+    return -kAlResult_InvalidIfIndex;
+  }
+
+  pthread_mutex_lock(&packet->mtx);
+  memcpy(packet->ifs[ifindex].addr, addr, sizeof(AlMacAddress));
+  packet->ifs[ifindex].addr_set = true;
+  pthread_mutex_unlock(&packet->mtx);
+  return al_Packet_PushEvent(packet, kPacketEvent_SetIfMacAddressResult, ifindex);
+}
+
+
+/**
+ * 수신된 프레임을 역캡슐화하여 MPDU 수신 콜백함수로 전달한다.
+ *  - 접속한 채널이 있으면, 해당 채널로 송신된 MPDU 만 전달한다.
+ *  - MAC 주소가 설정되어 있으면, 다른 주소로 향하는 개별주소 MPDU 는 전달하지 않는다.
+ *
+ * @param packet    플랫폼 정보
+ * @param ifindex   수신 인터페이스 식별번호
+ * @param frame     수신 프레임 (이더넷 헤더부터)
+ * @param len       수신 프레임 길이
+ */
+static void al_Packet_ProcessRxFrame(
+  struct PacketPlatform *const packet,
+  const AlIfIndex ifindex,
+  const uint8_t *const frame,
+  const uint32_t len)
+{
+  struct PacketInterface *fif = &packet->ifs[ifindex];
+
+  if (len < PACKET_ETH_HDR_SIZE + sizeof(struct PacketRadiotapHdr)) {
+    return;
+  }
+  if (ntohs(*(const uint16_t *)(frame + (2 * ETH_ALEN))) != PACKET_ETHERTYPE) {
+    return;
+  }
+  const struct PacketRadiotapHdr *rt = (const struct PacketRadiotapHdr *)(frame + PACKET_ETH_HDR_SIZE);
+  if ((rt->version != PACKET_RADIOTAP_VERSION) || (rt->hdr_len < sizeof(struct PacketRadiotapHdr)) ||
+      (len < PACKET_ETH_HDR_SIZE + rt->hdr_len + kAlMpduMinSize)) {
+    Log(kAlLogLevel_event, "Drop invalid frame on %s\n", fif->ifname);
+    return;
+  }
+  const uint8_t *mpdu = frame + PACKET_ETH_HDR_SIZE + rt->hdr_len;
+  AlMpduSize mpdu_size = (AlMpduSize)(len - PACKET_ETH_HDR_SIZE - rt->hdr_len);
+  if (mpdu_size > kAlMpduMaxSize) {
+    return;
+  }
+
+  if ((fif->chan[kAlTimeSlot_0] || fif->chan[kAlTimeSlot_1]) &&
+      (rt->channel != fif->chan[kAlTimeSlot_0]) && (rt->channel != fif->chan[kAlTimeSlot_1])) {
+    return;
+  }
+  const uint8_t *addr1 = mpdu + 4;
+  if (fif->addr_set && !(addr1[0] & 1) && memcmp(addr1, fif->addr, sizeof(AlMacAddress))) {
+    return;
+  }
+
+  struct AlMpduRxParams rxparams;
+  rxparams.ifindex = ifindex;
+  rxparams.timeslot = rt->timeslot;
+  rxparams.channel = rt->channel;
+  rxparams.rxpower = (int16_t)ntohs((uint16_t)rt->rxpower);
+  rxparams.rcpi = (rxparams.rxpower == PACKET_RX_POWER_UNKNOWN) ?
+                  PACKET_RCPI_UNKNOWN : al_ConvertRxPowerToRcpi(rxparams.rxpower);
+  rxparams.datarate = rt->datarate;
+
+  Log(kAlLogLevel_event, "Receive MPDU on %s - mpdu_size: %u, channel: %u\n", fif->ifname, mpdu_size, rt->channel);
+  al_RxMpdu(packet->parent, mpdu, mpdu_size, &rxparams, NULL, NULL);
+}
+
+
+/**
+ * 한 인터페이스의 수신 링에서 사용자에게 넘어온 블록들을 처리한다.
+ *
+ * @param packet    플랫폼 정보
+ * @param ifindex   인터페이스 식별번호
+ */
+static void al_Packet_ProcessRxRing(struct PacketPlatform *const packet, const AlIfIndex ifindex)
+{
+  struct PacketInterface *fif = &packet->ifs[ifindex];
+
+  while (1) {
+    struct tpacket_block_desc *pbd = PACKET_RX_BLOCK(fif, fif->rx_block);
+    if (!(__atomic_load_n(&pbd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+      break;
+    }
+    struct tpacket3_hdr *ppd = (struct tpacket3_hdr *)((uint8_t *)pbd + pbd->hdr.bh1.offset_to_first_pkt);
+    for (uint32_t i = 0; i < pbd->hdr.bh1.num_pkts; i++) {
+      const struct sockaddr_ll *sll =
+        (const struct sockaddr_ll *)((uint8_t *)ppd + TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+      if (sll->sll_pkttype != PACKET_OUTGOING) {
+        al_Packet_ProcessRxFrame(packet, ifindex, (uint8_t *)ppd + ppd->tp_mac, ppd->tp_snaplen);
+      }
+      ppd = (struct tpacket3_hdr *)((uint8_t *)ppd + ppd->tp_next_offset);
+    }
+    al_FlushRxMpdus(packet->parent); // 블록을 커널에 반환하기 전에 일괄 전달을 완료한다.
+    __atomic_store_n(&pbd->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    fif->rx_block = (fif->rx_block + 1) % PACKET_RX_BLOCK_NUM;
+  }
+}
+
+
+/**
+ * 송신 완료된 프레임들의 송신결과를 송신요청 순서대로 전달한다.
+ *  - 커널이 반환한 프레임(TP_STATUS_AVAILABLE)은 성공, 형식 오류(TP_STATUS_WRONG_FORMAT)로 버려진 프레임은 실패로 전달한다.
+ *  - 커널에 아직 전달되지 못한 프레임이 있으면 다시 송신을 요청한다.
+ *
+ * @param packet    플랫폼 정보
+ * @return          송신 완료 대기 중인 프레임이 남아 있으면 true
+ */
+static bool al_Packet_ProcessTxCompletion(struct PacketPlatform *const packet)
+{
+  AlTxResultCode result[PACKET_TX_FRAME_NUM];
+  int num = 0;
+  bool pending;
+
+  pthread_mutex_lock(&packet->mtx);
+  while ((g_packet_tx_order_head != g_packet_tx_order_tail) && (num < PACKET_TX_FRAME_NUM)) {
+    struct PacketInterface *fif = &packet->ifs[g_packet_tx_order[g_packet_tx_order_head % PACKET_TX_ORDER_SIZE]];
+    struct tpacket3_hdr *hdr = PACKET_TX_FRAME(fif, fif->tx_done);
+    uint32_t status = __atomic_load_n(&hdr->tp_status, __ATOMIC_ACQUIRE);
+    if (status == TP_STATUS_AVAILABLE) {
+      result[num++] = kAlTxResult_Success;
+    } else if (status & TP_STATUS_WRONG_FORMAT) {
+      Err("Fail to transmit MPDU on %s - wrong format\n", fif->ifname);
+      __atomic_store_n(&hdr->tp_status, TP_STATUS_AVAILABLE, __ATOMIC_RELEASE);
+      result[num++] = kAlTxResult_DevSpecificErr;
+    } else {
+      break;
+    }
+    fif->tx_done++;
+    g_packet_tx_order_head++;
+  }
+  for (int i = 0; i < packet->if_num; i++) {
+    struct PacketInterface *fif = &packet->ifs[i];
+    if ((fif->tx_head != fif->tx_done) &&
+        (__atomic_load_n(&PACKET_TX_FRAME(fif, fif->tx_head - 1)->tp_status, __ATOMIC_ACQUIRE) & TP_STATUS_SEND_REQUEST)) {
+      send(fif->tx_fd, NULL, 0, MSG_DONTWAIT);
+    }
+  }
+  pending = (g_packet_tx_order_head != g_packet_tx_order_tail);
+  pthread_mutex_unlock(&packet->mtx);
+
+  if (packet->parent->ProcessTransmitResultCallback) {
+    for (int i = 0; i < num; i++) {
+      packet->parent->ProcessTransmitResultCallback(result[i], (result[i] == kAlTxResult_Success) ? 0 : EINVAL);
+    }
+  }
+  return pending;
+}
+
+
+/**
+ * 제어요청 결과 이벤트들을 전달한다.
+ *
+ * @param packet    플랫폼 정보
+ */
+static void al_Packet_ProcessEvents(struct PacketPlatform *const packet)
+{
+  struct PacketEvent ev[PACKET_EVENT_QUEUE_SIZE];
+  int num = 0;
+
+  pthread_mutex_lock(&packet->mtx);
+  while (packet->ev_head != packet->ev_tail) {
+    ev[num++] = packet->ev[packet->ev_head & (PACKET_EVENT_QUEUE_SIZE - 1)];
+    packet->ev_head++;
+  }
+  pthread_mutex_unlock(&packet->mtx);
+
+  for (int i = 0; i < num; i++) {
+    if ((ev[i].type == kPacketEvent_AccessChannelResult) && packet->parent->ProcessAccessChannelResultCallback) {
+      packet->parent->ProcessAccessChannelResultCallback(ev[i].ifindex);
+    } else if ((ev[i].type == kPacketEvent_SetIfMacAddressResult) && packet->parent->ProcessSetIfMacAddressResultCallback) {
+      packet->parent->ProcessSetIfMacAddressResultCallback(ev[i].ifindex);
+    }
+  }
+}
+
+
+/**
+ * TimeSlot 전환 이벤트를 전달한다.
+ * 같은 장비 내 여러 인스턴스의 TimeSlot 이 일치하도록 CLOCK_REALTIME 기준 50msec 경계에서 전환한다.
+ *
+ * @param packet    플랫폼 정보
+ * @return          다음 전환까지 남은 시간 (msec)
+ */
+static int al_Packet_ProcessTimeSlot(struct PacketPlatform *const packet)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  uint64_t now = ((uint64_t)ts.tv_sec * 1000000ULL) + ((uint64_t)ts.tv_nsec / 1000ULL);
+  AlTimeSlot slot = (AlTimeSlot)((now / PACKET_TIMESLOT_INTERVAL) % 2);
+
+  if (slot != packet->cur_slot) {
+    packet->cur_slot = slot;
+    if ((slot == kAlTimeSlot_0) && packet->parent->ProcessTimeSlot0EventCallback) {
+      packet->parent->ProcessTimeSlot0EventCallback();
+    } else if ((slot == kAlTimeSlot_1) && packet->parent->ProcessTimeSlot1EventCallback) {
+      packet->parent->ProcessTimeSlot1EventCallback();
+    }
+  }
+  return (int)((PACKET_TIMESLOT_INTERVAL - (now % PACKET_TIMESLOT_INTERVAL)) / 1000ULL) + 1;
+}
+
+
+/**
+ * AF_PACKET 플랫폼의 이벤트 폴링 함수 구현부. 리턴하지 않는다.
+ *
+ * @param priv  플랫폼 정보
+ */
+static void al_Packet_PollEvent(const void *const priv)
+{
+  struct PacketPlatform *packet = (struct PacketPlatform *)priv;
+  struct pollfd fds[_V2X_IF_NUM_ + 1];
+  int nfds = packet->if_num + 1;
+  int timeout, ret;
+  bool tx_pending = false;
+  uint64_t cnt;
+
+  for (int i = 0; i < packet->if_num; i++) {
+    fds[i].fd = packet->ifs[i].rx_fd;
+    fds[i].events = POLLIN;
+  }
+  fds[packet->if_num].fd = packet->event_fd;
+  fds[packet->if_num].events = POLLIN;
+
+  while (1) {
+    timeout = packet->timeslot_enable ? al_Packet_ProcessTimeSlot(packet) : -1;
+    if (tx_pending) {
+      timeout = PACKET_TX_POLL_INTERVAL;
+    }
+    ret = poll(fds, nfds, timeout);
+    if ((ret < 0) && (errno != EINTR)) {
+      Err("Fail to poll event - %s\n", strerror(errno));
+      continue;
+    }
+    if (fds[packet->if_num].revents & POLLIN) {
+      if (read(packet->event_fd, &cnt, sizeof(cnt)) < 0) {
+        Err("Fail to read eventfd - %s\n", strerror(errno));
+      }
+      al_Packet_ProcessEvents(packet);
+    }
+    for (int i = 0; i < packet->if_num; i++) {
+      if (fds[i].revents & (POLLERR|POLLHUP|POLLNVAL)) {
+        Err("Poll error on %s - revents 0x%02X\n", packet->ifs[i].ifname, fds[i].revents);
+      }
+      al_Packet_ProcessRxRing(packet, (AlIfIndex)i);
+    }
+    tx_pending = al_Packet_ProcessTxCompletion(packet);
+  }
+}
+
+
+/**
+ * 네트워크 인터페이스에 대한 송신 링과 수신 링을 생성한다.
+ *
+ * @param fif   인터페이스 정보 (ifname 이 채워진 상태로 전달된다)
+ * @return      성공시 0, 실패시 음수(-AlResultCode)
+ */
+static int al_Packet_OpenInterface(struct PacketInterface *const fif)
+{
+  struct ifreq ifr;
+  struct sockaddr_ll sll;
+  struct tpacket_req3 req;
+  int version = TPACKET_V3, one = 1;
+
+  /*
+   * 네트워크 인터페이스 정보 확인
+   */
+  fif->netif_index = (int)if_nametoindex(fif->ifname);
+  if (fif->netif_index == 0) {
+    Err("Fail to find network interface %s\n", fif->ifname);
+    return -kAlResult_InvalidIfIndex;
+  }
+  fif->rx_fd = socket(AF_PACKET, SOCK_RAW, htons(PACKET_ETHERTYPE));
+  fif->tx_fd = socket(AF_PACKET, SOCK_RAW, 0);
+  if ((fif->rx_fd < 0) || (fif->tx_fd < 0)) {
+    Err("Fail to open AF_PACKET socket - %s\n", strerror(errno));
+    return -kAlResult_DevSpecificError;
+  }
+  memset(&ifr, 0, sizeof(ifr));
+  snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", fif->ifname);
+  if (ioctl(fif->tx_fd, SIOCGIFMTU, &ifr) < 0) {
+    Err("Fail to get mtu of %s - %s\n", fif->ifname, strerror(errno));
+    return -kAlResult_DevSpecificError;
+  }
+  fif->mtu = (uint32_t)ifr.ifr_mtu;
+  if (ioctl(fif->tx_fd, SIOCGIFHWADDR, &ifr) < 0) {
+    Err("Fail to get address of %s - %s\n", fif->ifname, strerror(errno));
+    return -kAlResult_DevSpecificError;
+  }
+  memcpy(fif->netif_addr, ifr.ifr_hwaddr.sa_data, ETH_ALEN);
+  if (fif->mtu < sizeof(struct PacketRadiotapHdr) + kAlMpduMaxSize) {
+    Log(kAlLogLevel_init, "MTU of %s(%u) is smaller than max MPDU size - long MPDUs will be rejected\n",
+        fif->ifname, fif->mtu);
+  }
+
+  /*
+   * 수신 링 (TPACKET_V3)
+   */
+  memset(&req, 0, sizeof(req));
+  req.tp_block_size = PACKET_RX_BLOCK_SIZE;
+  req.tp_block_nr = PACKET_RX_BLOCK_NUM;
+  req.tp_frame_size = PACKET_TX_FRAME_SIZE;
+  req.tp_frame_nr = (PACKET_RX_BLOCK_SIZE / PACKET_TX_FRAME_SIZE) * PACKET_RX_BLOCK_NUM;
+  req.tp_retire_blk_tov = PACKET_RX_BLOCK_TIMEOUT;
+  if ((setsockopt(fif->rx_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) ||
+      (setsockopt(fif->rx_fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0)) {
+    Err("Fail to set rx ring of %s - %s\n", fif->ifname, strerror(errno));
+    return -kAlResult_DevSpecificError;
+  }
+#ifdef PACKET_IGNORE_OUTGOING
+  setsockopt(fif->rx_fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &one, sizeof(one));
+#endif
+  fif->rx_ring = mmap(NULL, (size_t)PACKET_RX_BLOCK_SIZE * PACKET_RX_BLOCK_NUM,
+                      PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, fif->rx_fd, 0);
+  if (fif->rx_ring == MAP_FAILED) {
+    fif->rx_ring = mmap(NULL, (size_t)PACKET_RX_BLOCK_SIZE * PACKET_RX_BLOCK_NUM,
+                        PROT_READ | PROT_WRITE, MAP_SHARED, fif->rx_fd, 0);
+  }
+  if (fif->rx_ring == MAP_FAILED) {
+    Err("Fail to mmap rx ring of %s - %s\n", fif->ifname, strerror(errno));
+    return -kAlResult_NoMemory;
+  }
+  memset(&sll, 0, sizeof(sll));
+  sll.sll_family = AF_PACKET;
+  sll.sll_protocol = htons(PACKET_ETHERTYPE);
+  sll.sll_ifindex = fif->netif_index;
+  if (bind(fif->rx_fd, (struct sockaddr *)&sll, sizeof(sll)) < 0) {
+    Err("Fail to bind rx socket to %s - %s\n", fif->ifname, strerror(errno));
+    return -kAlResult_DevSpecificError;
+  }
+
+  /*
+   * 송신 링 (TPACKET_V3) - 형식 오류 프레임은 송신을 멈추지 않고 버리도록 PACKET_LOSS 를 설정한다.
+   */
+  memset(&req, 0, sizeof(req));
+  req.tp_block_size = PACKET_TX_BLOCK_SIZE;
+  req.tp_block_nr = (PACKET_TX_FRAME_NUM * PACKET_TX_FRAME_SIZE) / PACKET_TX_BLOCK_SIZE;
+  req.tp_frame_size = PACKET_TX_FRAME_SIZE;
+  req.tp_frame_nr = PACKET_TX_FRAME_NUM;
+  if ((setsockopt(fif->tx_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) ||
+      (setsockopt(fif->tx_fd, SOL_PACKET, PACKET_LOSS, &one, sizeof(one)) < 0) ||
+      (setsockopt(fif->tx_fd, SOL_PACKET, PACKET_TX_RING, &req, sizeof(req)) < 0)) {
+    Err("Fail to set tx ring of %s - %s\n", fif->ifname, strerror(errno));
+    return -kAlResult_DevSpecificError;
+  }
+  fif->tx_ring = mmap(NULL, (size_t)PACKET_TX_FRAME_NUM * PACKET_TX_FRAME_SIZE,
+                      PROT_READ | PROT_WRITE, MAP_SHARED, fif->tx_fd, 0);
+  if (fif->tx_ring == MAP_FAILED) {
+    Err("Fail to mmap tx ring of %s - %s\n", fif->ifname, strerror(errno));
+    return -kAlResult_NoMemory;
+  }
+  memset(&sll, 0, sizeof(sll));
+  sll.sll_family = AF_PACKET;
+  sll.sll_protocol = 0;   // 송신 전용 - 수신하지 않는다.
+  sll.sll_ifindex = fif->netif_index;
+  if (bind(fif->tx_fd, (struct sockaddr *)&sll, sizeof(sll)) < 0) {
+    Err("Fail to bind tx socket to %s - %s\n", fif->ifname, strerror(errno));
+    return -kAlResult_DevSpecificError;
+  }
+
+  Log(kAlLogLevel_init, "Open %s(%d) - mtu: %u, address: %02X:%02X:%02X:%02X:%02X:%02X\n",
+      fif->ifname, fif->netif_index, fif->mtu, fif->netif_addr[0], fif->netif_addr[1], fif->netif_addr[2],
+      fif->netif_addr[3], fif->netif_addr[4], fif->netif_addr[5]);
+  return kAlResult_Success;
+}
+
+
+/**
+ * AF_PACKET 플랫폼을 초기화한다.
+ *
+ * @param platform  액세스계층 플랫폼 정보
+ * @param reset     사용되지 않음
+ * @return          성공시 지원하는 인터페이스의 수, 실패시 음수(-AlResultCode)
+ */
+int INTERNAL al_PlatformInit(struct AlPlatform *const platform, const bool reset)
+{
+  struct PacketPlatform *packet = &g_al_packet_platform;
+  const char *str;
+  char buf[128];
+  char *saveptr, *tok;
+  int ret;
+
+  (void)reset;
+  Log(kAlLogLevel_init, "Initializing AF_PACKET platform\n");
+
+  /*
+   * 플랫폼 의존정보 등록
+   */
+  struct AlPlatformSpecificData *platform_data = &(platform->platform_data);
+  platform_data->priv = (void *)&g_al_packet_platform;
+  platform_data->TransmitMpdu = al_Packet_TransmitMpdu;
+  platform_data->AccessChannel = al_Packet_AccessChannel;
+  platform_data->GetCurrentChannel = al_Packet_GetCurrentChannel;
+  platform_data->ReleaseChannel = al_Packet_ReleaseChannel;
+  platform_data->SetIfMacAddress = al_Packet_SetIfMacAddress;
+  platform_data->PollEvent = al_Packet_PollEvent;
+
+  memset(packet, 0, sizeof(struct PacketPlatform));
+  packet->parent = platform;
+  g_packet_tx_order_head = g_packet_tx_order_tail = 0;
+  str = getenv(PACKET_ENV_PATHLOSS);
+  packet->pathloss = (int16_t)(((str != NULL) ? atoi(str) : PACKET_DEFAULT_PATHLOSS) * 2);
+  str = getenv(PACKET_ENV_TIMESLOT);
+  packet->timeslot_enable = (str == NULL) || (atoi(str) != 0);
+  packet->cur_slot = kAlTimeSlot_both;
+  pthread_mutex_init(&packet->mtx, NULL);
+  packet->event_fd = eventfd(0, EFD_NONBLOCK);
+  if (packet->event_fd < 0) {
+    Err("Fail to initialize AF_PACKET platform - eventfd() failed: %s\n", strerror(errno));
+    return -kAlResult_DevSpecificError;
+  }
+
+  /*
+   * 환경변수에 지정된 네트워크 인터페이스들을 순서대로 연다.
+   */
+  str = getenv(PACKET_ENV_IFNAMES);
+  if ((str == NULL) || (*str == '\0')) {
+    Err("Fail to initialize AF_PACKET platform - %s is not set\n", PACKET_ENV_IFNAMES);
+    return -kAlResult_InvalidIfNum;
+  }
+  snprintf(buf, sizeof(buf), "%s", str);
+  for (tok = strtok_r(buf, ",", &saveptr); tok != NULL; tok = strtok_r(NULL, ",", &saveptr)) {
+    if (packet->if_num >= _V2X_IF_NUM_) {
+      Err("Fail to initialize AF_PACKET platform - too many interfaces in %s\n", PACKET_ENV_IFNAMES);
+      return -kAlResult_InvalidIfNum;
+    }
+    struct PacketInterface *fif = &packet->ifs[packet->if_num];
+    snprintf(fif->ifname, sizeof(fif->ifname), "%s", tok);
+    ret = al_Packet_OpenInterface(fif);
+    if (ret < 0) {
+      return ret;
+    }
+    packet->if_num++;
+  }
+
+  Log(kAlLogLevel_init, "Success to initialize AF_PACKET platform - %u interface is supported\n", packet->if_num);
+  return packet->if_num;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file packet.h
+ * @date 2026-10-19
+ * @author gyun
+ * @brief 리눅스 네트워크 인터페이스(AF_PACKET) 플랫폼 정의 헤더파일
+ *
+ * V2X 칩디바이스 대신 리눅스 이더넷 인터페이스(veth, 실제 이더넷 등)로 MPDU 를 송수신한다.
+ *  - 802.11 QoS MPDU 를 이더넷 프레임에 캡슐화하여 전송한다.
+ *    이더넷 헤더(브로드캐스트, EtherType 0x88B5) + 의사 radiotap 헤더 + MPDU(CRC 제외)
+ *  - 의사 radiotap 헤더에는 채널, TimeSlot, 데이터레이트, 송신파워, 수신파워가 수납된다.
+ *  - 송수신에는 TPACKET_V3 mmap 링을 사용한다.
+ * 각 액세스계층 인터페이스는 AL_PACKET_IFNAMES 환경변수에 지정된 네트워크 인터페이스에 순서대로 대응된다.
+ * 네트워크 인터페이스의 MTU 는 MPDU 최대길이 + 의사 radiotap 헤더 길이(8바이트) 이상이어야 한다.
+ */
+
+
+#ifndef LIBWLANACCESS_PACKET_H
+#define LIBWLANACCESS_PACKET_H
+
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "wlanaccess-internal.h"
+
+
+#define PACKET_ETHERTYPE (0x88B5)           ///< 캡슐화 EtherType (IEEE 802 Local Experimental EtherType 1)
+#define PACKET_ETH_HDR_SIZE (14)            ///< 이더넷 헤더 길이
+#define PACKET_RADIOTAP_VERSION (0)         ///< 의사 radiotap 헤더 버전
+
+#define PACKET_RX_BLOCK_SIZE (1 << 17)      ///< 수신 링 블록 크기
+#define PACKET_RX_BLOCK_NUM (32)            ///< 수신 링 블록 개수
+#define PACKET_RX_BLOCK_TIMEOUT (1)         ///< 수신 링 블록 retire 시간 (msec) - 수신 지연시간 상한
+#define PACKET_TX_FRAME_SIZE (4096)         ///< 송신 링 프레임 크기 (최대 MPDU 를 캡슐화한 프레임을 수납할 수 있어야 한다)
+#define PACKET_TX_FRAME_NUM (256)           ///< 송신 링 프레임 개수
+#define PACKET_TX_POLL_INTERVAL (1)         ///< 송신 완료 확인 주기 (msec, 송신 완료 대기 중인 프레임이 있을 때)
+#define PACKET_EVENT_QUEUE_SIZE (64)        ///< 제어요청 결과 이벤트 큐 크기 (2의 거듭제곱)
+#define PACKET_TIMESLOT_INTERVAL (50000)    ///< TimeSlot 전환 주기 (usec 단위)
+#define PACKET_DEFAULT_PATHLOSS (90)        ///< 기본 경로손실 (dB) - 수신파워 = 송신파워 - 경로손실
+
+/*
+ * 환경변수로 지정하는 플랫폼 설정
+ */
+#define PACKET_ENV_IFNAMES "AL_PACKET_IFNAMES"     ///< 인터페이스 별 네트워크 인터페이스 이름 (쉼표로 구분, 필수)
+#define PACKET_ENV_PATHLOSS "AL_PACKET_PATHLOSS"   ///< 경로손실 (dB 단위, 기본: 90)
+#define PACKET_ENV_TIMESLOT "AL_PACKET_TIMESLOT"   ///< TimeSlot 전환 이벤트 발생 여부 (기본: 1)
+
+/**
+ * @brief 의사 radiotap 헤더. 이더넷 헤더와 MPDU 사이에 위치한다. 멀티바이트 필드는 빅엔디안이다.
+ */
+struct PacketRadiotapHdr {
+  uint8_t version;    ///< 헤더 버전 (PACKET_RADIOTAP_VERSION)
+  uint8_t hdr_len;    ///< 헤더 길이 (=MPDU 오프셋)
+  uint8_t channel;    ///< 송신 채널번호
+  uint8_t timeslot;   ///< 송신 TimeSlot
+  uint8_t datarate;   ///< 송신 데이터레이트 (500kbps 단위)
+  int8_t txpower;     ///< 송신파워 (0.5dBm 단위)
+  int16_t rxpower;    ///< 수신파워 (0.5dBm 단위). 송신측에서 경로손실을 적용하여 채운다. -32768=Unknown
+} __attribute__ ((packed));
+
+/**
+ * @brief 제어요청 결과 이벤트 종류
+ */
+enum ePacketEventType {
+  kPacketEvent_AccessChannelResult,
+  kPacketEvent_SetIfMacAddressResult,
+};
+typedef uint8_t PacketEventType; ///< @copydoc ePacketEventType
+
+/**
+ * @brief 제어요청 결과 이벤트
+ */
+struct PacketEvent {
+  PacketEventType type;
+  AlIfIndex ifindex;
+};
+
+/**
+ * @brief 인터페이스 정보
+ */
+struct PacketInterface {
+  char ifname[16];        ///< 네트워크 인터페이스 이름
+  int netif_index;        ///< 네트워크 인터페이스 식별번호
+  uint32_t mtu;           ///< 네트워크 인터페이스 MTU
+  uint8_t netif_addr[6];  ///< 네트워크 인터페이스 MAC 주소 (이더넷 헤더 송신지 주소)
+
+  AlChannel chan[2];      ///< TimeSlot 별 접속채널 (0=미접속 - 모든 채널의 MPDU 를 수신한다)
+  AlMacAddress addr;      ///< V2X MAC 주소 (개별주소 MPDU 수신 필터링에 사용된다)
+  bool addr_set;          ///< V2X MAC 주소 설정 여부
+
+  /* 수신 링 (TPACKET_V3) */
+  int rx_fd;
+  uint8_t *rx_ring;
+  uint32_t rx_block;      ///< 다음에 확인할 블록
+
+  /* 송신 링 (TPACKET_V3) */
+  int tx_fd;
+  uint8_t *tx_ring;
+  uint32_t tx_head;       ///< 다음에 채울 프레임 (누적 개수)
+  uint32_t tx_done;       ///< 다음에 완료를 확인할 프레임 (누적 개수)
+};
+
+/**
+ * @brief AF_PACKET 플랫폼 정보
+ */
+struct PacketPlatform {
+  struct AlPlatform *parent;  ///< 부모 플랫폼 정보
+  uint8_t if_num;             ///< 지원 인터페이스 개수
+  struct PacketInterface ifs[_V2X_IF_NUM_];
+
+  int16_t pathloss;           ///< 경로손실 (0.5dB 단위)
+  bool timeslot_enable;
+  AlTimeSlot cur_slot;        ///< 현재 TimeSlot
+
+  pthread_mutex_t mtx;        ///< 송신 링, 이벤트 큐, 인터페이스 설정 보호
+  int event_fd;               ///< 폴링 쓰레드를 깨우기 위한 eventfd
+  struct PacketEvent ev[PACKET_EVENT_QUEUE_SIZE];
+  uint32_t ev_head;
+  uint32_t ev_tail;
+};
+
+
+extern struct PacketPlatform g_al_packet_platform;
+
+
+#endif //LIBWLANACCESS_PACKET_H
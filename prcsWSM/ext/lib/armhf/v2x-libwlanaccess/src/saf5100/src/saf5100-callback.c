@@ -166,6 +166,16 @@ static tMKxStatus al_SAF5100_IsValid_RxInd(struct MKx *pMKx, tMKxRxPacket *pRxPk
 }
 
 
+/**
+ * @brief RxAlloc() 콜백함수에서 할당된 수신 패킷버퍼를 해제한다.
+ * @param pktbuf 해제할 패킷버퍼
+ */
+static void al_SAF5100_FreeRxPktBuf(void *pktbuf)
+{
+  PktBuf_Free((struct PktBuf *)pktbuf);
+}
+
+
 /**
  * @brief SAF5100 플랫폼 RxInd() 콜백함수 구현부
  * @param pMKx MKx 핸들
@@ -226,14 +236,10 @@ tMKxStatus INTERNAL al_SAF5100_RxInd(struct MKx *pMKx, tMKxRxPacket *pRxPkt, voi
   /*
    * 어플리케이션 콜백함수를 호출한다.
    */
+  //  - 일괄 수신처리 시에는 패킷버퍼가 al_FlushRxMpdus() 에서 해제된다.
   struct AlPlatform *platform = g_al_saf5100_platform.parent;
-  if (platform->ProcessRxMpduCallback) {
-    platform->ProcessRxMpduCallback(rx_pkt_data->RxFrame, rx_pkt_data->RxFrameLength, &rxparams);
-  } else {
-    Log(kAlLogLevel_event, "  No rx MPDU callback function\n");
-  }
-
-  PktBuf_Free((struct PktBuf *)pPriv);
+  al_RxMpdu(platform, rx_pkt_data->RxFrame, rx_pkt_data->RxFrameLength, &rxparams,
+            al_SAF5100_FreeRxPktBuf, pPriv);
   return MKXSTATUS_SUCCESS;
 }
 
@@ -294,8 +300,18 @@ tMKxStatus INTERNAL al_SAF5100_NotifInd(struct MKx *pMKx, tMKxNotif Notif)
 
   /*
    * 어플리케이션 콜백함수를 호출한다.
+   *  - 채널스위칭 타임슬롯 전환 이벤트는 첫번째 디바이스의 RadioA 기준으로 전달한다.
    */
-  // TODO::
+  if ((Notif & MKX_NOTIF_MASK_ACTIVE) && (Notif & MKX_NOTIF_MASK_RADIOA) && (saf5100_dev->dev_index == 0)) {
+    if ((Notif & MKX_NOTIF_MASK_CHANNEL0) && platform->ProcessTimeSlot0EventCallback) {
+      platform->ProcessTimeSlot0EventCallback();
+    } else if ((Notif & MKX_NOTIF_MASK_CHANNEL1) && platform->ProcessTimeSlot1EventCallback) {
+      platform->ProcessTimeSlot1EventCallback();
+    }
+  }
+  if ((Notif & MKX_NOTIF_MASK_ERROR) && platform->ProcessErrorEventCallback) {
+    platform->ProcessErrorEventCallback(kAlError_unspecified);
+  }
 
   return MKXSTATUS_SUCCESS;
 }
\ No newline at end of file
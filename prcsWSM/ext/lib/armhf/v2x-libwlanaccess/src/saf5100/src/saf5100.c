@@ -711,6 +711,7 @@ static void al_SAF5100_PollEvent(const void *const priv)
         Err("Poll error on module %d - revents 0x%02X\n", i, fds[i].revents);
       }
     }
+    al_FlushRxMpdus(saf5100_platform->parent);
   }
 }
 
@@ -10,8 +10,11 @@
 mqd_t recvFD, parRecvFD, sendFD;
 struct msgQ_elem_frame *recvPkt = NULL; // 메시지 버퍼
 struct msgQ_elem_frame *parRecvPkt = NULL; //PAR 메세지 버퍼
-struct msgQ_elem_frame *sendPkt = NULL; // 메시지 버퍼
-uint32_t msgqCnt = 0;
+struct msgQ_elem_frame *sendPkt[V2X_OBU_IF_MAX_NUM] = {NULL, }; // 인터페이스 별 메시지 버퍼 (각 송신쓰레드 전용)
+uint32_t msgqCnt = 0; // J2735/PAR 수신 메시지 공통 일련번호 (서로 다른 뮤텍스에서 증가되므로 원자적으로 증가시킨다)
+/* 수신 메시지 버퍼 뮤텍스 - 인터페이스 별 수신쓰레드들이 공유한다. */
+static pthread_mutex_t recvMtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t parRecvMtx = PTHREAD_MUTEX_INITIALIZER;
 
 int initMQ(void)
 {
@@ -46,7 +49,7 @@ int initMQ(void)
 
         /* PAR수신 Packet 메시지큐 생성 */
         parRecvFD = msgget((key_t)KEY_SEND_PAR, IPC_CREAT | 0666);
-        if (recvFD < 0)
+        if (parRecvFD < 0)
         {
             //perror("[prcsWSM] PAR msgget error ");
             syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] PAR msgget error : %s", strerror(errno));
@@ -56,13 +59,18 @@ int initMQ(void)
     }
     if(g_mib.op == opTX || g_mib.op == opTRX)
     {
-        /* 송신 메세지 큐용 버퍼 Allocation */
-        sendPkt = (struct msgQ_elem_frame *)calloc(1, sizeof(struct msgQ_elem_frame));
-        if( sendPkt == NULL )
+        /* 송신 메세지 큐용 버퍼 Allocation - 운용하는 인터페이스 별 */
+        for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++)
         {
-            //printf("[prcsWSM] Fail to allocate memory for send packet message queue.\n");
-            syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to allocate memory for send packet message queue.\n");
-            return -1;
+            if (!g_mib.ifs[i].enable)
+                continue;
+            sendPkt[i] = (struct msgQ_elem_frame *)calloc(1, sizeof(struct msgQ_elem_frame));
+            if( sendPkt[i] == NULL )
+            {
+                //printf("[prcsWSM] Fail to allocate memory for send packet message queue.\n");
+                syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to allocate memory for send packet message queue.\n");
+                return -1;
+            }
         }
         /* 송신 Packet 메시지큐 생성 */
         sendFD = msgget((key_t)KEY_SEND_J2735, IPC_CREAT | 0666);
@@ -70,7 +78,8 @@ int initMQ(void)
         {
             //perror("[prcsWSM] msgget error ");
             syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] msgget error : %s", strerror(errno));
-            free(sendPkt);
+            for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++)
+                free(sendPkt[i]);
             return -1;
         }
     }
@@ -102,77 +111,146 @@ void releaseMQ(void)
         /* 송신 Paket 메시지큐 닫기 */
         mq_close(sendFD);
         /* 송신 메세지 큐용 버퍼 FREE */
-        free(sendPkt);
+        for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++)
+            free(sendPkt[i]);
     }
 }
 
-int recvMQ(char *pkt)
+/****************************************************************************************
+
+  recvMQ()
+  특정 인터페이스로 송신할 패킷을 송신 메시지큐에서 꺼낸다.
+  송신 메시지큐는 모든 인터페이스가 공유하며, 메시지 타입(msgtype)으로 인터페이스를 구분한다.
+  (msgtype = 인터페이스 식별번호 + 1. 기존 송신 프로세스가 사용하는 msgtype 1 은 인터페이스 0 으로 송신된다)
+
+  arguments
+    ifindex : 인터페이스 식별번호
+    pkt     : 패킷이 저장될 버퍼
+
+  return
+    성공 시 패킷 길이, 실패 시 -1
+
+ ****************************************************************************************/
+int recvMQ(uint8_t ifindex, char *pkt)
 {
-    memset(sendPkt->msg.msg, 0, sendPkt->msg.msg_len);
+    struct msgQ_elem_frame *txPkt = sendPkt[ifindex];
 
-    if( msgrcv(sendFD, (char *)sendPkt, sizeof(struct msgQ_elem_frame) - sizeof(long), 1, 0) == -1 )
+    memset(txPkt->msg.msg, 0, txPkt->msg.msg_len);
+
+    if( msgrcv(sendFD, (char *)txPkt, sizeof(struct msgQ_elem_frame) - sizeof(long), ifindex + 1, 0) == -1 )
     {
         //perror("[prcsWSM] MQ receive error :  " );
         syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] MQ receive error : %s", strerror(errno));
+        V2X_OBU_INC_CNT(ifindex, tx_ipc_fail);
         return -1;
     }
     else
     {
         if (g_dbg >= kDbgMsgLevel_event)
         {
-            //printf("[prcsWSM] MQ receive(len: %d)\n", sendPkt->msg.msg_len);
-            syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] MQ receive(len: %d)\n", sendPkt->msg.msg_len);
+            //printf("[prcsWSM] MQ receive(len: %d)\n", txPkt->msg.msg_len);
+            syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] MQ receive(if%u, len: %d)\n", ifindex, txPkt->msg.msg_len);
         }
-        memcpy(pkt, sendPkt->msg.msg, sendPkt->msg.msg_len);
+        memcpy(pkt, txPkt->msg.msg, txPkt->msg.msg_len);
+        V2X_OBU_INC_CNT(ifindex, tx_ipc);
     }
 
-    return sendPkt->msg.msg_len;
+    return txPkt->msg.msg_len;
 }
 
-void sendMQ(uint8_t *pPkt, uint32_t len)
+/****************************************************************************************
+
+  sendMQ()
+  수신 WSM 을 prcsJ2735 로 전달한다.
+  msg 는 수신 메타데이터 헤더(struct msgQ_rx_meta)와 WSM body 로 구성된다.
+
+  arguments
+    meta : 수신 메타데이터
+    pPkt : WSM body
+    len  : WSM body 길이
+
+  return
+
+ ****************************************************************************************/
+void sendMQ(const struct msgQ_rx_meta *meta, uint8_t *pPkt, uint32_t len)
 {
+    if (len > MSGMAX - sizeof(struct msgQ_rx_meta))
+    {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] MQ send error : too long packet(%u)", len);
+        V2X_OBU_INC_CNT(meta->ifindex, rx_ipc_fail);
+        return;
+    }
+    pthread_mutex_lock(&recvMtx);
     memset(recvPkt->msg.msg, 0, recvPkt->msg.msg_len);
-    recvPkt->msg.msg_len = len;
-    memcpy(recvPkt->msg.msg, pPkt, len);
+    recvPkt->msg.msg_len = sizeof(struct msgQ_rx_meta) + len;
+    memcpy(recvPkt->msg.msg, meta, sizeof(struct msgQ_rx_meta));
+    memcpy(recvPkt->msg.msg + sizeof(struct msgQ_rx_meta), pPkt, len);
 
-    recvPkt->rxCnt = msgqCnt++;
+    recvPkt->rxCnt = __atomic_fetch_add(&msgqCnt, 1, __ATOMIC_RELAXED);
     recvPkt->msgtype = 1; 
 
     if( msgsnd( recvFD, (char *)recvPkt, sizeof(struct msgQ_elem_frame) - sizeof(long), IPC_NOWAIT) == -1 )
     {
         //perror("[precsWSM] MQ send error : ");
         syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] MQ send error : %s", strerror(errno));
+        V2X_OBU_INC_CNT(meta->ifindex, rx_ipc_fail);
     }
     else
     {
+        V2X_OBU_INC_CNT(meta->ifindex, rx_ipc);
         if (g_dbg >= kDbgMsgLevel_event)
         {
             //printf("[prcsWSM] MQ send(%d Byte) \n", recvPkt->msg.msg_len);
             syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] MQ send(%d Byte) \n", recvPkt->msg.msg_len);
         }
     }
+    pthread_mutex_unlock(&recvMtx);
 }
 
-void PARsendMQ(uint8_t *pPkt, uint32_t len)
+/****************************************************************************************
+
+  PARsendMQ()
+  수신 WSM 을 PAR 로 전달한다. msg 형식은 sendMQ() 와 동일하다.
+
+  arguments
+    meta : 수신 메타데이터
+    pPkt : WSM body
+    len  : WSM body 길이
+
+  return
+
+ ****************************************************************************************/
+void PARsendMQ(const struct msgQ_rx_meta *meta, uint8_t *pPkt, uint32_t len)
 {
+	if (len > MSGMAX - sizeof(struct msgQ_rx_meta))
+	{
+		syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] PAR MQ send error : too long packet(%u)", len);
+		V2X_OBU_INC_CNT(meta->ifindex, rx_ipc_fail);
+		return;
+	}
+	pthread_mutex_lock(&parRecvMtx);
 	memset(parRecvPkt->msg.msg, 0, parRecvPkt->msg.msg_len);
-	parRecvPkt->msg.msg_len = len;
-	memcpy(parRecvPkt->msg.msg, pPkt, len);
+	parRecvPkt->msg.msg_len = sizeof(struct msgQ_rx_meta) + len;
+	memcpy(parRecvPkt->msg.msg, meta, sizeof(struct msgQ_rx_meta));
+	memcpy(parRecvPkt->msg.msg + sizeof(struct msgQ_rx_meta), pPkt, len);
 
-	parRecvPkt->rxCnt = msgqCnt++;
+	parRecvPkt->rxCnt = __atomic_fetch_add(&msgqCnt, 1, __ATOMIC_RELAXED);
 	parRecvPkt->msgtype = 1;
 
 	if( msgsnd( parRecvFD, (char *)parRecvPkt, sizeof(struct msgQ_elem_frame) - sizeof(long), IPC_NOWAIT) == -1 )
 	{
 		//perror("[precsWSM] PAR MQ send error : ");
 		syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] PAR MQ send error : %s", strerror(errno));
+		V2X_OBU_INC_CNT(meta->ifindex, rx_ipc_fail);
 	}
 	else
 	{
+		V2X_OBU_INC_CNT(meta->ifindex, rx_ipc);
 		if (g_dbg >= kDbgMsgLevel_event)
 		{
 			//printf("[prcsWSM] MQ send(%d Byte) for PAR \n", parRecvPkt->msg.msg_len);
 			syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] MQ send(%d Byte) for PAR \n", parRecvPkt->msg.msg_len);
 		}
 	}
+	pthread_mutex_unlock(&parRecvMtx);
 }
@@ -38,12 +38,42 @@ struct msgQ_elem_frame
 };
 
 
+/*
+ * prcsWSM 이 수신 WSM 을 전달할 때 msg 앞에 붙이는 수신 메타데이터 헤더
+ *  - msg = [struct msgQ_rx_meta][WSM body]
+ *  - WSM body 는 msg 의 hdr_len 오프셋부터 시작한다. (이후 버전에서 필드가 추가되어도 하위호환)
+ *  - 모든 필드는 호스트 바이트오더로 저장된다. (동일 장비 내 프로세스 간 전달용)
+ */
+#define MSGQ_RX_META_VERSION 1
+
+struct msgQ_rx_meta
+{
+   uint8_t  version;       // 헤더 버전 (MSGQ_RX_META_VERSION)
+   uint8_t  hdr_len;       // 헤더 길이 (=WSM body 오프셋)
+   uint8_t  ifindex;       // 수신 인터페이스 식별번호
+   uint8_t  timeslot;      // 수신 TimeSlot
+   uint8_t  channel;       // 수신 채널번호
+   uint8_t  datarate;      // 수신 데이터레이트 (500kbps 단위)
+   uint8_t  rcpi;          // RCPI
+   uint8_t  wsmp_version;  // WSMP 버전
+   int16_t  rxpower;       // 수신 파워 (0.5dBm 단위). -32768=Unknown
+   uint8_t  src_mac[6];    // 송신지 MAC 주소
+   uint32_t psid;          // WSMP-T-Header PSID
+   int16_t  tx_chan_num;   // WSMP-N-Header ChannelNumber 확장필드 (없으면 -999)
+   int16_t  tx_datarate;   // WSMP-N-Header DataRate 확장필드 (없으면 -999)
+   int16_t  tx_power;      // WSMP-N-Header TransmitPowerUsed 확장필드 (없으면 -999)
+   uint8_t  priority;      // 사용자 우선순위
+   uint8_t  reserved;
+   uint64_t mono_ns;       // 수신시각 (CLOCK_MONOTONIC, 나노초)
+   uint64_t gps_us;        // 수신시각 (CLOCK_REALTIME, 마이크로초 - timeSync 에 의해 GPS 시각으로 동기화됨)
+} __attribute__((packed));
+
 static struct mq_attr cn_MQ_attr = {O_NONBLOCK, 10, sizeof(struct msgQ_elem_frame), 0};
 #endif /* !_CNVC_MSGQ_H_ */
 
 /* 함수원형 */
 int initMQ(void);
 void releaseMQ(void);
-int recvMQ(char *pkt);
-void sendMQ(uint8_t *pPkt, uint32_t len);
-void PARsendMQ(uint8_t *pPkt, uint32_t len);
+int recvMQ(uint8_t ifindex, char *pkt);
+void sendMQ(const struct msgQ_rx_meta *meta, uint8_t *pPkt, uint32_t len);
+void PARsendMQ(const struct msgQ_rx_meta *meta, uint8_t *pPkt, uint32_t len);
@@ -6,7 +6,7 @@
 	전역변수
 
 ****************************************************************************************/
-static const char	*optStr	=	"a:x:n:k:p:r:w:o:b:h";
+static const char	*optStr	=	"a:x:n:k:p:r:w:o:l:b:T:R:i:W:S:L:JD:C:h";
 
 
 /****************************************************************************************
@@ -30,7 +30,9 @@ static void usage(char *cmd) {
   printf("                           rx    : receive only\n");
   printf("                           tx    : transmit only\n");
   printf("                           trx   : transmit and receive\n");
-  printf("  -x <netifindex>        set network interface index(for tx)\n");
+  printf("  -x <netifindex>        select network interface to operate\n");
+  printf("                           -n, -k, -r, -w, -o, -l, -T, -R, -J after -x apply to that interface\n");
+  printf("                           may be repeated to operate several interfaces at once\n");
   printf("                           if not specified, set to 0\n");
   printf("  -n <channel>           set channel number(for tx)\n");
   printf("                           if not specified, set to CCH\n");
@@ -45,12 +47,45 @@ static void usage(char *cmd) {
   printf("                           if not specified, set to 20dBm\n");
   printf("  -o <priority>          set tx priority(for tx)\n");
   printf("                           if not specified, set to 7\n");
+  printf("  -l <lifetime>          set tx lifetime(in msec)(for tx)\n");
+  printf("                           frames not sent within lifetime are dropped\n");
+  printf("                           0 : never expire\n");
+  printf("                           if not specified, set to 1000msec\n");
+  printf("  -T <cpu>               set cpu core of tx thread(for tx, trx)\n");
+  printf("                           if not specified, not pinned\n");
+  printf("  -R <cpu>               set cpu core of rx threads(for rx, trx)\n");
+  printf("                           if not specified, not pinned\n");
+  printf("  -i <interval>          set telemetry interval(in msec)\n");
+  printf("                           statistics are published to shared memory %s\n", V2X_OBU_SHM_STATS_NAME);
+  printf("                           0 : disable telemetry\n");
+  printf("                           if not specified, set to %umsec\n", V2X_OBU_TELEMETRY_DEFAULT_INTERVAL);
+  printf("  -J                     join service channel advertised in WSA automatically(for rx, trx)\n");
+  printf("                           channel(-n) is scanned as CCH, and psid(-p) service channel is accessed\n");
+  printf("                           on time slot 1 while WSA is received\n");
+  printf("  -W <repeatrate>        transmit WSA on the interface selected by -x(for tx, trx)\n");
+  printf("                           the interface should access CCH (-n)\n");
+  printf("                           repeatrate : number of WSAs per 5 seconds (1~255)\n");
+  printf("  -S <channel>           advertise psid(-p) on service channel in WSA\n");
+  printf("                           if not specified, WSA is not transmitted until a PSR is added\n");
+  printf("  -L <lat,lon[,elev]>    set WSA 3D location(in degree, degree, meter)\n");
+  printf("                           if not specified, location is not included\n");
+  printf("  -D <conf>              activate DCC(decentralized congestion control) on all interfaces\n");
+  printf("                           channel busy ratio is measured from received frames (for rx, trx)\n");
+  printf("                           and tx interval per psid, tx power, datarate are limited by DCC state\n");
+  printf("                           default : built-in state table\n");
+  printf("                           <file>  : state table file (see v2x-obu-dcc.c)\n");
+  printf("  -C <file>              capture tx/rx MPDUs to pcapng file (802.11 link type)\n");
+  printf("                           channel, rcpi, rxpower, datarate are recorded in packet comments\n");
   printf("  -b                     activate debug message output\n");
   printf("  -h                     Print usage\n");
 
   printf("\nExample usage\n");
   printf("  Rx         : %s -a rx -p 20\n", cmd);
   printf("  Tx         : %s -a tx -p 20\n", cmd);
+  printf("  Tx/Rx      : %s -a trx -p 20 -T 1 -R 2\n", cmd);
+  printf("  2 ifs      : %s -a trx -p 20 -x 0 -n 178 -T 0 -R 1 -x 1 -n 184 -T 2 -R 3\n", cmd);
+  printf("  Join       : %s -a rx -p 20 -x 0 -n 180 -J\n", cmd);
+  printf("  WSA        : %s -a trx -p 20 -x 0 -n 180 -W 50 -S 178 -L 37.4000000,127.1000000,50\n", cmd);
   printf("\n");
 }
 
@@ -74,6 +109,12 @@ int32_t ParsingOptions(int32_t argc, char *argv[])
 	int32_t opt;
 	bool actionSpecified = false;
 	bool psidSpecified = false;
+	bool ifSpecified = false;
+	long ifIndex;
+	long repeatRate;
+	double lat, lon, elev;
+	int locNum;
+	struct V2X_OBU_IF_MIB *ifMib = &g_mib.ifs[0];
 
 	/*----------------------------------------------------------------------------------*/
 	/* 파라미터 파싱 및 저장 */
@@ -96,15 +137,22 @@ int32_t ParsingOptions(int32_t argc, char *argv[])
 			break;
 
 		case 'x':
-			g_mib.netIfIndex	=	(uint32_t)strtol(optarg, NULL, 10);
+			ifIndex	=	strtol(optarg, NULL, 10);
+			if((ifIndex < 0) || (ifIndex >= V2X_OBU_IF_MAX_NUM)) {
+				printf("Invalid netifindex - %s\n", optarg);
+				return	-1;
+			}
+			ifMib	=	&g_mib.ifs[ifIndex];
+			ifMib->enable	=	true;
+			ifSpecified	=	true;
 			break;
 
 		case 'n':
-			g_mib.channel=	(Dot3ChannelNumber)strtol(optarg, NULL, 10);
+			ifMib->channel	=	(Dot3ChannelNumber)strtol(optarg, NULL, 10);
 			break;
 
 		case 'k':
-			g_mib.timeSlot =	(Dot3TimeSlot)strtoul(optarg, NULL, 10);
+			ifMib->timeSlot	=	(Dot3TimeSlot)strtoul(optarg, NULL, 10);
 			break;
 
 		case 'p':
@@ -113,15 +161,72 @@ int32_t ParsingOptions(int32_t argc, char *argv[])
 			break;
 
 		case 'r':
-			g_mib.dataRate	=	(Dot3DataRate)strtol(optarg, NULL, 10);
+			ifMib->dataRate	=	(Dot3DataRate)strtol(optarg, NULL, 10);
 			break;
 
 		case 'w':
-			g_mib.power		=	(Dot3Power)strtol(optarg, NULL, 10);
+			ifMib->power	=	(Dot3Power)strtol(optarg, NULL, 10);
 			break;
 
 		case 'o':
-			g_mib.priority		=	(Dot3Priority)strtol(optarg, NULL, 10);
+			ifMib->priority	=	(Dot3Priority)strtol(optarg, NULL, 10);
+			break;
+
+		case 'l':
+			ifMib->lifetime	=	(uint32_t)strtoul(optarg, NULL, 10) * 1000;
+			break;
+
+		case 'T':
+			ifMib->txCpu	=	(int)strtol(optarg, NULL, 10);
+			break;
+
+		case 'R':
+			ifMib->rxCpu	=	(int)strtol(optarg, NULL, 10);
+			break;
+
+		case 'i':
+			g_mib.telemetry_interval	=	(uint32_t)strtoul(optarg, NULL, 10);
+			break;
+
+		case 'J':
+			ifMib->svcJoin	=	true;
+			break;
+
+		case 'W':
+			repeatRate	=	strtol(optarg, NULL, 10);
+			if((repeatRate < 1) || (repeatRate > kDot3WsaRepeatRate_Max)) {
+				printf("Invalid WSA repeat rate - %s\n", optarg);
+				return	-1;
+			}
+			g_mib.wsa.enable	=	true;
+			g_mib.wsa.ifindex	=	(uint8_t)(ifMib - g_mib.ifs);
+			g_mib.wsa.repeat_rate	=	(Dot3WsaRepeatRate)repeatRate;
+			break;
+
+		case 'S':
+			g_mib.wsa.service_chan	=	(Dot3ChannelNumber)strtol(optarg, NULL, 10);
+			break;
+
+		case 'L':
+			elev	=	0;
+			locNum	=	sscanf(optarg, "%lf,%lf,%lf", &lat, &lon, &elev);
+			if((locNum < 2) || (lat < -90.0) || (lat > 90.0) || (lon < -180.0) || (lon >= 180.0)) {
+				printf("Invalid WSA location - %s\n", optarg);
+				return	-1;
+			}
+			g_mib.wsa.loc_valid	=	true;
+			g_mib.wsa.loc.latitude	=	(Dot3Latitude)((lat * 1e7) + ((lat < 0) ? -0.5 : 0.5));
+			g_mib.wsa.loc.longitude	=	(Dot3Longitude)((lon * 1e7) + ((lon < 0) ? -0.5 : 0.5));
+			g_mib.wsa.loc.elevation	=	(locNum == 3) ? (Dot3Elevation)((elev * 10) + ((elev < 0) ? -0.5 : 0.5)) : kDot3Elevation_Unavailable;
+			break;
+
+		case 'D':
+			if(V2X_OBU_ConfigDcc(optarg) < 0)
+				return	-1;
+			break;
+
+		case 'C':
+			g_mib.capture_path	=	optarg;
 			break;
 
 		case 'b':
@@ -147,6 +252,10 @@ int32_t ParsingOptions(int32_t argc, char *argv[])
 		return -1;
 	}
 
+	/* 인터페이스를 지정하지 않으면 인터페이스 0 만 운용한다. */
+	if(!ifSpecified)
+		g_mib.ifs[0].enable	=	true;
+
 	return 0;
 }
 
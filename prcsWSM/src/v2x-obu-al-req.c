@@ -0,0 +1,130 @@
+/**
+ * @file v2x-obu-al-req.c
+ * @date 2026-10-19
+ * @brief 액세스계층 제어요청(Al_AccessChannel(), Al_SetIfMacAddress() 등)의 비동기 완료 처리 구현
+ *
+ * 액세스계층 제어요청은 API 리턴 후 결과 콜백함수(폴링쓰레드)로 완료가 통지된다.
+ * 요청 종류/인터페이스 별로 완료 객체를 두고, 요청 쓰레드는 완료 객체의 condition variable 에서 타임아웃을 두고 대기한다.
+ *  - 요청 시 V2X_OBU_StartAlReq() 로 토큰을 발급받은 후 Al_*() 를 호출하고, V2X_OBU_WaitAlReq() 로 완료를 대기한다.
+ *  - 결과 콜백함수에서는 V2X_OBU_CompleteAlReq() 를 호출한다.
+ *  - 결과 콜백에는 요청 식별정보가 없으므로, 타임아웃된 이전 요청의 결과가 뒤늦게 도착하면 다음 요청의 완료로 처리될 수 있다.
+ *    (동일한 요청을 재시도하는 경우에는 문제가 되지 않는다)
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+
+#include "v2x-obu.h"
+
+
+/**
+ * 액세스계층 제어요청 완료 객체
+ */
+struct V2X_OBU_AlReq
+{
+    pthread_mutex_t mtx;
+    pthread_cond_t cond;
+    uint32_t issued;    ///< 발급된 요청 토큰 (마지막 요청의 토큰)
+    uint32_t done;      ///< 완료된 요청 토큰
+};
+
+static struct V2X_OBU_AlReq g_al_req[kV2XObuAlReq_Num][V2X_OBU_IF_MAX_NUM]; ///< 요청 종류/인터페이스 별 완료 객체
+
+
+/**
+ * 액세스계층 제어요청 완료 객체들을 초기화한다. 결과 콜백함수 등록 전에 호출되어야 한다.
+ */
+void V2X_OBU_InitAlReq(void)
+{
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    for (int kind = 0; kind < kV2XObuAlReq_Num; kind++) {
+        for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+            memset(&g_al_req[kind][i], 0, sizeof(struct V2X_OBU_AlReq));
+            pthread_mutex_init(&g_al_req[kind][i].mtx, NULL);
+            pthread_cond_init(&g_al_req[kind][i].cond, &attr);
+        }
+    }
+    pthread_condattr_destroy(&attr);
+}
+
+
+/**
+ * 액세스계층 제어요청을 시작한다. Al_*() 호출 직전에 호출한다.
+ *  - 이전에 완료되지 않은 요청은 더 이상 대기하지 않는 것으로 처리한다.
+ *
+ * @param kind      요청 종류
+ * @param ifindex   인터페이스 식별번호
+ * @return          V2X_OBU_WaitAlReq() 에 전달할 요청 토큰
+ */
+uint32_t V2X_OBU_StartAlReq(const V2XObuAlReqKind kind, const uint8_t ifindex)
+{
+    struct V2X_OBU_AlReq *const req = &g_al_req[kind][ifindex];
+    uint32_t token;
+
+    pthread_mutex_lock(&req->mtx);
+    req->done = req->issued;
+    token = ++req->issued;
+    pthread_mutex_unlock(&req->mtx);
+    return token;
+}
+
+
+/**
+ * 액세스계층 제어요청의 완료를 통지한다. 결과 콜백함수(폴링쓰레드)에서 호출된다.
+ *
+ * @param kind      요청 종류
+ * @param ifindex   인터페이스 식별번호
+ */
+void V2X_OBU_CompleteAlReq(const V2XObuAlReqKind kind, const uint8_t ifindex)
+{
+    struct V2X_OBU_AlReq *req;
+
+    if ((kind >= kV2XObuAlReq_Num) || (ifindex >= V2X_OBU_IF_MAX_NUM)) {
+        return;
+    }
+    req = &g_al_req[kind][ifindex];
+    pthread_mutex_lock(&req->mtx);
+    if (req->done != req->issued) {
+        req->done++;
+        pthread_cond_broadcast(&req->cond);
+    }
+    pthread_mutex_unlock(&req->mtx);
+}
+
+
+/**
+ * 액세스계층 제어요청의 완료를 대기한다.
+ *
+ * @param kind      요청 종류
+ * @param ifindex   인터페이스 식별번호
+ * @param token     V2X_OBU_StartAlReq() 에서 발급받은 요청 토큰
+ * @param timeout   최대 대기시간 (msec 단위)
+ * @return          완료 시 0, 타임아웃 시 -1
+ */
+int V2X_OBU_WaitAlReq(const V2XObuAlReqKind kind, const uint8_t ifindex, const uint32_t token, const uint32_t timeout)
+{
+    struct V2X_OBU_AlReq *const req = &g_al_req[kind][ifindex];
+    const uint64_t deadline = V2X_OBU_GetMonoTimeNs() + (uint64_t)timeout * 1000000ULL;
+    struct timespec ts;
+    int ret = 0;
+
+    ts.tv_sec = (time_t)(deadline / 1000000000ULL);
+    ts.tv_nsec = (long)(deadline % 1000000000ULL);
+
+    pthread_mutex_lock(&req->mtx);
+    while ((int32_t)(req->done - token) < 0) {
+        ret = pthread_cond_timedwait(&req->cond, &req->mtx, &ts);
+        if (ret) {
+            break;
+        }
+    }
+    ret = ((int32_t)(req->done - token) < 0) ? -1 : 0;
+    pthread_mutex_unlock(&req->mtx);
+    return ret;
+}
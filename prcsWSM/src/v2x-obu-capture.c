@@ -0,0 +1,462 @@
+/**
+ * @file v2x-obu-capture.c
+ * @date 2026-10-19
+ * @author gyun
+ * @brief 송수신 MPDU pcapng 캡쳐 기능 구현
+ *
+ * 송수신 MPDU 와 메타데이터를 잠금 없는 링에 복사하고, 캡쳐 쓰레드가 링에서 꺼내 pcapng 파일로 기록한다.
+ *  - 링은 여러 생산자(인터페이스 별 수신쓰레드/송신쓰레드), 하나의 소비자(캡쳐 쓰레드) 구조의 bounded 큐이다.
+ *    생산자는 슬롯을 CAS 로 할당하고 MPDU 를 복사할 뿐, 잠금이나 시스템콜을 사용하지 않으므로 송수신 타이밍에 영향이 없다.
+ *  - 링이 가득 차면 생산자는 해당 MPDU 를 버리고 cap_drop 카운터를 증가시킨다. 버려진 개수는 주기적으로 기록되는
+ *    pcapng ISB(Interface Statistics Block)의 isb_osdrop 옵션으로도 남는다.
+ *  - 링은 V2X_OBU_CAPTURE_RING_SIZE 개의 MPDU 버스트를 흡수하며, 평균 송수신율이 캡쳐 쓰레드의 기록 속도
+ *    (x64/tmpfs 에서 초당 수십만 MPDU) 이하이면 손실 없이 기록된다.
+ *  - 링크 유형은 LINKTYPE_IEEE802_11(105, FCS 제외)이며, 인터페이스 별로 IDB 가 하나씩 기록된다.
+ *    각 패킷의 방향은 epb_flags 로, 채널/TimeSlot/DataRate/RCPI/수신파워/송신파워는 패킷 주석(opt_comment)으로 기록된다.
+ *  - 타임스탬프는 CLOCK_REALTIME(timeSync 에 의해 GPS 시각으로 동기화됨) 나노초 단위이다.
+ */
+
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "dot3/dot3.h"
+
+#include "v2x-obu.h"
+
+
+#define PCAPNG_BT_SHB (0x0A0D0D0AU)         ///< Section Header Block
+#define PCAPNG_BT_IDB (0x00000001U)         ///< Interface Description Block
+#define PCAPNG_BT_ISB (0x00000005U)         ///< Interface Statistics Block
+#define PCAPNG_BT_EPB (0x00000006U)         ///< Enhanced Packet Block
+#define PCAPNG_BYTE_ORDER_MAGIC (0x1A2B3C4DU)
+#define PCAPNG_LINKTYPE_IEEE802_11 (105)
+#define PCAPNG_OPT_ENDOFOPT (0)
+#define PCAPNG_OPT_COMMENT (1)
+#define PCAPNG_OPT_SHB_USERAPPL (4)
+#define PCAPNG_OPT_IF_NAME (2)
+#define PCAPNG_OPT_IF_TSRESOL (9)
+#define PCAPNG_OPT_EPB_FLAGS (2)
+#define PCAPNG_OPT_ISB_OSDROP (6)
+#define PCAPNG_EPB_FLAGS_INBOUND (1U)
+#define PCAPNG_EPB_FLAGS_OUTBOUND (2U)
+
+#define CAPTURE_DIR_RX (0)
+#define CAPTURE_DIR_TX (1)
+
+
+/**
+ * 캡쳐 레코드
+ */
+struct V2X_OBU_CaptureRec
+{
+  uint64_t ts;          ///< 송수신 시각 (CLOCK_REALTIME, 나노초)
+  uint32_t tx_seq;      ///< 송신 태그 일련번호 (송신)
+  int32_t tx_ret;       ///< Al_TransmitMpdu() 결과 (송신)
+  int16_t rxpower;      ///< 수신파워 (0.5dBm 단위, 수신)
+  int8_t txpower;       ///< 송신파워 (0.5dBm 단위, 송신)
+  uint8_t ifindex;
+  uint8_t dir;          ///< CAPTURE_DIR_RX 또는 CAPTURE_DIR_TX
+  uint8_t channel;
+  uint8_t timeslot;
+  uint8_t datarate;     ///< 500kbps 단위
+  uint8_t rcpi;         ///< RCPI (수신)
+  uint16_t len;         ///< MPDU 길이
+  uint8_t mpdu[kMpduMaxSize];
+};
+
+/**
+ * 캡쳐 링 슬롯
+ */
+struct V2X_OBU_CaptureSlot
+{
+  uint64_t seq;         ///< 슬롯 상태 (seq == pos 이면 비어 있음, seq == pos + 1 이면 기록 완료)
+  struct V2X_OBU_CaptureRec rec;
+};
+
+static struct {
+  bool enable;
+  FILE *fp;
+  pthread_t thread;     ///< 캡쳐 쓰레드
+  uint64_t enq_pos __attribute__((aligned(64)));  ///< 생산자 할당 위치
+  uint64_t deq_pos __attribute__((aligned(64)));  ///< 소비자 위치 (캡쳐 쓰레드만 접근)
+  struct V2X_OBU_CaptureSlot *ring;
+} g_cap;
+
+
+/**
+ * 링에서 레코드를 기록할 슬롯을 할당한다.
+ *
+ * @param ifindex   인터페이스 식별번호 (링이 가득 찼을 때 버려진 개수 집계용)
+ * @param pos       할당된 위치가 반환될 변수의 포인터
+ * @return          할당된 슬롯 (링이 가득 차면 NULL)
+ */
+static struct V2X_OBU_CaptureSlot* V2X_OBU_AllocCaptureSlot(const uint8_t ifindex, uint64_t *const pos)
+{
+    struct V2X_OBU_CaptureSlot *slot;
+    uint64_t p = __atomic_load_n(&g_cap.enq_pos, __ATOMIC_RELAXED);
+    int64_t diff;
+
+    while (1) {
+        slot = &g_cap.ring[p & (V2X_OBU_CAPTURE_RING_SIZE - 1)];
+        diff = (int64_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - p);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&g_cap.enq_pos, &p, p + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *pos = p;
+                return slot;
+            }
+        } else if (diff < 0) {
+            V2X_OBU_INC_CNT(ifindex, cap_drop);
+            return NULL;
+        } else {
+            p = __atomic_load_n(&g_cap.enq_pos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+
+/**
+ * 수신 MPDU 를 캡쳐한다. 수신쓰레드에서 호출된다.
+ *
+ * @param mpdu      수신 MPDU
+ * @param mpdu_size 수신 MPDU 길이
+ * @param meta      수신 메타데이터
+ */
+void V2X_OBU_CaptureRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size, const struct msgQ_rx_meta *const meta)
+{
+    struct V2X_OBU_CaptureSlot *slot;
+    uint64_t pos;
+
+    if (!g_cap.enable) {
+        return;
+    }
+    slot = V2X_OBU_AllocCaptureSlot(meta->ifindex, &pos);
+    if (!slot) {
+        return;
+    }
+    slot->rec.ts = meta->gps_us * 1000ULL;
+    slot->rec.ifindex = meta->ifindex;
+    slot->rec.dir = CAPTURE_DIR_RX;
+    slot->rec.channel = meta->channel;
+    slot->rec.timeslot = meta->timeslot;
+    slot->rec.datarate = meta->datarate;
+    slot->rec.rcpi = meta->rcpi;
+    slot->rec.rxpower = meta->rxpower;
+    slot->rec.len = (mpdu_size < kMpduMaxSize) ? mpdu_size : kMpduMaxSize;
+    memcpy(slot->rec.mpdu, mpdu, slot->rec.len);
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * 송신 MPDU 를 캡쳐한다. 송신쓰레드에서 Al_TransmitMpdu() 호출 후에 호출된다.
+ *
+ * @param tag       송신 태그
+ * @param mpdu      송신 MPDU
+ * @param mpdu_size 송신 MPDU 길이
+ * @param al_params 송신 파라미터
+ * @param ret       Al_TransmitMpdu() 결과
+ */
+void V2X_OBU_CaptureTxMpdu(
+        const struct V2X_OBU_TxTag *const tag,
+        const uint8_t *const mpdu,
+        const uint16_t mpdu_size,
+        const struct AlMpduTxParams *const al_params,
+        const int ret)
+{
+    struct V2X_OBU_CaptureSlot *slot;
+    struct timespec ts;
+    uint64_t pos;
+
+    if (!g_cap.enable) {
+        return;
+    }
+    slot = V2X_OBU_AllocCaptureSlot(tag->ifindex, &pos);
+    if (!slot) {
+        return;
+    }
+    clock_gettime(CLOCK_REALTIME, &ts);
+    slot->rec.ts = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    slot->rec.ifindex = tag->ifindex;
+    slot->rec.dir = CAPTURE_DIR_TX;
+    slot->rec.tx_seq = tag->seq;
+    slot->rec.tx_ret = ret;
+    slot->rec.channel = al_params->channel;
+    slot->rec.timeslot = al_params->timeslot;
+    slot->rec.datarate = al_params->datarate;
+    slot->rec.txpower = al_params->txpower;
+    slot->rec.len = (mpdu_size < kMpduMaxSize) ? mpdu_size : kMpduMaxSize;
+    memcpy(slot->rec.mpdu, mpdu, slot->rec.len);
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * pcapng 옵션을 버퍼에 추가한다. (값은 4바이트 단위로 패딩된다)
+ *
+ * @param buf       버퍼
+ * @param off       버퍼 내 기록 위치 (기록 후 다음 위치로 갱신된다)
+ * @param code      옵션 코드
+ * @param val       옵션 값
+ * @param len       옵션 값 길이
+ */
+static void V2X_OBU_PutPcapngOpt(uint8_t *const buf, size_t *const off, const uint16_t code, const void *const val, const uint16_t len)
+{
+    memcpy(buf + *off, &code, 2);
+    memcpy(buf + *off + 2, &len, 2);
+    memcpy(buf + *off + 4, val, len);
+    memset(buf + *off + 4 + len, 0, (4 - (len & 3)) & 3);
+    *off += 4 + ((len + 3U) & ~3U);
+}
+
+
+/**
+ * pcapng 블록을 완성하여 파일에 기록한다. (블록 헤더와 trailer 의 길이를 채운다)
+ *
+ * @param buf       블록 (8바이트 블록 헤더부터 옵션 끝까지 채워진 상태)
+ * @param type      블록 유형
+ * @param off       블록 헤더를 포함한 현재 길이 (trailer 제외)
+ * @return          성공 시 0, 실패 시 -1
+ */
+static int V2X_OBU_WritePcapngBlock(uint8_t *const buf, const uint32_t type, size_t off)
+{
+    const uint16_t end[2] = { PCAPNG_OPT_ENDOFOPT, 0 };
+    uint32_t total;
+
+    memcpy(buf + off, end, sizeof(end));
+    off += sizeof(end);
+    total = (uint32_t)(off + 4);
+    memcpy(buf, &type, 4);
+    memcpy(buf + 4, &total, 4);
+    memcpy(buf + off, &total, 4);
+    return (fwrite(buf, 1, total, g_cap.fp) == total) ? 0 : -1;
+}
+
+
+/**
+ * 캡쳐 레코드를 EPB 로 기록한다.
+ *
+ * @param rec       캡쳐 레코드
+ * @return          성공 시 0, 실패 시 -1
+ */
+static int V2X_OBU_WriteCaptureRec(const struct V2X_OBU_CaptureRec *const rec)
+{
+    static uint8_t buf[kMpduMaxSize + 256];
+    char comment[128];
+    uint32_t v32, flags;
+    size_t off = 8;
+    int len;
+
+    v32 = rec->ifindex;
+    memcpy(buf + off, &v32, 4);
+    v32 = (uint32_t)(rec->ts >> 32);
+    memcpy(buf + off + 4, &v32, 4);
+    v32 = (uint32_t)rec->ts;
+    memcpy(buf + off + 8, &v32, 4);
+    v32 = rec->len;
+    memcpy(buf + off + 12, &v32, 4);
+    memcpy(buf + off + 16, &v32, 4);
+    off += 20;
+    memcpy(buf + off, rec->mpdu, rec->len);
+    memset(buf + off + rec->len, 0, (4 - (rec->len & 3)) & 3);
+    off += (rec->len + 3U) & ~3U;
+
+    if (rec->dir == CAPTURE_DIR_RX) {
+        flags = PCAPNG_EPB_FLAGS_INBOUND;
+        len = snprintf(comment, sizeof(comment), "rx if=%u ch=%u ts=%u rate=%u rcpi=%u rxpower=%d",
+                       rec->ifindex, rec->channel, rec->timeslot, rec->datarate, rec->rcpi, rec->rxpower);
+    } else {
+        flags = PCAPNG_EPB_FLAGS_OUTBOUND;
+        len = snprintf(comment, sizeof(comment), "tx if=%u ch=%u ts=%u rate=%u txpower=%d seq=%u ret=%d",
+                       rec->ifindex, rec->channel, rec->timeslot, rec->datarate, rec->txpower, rec->tx_seq, rec->tx_ret);
+    }
+    V2X_OBU_PutPcapngOpt(buf, &off, PCAPNG_OPT_COMMENT, comment, (uint16_t)len);
+    V2X_OBU_PutPcapngOpt(buf, &off, PCAPNG_OPT_EPB_FLAGS, &flags, 4);
+    return V2X_OBU_WritePcapngBlock(buf, PCAPNG_BT_EPB, off);
+}
+
+
+/**
+ * 인터페이스 별 ISB 를 기록한다. (캡쳐 링이 가득 차서 버려진 누적 개수를 isb_osdrop 으로 남긴다)
+ */
+static void V2X_OBU_WriteCaptureStats(void)
+{
+    uint8_t buf[64];
+    struct timespec ts;
+    uint64_t now, drop;
+    uint32_t v32;
+    size_t off;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    now = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    for (uint32_t i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        off = 8;
+        memcpy(buf + off, &i, 4);
+        v32 = (uint32_t)(now >> 32);
+        memcpy(buf + off + 4, &v32, 4);
+        v32 = (uint32_t)now;
+        memcpy(buf + off + 8, &v32, 4);
+        off += 12;
+        drop = __atomic_load_n(&g_cnt[i].cap_drop, __ATOMIC_RELAXED);
+        V2X_OBU_PutPcapngOpt(buf, &off, PCAPNG_OPT_ISB_OSDROP, &drop, 8);
+        V2X_OBU_WritePcapngBlock(buf, PCAPNG_BT_ISB, off);
+    }
+}
+
+
+/**
+ * pcapng 파일 헤더(SHB, 인터페이스 별 IDB)를 기록한다.
+ *
+ * @return  성공 시 0, 실패 시 -1
+ */
+static int V2X_OBU_WriteCaptureHeader(void)
+{
+    uint8_t buf[128];
+    const uint32_t bom = PCAPNG_BYTE_ORDER_MAGIC;
+    const uint16_t ver[2] = { 1, 0 };
+    const uint64_t section_len = UINT64_MAX;
+    const uint16_t linktype[2] = { PCAPNG_LINKTYPE_IEEE802_11, 0 };
+    const uint32_t snaplen = kMpduMaxSize;
+    const uint8_t tsresol = 9;
+    char name[16];
+    size_t off;
+
+    off = 8;
+    memcpy(buf + off, &bom, 4);
+    memcpy(buf + off + 4, ver, 4);
+    memcpy(buf + off + 8, &section_len, 8);
+    off += 16;
+    V2X_OBU_PutPcapngOpt(buf, &off, PCAPNG_OPT_SHB_USERAPPL, "prcsWSM", 7);
+    if (V2X_OBU_WritePcapngBlock(buf, PCAPNG_BT_SHB, off) < 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        off = 8;
+        memcpy(buf + off, linktype, 4);
+        memcpy(buf + off + 4, &snaplen, 4);
+        off += 8;
+        snprintf(name, sizeof(name), "v2x%d", i);
+        V2X_OBU_PutPcapngOpt(buf, &off, PCAPNG_OPT_IF_NAME, name, (uint16_t)strlen(name));
+        V2X_OBU_PutPcapngOpt(buf, &off, PCAPNG_OPT_IF_TSRESOL, &tsresol, 1);
+        if (V2X_OBU_WritePcapngBlock(buf, PCAPNG_BT_IDB, off) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+
+/**
+ * 캡쳐 링에 쌓인 레코드를 모두 기록한다.
+ *
+ * @return  기록한 레코드 개수
+ */
+static uint32_t V2X_OBU_DrainCaptureRing(void)
+{
+    struct V2X_OBU_CaptureSlot *slot;
+    uint32_t cnt = 0;
+
+    while (1) {
+        slot = &g_cap.ring[g_cap.deq_pos & (V2X_OBU_CAPTURE_RING_SIZE - 1)];
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != g_cap.deq_pos + 1) {
+            break;
+        }
+        if (V2X_OBU_WriteCaptureRec(&slot->rec) == 0) {
+            V2X_OBU_INC_CNT(slot->rec.ifindex, cap_pkt);
+        }
+        __atomic_store_n(&slot->seq, g_cap.deq_pos + V2X_OBU_CAPTURE_RING_SIZE, __ATOMIC_RELEASE);
+        g_cap.deq_pos++;
+        cnt++;
+    }
+    return cnt;
+}
+
+
+/**
+ * 캡쳐 쓰레드 함수
+ *  - 링이 비어 있으면 V2X_OBU_CAPTURE_POLL_INTERVAL 동안 쉰다.
+ *  - V2X_OBU_CAPTURE_FLUSH_INTERVAL 마다 ISB 를 기록하고 파일을 flush 하여, 프로그램이 강제 종료되어도 파일을 읽을 수 있도록 한다.
+ *
+ * @param arg       미사용
+ * @return          NULL (프로그램 종료시에만 리턴됨)
+ */
+static void* V2X_OBU_CaptureThread(void *arg)
+{
+    const struct timespec poll = { 0, V2X_OBU_CAPTURE_POLL_INTERVAL * 1000000L };
+    uint64_t now, last_flush = V2X_OBU_GetMonoTimeNs();
+    (void)arg;
+
+    do {
+        if (V2X_OBU_DrainCaptureRing() == 0) {
+            nanosleep(&poll, NULL);
+        }
+        now = V2X_OBU_GetMonoTimeNs();
+        if (now - last_flush >= (uint64_t)V2X_OBU_CAPTURE_FLUSH_INTERVAL * 1000000ULL) {
+            V2X_OBU_WriteCaptureStats();
+            fflush(g_cap.fp);
+            last_flush = now;
+        }
+    } while (1);
+
+    return NULL;
+}
+
+
+/**
+ * 캡쳐 기능을 초기화하고 캡쳐 쓰레드를 시작한다.
+ *
+ * @param path      pcapng 파일 경로
+ * @return          성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_InitCapture(const char *const path)
+{
+    int ret;
+
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Initializing capture to %s\n", path);
+
+    g_cap.ring = calloc(V2X_OBU_CAPTURE_RING_SIZE, sizeof(struct V2X_OBU_CaptureSlot));
+    if (!g_cap.ring) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to allocate capture ring\n");
+        return -1;
+    }
+    for (uint64_t i = 0; i < V2X_OBU_CAPTURE_RING_SIZE; i++) {
+        g_cap.ring[i].seq = i;
+    }
+    g_cap.enq_pos = g_cap.deq_pos = 0;
+
+    g_cap.fp = fopen(path, "wb");
+    if (!g_cap.fp) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to open capture file %s - %s\n", path, strerror(errno));
+        goto err;
+    }
+    setvbuf(g_cap.fp, NULL, _IOFBF, V2X_OBU_CAPTURE_FILE_BUF_SIZE);
+    if (V2X_OBU_WriteCaptureHeader() < 0) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to write capture file header\n");
+        goto err;
+    }
+
+    ret = pthread_create(&g_cap.thread, NULL, V2X_OBU_CaptureThread, NULL);
+    if (ret) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to create capture thread - %s\n", strerror(ret));
+        goto err;
+    }
+    g_cap.enable = true;
+
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to initialize capture\n");
+    return 0;
+
+err:
+    if (g_cap.fp) {
+        fclose(g_cap.fp);
+        g_cap.fp = NULL;
+    }
+    free(g_cap.ring);
+    g_cap.ring = NULL;
+    return -1;
+}
@@ -0,0 +1,367 @@
+/**
+ * @file v2x-obu-dcc.c
+ * @date 2026-10-19
+ * @author gyun
+ * @brief DCC(Decentralized Congestion Control) 기능 구현
+ *
+ * 인터페이스 별로 수신 프레임의 추정 송신시간(airtime) 합으로 CBR(Channel Busy Ratio)을 측정하고,
+ * CBR 에 따라 DCC 상태를 전이하여 송신 파라미터를 조절한다. (SAE J2945/1 방식의 상태 테이블)
+ *  - 각 상태는 진입 CBR 하한, PSID 별 최소 송신간격(ITT), 최대 송신파워, 송신 DataRate 로 구성된다.
+ *  - CBR 측정주기(V2X_OBU_DCC_MEAS_INTERVAL)마다 직전 측정값과 평균한 CBR 로 목표 상태를 정한다.
+ *  - 목표 상태가 높으면 up 회 연속, 낮으면 down 회 연속 측정된 후에 한 단계씩 전이한다. (히스테리시스)
+ *  - 상태 테이블은 설정파일로 바꿀 수 있으며, 설정파일 형식은 다음과 같다. ('#' 이후는 주석)
+ *      up <연속 측정 횟수>
+ *      down <연속 측정 횟수>
+ *      state <진입 CBR(%)> <ITT(msec, 0=제한없음)> <최대 송신파워(dBm)> <최소 DataRate(500kbps 단위, 0=인터페이스 설정값)>
+ *    state 는 진입 CBR 오름차순으로 나열하며, 첫번째 state 의 진입 CBR 은 0 이어야 한다.
+ *  - 교번 접속 시에도 측정주기 전체 시간을 기준으로 CBR 을 계산하므로, 한 채널의 점유율보다 낮게 측정된다.
+ */
+
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "dot3/dot3.h"
+
+#include "v2x-obu.h"
+
+
+/**
+ * 인터페이스 별 DCC 정보
+ */
+struct V2X_OBU_DccIf
+{
+  uint64_t busy;                    ///< 현재 측정주기 동안의 수신 airtime 합 (usec, 수신쓰레드가 원자적으로 증가)
+  uint32_t cbr;                     ///< 평균 CBR (0.1% 단위)
+  uint32_t state;                   ///< 현재 DCC 상태 (상태 테이블 인덱스)
+  uint32_t pending;                 ///< 목표 상태가 연속으로 측정된 횟수
+  int32_t pending_dir;              ///< 목표 상태 방향 (1=상향, -1=하향, 0=없음)
+
+  /* PSID 별 마지막 송신 시각 - 해당 인터페이스의 송신 메시지큐 수신쓰레드만 접근한다. */
+  uint32_t psid_num;
+  Dot3Psid psid[V2X_OBU_TX_STATS_PSID_MAX_NUM];
+  uint64_t last_tx_ns[V2X_OBU_TX_STATS_PSID_MAX_NUM];
+};
+
+static struct {
+  pthread_t thread;                 ///< CBR 측정 쓰레드
+  bool enable;
+  uint32_t up_num;                  ///< 상향 전이에 필요한 연속 측정 횟수
+  uint32_t down_num;                ///< 하향 전이에 필요한 연속 측정 횟수
+  uint32_t state_num;
+  struct V2X_OBU_DccState states[V2X_OBU_DCC_STATE_MAX_NUM];
+  struct V2X_OBU_DccIf ifs[V2X_OBU_IF_MAX_NUM];
+} g_dcc;
+
+/// 기본 DCC 상태 테이블 - CBR 50% 이상에서 송신간격을 늘리고 송신파워를 줄이며, 70% 이상에서는 DataRate 를 높여 airtime 을 줄인다.
+static const struct V2X_OBU_DccState g_dcc_default_states[] = {
+  { .cbr = 0,   .itt = 0,   .power = 20, .datarate = 0 },  // Relaxed
+  { .cbr = 500, .itt = 100, .power = 18, .datarate = 0 },  // Active1
+  { .cbr = 600, .itt = 200, .power = 15, .datarate = 0 },  // Active2
+  { .cbr = 700, .itt = 400, .power = 12, .datarate = kDot3DataRate_9Mbps },  // Active3
+  { .cbr = 800, .itt = 600, .power = 10, .datarate = kDot3DataRate_9Mbps },  // Restrictive
+};
+
+
+/**
+ * DCC 설정파일을 읽어 상태 테이블을 설정한다.
+ *
+ * @param path      설정파일 경로
+ * @return          성공 시 0, 실패 시 -1
+ */
+static int V2X_OBU_LoadDccConfig(const char *const path)
+{
+    FILE *fp;
+    char line[128], *p;
+    unsigned int num, cbr, itt;
+    int power, datarate;
+    uint32_t lineno = 0;
+
+    fp = fopen(path, "r");
+    if (!fp) {
+        printf("Fail to open DCC config file %s\n", path);
+        return -1;
+    }
+    g_dcc.state_num = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        lineno++;
+        p = strchr(line, '#');
+        if (p) {
+            *p = '\0';
+        }
+        if (sscanf(line, " up %u", &num) == 1) {
+            g_dcc.up_num = num ? num : 1;
+        } else if (sscanf(line, " down %u", &num) == 1) {
+            g_dcc.down_num = num ? num : 1;
+        } else if (sscanf(line, " state %u %u %d %d", &cbr, &itt, &power, &datarate) == 4) {
+            if ((g_dcc.state_num == V2X_OBU_DCC_STATE_MAX_NUM) || (cbr > 100) ||
+                ((g_dcc.state_num == 0) && (cbr != 0)) ||
+                ((g_dcc.state_num > 0) && (cbr * 10 <= g_dcc.states[g_dcc.state_num - 1].cbr)) ||
+                (itt > UINT16_MAX) || (power < kDot3Power_Min) || (power > kDot3Power_Max) ||
+                ((datarate != 0) && ((datarate < kDot3DataRate_Min) || (datarate > kDot3DataRate_Max)))) {
+                printf("Invalid DCC state at %s:%u\n", path, lineno);
+                fclose(fp);
+                return -1;
+            }
+            g_dcc.states[g_dcc.state_num].cbr = (uint16_t)(cbr * 10);
+            g_dcc.states[g_dcc.state_num].itt = (uint16_t)itt;
+            g_dcc.states[g_dcc.state_num].power = (Dot3Power)power;
+            g_dcc.states[g_dcc.state_num].datarate = (Dot3DataRate)datarate;
+            g_dcc.state_num++;
+        } else {
+            for (p = line; (*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\n'); p++);
+            if (*p != '\0') {
+                printf("Invalid DCC config at %s:%u\n", path, lineno);
+                fclose(fp);
+                return -1;
+            }
+        }
+    }
+    fclose(fp);
+
+    if (g_dcc.state_num == 0) {
+        printf("No DCC state in %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+
+/**
+ * DCC 설정을 지정한다. 옵션 파싱 시 호출된다.
+ *
+ * @param conf      설정파일 경로 ("default" 이면 기본 상태 테이블 사용)
+ * @return          성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_ConfigDcc(const char *const conf)
+{
+    g_dcc.up_num = V2X_OBU_DCC_DEFAULT_UP_NUM;
+    g_dcc.down_num = V2X_OBU_DCC_DEFAULT_DOWN_NUM;
+    if (!strcmp(conf, "default")) {
+        g_dcc.state_num = sizeof(g_dcc_default_states) / sizeof(g_dcc_default_states[0]);
+        memcpy(g_dcc.states, g_dcc_default_states, sizeof(g_dcc_default_states));
+    } else if (V2X_OBU_LoadDccConfig(conf) < 0) {
+        return -1;
+    }
+    g_dcc.enable = true;
+    return 0;
+}
+
+
+/**
+ * 수신 MPDU 의 airtime 을 CBR 측정에 반영한다. 수신쓰레드에서 호출된다.
+ *
+ * @param ifindex   수신 인터페이스 식별번호
+ * @param mpdu_size 수신 MPDU 길이 (CRC 제외)
+ * @param datarate  수신 DataRate (500kbps 단위)
+ */
+void V2X_OBU_CountDccRxAirtime(const uint8_t ifindex, const uint16_t mpdu_size, const uint8_t datarate)
+{
+    if (!g_dcc.enable || (ifindex >= V2X_OBU_IF_MAX_NUM)) {
+        return;
+    }
+    __atomic_fetch_add(&g_dcc.ifs[ifindex].busy,
+                       V2X_OBU_GetTxAirtime(mpdu_size + kAlMacCrcSize, datarate), __ATOMIC_RELAXED);
+}
+
+
+/**
+ * DCC 상태에 따른 송신파워와 DataRate 를 반환한다.
+ *  - 송신파워는 인터페이스 설정값과 상태의 최대 송신파워 중 작은 값이다.
+ *  - DataRate 는 인터페이스 설정값과 상태의 DataRate 중 큰 값이다. (airtime 을 줄이기 위해 높이기만 한다)
+ *  - DCC 가 동작하지 않으면 인터페이스 설정값을 그대로 반환한다.
+ *
+ * @param ifindex   송신 인터페이스 식별번호
+ * @param power     송신파워가 반환될 변수의 포인터
+ * @param datarate  송신 DataRate 가 반환될 변수의 포인터
+ */
+void V2X_OBU_GetDccTxParams(const uint8_t ifindex, Dot3Power *const power, Dot3DataRate *const datarate)
+{
+    const struct V2X_OBU_IF_MIB *const ifmib = &g_mib.ifs[ifindex];
+
+    *power = ifmib->power;
+    *datarate = ifmib->dataRate;
+    if (!g_dcc.enable) {
+        return;
+    }
+    const struct V2X_OBU_DccState *const st =
+            &g_dcc.states[__atomic_load_n(&g_dcc.ifs[ifindex].state, __ATOMIC_RELAXED)];
+    if (st->power < *power) {
+        *power = st->power;
+    }
+    if (st->datarate > *datarate) {
+        *datarate = st->datarate;
+    }
+}
+
+
+/**
+ * DCC 상태의 ITT 에 따라 PSID 의 송신 여부를 결정한다. 송신 메시지큐 수신쓰레드에서 호출된다.
+ *  - 마지막으로 송신한 시각으로부터 ITT 가 지나지 않은 송신 요청은 버린다.
+ *
+ * @param ifindex   송신 인터페이스 식별번호
+ * @param psid      송신 PSID
+ * @param now       현재시각 (CLOCK_MONOTONIC, 나노초)
+ * @return          송신해야 하면 true
+ */
+bool V2X_OBU_CheckDccTx(const uint8_t ifindex, const Dot3Psid psid, const uint64_t now)
+{
+    struct V2X_OBU_DccIf *const dif = &g_dcc.ifs[ifindex];
+    uint32_t i;
+
+    if (!g_dcc.enable) {
+        return true;
+    }
+    for (i = 0; i < dif->psid_num; i++) {
+        if (dif->psid[i] == psid) {
+            break;
+        }
+    }
+    if (i == dif->psid_num) {
+        if (dif->psid_num == V2X_OBU_TX_STATS_PSID_MAX_NUM) {
+            return true; // 추적할 수 없는 PSID 는 제한하지 않는다.
+        }
+        dif->psid[dif->psid_num++] = psid;
+        dif->last_tx_ns[i] = now;
+        return true;
+    }
+
+    const uint64_t itt = (uint64_t)g_dcc.states[__atomic_load_n(&dif->state, __ATOMIC_RELAXED)].itt * 1000000ULL;
+    if (now - dif->last_tx_ns[i] < itt) {
+        V2X_OBU_INC_CNT(ifindex, dcc_drop);
+        return false;
+    }
+    dif->last_tx_ns[i] = now;
+    return true;
+}
+
+
+/**
+ * 인터페이스의 DCC 상태를 확인한다. (통계 게시용)
+ *
+ * @param ifindex   인터페이스 식별번호
+ * @param cbr       평균 CBR(0.1% 단위)이 반환될 변수의 포인터
+ * @param state     현재 DCC 상태(상태 테이블 인덱스)가 반환될 변수의 포인터
+ * @param st        현재 DCC 상태 정보가 반환될 변수의 포인터
+ * @return          DCC 가 동작 중이면 true
+ */
+bool V2X_OBU_GetDccStatus(const uint8_t ifindex, uint32_t *const cbr, uint32_t *const state, struct V2X_OBU_DccState *const st)
+{
+    if (!g_dcc.enable || (ifindex >= V2X_OBU_IF_MAX_NUM)) {
+        return false;
+    }
+    *cbr = __atomic_load_n(&g_dcc.ifs[ifindex].cbr, __ATOMIC_RELAXED);
+    *state = __atomic_load_n(&g_dcc.ifs[ifindex].state, __ATOMIC_RELAXED);
+    *st = g_dcc.states[*state];
+    return true;
+}
+
+
+/**
+ * 측정된 CBR 로 DCC 상태를 갱신한다.
+ *
+ * @param ifindex   인터페이스 식별번호
+ * @param cbr       이번 측정주기의 CBR (0.1% 단위)
+ */
+static void V2X_OBU_UpdateDccState(const uint8_t ifindex, const uint32_t cbr)
+{
+    struct V2X_OBU_DccIf *const dif = &g_dcc.ifs[ifindex];
+    uint32_t target, state;
+    int32_t dir;
+
+    dif->cbr = (dif->cbr + cbr) / 2;
+    state = dif->state;
+    for (target = g_dcc.state_num - 1; target > 0; target--) {
+        if (dif->cbr >= g_dcc.states[target].cbr) {
+            break;
+        }
+    }
+
+    dir = (target > state) ? 1 : ((target < state) ? -1 : 0);
+    if ((dir == 0) || (dir != dif->pending_dir)) {
+        dif->pending = 0;
+    }
+    dif->pending_dir = dir;
+    if (dir == 0) {
+        return;
+    }
+    if (++dif->pending < ((dir > 0) ? g_dcc.up_num : g_dcc.down_num)) {
+        return;
+    }
+    dif->pending = 0;
+    state = (uint32_t)((int32_t)state + dir);
+    __atomic_store_n(&dif->state, state, __ATOMIC_RELAXED);
+    V2X_OBU_INC_CNT(ifindex, dcc_state_change);
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] DCC state of if%u changed to %u - cbr: %u.%u%%, itt: %umsec, power: %ddBm, datarate: %d\n",
+           ifindex, state, dif->cbr / 10, dif->cbr % 10, g_dcc.states[state].itt, g_dcc.states[state].power,
+           g_dcc.states[state].datarate);
+}
+
+
+/**
+ * CBR 측정 쓰레드 함수
+ *  - 측정주기마다 각 인터페이스의 수신 airtime 합으로 CBR 을 계산하고 DCC 상태를 갱신한다.
+ *
+ * @param arg       미사용
+ * @return          NULL (프로그램 종료시에만 리턴됨)
+ */
+static void* V2X_OBU_DccThread(void *arg)
+{
+    struct timespec next;
+    uint64_t prev, now, busy, cbr;
+    (void)arg;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    prev = V2X_OBU_GetMonoTimeNs();
+    do {
+        next.tv_nsec += V2X_OBU_DCC_MEAS_INTERVAL * 1000000L;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) != 0);
+
+        now = V2X_OBU_GetMonoTimeNs();
+        for (uint8_t i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+            if (!g_mib.ifs[i].enable) {
+                continue;
+            }
+            busy = __atomic_exchange_n(&g_dcc.ifs[i].busy, 0, __ATOMIC_RELAXED);
+            cbr = (now > prev) ? (busy * 1000000ULL) / (now - prev) : 0; // usec * 1000 / (nsec / 1000)
+            V2X_OBU_UpdateDccState(i, (cbr > 1000) ? 1000 : (uint32_t)cbr);
+        }
+        prev = now;
+    } while (1);
+
+    return NULL;
+}
+
+
+/**
+ * DCC 기능을 초기화하고 CBR 측정 쓰레드를 시작한다. DCC 가 설정되지 않았으면 아무 것도 하지 않는다.
+ *
+ * @return  성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_InitDcc(void)
+{
+    int ret;
+
+    if (!g_dcc.enable) {
+        return 0;
+    }
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Initializing DCC - %u states, up: %u, down: %u\n",
+           g_dcc.state_num, g_dcc.up_num, g_dcc.down_num);
+
+    ret = pthread_create(&g_dcc.thread, NULL, V2X_OBU_DccThread, NULL);
+    if (ret) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to create DCC thread - %s\n", strerror(ret));
+        g_dcc.enable = false;
+        return -1;
+    }
+
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to initialize DCC\n");
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "wlanaccess/wlanaccess.h"
@@ -18,33 +19,26 @@
 pthread_t g_poll_thread; ///< 이벤트 폴링 쓰레드
 
 
-/// 채널접속이 완료되었는지 여부를 나타내는 변수. 채널접속요청 API 와 채널접속결과 콜백함수에서 사용된다.
-volatile bool g_chan_access_complete = false;
-/// MAC주소설정이 완료되었는지 여부를 나타내는 변수. MAC주소설정요청 API 와 MAC주소설정결과 콜백함수에서 사용된다.
-volatile bool g_set_if_mac_addr_done = false;
-
 
 /**
  * MPDU 수신처리 콜백함수. access 라이브러리에서 호출된다.
+ *  - 배포된 libwlanaccess(armhf) 에는 일괄 수신처리 콜백(Al_RegisterCallbackRxMpduBatch)이 없으므로,
+ *    MPDU 별 수신처리 콜백으로 수신 큐에 넣는다.
  *
- * @param mpdu
- * @param mpdu_size
- * @param rxparams
+ * @param mpdu      수신된 MPDU
+ * @param mpdu_size 수신된 MPDU의 크기
+ * @param rxparams  수신패킷정보
  */
 static void V2X_OBU_ProcessRxMpduCallback(
         const uint8_t *const mpdu,
         const AlMpduSize mpdu_size,
         const struct AlMpduRxParams *const rxparams)
 {
+    struct msgQ_rx_meta meta;
+    struct timespec ts;
+
     if(g_dbg)
     {
-#if 0
-        printf("\n-- Processing received MPDU --------------------------------\n");
-        printf("Rx MPDU callback - MPDU size: %u, ifindex: %u, timeslot: %u, channel: %u, "
-                "rxpower: %d(0.5dBm), rcpi: %u, datarate: %u(500kbps)\n",
-                mpdu_size, rxparams->ifindex, rxparams->timeslot, rxparams->channel,
-                rxparams->rxpower, rxparams->rcpi, rxparams->datarate);
-#endif
         syslog(LOG_INFO | LOG_LOCAL0, "\n-- Processing received MPDU --------------------------------\n");
         syslog(LOG_INFO | LOG_LOCAL0, "Rx MPDU callback - MPDU size: %u, ifindex: %u, timeslot: %u, channel: %u, "
                 "rxpower: %d(0.5dBm), rcpi: %u, datarate: %u(500kbps)\n",
@@ -52,9 +46,29 @@ static void V2X_OBU_ProcessRxMpduCallback(
                 rxparams->rxpower, rxparams->rcpi, rxparams->datarate);
     }
 
-    g_mib.rcpi = rxparams->rcpi;
-    g_mib.rxpower = rxparams->rxpower/2;
-    V2X_OBU_ProcessRxMpdu(mpdu, mpdu_size);
+    /*
+     * 수신 메타데이터 설정
+     *  - 수신 파라미터는 전역변수를 거치지 않고 패킷 단위로 전달된다. (WSM 관련 필드는 파싱 후 채워진다)
+     */
+    memset(&meta, 0, sizeof(meta));
+    meta.version = MSGQ_RX_META_VERSION;
+    meta.hdr_len = sizeof(meta);
+    meta.ifindex = rxparams->ifindex;
+    meta.timeslot = rxparams->timeslot;
+    meta.channel = rxparams->channel;
+    meta.datarate = rxparams->datarate;
+    meta.rcpi = rxparams->rcpi;
+    meta.rxpower = rxparams->rxpower;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    meta.mono_ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    meta.gps_us = (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+
+    /*
+     * 수신 쓰레드로 전달한다.
+     *  - 폴링 쓰레드에서 파싱/메시지큐 전송을 수행하지 않으므로, 송신결과 등 다른 이벤트 처리가 지연되지 않는다.
+     */
+    V2X_OBU_EnqueueRxMpdu(mpdu, mpdu_size, &meta);
 }
 
 
@@ -67,7 +81,7 @@ static void V2X_OBU_ProcessAccessChannelResultCallback(const AlIfIndex ifindex)
 {
     //printf("Access channel result callback - ifindex: %u\n", ifindex);
     syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Access channel result callback - ifindex: %u\n", ifindex);
-    g_chan_access_complete = true;
+    V2X_OBU_CompleteAlReq(kV2XObuAlReq_AccessChannel, ifindex);
 }
 
 
@@ -82,7 +96,30 @@ static void V2X_OBU_ProcessTransmitResultCallback(const AlTxResultCode result, c
     if(g_dbg)
         //printf("Transmit result callback - result: %d, errcode: %d\n", result, dev_specific_errcode);
         syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Transmit result callback - result: %d, errcode: %d\n", result, dev_specific_errcode);
+
+    /* 송신 태그와 매칭하여 송신 지연/결과 통계에 반영한다. */
+    V2X_OBU_ProcessTxResult(result, dev_specific_errcode);
+}
+
+
+#ifdef V2X_OBU_TIMESLOT_EVENT
+/**
+ * TimeSlot0 시작 이벤트 콜백 함수 (TimeSlot1 -> TimeSlot0)
+ */
+static void V2X_OBU_ProcessTimeSlot0EventCallback(void)
+{
+    V2X_OBU_ProcessTimeSlotEvent(kDot3TimeSlot_0);
+}
+
+
+/**
+ * TimeSlot1 시작 이벤트 콜백 함수 (TimeSlot0 -> TimeSlot1)
+ */
+static void V2X_OBU_ProcessTimeSlot1EventCallback(void)
+{
+    V2X_OBU_ProcessTimeSlotEvent(kDot3TimeSlot_1);
 }
+#endif
 
 
 /**
@@ -94,7 +131,7 @@ static void V2X_OBU_ProcessSetIfMacAddressResultCallback(const AlIfIndex ifindex
 {
     //printf("Set interface MAC address result callback - ifindex: %u\n", ifindex);
     syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Set interface MAC address result callback - ifindex: %u\n", ifindex);
-    g_set_if_mac_addr_done = true;
+    V2X_OBU_CompleteAlReq(kV2XObuAlReq_SetIfMacAddress, ifindex);
 }
 
 
@@ -148,12 +185,24 @@ int V2X_OBU_OpenAccessLibrary(const int log_level)
 
     /*
      * 콜백함수 등록
+     *  - 제어요청 결과 콜백에서 사용하는 완료 객체를 먼저 초기화한다.
      */
+    V2X_OBU_InitAlReq();
 
     if(g_mib.op == opRX || g_mib.op == opTRX)
         Al_RegisterCallbackRxMpdu(V2X_OBU_ProcessRxMpduCallback);
-    else if(g_mib.op == opTX || g_mib.op == opTRX)
+    if(g_mib.op == opTX || g_mib.op == opTRX) {
         Al_RegisterCallbackTransmitResult(V2X_OBU_ProcessTransmitResultCallback);
+#ifdef V2X_OBU_TIMESLOT_EVENT
+        /*
+         * 송신 스케줄러가 현재 TimeSlot 을 추적하는데 사용된다.
+         *  - 배포된 libwlanaccess(armhf) 에는 TimeSlot 이벤트 콜백 등록 API 가 없으므로 빌드 옵션(USE_TIMESLOT_EVENT)으로 사용한다.
+         *  - 사용하지 않으면 송신 스케줄러는 TimeSlot 과 무관하게 송신 요청을 꺼낸다.
+         */
+        Al_RegisterCallbackTimeSlot0Event(V2X_OBU_ProcessTimeSlot0EventCallback);
+        Al_RegisterCallbackTimeSlot1Event(V2X_OBU_ProcessTimeSlot1EventCallback);
+#endif
+    }
     Al_RegisterCallbackAccessChannelResult(V2X_OBU_ProcessAccessChannelResultCallback);
     Al_RegisterCallbackSetIfMacAddressResult(V2X_OBU_ProcessSetIfMacAddressResultCallback);
 
@@ -167,6 +216,15 @@ int V2X_OBU_OpenAccessLibrary(const int log_level)
         syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to create poll thread : %s", strerror(errno));
         return -1;
     }
+    /* 수신 MPDU 콜백이 호출되는 쓰레드이므로, 운용하는 첫번째 인터페이스의 수신 코어에 할당한다. */
+    if(g_mib.op == opRX || g_mib.op == opTRX) {
+        for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+            if (g_mib.ifs[i].enable) {
+                V2X_OBU_SetThreadAffinity(g_poll_thread, g_mib.ifs[i].rxCpu);
+                break;
+            }
+        }
+    }
 
     //printf("Success to open access library - %d interface is supported\n", g_mib.if_num);
     syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to open access library - %d interface is supported\n", g_mib.if_num);
@@ -174,8 +232,58 @@ int V2X_OBU_OpenAccessLibrary(const int log_level)
 }
 
 
+/**
+ * 여러 인터페이스에 대해 채널 접속을 동시에 수행한다.
+ *  - 모든 인터페이스에 채널접속을 요청한 후, 각 인터페이스의 채널접속결과 콜백을 대기한다.
+ *  - 결과 대기시간(V2X_OBU_AL_REQ_TIMEOUT)을 초과한 인터페이스에 대해서만 다시 요청한다. (최대 V2X_OBU_AL_REQ_TRY_NUM 회)
+ *
+ * @param if_mask   채널접속할 인터페이스 비트맵 (bit i = 인터페이스 i)
+ * @param ts0_chan  인터페이스 별 TS0 채널번호
+ * @param ts1_chan  인터페이스 별 TS1 채널번호
+ * @return          성공 시 0, 실패 시 -1
+ */
+static int V2X_OBU_AccessChannelMulti(uint32_t if_mask, const uint8_t *ts0_chan, const uint8_t *ts1_chan)
+{
+    uint32_t token[V2X_OBU_IF_MAX_NUM];
+    int ret;
+
+    for (int try = 0; (try < V2X_OBU_AL_REQ_TRY_NUM) && if_mask; try++) {
+        for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+            if (!(if_mask & (1U << i))) {
+                continue;
+            }
+            //printf("Accessing channel - if_idx: %u, ts0_chan: %u, ts1_chan: %u\n", if_idx, ts0_chan, ts1_chan);
+            syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Accessing channel - if_idx: %d, ts0_chan: %u, ts1_chan: %u, try: %d\n",
+                   i, ts0_chan[i], ts1_chan[i], try + 1);
+            token[i] = V2X_OBU_StartAlReq(kV2XObuAlReq_AccessChannel, i);
+            ret = Al_AccessChannel(i, ts0_chan[i], ts1_chan[i]);
+            if (ret < 0) {
+                //printf("Fail to Al_AccessChannel() - %d\n", ret);
+                syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to Al_AccessChannel() on if%d - %d\n", i, ret);
+                return -1;
+            }
+        }
+        for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+            if (!(if_mask & (1U << i))) {
+                continue;
+            }
+            /* 앞 인터페이스를 대기하는 동안 완료된 인터페이스는 바로 리턴된다. */
+            if (V2X_OBU_WaitAlReq(kV2XObuAlReq_AccessChannel, i, token[i], V2X_OBU_AL_REQ_TIMEOUT) == 0) {
+                //printf("Success to access channel\n");
+                syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to access channel on if%d\n", i);
+                if_mask &= ~(1U << i);
+            } else {
+                syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Timeout to access channel on if%d\n", i);
+            }
+        }
+    }
+    return if_mask ? -1 : 0;
+}
+
+
 /**
  * 채널 접속을 수행한다.
+ *  - 채널접속결과 콜백이 호출될 때까지 대기한다. (결과 대기시간 초과 시 재시도)
  *
  * @param if_idx    채널접속한 인터페이스 식별번호
  * @param ts0_chan  TS0 채널번호
@@ -184,22 +292,35 @@ int V2X_OBU_OpenAccessLibrary(const int log_level)
  */
 int V2X_OBU_AccessChannel(const uint8_t if_idx, const uint8_t ts0_chan, const uint8_t ts1_chan)
 {
-    //printf("Accessing channel - if_idx: %u, ts0_chan: %u, ts1_chan: %u\n", if_idx, ts0_chan, ts1_chan);
-    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Accessing channel - if_idx: %u, ts0_chan: %u, ts1_chan: %u\n", if_idx, ts0_chan, ts1_chan);
+    uint8_t ts0[V2X_OBU_IF_MAX_NUM], ts1[V2X_OBU_IF_MAX_NUM];
 
-    g_chan_access_complete = false;
-    int ret = Al_AccessChannel(if_idx, ts0_chan, ts1_chan);
-    if (ret < 0) {
-        //printf("Fail to Al_AccessChannel() - %d\n", ret);
-        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to Al_AccessChannel() - %d\n", ret);
-        return ret;
+    if (if_idx >= V2X_OBU_IF_MAX_NUM) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to access channel - invalid if_idx: %u\n", if_idx);
+        return -1;
     }
-    //while(!g_chan_access_complete); // 채널접속결과 콜백함수가 호출될 때까지 대기
-    usleep(10000);
+    ts0[if_idx] = ts0_chan;
+    ts1[if_idx] = ts1_chan;
+    return V2X_OBU_AccessChannelMulti(1U << if_idx, ts0, ts1);
+}
 
-    //printf("Success to access channel\n");
-    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to access channel\n");
-    return 0;
+
+/**
+ * 운용하는 모든 인터페이스에 대해 설정된 채널(g_mib.ifs[].channel)로 채널 접속을 동시에 수행한다.
+ *
+ * @return          성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_AccessChannelAll(void)
+{
+    uint8_t ts0[V2X_OBU_IF_MAX_NUM], ts1[V2X_OBU_IF_MAX_NUM];
+    uint32_t if_mask = 0;
+
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        if (g_mib.ifs[i].enable) {
+            ts0[i] = ts1[i] = g_mib.ifs[i].channel;
+            if_mask |= (1U << i);
+        }
+    }
+    return V2X_OBU_AccessChannelMulti(if_mask, ts0, ts1);
 }
 
 
@@ -229,33 +350,92 @@ int V2X_OBU_GetCurrentChannel(uint8_t *const ts0_chan, uint8_t *const ts1_chan)
 }
 
 
+/**
+ * 여러 인터페이스의 MAC 주소를 동시에 설정한다.
+ *  - 모든 인터페이스에 MAC 주소설정을 요청한 후, 각 인터페이스의 MAC주소설정결과 콜백을 대기한다.
+ *  - 결과 대기시간(V2X_OBU_AL_REQ_TIMEOUT)을 초과한 인터페이스에 대해서만 다시 요청한다. (최대 V2X_OBU_AL_REQ_TRY_NUM 회)
+ *
+ * @param if_mask   MAC 주소를 설정할 인터페이스 비트맵 (bit i = 인터페이스 i)
+ * @param addr      인터페이스 별 MAC 주소
+ * @return          성공 시 0, 실패 시 -1
+ */
+static int V2X_OBU_SetIfMacAddressMulti(uint32_t if_mask, const uint8_t *const *addr)
+{
+    uint32_t token[V2X_OBU_IF_MAX_NUM];
+    int ret;
+
+    for (int try = 0; (try < V2X_OBU_AL_REQ_TRY_NUM) && if_mask; try++) {
+        for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+            if (!(if_mask & (1U << i))) {
+                continue;
+            }
+            //printf("Set interface MAC address %02X:%02X:%02X:%02X:%02X:%02X on interface %d\n",
+             //       addr[0], addr[1], addr[2], addr[3], addr[4], addr[5], if_idx);
+            syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Set interface MAC address %02X:%02X:%02X:%02X:%02X:%02X on interface %d, try: %d\n",
+                    addr[i][0], addr[i][1], addr[i][2], addr[i][3], addr[i][4], addr[i][5], i, try + 1);
+            token[i] = V2X_OBU_StartAlReq(kV2XObuAlReq_SetIfMacAddress, i);
+            ret = Al_SetIfMacAddress(i, addr[i]);
+            if (ret < 0) {
+                //printf("Fail to Al_SetIfMacAddress() - ret: %d\n", ret);
+                syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to Al_SetIfMacAddress() on if%d - ret: %d\n", i, ret);
+                return -1;
+            }
+        }
+        for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+            if (!(if_mask & (1U << i))) {
+                continue;
+            }
+            if (V2X_OBU_WaitAlReq(kV2XObuAlReq_SetIfMacAddress, i, token[i], V2X_OBU_AL_REQ_TIMEOUT) == 0) {
+                //printf("Success to set interface mac address\n");
+                syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to set interface mac address on if%d\n", i);
+                if_mask &= ~(1U << i);
+            } else {
+                syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Timeout to set interface mac address on if%d\n", i);
+            }
+        }
+    }
+    return if_mask ? -1 : 0;
+}
+
+
 /**
  * 인터페이스 MAC 주소를 설정한다.
+ *  - MAC주소설정결과 콜백이 호출될 때까지 대기한다. (결과 대기시간 초과 시 재시도)
  *
- * @param ts0_chan  TS0 채널번호가 저장될 변수의 포인터
- * @param ts1_chan  TS1 채널번호가 저장될 변수의 포인터
+ * @param if_idx    MAC 주소를 설정할 인터페이스 식별번호
+ * @param addr      설정할 MAC 주소
  * @return          성공 시 0, 실패 시 -1
  */
 int V2X_OBU_SetIfMacAddress(const uint8_t if_idx, const uint8_t *addr)
 {
-    int ret;
-    //printf("Set interface MAC address %02X:%02X:%02X:%02X:%02X:%02X on interface %d\n",
-     //       addr[0], addr[1], addr[2], addr[3], addr[4], addr[5], if_idx);
-    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Set interface MAC address %02X:%02X:%02X:%02X:%02X:%02X on interface %d\n",
-            addr[0], addr[1], addr[2], addr[3], addr[4], addr[5], if_idx);
+    const uint8_t *addrs[V2X_OBU_IF_MAX_NUM];
 
-    g_set_if_mac_addr_done = false;
-    ret = Al_SetIfMacAddress(if_idx, addr);
-    if (ret < 0) {
-        //printf("Fail to Al_SetIfMacAddress() - ret: %d\n", ret);
-        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to Al_SetIfMacAddress() - ret: %d\n", ret);
+    if (if_idx >= V2X_OBU_IF_MAX_NUM) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to set interface MAC address - invalid if_idx: %u\n", if_idx);
         return -1;
     }
-    while(!g_set_if_mac_addr_done);
+    addrs[if_idx] = addr;
+    return V2X_OBU_SetIfMacAddressMulti(1U << if_idx, addrs);
+}
 
-    //printf("Success to set interface mac address\n");
-        syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to set interface mac address\n");
-    return 0;
+
+/**
+ * 운용하는 모든 인터페이스의 MAC 주소(g_mib.ifs[].macAddr)를 동시에 설정한다.
+ *
+ * @return          성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_SetIfMacAddressAll(void)
+{
+    const uint8_t *addrs[V2X_OBU_IF_MAX_NUM];
+    uint32_t if_mask = 0;
+
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        if (g_mib.ifs[i].enable) {
+            addrs[i] = g_mib.ifs[i].macAddr;
+            if_mask |= (1U << i);
+        }
+    }
+    return V2X_OBU_SetIfMacAddressMulti(if_mask, addrs);
 }
 
 
@@ -0,0 +1,162 @@
+/**
+ * @file v2x-obu-rx-wsa.c
+ * @date 2026-10-19
+ * @author gyun
+ * @brief 수신 WSA 파싱 결과 캐시 기능 구현
+ *
+ * RSU 는 동일한 WSA 를 초당 여러 번 반복 송신하므로, 수신 WSA 마다 Dot3_ParseWsa()(ASN.1 디코딩)를 수행하지 않도록
+ * 송신지 MAC 주소 별로 마지막 WSA 의 인코딩 바이트와 파싱 결과를 캐시한다.
+ *  - 송신지 MAC 주소, 길이, 인코딩 바이트 해시가 같은 엔트리를 찾은 후 바이트 단위로 비교하여 동일하면 파싱 결과를 재사용한다.
+ *    (content count 가 같아도 내용이 다를 수 있으므로 WSA ID/content count 대신 인코딩 바이트 전체를 비교한다)
+ *  - 캐시는 인터페이스 별로 두며, 해당 인터페이스의 수신쓰레드만 접근하므로 잠금을 사용하지 않는다.
+ *  - 캐시가 가득 차면 가장 오래 전에 사용된 엔트리를 교체한다. 송신지 하나가 V2X_OBU_RX_WSA_CACHE_SRC_MAX_NUM 개를
+ *    초과하여 사용하지 않도록, 해당 송신지의 엔트리가 이미 그만큼 있으면 그 중 가장 오래된 엔트리를 교체한다.
+ */
+
+
+#include <string.h>
+
+#include "dot3/dot3.h"
+
+#include "v2x-obu.h"
+
+
+/**
+ * 수신 WSA 캐시 엔트리
+ */
+struct V2X_OBU_RxWsaCacheEntry
+{
+  bool valid;                             ///< 사용 중 여부
+  uint8_t src_mac[6];                     ///< WSA 송신지 MAC 주소
+  uint16_t wsa_size;                      ///< 인코딩된 WSA 길이
+  uint32_t hash;                          ///< 인코딩된 WSA 해시
+  uint64_t last_ns;                       ///< 마지막 사용 시각 (CLOCK_MONOTONIC, 나노초)
+  uint8_t wsa[kWsmBodyMaxSize];           ///< 인코딩된 WSA
+  struct Dot3ParseWsaParams params;       ///< 파싱 결과
+};
+
+static struct V2X_OBU_RxWsaCacheEntry g_rx_wsa_cache[V2X_OBU_IF_MAX_NUM][V2X_OBU_RX_WSA_CACHE_SIZE]; ///< 인터페이스 별 수신 WSA 캐시
+
+
+/**
+ * 인코딩된 WSA 의 해시(FNV-1a 32비트)를 계산한다.
+ *
+ * @param wsa       인코딩된 WSA
+ * @param wsa_size  인코딩된 WSA 의 길이
+ * @return          해시
+ */
+static uint32_t V2X_OBU_HashRxWsa(const uint8_t *const wsa, const uint16_t wsa_size)
+{
+    uint32_t hash = 2166136261U;
+    for (uint16_t i = 0; i < wsa_size; i++) {
+        hash = (hash ^ wsa[i]) * 16777619U;
+    }
+    return hash;
+}
+
+
+/**
+ * 캐시에서 새 WSA 를 저장할 엔트리를 선택한다.
+ *
+ * @param cache     인터페이스의 수신 WSA 캐시
+ * @param src_mac   WSA 송신지 MAC 주소
+ * @return          저장할 엔트리
+ */
+static struct V2X_OBU_RxWsaCacheEntry* V2X_OBU_SelectRxWsaCacheVictim(
+        struct V2X_OBU_RxWsaCacheEntry *const cache,
+        const uint8_t *const src_mac)
+{
+    struct V2X_OBU_RxWsaCacheEntry *oldest = NULL, *src_oldest = NULL;
+    unsigned int src_cnt = 0;
+
+    for (unsigned int i = 0; i < V2X_OBU_RX_WSA_CACHE_SIZE; i++) {
+        struct V2X_OBU_RxWsaCacheEntry *const entry = &cache[i];
+        if (!entry->valid) {
+            if (!oldest || oldest->valid) {
+                oldest = entry;
+            }
+            continue;
+        }
+        if (!memcmp(entry->src_mac, src_mac, sizeof(entry->src_mac))) {
+            src_cnt++;
+            if (!src_oldest || (entry->last_ns < src_oldest->last_ns)) {
+                src_oldest = entry;
+            }
+        }
+        if (!oldest || (oldest->valid && (entry->last_ns < oldest->last_ns))) {
+            oldest = entry;
+        }
+    }
+    return (src_cnt >= V2X_OBU_RX_WSA_CACHE_SRC_MAX_NUM) ? src_oldest : oldest;
+}
+
+
+/**
+ * 수신된 WSA 를 파싱한다. 수신쓰레드에서 호출된다.
+ *  - 같은 송신지로부터 이전에 수신된 WSA 와 동일하면 파싱하지 않고 캐시된 파싱 결과를 반환한다.
+ *
+ * @param wsa       인코딩된 WSA (WSM body)
+ * @param wsa_size  인코딩된 WSA 의 길이
+ * @param meta      WSA 를 수납한 WSM 의 수신 메타데이터 (송신지 MAC 주소, 수신시각이 채워져 있어야 한다)
+ * @param params    파싱 결과(캐시 엔트리)의 포인터가 반환될 변수의 포인터. 다음 WSA 수신 전까지만 유효하다.
+ * @return          성공 시 0, 실패 시 음수(-Dot3ResultCode)
+ */
+int V2X_OBU_ParseRxWsa(
+        const uint8_t *const wsa,
+        const uint16_t wsa_size,
+        const struct msgQ_rx_meta *const meta,
+        const struct Dot3ParseWsaParams **const params)
+{
+    struct V2X_OBU_RxWsaCacheEntry *cache, *entry;
+    uint32_t hash;
+    int ret;
+
+    /*
+     * 수신 인터페이스는 수신 큐에 넣을 때 이미 확인되었다. (V2X_OBU_EnqueueRxMpdus())
+     */
+    if (!wsa_size) {
+        return -kDot3Result_Fail_NullParameters;
+    }
+    if (wsa_size > kWsmBodyMaxSize) {
+        return -kDot3Result_Fail_TooLongWsa;
+    }
+    cache = g_rx_wsa_cache[meta->ifindex];
+    hash = V2X_OBU_HashRxWsa(wsa, wsa_size);
+
+    /*
+     * 동일한 WSA 가 캐시되어 있으면 파싱 결과를 재사용한다.
+     */
+    for (unsigned int i = 0; i < V2X_OBU_RX_WSA_CACHE_SIZE; i++) {
+        entry = &cache[i];
+        if (entry->valid &&
+            (entry->hash == hash) &&
+            (entry->wsa_size == wsa_size) &&
+            !memcmp(entry->src_mac, meta->src_mac, sizeof(entry->src_mac)) &&
+            !memcmp(entry->wsa, wsa, wsa_size)) {
+            entry->last_ns = meta->mono_ns;
+            V2X_OBU_INC_CNT(meta->ifindex, rx_wsa_cache_hit);
+            *params = &entry->params;
+            return 0;
+        }
+    }
+
+    /*
+     * 새 WSA 는 파싱하여 캐시에 저장한다. (파싱에 실패한 WSA 는 저장하지 않는다)
+     */
+    V2X_OBU_INC_CNT(meta->ifindex, rx_wsa_cache_miss);
+    entry = V2X_OBU_SelectRxWsaCacheVictim(cache, meta->src_mac);
+    entry->valid = false;
+    memset(&entry->params, 0, sizeof(entry->params));
+    ret = Dot3_ParseWsa(wsa, wsa_size, &entry->params);
+    if (ret < 0) {
+        return ret;
+    }
+    memcpy(entry->src_mac, meta->src_mac, sizeof(entry->src_mac));
+    entry->wsa_size = wsa_size;
+    entry->hash = hash;
+    entry->last_ns = meta->mono_ns;
+    memcpy(entry->wsa, wsa, wsa_size);
+    entry->valid = true;
+    *params = &entry->params;
+    return 0;
+}
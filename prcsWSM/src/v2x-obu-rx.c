@@ -19,6 +19,34 @@
 #include "hexdump.h"
 
 
+/**
+ * 수신 MPDU 큐 엔트리
+ */
+struct V2X_OBU_RxMpduEntry
+{
+    uint16_t mpdu_size;
+    uint8_t mpdu[kMpduMaxSize];
+    struct msgQ_rx_meta meta;
+};
+
+/**
+ * 수신 MPDU 큐 (이벤트 폴링 쓰레드 -> 수신 쓰레드)
+ */
+struct V2X_OBU_RxMpduQueue
+{
+    pthread_mutex_t mtx;
+    pthread_cond_t cond;
+    uint32_t head;  ///< 다음에 꺼낼 위치
+    uint32_t tail;  ///< 다음에 넣을 위치
+    uint32_t drop_cnt;  ///< 큐가 가득 차서 버려진 MPDU 개수
+    struct V2X_OBU_RxMpduEntry entry[RX_MPDU_QUEUE_SIZE];
+};
+
+static struct V2X_OBU_RxMpduQueue g_rx_q[V2X_OBU_IF_MAX_NUM]; ///< 인터페이스 별 수신 MPDU 큐
+static pthread_t g_rx_thread[V2X_OBU_IF_MAX_NUM]; ///< 인터페이스 별 수신쓰레드
+static volatile bool g_rx_started = false; ///< 수신 큐/쓰레드 초기화 완료 여부 (완료 전 수신된 MPDU 는 버린다)
+
+
 /**
  * 파싱된 WSA의 내용을 출력한다.
  *
@@ -103,20 +131,23 @@ static void V2X_OBU_PrintWsaParseParams(const struct Dot3ParseWsaParams *const p
  *
  * @param mpdu      수신된 MPDU
  * @param mpdu_size 수신된 MPDU의 크기
+ * @param meta      수신 메타데이터 (액세스계층 수신파라미터가 채워진 상태로 전달되며, WSM 헤더 정보가 추가로 채워진다)
  */
-void V2X_OBU_ProcessRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size)
+void V2X_OBU_ProcessRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size, struct msgQ_rx_meta *const meta)
 {
+    /* 파싱 여부와 관계없이 모든 수신 프레임이 채널을 점유한다. */
+    V2X_OBU_CountDccRxAirtime(meta->ifindex, mpdu_size, meta->datarate);
+    V2X_OBU_CaptureRxMpdu(mpdu, mpdu_size, meta);
 
     /*
      * WSM MPDU 파싱
      */
     struct Dot3WsmMpduRxParams dot3_params;
     bool wsr_registered;
-    uint8_t BUFFER[kMpduMaxSize];
     uint8_t outbuf[kMpduMaxSize];
-    int len=0;
     int payload_size = Dot3_ParseWsmMpdu(mpdu, mpdu_size, outbuf, sizeof(outbuf), &dot3_params, &wsr_registered);
     if (payload_size < 0) {
+        V2X_OBU_INC_CNT(meta->ifindex, rx_parse_fail);
         if(g_dbg)
         {
             //printf("Fail to Dot3_ParseWsmMpdu() %d\n", payload_size);
@@ -127,6 +158,18 @@ void V2X_OBU_ProcessRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size)
         return;
     }
 
+    /*
+     * 수신 메타데이터에 WSM 헤더 정보를 채운다.
+     */
+    meta->wsmp_version = (uint8_t)dot3_params.version;
+    memcpy(meta->src_mac, dot3_params.src_mac_addr, sizeof(meta->src_mac));
+    meta->psid = dot3_params.psid;
+    meta->tx_chan_num = (int16_t)dot3_params.tx_chan_num;
+    meta->tx_datarate = (int16_t)dot3_params.tx_datarate;
+    meta->tx_power = (int16_t)dot3_params.tx_power;
+    meta->priority = (uint8_t)dot3_params.priority;
+    V2X_OBU_CountRxPsid(dot3_params.psid);
+
     if (g_dbg >= kDbgMsgLevel_event) {
 #if 0
         printf("Success to Dot3_ParseWsmMpdu() - payload_size: %d\n", payload_size);
@@ -141,8 +184,7 @@ void V2X_OBU_ProcessRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size)
         syslog(LOG_INFO | LOG_LOCAL0, "Success to Dot3_ParseWsmMpdu() - payload_size: %d\n", payload_size);
         syslog(LOG_INFO | LOG_LOCAL0, "    tx_chan_num: %d, tx_datarate: %d, tx_power: %d, priority: %d, psid: %d\n",
                 dot3_params.tx_chan_num, dot3_params.tx_datarate, dot3_params.tx_power, dot3_params.priority, dot3_params.psid);
-	syslog(LOG_INFO | LOG_LOCAL0, "rx_power : %d, rcpi : %d \n",
-			g_mib.rxpower, g_mib.rcpi);
+        syslog(LOG_INFO | LOG_LOCAL0, "    rx_power: %d(0.5dBm), rcpi: %u\n", meta->rxpower, meta->rcpi);
         //syslog(LOG_INFO | LOG_LOCAL0, "    dst_mac_addr: %02X:%02X:%02X:%02X:%02X:%02X, src_mac_addr: %02X:%02X:%02X:%02X:%02X:%02X\n",
                 //dot3_params.dst_mac_addr[0], dot3_params.dst_mac_addr[1], dot3_params.dst_mac_addr[2],
                 //dot3_params.dst_mac_addr[3], dot3_params.dst_mac_addr[4], dot3_params.dst_mac_addr[5],
@@ -168,10 +210,11 @@ void V2X_OBU_ProcessRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size)
      * WSA 인 경우 파싱한다.
      */
     if (dot3_params.psid == kDot3Psid_Wsa) {
-        struct Dot3ParseWsaParams wsa_params;
-        memset(&wsa_params, 0, sizeof(wsa_params));
-        int ret = Dot3_ParseWsa(outbuf, payload_size, &wsa_params);
+        const struct Dot3ParseWsaParams *wsa_params;
+        V2X_OBU_INC_CNT(meta->ifindex, rx_wsa);
+        int ret = V2X_OBU_ParseRxWsa(outbuf, payload_size, meta, &wsa_params);
         if (ret < 0) {
+            V2X_OBU_INC_CNT(meta->ifindex, rx_wsa_parse_fail);
             if(g_dbg)
             {
                 //printf("Fail to parse WSA - %d\n", ret);
@@ -184,14 +227,15 @@ void V2X_OBU_ProcessRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size)
         if (g_dbg >= kDbgMsgLevel_event) {
             //printf("Success to parse WSA()\n");
             syslog(LOG_INFO | LOG_LOCAL0, "Success to parse WSA()\n");
-            V2X_OBU_PrintWsaParseParams(&wsa_params);
+            V2X_OBU_PrintWsaParseParams(wsa_params);
         }
+        V2X_OBU_ProcessRxWsaForSvcJoin(wsa_params, meta);
     }
     /*
      * 원하는 WSMP인 경우 적당히 처리한다.
      */
     if (dot3_params.psid == g_mib.psid) {
-        sendMQ(outbuf, payload_size);
+        sendMQ(meta, outbuf, payload_size);
         if (g_dbg >= kDbgMsgLevel_event) {
             //printf("Processing interseted WSM for psid %u\n", dot3_params.psid);
             //printf("------------------------------------------------------------\n\n");
@@ -201,14 +245,7 @@ void V2X_OBU_ProcessRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size)
         /* TO DO */
     }
     else if (dot3_params.psid == 7777) {
-	    memset(BUFFER,0,sizeof(kMpduMaxSize));
-	    memcpy(BUFFER+len,outbuf,payload_size);
-	    len+=payload_size;
-	    memcpy(BUFFER+len, &g_mib.rxpower, sizeof(int16_t)); //int16_t short int 2Byte
-	    len+=sizeof(int16_t);
-	    memcpy(BUFFER+len, &g_mib.rcpi, sizeof(uint8_t)); //uint8_t unsigned char 1Byte
-	    len+=sizeof(uint8_t);
-        PARsendMQ(BUFFER, len);
+        PARsendMQ(meta, outbuf, payload_size);
         if (g_dbg >= kDbgMsgLevel_event) {
             //printf("Processing interseted WSM for psid %u\n", dot3_params.psid);
             //printf("------------------------------------------------------------\n\n");
@@ -233,3 +270,159 @@ void V2X_OBU_ProcessRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size)
 }
 
 
+/**
+ * 수신된 MPDU 들을 각 수신 인터페이스의 수신 큐에 넣는다. 이벤트 폴링 쓰레드(MPDU 수신 콜백)에서 호출된다.
+ *  - 같은 인터페이스로 연속 수신된 MPDU 들은 한 번의 큐 잠금/수신쓰레드 깨우기로 처리한다.
+ *
+ * @param mpdus      수신된 MPDU 배열
+ * @param mpdu_sizes 수신된 MPDU 크기 배열
+ * @param metas      수신 메타데이터 배열
+ * @param num        수신된 MPDU 개수
+ * @return           큐에 넣은 MPDU 개수
+ */
+int V2X_OBU_EnqueueRxMpdus(
+        const uint8_t *const *const mpdus,
+        const uint16_t *const mpdu_sizes,
+        const struct msgQ_rx_meta *const metas,
+        const unsigned int num)
+{
+    struct V2X_OBU_RxMpduQueue *q = NULL;
+    struct V2X_OBU_RxMpduEntry *entry;
+    int cnt = 0;
+
+    if (!g_rx_started) {
+        return 0;
+    }
+    for (unsigned int i = 0; i < num; i++) {
+        const struct msgQ_rx_meta *meta = &metas[i];
+        if ((meta->ifindex >= V2X_OBU_IF_MAX_NUM) || !g_mib.ifs[meta->ifindex].enable) {
+            if (g_dbg >= kDbgMsgLevel_event) {
+                syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Drop MPDU received on not operating if%u\n", meta->ifindex);
+            }
+            continue;
+        }
+        if (mpdu_sizes[i] > kMpduMaxSize) {
+            syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Drop too long MPDU(%u)\n", mpdu_sizes[i]);
+            continue;
+        }
+
+        V2X_OBU_INC_CNT(meta->ifindex, rx_mpdu);
+        if (q != &g_rx_q[meta->ifindex]) {
+            if (q) {
+                pthread_cond_signal(&q->cond);
+                pthread_mutex_unlock(&q->mtx);
+            }
+            q = &g_rx_q[meta->ifindex];
+            pthread_mutex_lock(&q->mtx);
+        }
+        if (q->tail - q->head >= RX_MPDU_QUEUE_SIZE) {
+            q->drop_cnt++;
+            V2X_OBU_INC_CNT(meta->ifindex, rx_queue_drop);
+            if (g_dbg) {
+                syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Rx MPDU queue full on if%u - drop count: %u\n", meta->ifindex, q->drop_cnt);
+            }
+            continue;
+        }
+        entry = &q->entry[q->tail % RX_MPDU_QUEUE_SIZE];
+        entry->mpdu_size = mpdu_sizes[i];
+        memcpy(entry->mpdu, mpdus[i], mpdu_sizes[i]);
+        memcpy(&entry->meta, meta, sizeof(struct msgQ_rx_meta));
+        q->tail++;
+        cnt++;
+    }
+    if (q) {
+        pthread_cond_signal(&q->cond);
+        pthread_mutex_unlock(&q->mtx);
+    }
+
+    return cnt;
+}
+
+
+/**
+ * 수신된 MPDU 를 수신 인터페이스의 수신 큐에 넣는다.
+ *
+ * @param mpdu      수신된 MPDU
+ * @param mpdu_size 수신된 MPDU의 크기
+ * @param meta      수신 메타데이터
+ * @return          성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_EnqueueRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size, const struct msgQ_rx_meta *const meta)
+{
+    return (V2X_OBU_EnqueueRxMpdus(&mpdu, &mpdu_size, meta, 1) == 1) ? 0 : -1;
+}
+
+
+/**
+ * WSM 수신 쓰레드 함수
+ *  - 인터페이스 별로 하나씩 생성되며, 해당 인터페이스의 수신 큐에 MPDU 가 들어오면 꺼내서 처리한다.
+ *  - 엔트리 처리 중에는 큐 잠금을 해제하므로, 폴링 쓰레드는 다른 엔트리에 계속 MPDU 를 넣을 수 있다.
+ *  - 깨어날 때마다 그 시점까지 쌓인 엔트리들을 모두 처리한다.
+ *
+ * @param arg       수신 인터페이스 식별번호
+ * @return          NULL (프로그램 종료시에만 리턴됨)
+ */
+static void* V2X_OBU_WsmRxThread(void *arg)
+{
+    struct V2X_OBU_RxMpduQueue *const q = &g_rx_q[(uintptr_t)arg];
+    struct V2X_OBU_RxMpduEntry *entry;
+
+    uint32_t head, tail;
+
+    while (1) {
+        pthread_mutex_lock(&q->mtx);
+        while (q->head == q->tail) {
+            pthread_cond_wait(&q->cond, &q->mtx);
+        }
+        head = q->head;
+        tail = q->tail;
+        pthread_mutex_unlock(&q->mtx);
+
+        /*
+         * 큐에 쌓인 엔트리들을 한 번에 처리하고, 처리가 끝난 뒤 한 번만 큐를 잠가 반환한다.
+         *  - 다음 엔트리의 MPDU 를 미리 캐시로 읽어 들인다.
+         */
+        for (; head != tail; head++) {
+            entry = &q->entry[head % RX_MPDU_QUEUE_SIZE];
+            if (head + 1 != tail) {
+                __builtin_prefetch(q->entry[(head + 1) % RX_MPDU_QUEUE_SIZE].mpdu);
+            }
+            V2X_OBU_ProcessRxMpdu(entry->mpdu, entry->mpdu_size, &entry->meta);
+        }
+
+        pthread_mutex_lock(&q->mtx);
+        q->head = tail;
+        pthread_mutex_unlock(&q->mtx);
+    }
+    return NULL;
+}
+
+
+/**
+ * WSM 수신동작을 초기화한다.
+ *
+ * @return  성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_InitWsmRx(void)
+{
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Initializing WSM rx operation\n");
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        pthread_mutex_init(&g_rx_q[i].mtx, NULL);
+        pthread_cond_init(&g_rx_q[i].cond, NULL);
+    }
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        if (!g_mib.ifs[i].enable) {
+            continue;
+        }
+        int ret = pthread_create(&g_rx_thread[i], NULL, V2X_OBU_WsmRxThread, (void *)(uintptr_t)i);
+        if (ret) {
+            syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to create WSM rx thread() for if%d : %s\n", i, strerror(ret));
+            return -1;
+        }
+        V2X_OBU_SetThreadAffinity(g_rx_thread[i], g_mib.ifs[i].rxCpu);
+    }
+    g_rx_started = true;
+
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to initialize WSM rx operation\n");
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file v2x-obu-shm-stats.h
+ * @date 2026-10-19
+ * @brief prcsWSM 통계 공유메모리 페이지 형식
+ *
+ * prcsWSM 의 텔레메트리 쓰레드가 주기적으로 갱신하는 공유메모리(POSIX shm) 페이지 형식을 정의한다.
+ * 외부 도구는 이 헤더만 포함하여 IPC 없이 통계를 읽을 수 있다. (다른 헤더에 의존하지 않는다)
+ *
+ * 쓰기는 텔레메트리 쓰레드 하나만 수행하며, seqlock 으로 일관성을 보장한다. 읽는 측은 다음과 같이 읽는다.
+ *  1) seq 를 읽는다. 홀수이면 갱신 중이므로 다시 읽는다.
+ *  2) 필요한 내용을 복사한다.
+ *  3) seq 를 다시 읽어 1) 과 다르면 처음부터 다시 읽는다.
+ *
+ *   int fd = shm_open(V2X_OBU_SHM_STATS_NAME, O_RDONLY, 0);
+ *   const struct V2X_OBU_ShmStats *p = mmap(NULL, sizeof(*p), PROT_READ, MAP_SHARED, fd, 0);
+ */
+
+#ifndef V2X_OBU_V2X_OBU_SHM_STATS_H
+#define V2X_OBU_V2X_OBU_SHM_STATS_H
+
+#include <stdint.h>
+
+
+#define V2X_OBU_SHM_STATS_NAME "/prcsWSM-stats" ///< shm_open() 이름
+#define V2X_OBU_SHM_STATS_MAGIC (0x4d535750U) ///< "PWSM"
+#define V2X_OBU_SHM_STATS_VERSION (7)
+#define V2X_OBU_SHM_STATS_IF_MAX_NUM (2) ///< 인터페이스 통계 개수 (V2X_OBU_IF_MAX_NUM 과 같다)
+#define V2X_OBU_SHM_STATS_PSID_MAX_NUM (16) ///< PSID 별 통계 최대 개수
+
+
+/**
+ * prcsWSM 인터페이스 별 카운터 (누적값 또는 초당 변화량)
+ */
+struct V2X_OBU_ShmIfCounters
+{
+  uint64_t rx_mpdu;           ///< 수신 MPDU
+  uint64_t rx_queue_drop;     ///< 수신 큐가 가득 차서 버려진 MPDU
+  uint64_t rx_parse_fail;     ///< WSM 파싱 실패
+  uint64_t rx_wsa;            ///< 수신 WSA
+  uint64_t rx_wsa_parse_fail; ///< WSA 파싱 실패
+  uint64_t rx_ipc;            ///< 수신 메시지큐(J2735/PAR) 전달 성공
+  uint64_t rx_ipc_fail;       ///< 수신 메시지큐(J2735/PAR) 전달 실패 (큐 가득 참 등)
+  uint64_t tx_ipc;            ///< 송신 메시지큐 수신
+  uint64_t tx_ipc_fail;       ///< 송신 메시지큐 수신 실패
+  uint64_t tx_req;            ///< 송신 요청 (Al_TransmitMpdu() 호출)
+  uint64_t tx_submit_fail;    ///< Al_TransmitMpdu() 실패
+  uint64_t tx_complete;       ///< 송신결과 수신
+  uint64_t tx_complete_fail;  ///< 송신결과 실패
+  uint64_t tx_expire;         ///< 유효기간 만료로 버려진 송신 요청
+  uint64_t tx_overflow;       ///< 송신 큐가 가득 차서 버려진 송신 요청
+  uint64_t tx_wsa;            ///< 송신 스케줄러에 넣은 WSA (version 2)
+  uint64_t tx_wsa_encode;     ///< WSA 인코딩 (version 2)
+  uint64_t svc_join;          ///< 서비스채널 접속 (version 3)
+  uint64_t svc_leave;         ///< 서비스채널 이탈 (version 3)
+  uint64_t dcc_drop;          ///< DCC 최소 송신간격 제한으로 버려진 송신 메시지 (version 4)
+  uint64_t dcc_state_change;  ///< DCC 상태 전이 (version 4)
+  uint64_t cap_pkt;           ///< 캡쳐 파일에 기록된 MPDU (version 5)
+  uint64_t cap_drop;          ///< 캡쳐 링이 가득 차서 버려진 MPDU (version 5)
+  uint64_t rx_wsa_cache_hit;  ///< 이전과 동일하여 WSA 파싱을 생략한 수신 WSA (version 6)
+  uint64_t rx_wsa_cache_miss; ///< 새로 파싱한 수신 WSA (version 6)
+};
+
+/**
+ * 인터페이스 별 통계
+ */
+struct V2X_OBU_ShmIfStats
+{
+  uint8_t  enable;            ///< 운용 여부
+  uint8_t  channel;           ///< 송신 채널
+  uint8_t  svc_chan;          ///< 서비스 접속 모드에서 접속한 서비스채널 (0 이면 미접속, version 3)
+  uint8_t  dcc_state;         ///< DCC 상태 (상태 테이블 인덱스, DCC 미동작 시 0xFF, version 4)
+  uint32_t svc_join_latency;  ///< 마지막 WSA 탐색 ~ 서비스채널 접속 지연 (usec, version 3)
+  uint16_t cbr;               ///< DCC 평균 CBR (0.1% 단위, version 4)
+  uint16_t dcc_itt;           ///< DCC 상태의 PSID 별 최소 송신간격 (msec, version 4)
+  int8_t   dcc_power;         ///< DCC 적용 송신파워 (dBm, version 4)
+  uint8_t  dcc_datarate;      ///< DCC 적용 송신 DataRate (500kbps 단위, version 4)
+  uint8_t  reserved[2];
+  struct V2X_OBU_ShmIfCounters total; ///< 누적값
+  struct V2X_OBU_ShmIfCounters rate;  ///< 초당 변화량
+};
+
+/**
+ * PSID 별 통계
+ */
+struct V2X_OBU_ShmPsidStats
+{
+  uint32_t psid;
+  uint32_t reserved;
+  uint64_t rx_total;  ///< 수신 WSM 누적 개수
+  uint64_t tx_total;  ///< 송신 요청 누적 개수
+  uint64_t rx_rate;   ///< 초당 수신 WSM 개수
+  uint64_t tx_rate;   ///< 초당 송신 요청 개수
+};
+
+/**
+ * 통계 공유메모리 페이지
+ */
+struct V2X_OBU_ShmStats
+{
+  uint32_t magic;             ///< V2X_OBU_SHM_STATS_MAGIC
+  uint16_t version;           ///< V2X_OBU_SHM_STATS_VERSION
+  uint16_t if_num;            ///< ifs[] 개수
+  uint32_t size;              ///< 구조체 크기
+  volatile uint32_t seq;      ///< seqlock 카운터 (홀수이면 갱신 중)
+  uint32_t interval;          ///< 갱신 주기 (msec)
+  uint32_t psid_num;          ///< psids[] 에 유효한 개수
+  uint32_t pid;               ///< prcsWSM 프로세스 ID
+  uint32_t reserved;
+  uint64_t update_cnt;        ///< 갱신 횟수
+  uint64_t update_mono_ns;    ///< 마지막 갱신 시각 (CLOCK_MONOTONIC, 나노초)
+  struct V2X_OBU_ShmIfStats ifs[V2X_OBU_SHM_STATS_IF_MAX_NUM];
+  struct V2X_OBU_ShmPsidStats psids[V2X_OBU_SHM_STATS_PSID_MAX_NUM];
+};
+
+#endif //V2X_OBU_V2X_OBU_SHM_STATS_H
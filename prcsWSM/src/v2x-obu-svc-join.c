@@ -0,0 +1,316 @@
+/**
+ * @file v2x-obu-svc-join.c
+ * @date 2026-10-19
+ * @author gyun
+ * @brief WSA 기반 서비스 탐색 및 서비스채널 자동 접속 기능 구현
+ *
+ * 서비스 접속 모드(-J)로 설정된 인터페이스는 CCH(인터페이스 채널)를 탐색하다가, 수신된 WSA 에 관심 PSID(g_mib.psid)의
+ * Service info 가 있고 RCPI/WSA count 임계값 조건을 만족하면 광고된 서비스채널로 교번 접속한다. (TS0=CCH, TS1=SCH)
+ * 해당 WSA 가 만료시간 동안 수신되지 않으면 다시 CCH 로 돌아간다.
+ *  - WSA 처리는 수신쓰레드에서, 채널 접속(결과 대기 포함)은 서비스 접속 쓰레드에서 수행하여 수신쓰레드가 블로킹되지 않도록 한다.
+ *  - WSA 탐색(조건을 만족한 WSA 수신) 시각부터 채널 접속 완료까지의 지연을 측정하여 로그와 통계 공유메모리로 보고한다.
+ */
+
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "dot3/dot3.h"
+
+#include "v2x-obu.h"
+
+
+/**
+ * 인터페이스 별 서비스 접속 정보
+ */
+struct V2X_OBU_SvcJoinIf
+{
+  /* 서비스 후보 - 수신쓰레드가 갱신하며 mtx 로 보호된다. */
+  bool cand;                        ///< 후보 WSA 송신지가 있는지 여부
+  bool avail;                       ///< 후보 서비스가 임계값 조건을 만족하여 접속 가능한지 여부
+  uint8_t src_mac[6];               ///< 후보 WSA 송신지 MAC 주소
+  Dot3ChannelNumber sch;            ///< 광고된 서비스채널
+  uint64_t found_ns;                ///< 접속 가능해진 WSA 수신시각 (CLOCK_MONOTONIC, 나노초)
+  uint64_t last_ns;                 ///< 마지막 WSA 수신시각
+  uint64_t timeout_ns;              ///< WSA 만료시간
+  uint64_t rx_ns[V2X_OBU_SVC_WSA_CNT_MAX_NUM]; ///< 최근 WSA 수신시각 (WSA count threshold 확인용 원형버퍼)
+  uint32_t rx_cnt;                  ///< rx_ns 에 기록된 누적 개수
+
+  /* 접속 상태 - 서비스 접속 쓰레드만 접근한다. */
+  Dot3ChannelNumber joined_sch;     ///< 접속한 서비스채널 (0 이면 CCH 탐색 중)
+  uint32_t join_cnt;                ///< 서비스채널 접속 횟수
+  uint64_t latency_min;             ///< 탐색 ~ 접속 지연 최소값 (usec)
+  uint64_t latency_max;             ///< 탐색 ~ 접속 지연 최대값 (usec)
+  uint64_t latency_sum;             ///< 탐색 ~ 접속 지연 합 (usec)
+
+  /* 통계 공유메모리 게시용 */
+  volatile uint8_t pub_sch;         ///< 접속한 서비스채널
+  volatile uint32_t pub_latency;    ///< 마지막 탐색 ~ 접속 지연 (usec)
+};
+
+static struct {
+  pthread_t thread;                 ///< 서비스 접속 쓰레드
+  pthread_mutex_t mtx;
+  pthread_cond_t cond;              ///< 서비스 후보 상태 변경 알림
+  struct V2X_OBU_SvcJoinIf ifs[V2X_OBU_IF_MAX_NUM];
+} g_svc_join = { .mtx = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER };
+
+
+/**
+ * WSA 에서 관심 PSID 에 대한 Service info 를 찾는다.
+ *
+ * @param wsa       파싱된 WSA
+ * @param sch       광고된 서비스채널이 반환될 변수의 포인터
+ * @return          Service info (없거나 Channel info 를 참조할 수 없으면 NULL)
+ */
+static const struct Dot3Wsi* V2X_OBU_FindInterestedWsi(const struct Dot3ParseWsaParams *const wsa, Dot3ChannelNumber *const sch)
+{
+    for (int i = 0; i < wsa->wsi_num; i++) {
+        const struct Dot3Wsi *const wsi = &wsa->wsis[i];
+        if (wsi->psid != g_mib.psid) {
+            continue;
+        }
+        if ((wsi->channel_index < kDot3WsaChannelIndex_Min) || (wsi->channel_index > wsa->wci_num)) {
+            continue;
+        }
+        *sch = wsa->wcis[wsi->channel_index - 1].chan_num;
+        return wsi;
+    }
+    return NULL;
+}
+
+
+/**
+ * 수신된 WSA 로 서비스 후보 상태를 갱신한다. 수신쓰레드에서 호출된다.
+ *  - 이미 접속 가능한 후보가 있으면, 후보가 만료될 때까지 다른 송신지의 WSA 는 무시한다.
+ *  - RCPI threshold 확장필드가 있으면 수신 RCPI 가 임계값 이상인 WSA 만 유효하다.
+ *  - WSA count threshold 확장필드가 있으면 WSA count threshold interval 동안 임계값 이상 수신되어야 접속 가능하다.
+ *
+ * @param wsa       파싱된 WSA
+ * @param meta      WSA 를 수납한 WSM 의 수신 메타데이터
+ */
+void V2X_OBU_ProcessRxWsaForSvcJoin(const struct Dot3ParseWsaParams *const wsa, const struct msgQ_rx_meta *const meta)
+{
+    struct V2X_OBU_SvcJoinIf *jif;
+    const struct Dot3Wsi *wsi;
+    Dot3ChannelNumber sch;
+    uint64_t window;
+    uint32_t cnt, need;
+
+    if ((meta->ifindex >= V2X_OBU_IF_MAX_NUM) || !g_mib.ifs[meta->ifindex].svcJoin) {
+        return;
+    }
+    jif = &g_svc_join.ifs[meta->ifindex];
+    wsi = V2X_OBU_FindInterestedWsi(wsa, &sch);
+    if (!wsi) {
+        return;
+    }
+    if (wsi->extensions.rcpi_threshold && ((Dot3Rcpi)meta->rcpi < wsi->rcpi_threshold)) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_svc_join.mtx);
+    if (jif->cand && memcmp(jif->src_mac, meta->src_mac, sizeof(jif->src_mac))) {
+        if (jif->avail) {
+            pthread_mutex_unlock(&g_svc_join.mtx);
+            return;
+        }
+        jif->cand = false; // 접속 조건을 만족하지 못한 후보는 새 송신지로 교체한다.
+    }
+    if (!jif->cand) {
+        jif->cand = true;
+        memcpy(jif->src_mac, meta->src_mac, sizeof(jif->src_mac));
+        jif->rx_cnt = 0;
+    }
+    jif->rx_ns[jif->rx_cnt % V2X_OBU_SVC_WSA_CNT_MAX_NUM] = meta->mono_ns;
+    jif->rx_cnt++;
+    jif->last_ns = meta->mono_ns;
+    jif->timeout_ns = (wsa->hdr.extensions.repeat_rate && wsa->hdr.repeat_rate) ?
+                      (uint64_t)V2X_OBU_SVC_TIMEOUT_REPEAT_NUM * 5000000000ULL / wsa->hdr.repeat_rate :
+                      (uint64_t)V2X_OBU_SVC_DEFAULT_TIMEOUT * 1000000ULL;
+
+    if (!jif->avail) {
+        need = wsi->extensions.wsa_cnt_threshold ? wsi->wsa_cnt_threshold : 1;
+        if (need > V2X_OBU_SVC_WSA_CNT_MAX_NUM) {
+            need = V2X_OBU_SVC_WSA_CNT_MAX_NUM;
+        }
+        window = (uint64_t)(wsi->extensions.wsa_cnt_threshold_interval ? wsi->wsa_cnt_threshold_interval : 1) * 100000000ULL;
+        cnt = 0;
+        for (uint32_t i = 0; (i < jif->rx_cnt) && (i < V2X_OBU_SVC_WSA_CNT_MAX_NUM); i++) {
+            if (meta->mono_ns - jif->rx_ns[(jif->rx_cnt - 1 - i) % V2X_OBU_SVC_WSA_CNT_MAX_NUM] > window) {
+                break;
+            }
+            cnt++;
+        }
+        if (cnt >= need) {
+            jif->avail = true;
+            jif->found_ns = meta->mono_ns;
+            jif->sch = sch;
+            pthread_cond_signal(&g_svc_join.cond);
+        }
+    } else if (jif->sch != sch) {
+        jif->sch = sch;
+        jif->found_ns = meta->mono_ns;
+        pthread_cond_signal(&g_svc_join.cond);
+    }
+    pthread_mutex_unlock(&g_svc_join.mtx);
+}
+
+
+/**
+ * 인터페이스의 서비스 후보 상태에 따라 서비스채널에 접속하거나 CCH 로 돌아간다.
+ *
+ * @param ifindex   인터페이스 식별번호
+ * @param now       현재시각 (CLOCK_MONOTONIC, 나노초)
+ */
+static void V2X_OBU_UpdateSvcJoin(const uint8_t ifindex, const uint64_t now)
+{
+    struct V2X_OBU_SvcJoinIf *const jif = &g_svc_join.ifs[ifindex];
+    const Dot3ChannelNumber cch = g_mib.ifs[ifindex].channel;
+    Dot3ChannelNumber sch = 0;
+    uint64_t found_ns = 0, latency;
+
+    pthread_mutex_lock(&g_svc_join.mtx);
+    if (jif->cand && (now - jif->last_ns > jif->timeout_ns)) {
+        jif->cand = jif->avail = false;
+    }
+    if (jif->avail) {
+        sch = jif->sch;
+        found_ns = jif->found_ns;
+    }
+    pthread_mutex_unlock(&g_svc_join.mtx);
+
+    if (sch == jif->joined_sch) {
+        return;
+    }
+
+    /* 서비스가 만료되었으면 CCH 로 돌아간다. */
+    if (sch == 0) {
+        if (V2X_OBU_AccessChannel(ifindex, cch, cch) == 0) {
+            syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Leave service channel %u on interface %u - WSA timed out\n",
+                   jif->joined_sch, ifindex);
+            jif->joined_sch = 0;
+            jif->pub_sch = 0;
+            V2X_OBU_INC_CNT(ifindex, svc_leave);
+        }
+        return;
+    }
+
+    /* 광고된 서비스채널로 교번 접속한다. */
+    if (V2X_OBU_AccessChannel(ifindex, cch, sch) < 0) {
+        return; // 다음 주기에 다시 시도한다.
+    }
+    latency = (V2X_OBU_GetMonoTimeNs() - found_ns) / 1000;
+    jif->joined_sch = sch;
+    jif->join_cnt++;
+    jif->latency_sum += latency;
+    if ((jif->join_cnt == 1) || (latency < jif->latency_min)) {
+        jif->latency_min = latency;
+    }
+    if (latency > jif->latency_max) {
+        jif->latency_max = latency;
+    }
+    jif->pub_sch = sch;
+    jif->pub_latency = (latency > UINT32_MAX) ? UINT32_MAX : (uint32_t)latency;
+    V2X_OBU_INC_CNT(ifindex, svc_join);
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Join service channel %u on interface %u - latency: %lluusec "
+           "(min: %llu, avg: %llu, max: %llu, cnt: %u)\n", sch, ifindex, (unsigned long long)latency,
+           (unsigned long long)jif->latency_min, (unsigned long long)(jif->latency_sum / jif->join_cnt),
+           (unsigned long long)jif->latency_max, jif->join_cnt);
+}
+
+
+/**
+ * 서비스 접속 쓰레드 함수
+ *  - 서비스 후보 상태가 바뀌면 즉시, 그렇지 않으면 V2X_OBU_SVC_CHECK_INTERVAL 마다 접속 상태를 갱신한다.
+ *
+ * @param arg       미사용
+ * @return          NULL (프로그램 종료시에만 리턴됨)
+ */
+static void* V2X_OBU_SvcJoinThread(void *arg)
+{
+    struct timespec ts;
+    (void)arg;
+
+    do {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        ts.tv_nsec += V2X_OBU_SVC_CHECK_INTERVAL * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_nsec -= 1000000000L;
+            ts.tv_sec++;
+        }
+        pthread_mutex_lock(&g_svc_join.mtx);
+        pthread_cond_timedwait(&g_svc_join.cond, &g_svc_join.mtx, &ts);
+        pthread_mutex_unlock(&g_svc_join.mtx);
+
+        const uint64_t now = V2X_OBU_GetMonoTimeNs();
+        for (uint8_t i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+            if (g_mib.ifs[i].enable && g_mib.ifs[i].svcJoin) {
+                V2X_OBU_UpdateSvcJoin(i, now);
+            }
+        }
+    } while (1);
+
+    return NULL;
+}
+
+
+/**
+ * 인터페이스의 서비스 접속 상태를 확인한다. (통계 게시용)
+ *
+ * @param ifindex   인터페이스 식별번호
+ * @param sch       접속한 서비스채널이 반환될 변수의 포인터 (0 이면 미접속)
+ * @param latency   마지막 탐색 ~ 접속 지연(usec)이 반환될 변수의 포인터
+ */
+void V2X_OBU_GetSvcJoinStatus(const uint8_t ifindex, uint8_t *const sch, uint32_t *const latency)
+{
+    *sch = 0;
+    *latency = 0;
+    if (ifindex < V2X_OBU_IF_MAX_NUM) {
+        *sch = g_svc_join.ifs[ifindex].pub_sch;
+        *latency = g_svc_join.ifs[ifindex].pub_latency;
+    }
+}
+
+
+/**
+ * 서비스 탐색 및 서비스채널 자동 접속 기능을 초기화한다.
+ *  - 서비스 접속 모드 인터페이스들을 CCH 로 접속시키고 서비스 접속 쓰레드를 시작한다.
+ *
+ * @return  성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_InitSvcJoin(void)
+{
+    pthread_condattr_t attr;
+    int ret;
+
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Initializing service join - psid: %u\n", g_mib.psid);
+
+    for (uint8_t i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        if (g_mib.ifs[i].enable && g_mib.ifs[i].svcJoin) {
+            ret = V2X_OBU_AccessChannel(i, g_mib.ifs[i].channel, g_mib.ifs[i].channel);
+            if (ret < 0) {
+                return -1;
+            }
+        }
+    }
+
+    /* 대기 시각을 CLOCK_MONOTONIC 기준으로 지정한다. */
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_destroy(&g_svc_join.cond);
+    pthread_cond_init(&g_svc_join.cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    ret = pthread_create(&g_svc_join.thread, NULL, V2X_OBU_SvcJoinThread, NULL);
+    if (ret) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to create service join thread - %s\n", strerror(ret));
+        return -1;
+    }
+
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to initialize service join\n");
+    return 0;
+}
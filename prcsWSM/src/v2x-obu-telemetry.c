@@ -0,0 +1,341 @@
+/**
+ * @file v2x-obu-telemetry.c
+ * @date 2026-10-19
+ * @brief 액세스계층/prcsWSM 통계 텔레메트리 기능 구현
+ *
+ * 텔레메트리 쓰레드가 설정된 주기마다 다음 정보를 수집하여 통계 공유메모리 페이지(v2x-obu-shm-stats.h)에 게시한다.
+ *  - prcsWSM 카운터 (수신 파싱 실패, 메시지큐 전달 실패 등. g_cnt)
+ *  - 송신 통계 (v2x-obu-tx-stats.c), 송신 스케줄러 통계 (v2x-obu-tx-sched.c)
+ *  - PSID 별 송수신 개수
+ * 누적값과 함께 직전 수집 시점 대비 초당 변화량을 계산하여 게시한다.
+ * 액세스계층 통계(Al_GetTxStatistics() 등)는 배포된 libwlanaccess(armhf) 에 없으므로 게시하지 않는다.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "v2x-obu.h"
+
+
+struct V2X_OBU_Counters g_cnt[V2X_OBU_IF_MAX_NUM]; ///< 인터페이스 별 prcsWSM 카운터
+
+/**
+ * PSID 별 수신 카운터
+ *  - 수신쓰레드에서 갱신되고 텔레메트리 쓰레드에서 읽는다.
+ */
+static struct
+{
+    pthread_mutex_t mtx;
+    uint32_t psid_num;
+    Dot3Psid psid[V2X_OBU_SHM_STATS_PSID_MAX_NUM];
+    uint64_t cnt[V2X_OBU_SHM_STATS_PSID_MAX_NUM];
+} g_rx_psid_cnt = { .mtx = PTHREAD_MUTEX_INITIALIZER };
+
+static struct V2X_OBU_ShmStats *g_shm_stats = NULL; ///< 통계 공유메모리 페이지
+static pthread_t g_telemetry_thread; ///< 텔레메트리 쓰레드
+
+
+/**
+ * 수신 WSM 의 PSID 별 카운터를 증가시킨다. 수신쓰레드에서 호출된다.
+ *  - 등록공간이 부족하면 집계하지 않는다.
+ *
+ * @param psid  수신 WSM 의 PSID
+ */
+void V2X_OBU_CountRxPsid(const Dot3Psid psid)
+{
+    uint32_t i;
+
+    pthread_mutex_lock(&g_rx_psid_cnt.mtx);
+    for (i = 0; i < g_rx_psid_cnt.psid_num; i++) {
+        if (g_rx_psid_cnt.psid[i] == psid) {
+            break;
+        }
+    }
+    if (i == g_rx_psid_cnt.psid_num) {
+        if (i < V2X_OBU_SHM_STATS_PSID_MAX_NUM) {
+            g_rx_psid_cnt.psid[i] = psid;
+            g_rx_psid_cnt.cnt[i] = 0;
+            g_rx_psid_cnt.psid_num++;
+        }
+    }
+    if (i < V2X_OBU_SHM_STATS_PSID_MAX_NUM) {
+        g_rx_psid_cnt.cnt[i]++;
+    }
+    pthread_mutex_unlock(&g_rx_psid_cnt.mtx);
+}
+
+
+/**
+ * 초당 변화량을 계산한다.
+ */
+static uint64_t V2X_OBU_GetRate(const uint64_t cur, const uint64_t prev, const uint64_t elapsed_ns)
+{
+    if ((cur < prev) || (elapsed_ns == 0)) {
+        return 0;
+    }
+    return ((cur - prev) * 1000000000ULL) / elapsed_ns;
+}
+
+
+/**
+ * PSID 별 통계 항목을 찾는다. 없으면 추가한다.
+ *
+ * @return  통계 항목. 공간이 부족하면 NULL
+ */
+static struct V2X_OBU_ShmPsidStats* V2X_OBU_GetShmPsidStats(
+        struct V2X_OBU_ShmPsidStats *const psids,
+        uint32_t *const psid_num,
+        const Dot3Psid psid)
+{
+    for (uint32_t i = 0; i < *psid_num; i++) {
+        if (psids[i].psid == psid) {
+            return &psids[i];
+        }
+    }
+    if (*psid_num >= V2X_OBU_SHM_STATS_PSID_MAX_NUM) {
+        return NULL;
+    }
+    memset(&psids[*psid_num], 0, sizeof(struct V2X_OBU_ShmPsidStats));
+    psids[*psid_num].psid = psid;
+    return &psids[(*psid_num)++];
+}
+
+
+/**
+ * 인터페이스의 DCC 상태를 수집한다.
+ *
+ * @param ifindex   인터페이스 식별번호
+ * @param ifs       수집한 상태가 저장될 인터페이스 통계
+ */
+static void V2X_OBU_CollectDccTelemetry(const uint8_t ifindex, struct V2X_OBU_ShmIfStats *const ifs)
+{
+    struct V2X_OBU_DccState st;
+    uint32_t cbr, state;
+    Dot3Power power;
+    Dot3DataRate datarate;
+
+    ifs->dcc_state = 0xFF;
+    ifs->cbr = ifs->dcc_itt = 0;
+    if (V2X_OBU_GetDccStatus(ifindex, &cbr, &state, &st)) {
+        ifs->dcc_state = (uint8_t)state;
+        ifs->cbr = (uint16_t)cbr;
+        ifs->dcc_itt = st.itt;
+    }
+    V2X_OBU_GetDccTxParams(ifindex, &power, &datarate);
+    ifs->dcc_power = (int8_t)power;
+    ifs->dcc_datarate = (uint8_t)datarate;
+}
+
+
+/**
+ * 통계를 수집하여 sample 에 저장한다. (초당 변화량은 제외)
+ *
+ * @param sample    수집한 통계가 저장될 구조체
+ */
+static void V2X_OBU_CollectTelemetry(struct V2X_OBU_ShmStats *const sample)
+{
+    struct V2X_OBU_TxStats tx_if[V2X_OBU_IF_MAX_NUM];
+    Dot3Psid tx_psid[V2X_OBU_TX_STATS_PSID_MAX_NUM];
+    struct V2X_OBU_TxStats tx_psid_stats[V2X_OBU_TX_STATS_PSID_MAX_NUM];
+    struct V2X_OBU_TxSchedStats sched[kV2XObuAc_Num];
+    struct V2X_OBU_ShmPsidStats *entry;
+    int tx_psid_num;
+
+    tx_psid_num = V2X_OBU_GetTxStats(tx_if, tx_psid, tx_psid_stats);
+
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        struct V2X_OBU_ShmIfStats *const ifs = &sample->ifs[i];
+        struct V2X_OBU_ShmIfCounters *const c = &ifs->total;
+        ifs->enable = g_mib.ifs[i].enable;
+        ifs->channel = g_mib.ifs[i].channel;
+        if (!ifs->enable) {
+            continue;
+        }
+        V2X_OBU_GetSvcJoinStatus(i, &ifs->svc_chan, &ifs->svc_join_latency);
+        V2X_OBU_CollectDccTelemetry(i, ifs);
+
+        /* prcsWSM 카운터 */
+        c->rx_mpdu = __atomic_load_n(&g_cnt[i].rx_mpdu, __ATOMIC_RELAXED);
+        c->rx_queue_drop = __atomic_load_n(&g_cnt[i].rx_queue_drop, __ATOMIC_RELAXED);
+        c->rx_parse_fail = __atomic_load_n(&g_cnt[i].rx_parse_fail, __ATOMIC_RELAXED);
+        c->rx_wsa = __atomic_load_n(&g_cnt[i].rx_wsa, __ATOMIC_RELAXED);
+        c->rx_wsa_parse_fail = __atomic_load_n(&g_cnt[i].rx_wsa_parse_fail, __ATOMIC_RELAXED);
+        c->rx_ipc = __atomic_load_n(&g_cnt[i].rx_ipc, __ATOMIC_RELAXED);
+        c->rx_ipc_fail = __atomic_load_n(&g_cnt[i].rx_ipc_fail, __ATOMIC_RELAXED);
+        c->tx_ipc = __atomic_load_n(&g_cnt[i].tx_ipc, __ATOMIC_RELAXED);
+        c->tx_ipc_fail = __atomic_load_n(&g_cnt[i].tx_ipc_fail, __ATOMIC_RELAXED);
+        c->tx_wsa = __atomic_load_n(&g_cnt[i].tx_wsa, __ATOMIC_RELAXED);
+        c->tx_wsa_encode = __atomic_load_n(&g_cnt[i].tx_wsa_encode, __ATOMIC_RELAXED);
+        c->svc_join = __atomic_load_n(&g_cnt[i].svc_join, __ATOMIC_RELAXED);
+        c->svc_leave = __atomic_load_n(&g_cnt[i].svc_leave, __ATOMIC_RELAXED);
+        c->dcc_drop = __atomic_load_n(&g_cnt[i].dcc_drop, __ATOMIC_RELAXED);
+        c->dcc_state_change = __atomic_load_n(&g_cnt[i].dcc_state_change, __ATOMIC_RELAXED);
+        c->cap_pkt = __atomic_load_n(&g_cnt[i].cap_pkt, __ATOMIC_RELAXED);
+        c->cap_drop = __atomic_load_n(&g_cnt[i].cap_drop, __ATOMIC_RELAXED);
+        c->rx_wsa_cache_hit = __atomic_load_n(&g_cnt[i].rx_wsa_cache_hit, __ATOMIC_RELAXED);
+        c->rx_wsa_cache_miss = __atomic_load_n(&g_cnt[i].rx_wsa_cache_miss, __ATOMIC_RELAXED);
+
+        /* 송신 통계 */
+        c->tx_req = tx_if[i].tx_cnt;
+        c->tx_submit_fail = tx_if[i].submit_fail_cnt;
+        c->tx_complete = tx_if[i].complete_cnt;
+        c->tx_complete_fail = tx_if[i].complete_fail_cnt;
+        V2X_OBU_GetTxSchedStats(i, sched, NULL);
+        c->tx_expire = c->tx_overflow = 0;
+        for (int ac = 0; ac < kV2XObuAc_Num; ac++) {
+            c->tx_expire += sched[ac].expire_cnt;
+            c->tx_overflow += sched[ac].overflow_cnt;
+        }
+    }
+
+    /* PSID 별 송수신 개수 */
+    sample->psid_num = 0;
+    pthread_mutex_lock(&g_rx_psid_cnt.mtx);
+    for (uint32_t i = 0; i < g_rx_psid_cnt.psid_num; i++) {
+        entry = V2X_OBU_GetShmPsidStats(sample->psids, &sample->psid_num, g_rx_psid_cnt.psid[i]);
+        if (entry) {
+            entry->rx_total = g_rx_psid_cnt.cnt[i];
+        }
+    }
+    pthread_mutex_unlock(&g_rx_psid_cnt.mtx);
+    for (int i = 0; i < tx_psid_num; i++) {
+        entry = V2X_OBU_GetShmPsidStats(sample->psids, &sample->psid_num, tx_psid[i]);
+        if (entry) {
+            entry->tx_total = tx_psid_stats[i].tx_cnt;
+        }
+    }
+}
+
+
+/**
+ * 이번 수집값과 직전 수집값으로 초당 변화량을 계산한다.
+ */
+static void V2X_OBU_CalcTelemetryRate(
+        struct V2X_OBU_ShmStats *const cur,
+        const struct V2X_OBU_ShmStats *const prev,
+        const uint64_t elapsed_ns)
+{
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        const uint64_t *const c = (const uint64_t *)&cur->ifs[i].total;
+        const uint64_t *const p = (const uint64_t *)&prev->ifs[i].total;
+        uint64_t *const r = (uint64_t *)&cur->ifs[i].rate;
+        for (size_t k = 0; k < sizeof(struct V2X_OBU_ShmIfCounters) / sizeof(uint64_t); k++) {
+            r[k] = V2X_OBU_GetRate(c[k], p[k], elapsed_ns);
+        }
+    }
+    for (uint32_t i = 0; i < cur->psid_num; i++) {
+        struct V2X_OBU_ShmPsidStats *const e = &cur->psids[i];
+        e->rx_rate = e->tx_rate = 0;
+        for (uint32_t j = 0; j < prev->psid_num; j++) {
+            if (prev->psids[j].psid == e->psid) {
+                e->rx_rate = V2X_OBU_GetRate(e->rx_total, prev->psids[j].rx_total, elapsed_ns);
+                e->tx_rate = V2X_OBU_GetRate(e->tx_total, prev->psids[j].tx_total, elapsed_ns);
+                break;
+            }
+        }
+    }
+}
+
+
+/**
+ * 수집한 통계를 공유메모리 페이지에 게시한다. (seqlock 쓰기)
+ */
+static void V2X_OBU_PublishTelemetry(const struct V2X_OBU_ShmStats *const sample, const uint64_t now)
+{
+    struct V2X_OBU_ShmStats *const shm = g_shm_stats;
+
+    __atomic_store_n(&shm->seq, shm->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    shm->psid_num = sample->psid_num;
+    memcpy(shm->ifs, sample->ifs, sizeof(shm->ifs));
+    memcpy(shm->psids, sample->psids, sizeof(shm->psids));
+    shm->update_cnt++;
+    shm->update_mono_ns = now;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&shm->seq, shm->seq + 1, __ATOMIC_RELAXED);
+}
+
+
+/**
+ * 텔레메트리 쓰레드 함수
+ *
+ * @param arg   사용하지 않음
+ * @return      NULL (프로그램 종료시에만 리턴됨)
+ */
+static void* V2X_OBU_TelemetryThread(void *arg)
+{
+    static struct V2X_OBU_ShmStats sample[2];
+    uint64_t prev_time, now;
+    int cur = 0;
+
+    (void)arg;
+    memset(sample, 0, sizeof(sample));
+    V2X_OBU_CollectTelemetry(&sample[1]);
+    prev_time = V2X_OBU_GetMonoTimeNs();
+
+    while (1) {
+        usleep(g_mib.telemetry_interval * 1000);
+        now = V2X_OBU_GetMonoTimeNs();
+        memset(&sample[cur], 0, sizeof(sample[cur]));
+        V2X_OBU_CollectTelemetry(&sample[cur]);
+        V2X_OBU_CalcTelemetryRate(&sample[cur], &sample[cur ^ 1], now - prev_time);
+        V2X_OBU_PublishTelemetry(&sample[cur], now);
+        prev_time = now;
+        cur ^= 1;
+    }
+    return NULL;
+}
+
+
+/**
+ * 텔레메트리 기능을 초기화한다.
+ *  - 통계 공유메모리 페이지를 생성한 후 텔레메트리 쓰레드를 생성한다.
+ *  - 텔레메트리 주기(g_mib.telemetry_interval)가 0 이면 아무 동작도 하지 않는다.
+ *
+ * @return  성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_InitTelemetry(void)
+{
+    int fd, ret;
+
+    if (g_mib.telemetry_interval == 0) {
+        return 0;
+    }
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Initializing telemetry - interval: %ums\n", g_mib.telemetry_interval);
+
+    fd = shm_open(V2X_OBU_SHM_STATS_NAME, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to shm_open(%s) : %s\n", V2X_OBU_SHM_STATS_NAME, strerror(errno));
+        return -1;
+    }
+    if (ftruncate(fd, sizeof(struct V2X_OBU_ShmStats)) < 0) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to ftruncate() stats page : %s\n", strerror(errno));
+        close(fd);
+        return -1;
+    }
+    g_shm_stats = mmap(NULL, sizeof(struct V2X_OBU_ShmStats), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (g_shm_stats == MAP_FAILED) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to mmap() stats page : %s\n", strerror(errno));
+        g_shm_stats = NULL;
+        return -1;
+    }
+    memset(g_shm_stats, 0, sizeof(struct V2X_OBU_ShmStats));
+    g_shm_stats->version = V2X_OBU_SHM_STATS_VERSION;
+    g_shm_stats->if_num = V2X_OBU_SHM_STATS_IF_MAX_NUM;
+    g_shm_stats->size = sizeof(struct V2X_OBU_ShmStats);
+    g_shm_stats->interval = g_mib.telemetry_interval;
+    g_shm_stats->pid = (uint32_t)getpid();
+    __atomic_store_n(&g_shm_stats->magic, V2X_OBU_SHM_STATS_MAGIC, __ATOMIC_RELEASE);
+
+    ret = pthread_create(&g_telemetry_thread, NULL, V2X_OBU_TelemetryThread, NULL);
+    if (ret) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to create telemetry thread : %s\n", strerror(ret));
+        return -1;
+    }
+
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to initialize telemetry - %s\n", V2X_OBU_SHM_STATS_NAME);
+    return 0;
+}
@@ -0,0 +1,429 @@
+/**
+ * @file v2x-obu-tx-sched.c
+ * @date 2026-10-19
+ * @brief 우선순위, 유효기간 및 TimeSlot 기반 WSM 송신 스케줄러 구현
+ *
+ * 인터페이스 별로 송신 TimeSlot(TimeSlot0, TimeSlot1, Continuous) 마다
+ * 802.11p EDCA 의 AC(Access Category)에 대응하는 4개의 송신 큐를 둔다.
+ * 송신 요청은 송신 TimeSlot 과 사용자 우선순위(Dot3Priority 0~7)에 따라 큐에 저장되고,
+ * 송신쓰레드는 현재 TimeSlot 에 송신 가능한 큐들 중 가장 높은 AC 의 큐부터 꺼낸다. (AC_VO > AC_VI > AC_BE > AC_BK)
+ *
+ * 교번(alternating) 채널접속 시에는 액세스계층의 TimeSlot0/TimeSlot1 이벤트 콜백으로 현재 TimeSlot 을 추적하여,
+ *  - TimeSlot0/1 요청은 해당 TimeSlot 동안에만 꺼낸다.
+ *  - TimeSlot 시작 후 guard interval 동안에는 꺼내지 않는다.
+ *  - TimeSlot 의 남은 시간 안에 송신을 마칠 수 없는 요청은 다음 TimeSlot 으로 미룬다.
+ * TimeSlot 이벤트가 없는 경우(continuous 접속, USE_TIMESLOT_EVENT 빌드 옵션 미사용 등)에는 TimeSlot 과 무관하게 꺼낸다.
+ *
+ * 각 송신 요청은 유효기간(deadline)을 가지며, 큐에서 꺼낼 때 이미 만료된 요청은 송신하지 않고 버린다.
+ * 큐가 가득 찬 경우에는 해당 큐에서 가장 오래된 요청을 버린다. (오래된 보정정보보다 최신 보정정보가 유효하다)
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+
+#include "v2x-obu.h"
+
+
+/// AC 별 송신 큐 크기
+#define TX_AC_QUEUE_SIZE (32)
+
+/// TimeSlot 상태를 알 수 없음 (TimeSlot 이벤트 미수신)
+#define TX_SLOT_UNKNOWN (0xff)
+
+/// MPDU 송신시간 계산 시 더해지는 오버헤드 (PLCP preamble/header, usec)
+#define TX_PHY_OVERHEAD (40)
+
+
+/**
+ * AC 별 송신 큐
+ */
+struct V2X_OBU_TxAcQueue
+{
+    uint32_t head; ///< 다음에 꺼낼 위치
+    uint32_t tail; ///< 다음에 넣을 위치
+    struct V2X_OBU_TxReq req[TX_AC_QUEUE_SIZE];
+};
+
+/**
+ * 인터페이스 별 송신 스케줄러
+ */
+struct V2X_OBU_TxSched
+{
+    pthread_mutex_t mtx;
+    pthread_cond_t cond;
+    uint8_t cur_slot; ///< 현재 TimeSlot (kDot3TimeSlot_0/1, TX_SLOT_UNKNOWN)
+    uint64_t slot_start; ///< 현재 TimeSlot 시작 시각 (CLOCK_MONOTONIC, 나노초)
+    struct V2X_OBU_TxAcQueue q[V2X_OBU_TX_SLOT_NUM][kV2XObuAc_Num]; ///< TimeSlot/AC 별 송신 큐
+    struct V2X_OBU_TxSchedStats stats[kV2XObuAc_Num]; ///< AC 별 통계
+    struct V2X_OBU_TxSlotStats slot_stats[V2X_OBU_TX_SLOT_NUM]; ///< TimeSlot 별 통계
+};
+
+static struct V2X_OBU_TxSched g_tx_sched[V2X_OBU_IF_MAX_NUM]; ///< 인터페이스 별 송신 스케줄러
+static volatile bool g_tx_sched_initialized = false; ///< 송신 스케줄러 초기화 여부 (TimeSlot 콜백에서 확인)
+
+
+/**
+ * 사용자 우선순위(UP)에 대응하는 AC 를 반환한다. (IEEE 802.11 UP-to-AC 매핑)
+ *
+ * @param priority  사용자 우선순위 (0~7)
+ * @return          AC
+ */
+V2XObuAc V2X_OBU_GetAcFromPriority(const Dot3Priority priority)
+{
+    switch (priority) {
+        case 1:
+        case 2:
+            return kV2XObuAc_BK;
+        case 4:
+        case 5:
+            return kV2XObuAc_VI;
+        case 6:
+        case 7:
+            return kV2XObuAc_VO;
+        case 0:
+        case 3:
+        default:
+            return kV2XObuAc_BE;
+    }
+}
+
+
+/**
+ * MPDU 의 송신시간(airtime)을 추정한다.
+ *
+ * @param mpdu_size MPDU 길이
+ * @param datarate  DataRate (500kbps 단위)
+ * @return          송신시간 (usec)
+ */
+uint32_t V2X_OBU_GetTxAirtime(const uint32_t mpdu_size, const Dot3DataRate datarate)
+{
+    if (datarate == 0) {
+        return TX_PHY_OVERHEAD;
+    }
+    return TX_PHY_OVERHEAD + (mpdu_size * 8 * 2) / datarate;
+}
+
+
+/**
+ * 송신 스케줄러를 초기화한다.
+ */
+void V2X_OBU_InitTxSched(void)
+{
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        memset(&g_tx_sched[i], 0, sizeof(struct V2X_OBU_TxSched));
+        pthread_mutex_init(&g_tx_sched[i].mtx, NULL);
+        pthread_cond_init(&g_tx_sched[i].cond, &attr);
+        g_tx_sched[i].cur_slot = TX_SLOT_UNKNOWN;
+    }
+    pthread_condattr_destroy(&attr);
+    g_tx_sched_initialized = true;
+}
+
+
+/**
+ * TimeSlot 시작 이벤트를 처리한다. 액세스계층 TimeSlot0/TimeSlot1 이벤트 콜백에서 호출된다.
+ *  - 모든 인터페이스 스케줄러의 현재 TimeSlot 을 갱신하고, 대기중인 송신쓰레드를 깨운다.
+ *
+ * @param slot  시작된 TimeSlot (kDot3TimeSlot_0 또는 kDot3TimeSlot_1)
+ */
+void V2X_OBU_ProcessTimeSlotEvent(const Dot3TimeSlot slot)
+{
+    struct V2X_OBU_TxSched *sched;
+    uint64_t now;
+
+    if (!g_tx_sched_initialized || (slot > kDot3TimeSlot_1)) {
+        return;
+    }
+
+    now = V2X_OBU_GetMonoTimeNs();
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        sched = &g_tx_sched[i];
+        pthread_mutex_lock(&sched->mtx);
+        sched->cur_slot = (uint8_t)slot;
+        sched->slot_start = now;
+        sched->slot_stats[slot].slot_cnt++;
+        pthread_cond_broadcast(&sched->cond);
+        pthread_mutex_unlock(&sched->mtx);
+    }
+}
+
+
+/**
+ * 송신 요청을 송신 스케줄러에 넣는다.
+ *
+ * @param ifindex       송신 인터페이스 식별번호
+ * @param tag           송신 태그 (메시지큐에서 꺼낸 시각까지 기록된 상태)
+ * @param priority      사용자 우선순위 (0~7)
+ * @param timeslot      송신 TimeSlot (kDot3TimeSlot_0, kDot3TimeSlot_1, kDot3TimeSlot_Continuous)
+ * @param lifetime      유효기간 (usec 단위, 0 이면 만료되지 않음)
+ * @param pkt           송신할 페이로드 (WSM body)
+ * @param len           페이로드 길이
+ * @return              성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_EnqueueTxReq(
+        const uint8_t ifindex,
+        const struct V2X_OBU_TxTag *const tag,
+        const Dot3Priority priority,
+        const Dot3TimeSlot timeslot,
+        const uint32_t lifetime,
+        const uint8_t *const pkt,
+        const uint16_t len)
+{
+    struct V2X_OBU_TxSched *const sched = &g_tx_sched[ifindex];
+    const V2XObuAc ac = V2X_OBU_GetAcFromPriority(priority);
+    const Dot3TimeSlot slot = (timeslot > kDot3TimeSlot_Continuous) ? kDot3TimeSlot_Continuous : timeslot;
+    struct V2X_OBU_TxAcQueue *const q = &sched->q[slot][ac];
+    struct V2X_OBU_TxReq *req;
+
+    if (len > sizeof(req->pkt)) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to enqueue tx request - too long packet(%u)\n", len);
+        return -1;
+    }
+
+    pthread_mutex_lock(&sched->mtx);
+    if (q->tail - q->head >= TX_AC_QUEUE_SIZE) {
+        q->head++;
+        sched->stats[ac].overflow_cnt++;
+    }
+    req = &q->req[q->tail % TX_AC_QUEUE_SIZE];
+    memcpy(&req->tag, tag, sizeof(struct V2X_OBU_TxTag));
+    req->priority = priority;
+    req->timeslot = slot;
+    req->deadline = lifetime ? (tag->t_dequeue + (uint64_t)lifetime * 1000ULL) : 0;
+    req->deferred = false;
+    req->len = len;
+    memcpy(req->pkt, pkt, len);
+    q->tail++;
+    sched->stats[ac].enqueue_cnt++;
+    pthread_cond_signal(&sched->cond);
+    pthread_mutex_unlock(&sched->mtx);
+
+    return 0;
+}
+
+
+/**
+ * 큐의 앞쪽에서 유효기간이 지난 요청들을 버린다. sched->mtx 를 잡은 상태에서 호출되어야 한다.
+ *
+ * @return  큐에 남아있는 첫번째 요청. 큐가 비어있으면 NULL
+ */
+static struct V2X_OBU_TxReq* V2X_OBU_PurgeExpiredTxReq(
+        struct V2X_OBU_TxSched *const sched,
+        const uint8_t ifindex,
+        const V2XObuAc ac,
+        struct V2X_OBU_TxAcQueue *const q,
+        const uint64_t now)
+{
+    struct V2X_OBU_TxReq *head;
+
+    while (q->head != q->tail) {
+        head = &q->req[q->head % TX_AC_QUEUE_SIZE];
+        if (head->deadline && (head->deadline <= now)) {
+            q->head++;
+            sched->stats[ac].expire_cnt++;
+            if (g_dbg >= kDbgMsgLevel_event) {
+                syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Drop expired tx request - seq: %u, if%u, psid: %u, late: %lluus\n",
+                       head->tag.seq, ifindex, head->tag.psid,
+                       (unsigned long long)((now - head->deadline) / 1000ULL));
+            }
+            continue;
+        }
+        return head;
+    }
+    return NULL;
+}
+
+
+/**
+ * 송신 스케줄러에서 다음에 송신할 요청을 꺼낸다. 송신할 요청이 있을 때까지 대기한다.
+ *  - 현재 TimeSlot 에 송신 가능한 큐들 중 가장 높은 AC 의 큐부터 확인한다.
+ *  - 같은 AC 에서는 해당 TimeSlot 전용 요청을 Continuous 요청보다 먼저 꺼낸다.
+ *  - 유효기간이 지난 요청은 버리고 만료 카운터를 증가시킨다.
+ *
+ * @param ifindex   송신 인터페이스 식별번호
+ * @param req       꺼낸 송신 요청이 저장될 구조체
+ */
+void V2X_OBU_DequeueTxReq(const uint8_t ifindex, struct V2X_OBU_TxReq *const req)
+{
+    struct V2X_OBU_TxSched *const sched = &g_tx_sched[ifindex];
+    const uint64_t slot_len = (uint64_t)V2X_OBU_TIMESLOT_INTERVAL * 1000ULL;
+    const uint64_t guard = (uint64_t)V2X_OBU_TIMESLOT_GUARD_INTERVAL * 1000ULL;
+    struct V2X_OBU_TxAcQueue *q;
+    struct V2X_OBU_TxReq *head;
+    uint64_t now, wakeup, slot_end;
+    uint32_t airtime;
+    Dot3Power power;
+    Dot3DataRate datarate;
+    bool slot_known, in_guard;
+    Dot3TimeSlot slots[2];
+    int slot_num;
+    struct timespec ts;
+
+    pthread_mutex_lock(&sched->mtx);
+    while (1) {
+        now = V2X_OBU_GetMonoTimeNs();
+        wakeup = now + slot_len;
+        V2X_OBU_GetDccTxParams(ifindex, &power, &datarate);
+
+        /*
+         * 현재 TimeSlot 을 확인한다.
+         *  - TimeSlot 이벤트가 두 TimeSlot 이상 들어오지 않으면 교번 접속이 아닌 것으로 간주한다.
+         */
+        slot_known = (sched->cur_slot != TX_SLOT_UNKNOWN) && (now < sched->slot_start + 2 * slot_len);
+        in_guard = slot_known && (now < sched->slot_start + guard);
+        slot_end = sched->slot_start + slot_len;
+
+        slot_num = 0;
+        if (!slot_known) {
+            slots[slot_num++] = kDot3TimeSlot_0;
+            slots[slot_num++] = kDot3TimeSlot_1;
+        } else if (!in_guard) {
+            slots[slot_num++] = sched->cur_slot;
+        } else {
+            wakeup = sched->slot_start + guard;
+        }
+
+        /* 송신할 수 없는 TimeSlot 큐에서도 만료된 요청은 버린다. */
+        for (int s = 0; s < V2X_OBU_TX_SLOT_NUM; s++) {
+            for (int ac = 0; ac < kV2XObuAc_Num; ac++) {
+                V2X_OBU_PurgeExpiredTxReq(sched, ifindex, ac, &sched->q[s][ac], now);
+            }
+        }
+
+        for (int ac = kV2XObuAc_Num - 1; ac >= 0; ac--) {
+            for (int s = 0; s <= slot_num; s++) {
+                const Dot3TimeSlot slot = (s < slot_num) ? slots[s] : kDot3TimeSlot_Continuous;
+                q = &sched->q[slot][ac];
+                head = V2X_OBU_PurgeExpiredTxReq(sched, ifindex, ac, q, now);
+                if (!head) {
+                    continue;
+                }
+                airtime = V2X_OBU_GetTxAirtime(head->len + kWsmpHdrMaxSize + kQoSMacHdrSize + kLLCHdrSize, datarate);
+                if (slot != kDot3TimeSlot_Continuous) {
+                    /*
+                     * TimeSlot 의 남은 시간 안에 송신을 마칠 수 없으면 다음 TimeSlot 으로 미룬다.
+                     * 같은 요청이 송신될 때까지 여러 번 확인되므로, 미뤄진 요청 개수는 처음 미뤄질 때만 센다.
+                     */
+                    if (slot_known && (now + (uint64_t)airtime * 1000ULL > slot_end)) {
+                        if (!head->deferred) {
+                            head->deferred = true;
+                            sched->slot_stats[slot].deferred_cnt++;
+                        }
+                        continue;
+                    }
+                }
+                memcpy(req, head, sizeof(struct V2X_OBU_TxReq));
+                q->head++;
+                sched->stats[ac].dequeue_cnt++;
+                sched->slot_stats[slot].tx_cnt++;
+                sched->slot_stats[slot].tx_bytes += head->len;
+                sched->slot_stats[slot].airtime += airtime;
+                pthread_mutex_unlock(&sched->mtx);
+                return;
+            }
+        }
+
+        /* 다음 TimeSlot 이벤트, guard interval 종료, 새로운 요청 중 먼저 발생하는 시점까지 대기한다. */
+        ts.tv_sec = (time_t)(wakeup / 1000000000ULL);
+        ts.tv_nsec = (long)(wakeup % 1000000000ULL);
+        int ret = pthread_cond_timedwait(&sched->cond, &sched->mtx, &ts);
+        if (ret && (ret != ETIMEDOUT)) {
+            syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to wait tx request on if%u : %s\n", ifindex, strerror(ret));
+        }
+    }
+}
+
+
+/**
+ * 송신 요청의 남은 유효기간을 반환한다.
+ *
+ * @param req   송신 요청
+ * @return      남은 유효기간 (usec 단위). 유효기간이 없으면 0, 이미 만료되었으면 1
+ */
+uint64_t V2X_OBU_GetTxReqRemainingLifetime(const struct V2X_OBU_TxReq *const req)
+{
+    uint64_t now;
+
+    if (req->deadline == 0) {
+        return 0;
+    }
+    now = V2X_OBU_GetMonoTimeNs();
+    if (req->deadline <= now + 1000ULL) {
+        return 1;
+    }
+    return (req->deadline - now) / 1000ULL;
+}
+
+
+/**
+ * 송신 스케줄러 통계정보를 복사하여 반환한다.
+ *
+ * @param ifindex       인터페이스 식별번호
+ * @param stats         AC 별 통계정보가 저장될 배열 (kV2XObuAc_Num 개)
+ * @param slot_stats    TimeSlot 별 통계정보가 저장될 배열 (V2X_OBU_TX_SLOT_NUM 개). NULL 이면 반환하지 않는다.
+ */
+void V2X_OBU_GetTxSchedStats(
+        const uint8_t ifindex,
+        struct V2X_OBU_TxSchedStats *const stats,
+        struct V2X_OBU_TxSlotStats *const slot_stats)
+{
+    struct V2X_OBU_TxSched *const sched = &g_tx_sched[ifindex];
+
+    pthread_mutex_lock(&sched->mtx);
+    memcpy(stats, sched->stats, sizeof(sched->stats));
+    for (int ac = 0; ac < kV2XObuAc_Num; ac++) {
+        stats[ac].queued = 0;
+        for (int s = 0; s < V2X_OBU_TX_SLOT_NUM; s++) {
+            stats[ac].queued += sched->q[s][ac].tail - sched->q[s][ac].head;
+        }
+    }
+    if (slot_stats) {
+        memcpy(slot_stats, sched->slot_stats, sizeof(sched->slot_stats));
+    }
+    pthread_mutex_unlock(&sched->mtx);
+}
+
+
+/**
+ * 송신 스케줄러 통계정보를 출력한다.
+ *  - TimeSlot 이용률은 (추정 송신시간 합) / (TimeSlot 개수 * TimeSlot 길이) 로 계산한다.
+ */
+void V2X_OBU_PrintTxSchedStats(void)
+{
+    static const char *ac_name[kV2XObuAc_Num] = { "AC_BK", "AC_BE", "AC_VI", "AC_VO" };
+    static const char *slot_name[V2X_OBU_TX_SLOT_NUM] = { "TS0", "TS1", "CONT" };
+    struct V2X_OBU_TxSchedStats stats[kV2XObuAc_Num];
+    struct V2X_OBU_TxSlotStats slot_stats[V2X_OBU_TX_SLOT_NUM];
+    uint32_t util;
+
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Tx scheduler statistics\n");
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        if (!g_mib.ifs[i].enable) {
+            continue;
+        }
+        V2X_OBU_GetTxSchedStats(i, stats, slot_stats);
+        for (int ac = kV2XObuAc_Num - 1; ac >= 0; ac--) {
+            syslog(LOG_INFO | LOG_LOCAL0, "  if%d %s - queued: %u, enqueue: %u, dequeue: %u, expire: %u, overflow: %u\n",
+                   i, ac_name[ac], stats[ac].queued, stats[ac].enqueue_cnt, stats[ac].dequeue_cnt,
+                   stats[ac].expire_cnt, stats[ac].overflow_cnt);
+        }
+        for (int s = 0; s < V2X_OBU_TX_SLOT_NUM; s++) {
+            util = 0;
+            if (slot_stats[s].slot_cnt) {
+                util = (uint32_t)((slot_stats[s].airtime * 1000ULL) /
+                                  ((uint64_t)slot_stats[s].slot_cnt * V2X_OBU_TIMESLOT_INTERVAL));
+            }
+            syslog(LOG_INFO | LOG_LOCAL0, "  if%d %s - slots: %u, tx: %u, bytes: %llu, airtime: %lluus, deferred: %u, util: %u.%u%%\n",
+                   i, slot_name[s], slot_stats[s].slot_cnt, slot_stats[s].tx_cnt,
+                   (unsigned long long)slot_stats[s].tx_bytes, (unsigned long long)slot_stats[s].airtime,
+                   slot_stats[s].deferred_cnt, util / 10, util % 10);
+        }
+    }
+}
@@ -0,0 +1,423 @@
+/**
+ * @file v2x-obu-tx-stats.c
+ * @date 2026-10-19
+ * @brief WSM 송신 완료 추적 및 송신 지연/결과 통계 기능 구현
+ *
+ * 송신되는 각 WSM 에 태그(struct V2X_OBU_TxTag)를 붙여 다음 시각을 기록한다.
+ *  - 메시지큐에서 꺼낸 시각 (t_dequeue)
+ *  - MPDU 생성 완료 시각 (t_build)
+ *  - Al_TransmitMpdu() 리턴 시각 (t_submit)
+ *  - 송신결과 콜백 호출 시각 (t_complete)
+ *
+ * 송신결과 콜백에는 어떤 MPDU 에 대한 결과인지 식별할 정보가 없으므로,
+ * 송신요청 순서대로 태그를 송신중 FIFO 에 넣고 송신결과 콜백마다 하나씩 꺼내어 매칭한다.
+ * 이를 위해 FIFO 삽입과 Al_TransmitMpdu() 호출은 하나의 잠금 안에서 수행된다. (모든 인터페이스 공통)
+ *  - 모든 송신 요청은 FIFO 엔트리를 가진다. FIFO 의 마지막 한 칸은 자리표시(untracked) 엔트리용으로 남겨두어,
+ *    FIFO 가 가득 차서 추적하지 못하는 송신 요청도 송신결과 하나를 소비하도록 한다. (연속된 요청들은 한 엔트리를 공유)
+ *  - 송신결과가 유실되면 이후의 매칭이 모두 밀리므로, 유효기간 + TX_RESULT_MARGIN 이 지나도록 송신결과가 없는
+ *    엔트리는 매칭 전에 버리고 lost 로 집계한다.
+ *
+ * 지연시간은 인터페이스 별, PSID 별로 다음 구간에 대해 히스토그램으로 누적된다.
+ *  - pipeline : t_dequeue ~ t_submit (prcsWSM 내부 처리 지연)
+ *  - radio    : t_submit ~ t_complete (디바이스 처리 지연)
+ *  - total    : t_dequeue ~ t_complete
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include <syslog.h>
+
+#include "wlanaccess/wlanaccess.h"
+
+#include "v2x-obu.h"
+
+
+/// 송신중 FIFO 크기
+#define TX_INFLIGHT_FIFO_SIZE (256)
+
+/// 송신 통계 출력 주기 (나노초)
+#define TX_STATS_PRINT_INTERVAL (10ULL * 1000000000ULL)
+
+/// 유효기간이 지난 후 송신결과를 더 기다리는 시간 (나노초)
+#define TX_RESULT_MARGIN (100ULL * 1000000ULL)
+
+
+/**
+ * 송신중 FIFO 엔트리
+ */
+struct V2X_OBU_TxInflight
+{
+    struct V2X_OBU_TxTag tag; ///< 송신 태그 (자리표시 엔트리는 마지막 요청의 태그)
+    uint64_t lost_time; ///< 이 시각까지 송신결과가 없으면 유실된 것으로 본다 (CLOCK_MONOTONIC, 나노초)
+    uint32_t untracked_num; ///< 자리표시 엔트리가 대신하는 송신 요청 개수 (0 이면 추적 태그)
+};
+
+
+/**
+ * 송신 추적 정보
+ */
+static struct
+{
+    pthread_mutex_t mtx;
+    uint32_t seq; ///< 다음 태그 일련번호
+    uint32_t head; ///< 송신중 FIFO 에서 다음에 꺼낼 위치
+    uint32_t tail; ///< 송신중 FIFO 에 다음에 넣을 위치
+    struct V2X_OBU_TxInflight inflight[TX_INFLIGHT_FIFO_SIZE]; ///< 송신결과 대기 중인 엔트리들
+    uint32_t unmatched_result_cnt; ///< 대응하는 태그가 없는 송신결과 개수
+    uint32_t lost_untracked_cnt; ///< 송신결과를 받지 못해 버려진 자리표시(추적하지 않은) 송신 요청 개수
+    uint64_t last_print; ///< 마지막 통계 출력 시각
+
+    struct V2X_OBU_TxStats if_stats[V2X_OBU_IF_MAX_NUM]; ///< 인터페이스 별 통계
+    uint32_t psid_num; ///< psid_stats 에 등록된 PSID 개수
+    Dot3Psid psid[V2X_OBU_TX_STATS_PSID_MAX_NUM]; ///< psid_stats 에 등록된 PSID
+    struct V2X_OBU_TxStats psid_stats[V2X_OBU_TX_STATS_PSID_MAX_NUM]; ///< PSID 별 통계
+    struct V2X_OBU_TxStats other_psid_stats; ///< 등록공간이 부족한 PSID 들에 대한 통계
+} g_tx_track = { .mtx = PTHREAD_MUTEX_INITIALIZER };
+
+
+/**
+ * 지연시간이 속하는 히스토그램 구간을 반환한다.
+ *  - 구간 i 는 [2^i, 2^(i+1)) usec 이다. (구간 0 은 2usec 미만, 마지막 구간은 그 이상 모두)
+ *
+ * @param latency_ns    지연시간 (나노초)
+ * @return              히스토그램 구간 인덱스
+ */
+static uint32_t V2X_OBU_GetLatencyHistBin(const uint64_t latency_ns)
+{
+    uint64_t usec = latency_ns / 1000ULL;
+    uint32_t bin = 0;
+    while ((usec >>= 1) && (bin < V2X_OBU_LATENCY_HIST_BIN_NUM - 1)) {
+        bin++;
+    }
+    return bin;
+}
+
+
+/**
+ * PSID 에 해당하는 통계정보를 반환한다. 처음 보는 PSID 이면 등록한다.
+ *  - g_tx_track.mtx 가 잠긴 상태에서 호출되어야 한다.
+ *
+ * @param psid  PSID
+ * @return      통계정보
+ */
+static struct V2X_OBU_TxStats *V2X_OBU_GetPsidTxStats(const Dot3Psid psid)
+{
+    for (uint32_t i = 0; i < g_tx_track.psid_num; i++) {
+        if (g_tx_track.psid[i] == psid) {
+            return &g_tx_track.psid_stats[i];
+        }
+    }
+    if (g_tx_track.psid_num < V2X_OBU_TX_STATS_PSID_MAX_NUM) {
+        g_tx_track.psid[g_tx_track.psid_num] = psid;
+        return &g_tx_track.psid_stats[g_tx_track.psid_num++];
+    }
+    return &g_tx_track.other_psid_stats;
+}
+
+
+/**
+ * 송신 실패 상세 에러코드 카운터를 증가시킨다.
+ *
+ * @param stats     통계정보
+ * @param errcode   디바이스별로 정의된 상세 에러코드
+ */
+static void V2X_OBU_CountTxErrcode(struct V2X_OBU_TxStats *const stats, const int errcode)
+{
+    for (uint32_t i = 0; i < V2X_OBU_TX_ERRCODE_MAX_NUM; i++) {
+        if (stats->errcode[i].cnt == 0) {
+            stats->errcode[i].errcode = errcode;
+        }
+        if (stats->errcode[i].errcode == errcode) {
+            stats->errcode[i].cnt++;
+            return;
+        }
+    }
+    stats->other_errcode_cnt++;
+}
+
+
+/**
+ * 송신이 완료된 태그를 통계에 반영한다.
+ *  - g_tx_track.mtx 가 잠긴 상태에서 호출되어야 한다.
+ *
+ * @param stats     통계정보
+ * @param tag       송신 태그
+ * @param result    송신 요청 처리 결과
+ * @param errcode   디바이스별로 정의된 상세 에러코드
+ */
+static void V2X_OBU_UpdateTxStats(
+        struct V2X_OBU_TxStats *const stats,
+        const struct V2X_OBU_TxTag *const tag,
+        const AlTxResultCode result,
+        const int errcode)
+{
+    stats->complete_cnt++;
+    if (result != kAlTxResult_Success) {
+        stats->complete_fail_cnt++;
+        V2X_OBU_CountTxErrcode(stats, errcode);
+    }
+    stats->hist_pipeline[V2X_OBU_GetLatencyHistBin(tag->t_submit - tag->t_dequeue)]++;
+    stats->hist_radio[V2X_OBU_GetLatencyHistBin(tag->t_complete - tag->t_submit)]++;
+    stats->hist_total[V2X_OBU_GetLatencyHistBin(tag->t_complete - tag->t_dequeue)]++;
+}
+
+
+/**
+ * 송신 태그를 초기화한다. 송신할 메시지를 메시지큐에서 꺼낸 직후에 호출한다.
+ *
+ * @param tag       초기화할 송신 태그
+ * @param ifindex   송신 인터페이스 식별번호
+ * @param psid      송신 PSID
+ */
+void V2X_OBU_InitTxTag(struct V2X_OBU_TxTag *const tag, const uint8_t ifindex, const Dot3Psid psid)
+{
+    memset(tag, 0, sizeof(struct V2X_OBU_TxTag));
+    tag->ifindex = ifindex;
+    tag->psid = psid;
+    tag->t_dequeue = V2X_OBU_GetMonoTimeNs();
+    pthread_mutex_lock(&g_tx_track.mtx);
+    tag->seq = g_tx_track.seq++;
+    pthread_mutex_unlock(&g_tx_track.mtx);
+}
+
+
+/**
+ * 태그가 붙은 MPDU 를 전송한다.
+ *  - 태그를 송신중 FIFO 에 넣고 Al_TransmitMpdu() 를 호출한다.
+ *  - 송신결과 콜백과의 매칭을 위해, 두 동작은 하나의 잠금 안에서 수행된다.
+ *  - FIFO 에 남은 칸이 자리표시용 한 칸뿐이면 태그 대신 자리표시 엔트리를 넣는다. (untracked 로 집계)
+ *
+ * @param tag       송신 태그 (t_build 까지 기록된 상태)
+ * @param mpdu      전송할 MPDU
+ * @param mpdu_size 전송할 MPDU 의 크기
+ * @param al_params 액세스계층 MPDU 전송 파라미터
+ * @return          Al_TransmitMpdu() 의 반환값
+ */
+int V2X_OBU_TransmitTaggedMpdu(
+        struct V2X_OBU_TxTag *const tag,
+        const uint8_t *const mpdu,
+        const uint16_t mpdu_size,
+        const struct AlMpduTxParams *const al_params)
+{
+    struct V2X_OBU_TxInflight *entry;
+    const uint64_t lifetime = al_params->expiry ? al_params->expiry : V2X_OBU_TX_DEFAULT_LIFETIME;
+    bool untracked = false, new_entry = true;
+    int ret;
+
+    pthread_mutex_lock(&g_tx_track.mtx);
+    g_tx_track.if_stats[tag->ifindex].tx_cnt++;
+    V2X_OBU_GetPsidTxStats(tag->psid)->tx_cnt++;
+    if (g_tx_track.tail - g_tx_track.head < TX_INFLIGHT_FIFO_SIZE - 1) {
+        entry = &g_tx_track.inflight[g_tx_track.tail % TX_INFLIGHT_FIFO_SIZE];
+    } else {
+        /*
+         * 자리표시 엔트리를 사용한다.
+         *  - 마지막 엔트리가 자리표시 엔트리이면 공유하고, 아니면 남겨둔 칸에 새로 넣는다.
+         *  - 추적 태그는 TX_INFLIGHT_FIFO_SIZE - 1 개까지만 들어가므로 남겨둔 칸은 항상 비어 있다.
+         */
+        untracked = true;
+        entry = &g_tx_track.inflight[(g_tx_track.tail - 1) % TX_INFLIGHT_FIFO_SIZE];
+        if ((g_tx_track.tail == g_tx_track.head) || (entry->untracked_num == 0)) {
+            entry = &g_tx_track.inflight[g_tx_track.tail % TX_INFLIGHT_FIFO_SIZE];
+        } else {
+            new_entry = false;
+        }
+        g_tx_track.if_stats[tag->ifindex].untracked_cnt++;
+        V2X_OBU_GetPsidTxStats(tag->psid)->untracked_cnt++;
+    }
+
+    ret = Al_TransmitMpdu(tag->ifindex, mpdu, mpdu_size, al_params);
+    tag->t_submit = V2X_OBU_GetMonoTimeNs();
+
+    if (ret < 0) {
+        /* 송신결과 콜백이 호출되지 않으므로 FIFO 에 넣지 않는다. */
+        g_tx_track.if_stats[tag->ifindex].submit_fail_cnt++;
+        V2X_OBU_GetPsidTxStats(tag->psid)->submit_fail_cnt++;
+    } else {
+        memcpy(&entry->tag, tag, sizeof(struct V2X_OBU_TxTag));
+        entry->lost_time = tag->t_submit + lifetime * 1000ULL + TX_RESULT_MARGIN;
+        if (new_entry) {
+            entry->untracked_num = untracked ? 1 : 0;
+            g_tx_track.tail++;
+        } else {
+            entry->untracked_num++;
+        }
+    }
+    pthread_mutex_unlock(&g_tx_track.mtx);
+
+    return ret;
+}
+
+
+/**
+ * 송신결과를 받지 못한 채 유실 시각이 지난 엔트리들을 송신중 FIFO 에서 버린다.
+ *  - g_tx_track.mtx 가 잠긴 상태에서 호출되어야 한다.
+ *
+ * @param now   현재 시각 (CLOCK_MONOTONIC, 나노초)
+ */
+static void V2X_OBU_DropLostTxTags(const uint64_t now)
+{
+    struct V2X_OBU_TxInflight *entry;
+
+    while (g_tx_track.head != g_tx_track.tail) {
+        entry = &g_tx_track.inflight[g_tx_track.head % TX_INFLIGHT_FIFO_SIZE];
+        if (entry->lost_time > now) {
+            break;
+        }
+        if (entry->untracked_num) {
+            g_tx_track.lost_untracked_cnt += entry->untracked_num;
+        } else {
+            g_tx_track.if_stats[entry->tag.ifindex].lost_cnt++;
+            V2X_OBU_GetPsidTxStats(entry->tag.psid)->lost_cnt++;
+        }
+        if (g_dbg >= kDbgMsgLevel_event) {
+            syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Drop lost tx tag - seq: %u, if%u, psid: %u, untracked: %u\n",
+                   entry->tag.seq, entry->tag.ifindex, entry->tag.psid, entry->untracked_num);
+        }
+        g_tx_track.head++;
+    }
+}
+
+
+/**
+ * 송신결과를 송신중 FIFO 의 가장 오래된 태그와 매칭하여 통계에 반영한다. 송신결과 콜백에서 호출된다.
+ *  - 매칭 전에 송신결과가 유실된 것으로 보이는 엔트리들을 버린다.
+ *  - 가장 오래된 엔트리가 자리표시 엔트리이면 송신결과를 통계에 반영하지 않고 소비만 한다.
+ *
+ * @param result    송신 요청 처리 결과
+ * @param errcode   디바이스별로 정의된 상세 에러코드
+ */
+void V2X_OBU_ProcessTxResult(const AlTxResultCode result, const int errcode)
+{
+    struct V2X_OBU_TxInflight *entry;
+    struct V2X_OBU_TxTag tag;
+    uint64_t now = V2X_OBU_GetMonoTimeNs();
+    bool print = false;
+
+    pthread_mutex_lock(&g_tx_track.mtx);
+    V2X_OBU_DropLostTxTags(now);
+    entry = &g_tx_track.inflight[g_tx_track.head % TX_INFLIGHT_FIFO_SIZE];
+    if (g_tx_track.head == g_tx_track.tail) {
+        g_tx_track.unmatched_result_cnt++;
+    } else if (entry->untracked_num) {
+        if (--entry->untracked_num == 0) {
+            g_tx_track.head++;
+        }
+    } else {
+        memcpy(&tag, &entry->tag, sizeof(tag));
+        g_tx_track.head++;
+        tag.t_complete = now;
+        V2X_OBU_UpdateTxStats(&g_tx_track.if_stats[tag.ifindex], &tag, result, errcode);
+        V2X_OBU_UpdateTxStats(V2X_OBU_GetPsidTxStats(tag.psid), &tag, result, errcode);
+        if ((g_dbg >= kDbgMsgLevel_event) || (result != kAlTxResult_Success)) {
+            syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Tx result - seq: %u, if%u, psid: %u, result: %d, errcode: %d, "
+                   "build: %lluus, submit: %lluus, complete: %lluus\n",
+                   tag.seq, tag.ifindex, tag.psid, result, errcode,
+                   (unsigned long long)((tag.t_build - tag.t_dequeue) / 1000ULL),
+                   (unsigned long long)((tag.t_submit - tag.t_build) / 1000ULL),
+                   (unsigned long long)((tag.t_complete - tag.t_submit) / 1000ULL));
+        }
+    }
+    if ((g_dbg >= kDbgMsgLevel_event) && (now - g_tx_track.last_print >= TX_STATS_PRINT_INTERVAL)) {
+        g_tx_track.last_print = now;
+        print = true;
+    }
+    pthread_mutex_unlock(&g_tx_track.mtx);
+
+    if (print) {
+        V2X_OBU_PrintTxStats();
+    }
+}
+
+
+/**
+ * 송신 통계정보를 복사하여 반환한다.
+ *
+ * @param if_stats      인터페이스 별 통계정보가 저장될 배열 (V2X_OBU_IF_MAX_NUM 개)
+ * @param psid          PSID 별 통계정보의 PSID 가 저장될 배열 (V2X_OBU_TX_STATS_PSID_MAX_NUM 개)
+ * @param psid_stats    PSID 별 통계정보가 저장될 배열 (V2X_OBU_TX_STATS_PSID_MAX_NUM 개)
+ * @return              반환된 PSID 별 통계정보의 개수
+ */
+int V2X_OBU_GetTxStats(
+        struct V2X_OBU_TxStats *const if_stats,
+        Dot3Psid *const psid,
+        struct V2X_OBU_TxStats *const psid_stats)
+{
+    int num;
+    pthread_mutex_lock(&g_tx_track.mtx);
+    memcpy(if_stats, g_tx_track.if_stats, sizeof(g_tx_track.if_stats));
+    num = (int)g_tx_track.psid_num;
+    memcpy(psid, g_tx_track.psid, sizeof(Dot3Psid) * num);
+    memcpy(psid_stats, g_tx_track.psid_stats, sizeof(struct V2X_OBU_TxStats) * num);
+    pthread_mutex_unlock(&g_tx_track.mtx);
+    return num;
+}
+
+
+/**
+ * 하나의 통계정보를 출력한다.
+ *
+ * @param name      출력 이름
+ * @param stats     통계정보
+ */
+static void V2X_OBU_PrintTxStatsEntry(const char *const name, const struct V2X_OBU_TxStats *const stats)
+{
+    char buf[512];
+    int len;
+
+    syslog(LOG_INFO | LOG_LOCAL0, "  %s - tx: %u, submit_fail: %u, complete: %u, complete_fail: %u, untracked: %u, lost: %u\n",
+           name, stats->tx_cnt, stats->submit_fail_cnt, stats->complete_cnt, stats->complete_fail_cnt, stats->untracked_cnt,
+           stats->lost_cnt);
+    for (uint32_t i = 0; i < V2X_OBU_TX_ERRCODE_MAX_NUM; i++) {
+        if (stats->errcode[i].cnt) {
+            syslog(LOG_INFO | LOG_LOCAL0, "    errcode %d: %u\n", stats->errcode[i].errcode, stats->errcode[i].cnt);
+        }
+    }
+    if (stats->other_errcode_cnt) {
+        syslog(LOG_INFO | LOG_LOCAL0, "    errcode others: %u\n", stats->other_errcode_cnt);
+    }
+
+    const uint32_t *hist[3] = { stats->hist_pipeline, stats->hist_radio, stats->hist_total };
+    const char *hist_name[3] = { "pipeline", "radio", "total" };
+    for (int h = 0; h < 3; h++) {
+        len = snprintf(buf, sizeof(buf), "    %-8s(us, 2^n):", hist_name[h]);
+        for (int i = 0; i < V2X_OBU_LATENCY_HIST_BIN_NUM; i++) {
+            len += snprintf(buf + len, sizeof(buf) - len, " %u", hist[h][i]);
+        }
+        syslog(LOG_INFO | LOG_LOCAL0, "%s\n", buf);
+    }
+}
+
+
+/**
+ * 송신 통계정보를 출력한다.
+ */
+void V2X_OBU_PrintTxStats(void)
+{
+    struct V2X_OBU_TxStats if_stats[V2X_OBU_IF_MAX_NUM];
+    Dot3Psid psid[V2X_OBU_TX_STATS_PSID_MAX_NUM];
+    struct V2X_OBU_TxStats psid_stats[V2X_OBU_TX_STATS_PSID_MAX_NUM];
+    char name[32];
+
+    uint32_t unmatched_result_cnt, lost_untracked_cnt;
+
+    int psid_num = V2X_OBU_GetTxStats(if_stats, psid, psid_stats);
+    pthread_mutex_lock(&g_tx_track.mtx);
+    unmatched_result_cnt = g_tx_track.unmatched_result_cnt;
+    lost_untracked_cnt = g_tx_track.lost_untracked_cnt;
+    pthread_mutex_unlock(&g_tx_track.mtx);
+
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Tx statistics - unmatched result: %u, lost untracked: %u\n",
+           unmatched_result_cnt, lost_untracked_cnt);
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        if (g_mib.ifs[i].enable) {
+            snprintf(name, sizeof(name), "if%d", i);
+            V2X_OBU_PrintTxStatsEntry(name, &if_stats[i]);
+        }
+    }
+    for (int i = 0; i < psid_num; i++) {
+        snprintf(name, sizeof(name), "psid %u", psid[i]);
+        V2X_OBU_PrintTxStatsEntry(name, &psid_stats[i]);
+    }
+    V2X_OBU_PrintTxSchedStats();
+}
@@ -0,0 +1,307 @@
+/**
+ * @file v2x-obu-tx-wsa.c
+ * @date 2026-10-19
+ * @author gyun
+ * @brief WSA 송신 기능 구현
+ *
+ * dot3 라이브러리의 PSR/PCI 테이블로부터 Dot3_ConstructWsa() 로 WSA 를 생성하여 WSA 송신 인터페이스(CCH)로
+ * 반복주기마다 송신한다.
+ *  - 인코딩된 WSA 는 캐시하며, 매 송신 시에는 캐시된 바이트를 그대로 송신 스케줄러에 넣는다.
+ *  - PSR 테이블 내용이 바뀌거나 위치가 V2X_OBU_WSA_LOC_THRESHOLD 이상 이동한 경우에만 다시 인코딩한다.
+ *  - PCI 테이블은 라이브러리 초기화 시에만 설정되며, WSA 에 수납되는 Channel Info 는 PSR 의 서비스채널에 의해
+ *    결정되므로 PSR 테이블 비교로 Channel Info 변경도 함께 감지된다.
+ */
+
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "dot3/dot3.h"
+
+#include "v2x-obu.h"
+
+
+/**
+ * WSA 송신 정보
+ */
+struct V2X_OBU_WsaTx
+{
+  pthread_t thread;                   ///< WSA 송신쓰레드
+
+  /* 위치정보 - V2X_OBU_SetWsaLocation() 으로 갱신되며 mtx 로 보호된다. */
+  pthread_mutex_t mtx;
+  bool loc_valid;                     ///< 위치정보 유효 여부
+  struct Dot3WsaThreeDLocation loc;   ///< 현재 위치
+
+  /* 인코딩 캐시 - WSA 송신쓰레드만 접근한다. */
+  bool encoded;                       ///< 한 번 이상 인코딩되었는지 여부
+  Dot3WsaContentCount content_count;  ///< 캐시된 WSA 의 content count
+  bool enc_loc_valid;                 ///< 캐시된 WSA 에 위치정보가 수납되었는지 여부
+  struct Dot3WsaThreeDLocation enc_loc; ///< 캐시된 WSA 에 수납된 위치
+  int psr_num;                        ///< 캐시된 WSA 에 수납된 PSR 개수 (-1 이면 다시 인코딩 필요)
+  struct Dot3Psr psrs[kDot3PsrNum_MaxNum];    ///< 캐시된 WSA 에 수납된 PSR
+  struct Dot3Psr scratch[kDot3PsrNum_MaxNum]; ///< 현재 PSR 테이블 확인용 버퍼
+  uint16_t wsa_size;                  ///< 캐시된 WSA 길이
+  uint8_t wsa[kMpduMaxSize];          ///< 캐시된 WSA
+};
+
+static struct V2X_OBU_WsaTx g_wsa_tx = { .mtx = PTHREAD_MUTEX_INITIALIZER };
+
+
+/**
+ * WSA 에 수납할 위치정보를 설정한다.
+ *  - 설정된 위치는 캐시된 WSA 의 위치와 V2X_OBU_WSA_LOC_THRESHOLD 이상 차이날 때 다음 송신 시점에 반영된다.
+ *
+ * @param latitude      위도 (0.1 마이크로도 단위). kDot3Latitude_Unavailable 이면 위치정보를 수납하지 않는다.
+ * @param longitude     경도 (0.1 마이크로도 단위)
+ * @param elevation     고도 (10cm 단위). 알 수 없으면 kDot3Elevation_Unavailable
+ * @return              성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_SetWsaLocation(const Dot3Latitude latitude, const Dot3Longitude longitude, const Dot3Elevation elevation)
+{
+    bool valid = (latitude != kDot3Latitude_Unavailable);
+    if (valid &&
+        ((latitude < kDot3Latitude_Min) || (latitude > kDot3Latitude_Max) ||
+         (longitude < kDot3Longitude_Min) || (longitude >= kDot3Longitude_Max) ||
+         (elevation < kDot3Elevation_Min) || (elevation > kDot3Elevation_Max))) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to set WSA location - invalid location %d, %d, %d\n",
+               latitude, longitude, elevation);
+        return -1;
+    }
+
+    pthread_mutex_lock(&g_wsa_tx.mtx);
+    g_wsa_tx.loc_valid = valid;
+    g_wsa_tx.loc.latitude = latitude;
+    g_wsa_tx.loc.longitude = longitude;
+    g_wsa_tx.loc.elevation = elevation;
+    pthread_mutex_unlock(&g_wsa_tx.mtx);
+    return 0;
+}
+
+
+/**
+ * 두 위치가 V2X_OBU_WSA_LOC_THRESHOLD 이상 떨어져 있는지 확인한다.
+ *  - 임계값이 수 미터 수준이므로 equirectangular 근사로 수평거리를 계산한다.
+ *
+ * @param a     위치 1
+ * @param b     위치 2
+ * @return      떨어져 있으면 true
+ */
+static bool V2X_OBU_IsWsaLocationMoved(const struct Dot3WsaThreeDLocation *const a, const struct Dot3WsaThreeDLocation *const b)
+{
+    /* 위도 0.1 마이크로도 당 거리 (m) */
+    const double m_per_unit = 0.0111319491;
+    const double threshold = V2X_OBU_WSA_LOC_THRESHOLD;
+
+    double dlon = (double)a->longitude - (double)b->longitude;
+    if (dlon > 1800000000.0) {
+        dlon -= 3600000000.0;
+    } else if (dlon < -1800000000.0) {
+        dlon += 3600000000.0;
+    }
+    const double lat = ((double)a->latitude + (double)b->latitude) * 0.5e-7 * (M_PI / 180.0);
+    const double dy = ((double)a->latitude - (double)b->latitude) * m_per_unit;
+    const double dx = dlon * m_per_unit * cos(lat);
+    if ((dx * dx) + (dy * dy) >= threshold * threshold) {
+        return true;
+    }
+
+    /* 고도는 둘 다 알려진 경우에만 비교한다. */
+    if ((a->elevation != kDot3Elevation_Unavailable) && (b->elevation != kDot3Elevation_Unavailable)) {
+        const int32_t delev = a->elevation - b->elevation;
+        if ((double)((delev < 0) ? -delev : delev) >= threshold * 10.0) {
+            return true;
+        }
+    }
+    return (a->elevation == kDot3Elevation_Unavailable) != (b->elevation == kDot3Elevation_Unavailable);
+}
+
+
+/**
+ * 캐시된 WSA 가 현재 PSR 테이블과 위치를 반영하는지 확인하고, 그렇지 않으면 다시 인코딩한다.
+ *
+ * @return  송신할 WSA 가 있으면 1, 광고할 서비스(PSR)가 없으면 0, 인코딩 실패 시 -1
+ */
+static int V2X_OBU_UpdateWsa(void)
+{
+    struct V2X_OBU_WsaTx *const w = &g_wsa_tx;
+    struct Dot3ConstructWsaParams params;
+    struct Dot3WsaThreeDLocation loc;
+    bool loc_valid, changed;
+    int psr_num, n, ret;
+
+    /*
+     * 현재 PSR 테이블에서 이 WSA 에 수납될 PSR 들을 가져와 캐시된 PSR 들과 비교한다.
+     *  - Dot3_GetAllPsrs() 는 테이블 엔트리를 그대로 복사하므로, 내용이 같으면 바이트 단위로도 같다.
+     */
+    n = Dot3_GetAllPsrs(w->scratch, kDot3PsrNum_MaxNum);
+    if (n < 0) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to Dot3_GetAllPsrs() - %d\n", n);
+        return -1;
+    }
+    psr_num = 0;
+    for (int i = 0; i < n; i++) {
+        if (w->scratch[i].wsa_id == g_mib.wsa.wsa_id) {
+            if (i != psr_num) {
+                memcpy(&w->scratch[psr_num], &w->scratch[i], sizeof(struct Dot3Psr));
+            }
+            psr_num++;
+        }
+    }
+    changed = (psr_num != w->psr_num) || memcmp(w->scratch, w->psrs, sizeof(struct Dot3Psr) * psr_num);
+
+    pthread_mutex_lock(&w->mtx);
+    loc_valid = w->loc_valid;
+    loc = w->loc;
+    pthread_mutex_unlock(&w->mtx);
+    if (loc_valid != w->enc_loc_valid) {
+        changed = true;
+    } else if (loc_valid && V2X_OBU_IsWsaLocationMoved(&loc, &w->enc_loc)) {
+        changed = true;
+    }
+
+    if (!changed) {
+        return (w->psr_num > 0) ? 1 : 0;
+    }
+
+    /*
+     * 변경된 내용으로 다시 인코딩한다.
+     *  - 광고할 서비스가 없으면 WSA 를 송신하지 않는다.
+     *  - 내용이 바뀌었으므로 content count 를 증가시킨다.
+     */
+    if (w->encoded) {
+        w->content_count = (Dot3WsaContentCount)((w->content_count + 1) % (kDot3WsaMaxContentCount + 1));
+    }
+    w->psr_num = psr_num;
+    memcpy(w->psrs, w->scratch, sizeof(struct Dot3Psr) * psr_num);
+    w->enc_loc_valid = loc_valid;
+    w->enc_loc = loc;
+    w->encoded = true;
+    w->wsa_size = 0;
+    if (psr_num == 0) {
+        return 0;
+    }
+
+    memset(&params, 0, sizeof(params));
+    params.hdr.version = kDot3WsaVersion_Current;
+    params.hdr.wsa_id = g_mib.wsa.wsa_id;
+    params.hdr.content_count = w->content_count;
+    params.hdr.extensions.repeat_rate = true;
+    params.hdr.repeat_rate = g_mib.wsa.repeat_rate;
+    if (loc_valid) {
+        params.hdr.extensions.threed_location = true;
+        params.hdr.threed_location = loc;
+    }
+    ret = Dot3_ConstructWsa(&params, w->wsa, sizeof(w->wsa));
+    V2X_OBU_INC_CNT(g_mib.wsa.ifindex, tx_wsa_encode);
+    if (ret < 0) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to Dot3_ConstructWsa() - %d\n", ret);
+        w->psr_num = -1; // 다음 송신주기에 다시 인코딩을 시도한다.
+        return -1;
+    }
+    w->wsa_size = (uint16_t)ret;
+
+    if (g_dbg >= kDbgMsgLevel_event) {
+        syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to construct %d-bytes WSA - %d services, content count: %u\n",
+               ret, psr_num, w->content_count);
+    }
+    return 1;
+}
+
+
+/**
+ * WSA 송신 쓰레드 함수
+ *  - 송신주기마다 캐시된 WSA 를 확인/갱신하고, WSA 송신 인터페이스의 송신 스케줄러에 넣는다.
+ *  - 송신 요청의 유효기간은 송신주기로 설정하여, 다음 WSA 가 생성되기 전에 송신되지 못한 WSA 는 버려지도록 한다.
+ *
+ * @param arg       송신주기 (usec 단위)
+ * @return          NULL (프로그램 종료시에만 리턴됨)
+ */
+static void* V2X_OBU_WsaTxThread(void *arg)
+{
+    const uint32_t interval = (uint32_t)(uintptr_t)arg;
+    const uint8_t ifindex = g_mib.wsa.ifindex;
+    const struct V2X_OBU_IF_MIB *const ifmib = &g_mib.ifs[ifindex];
+    struct V2X_OBU_TxTag tag;
+    struct timespec next;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    do {
+        if (V2X_OBU_UpdateWsa() > 0) {
+            V2X_OBU_InitTxTag(&tag, ifindex, kDot3Psid_Wsa);
+            if (V2X_OBU_EnqueueTxReq(ifindex, &tag, ifmib->priority, ifmib->timeSlot, interval,
+                                     g_wsa_tx.wsa, g_wsa_tx.wsa_size) == 0) {
+                V2X_OBU_INC_CNT(ifindex, tx_wsa);
+            }
+        }
+
+        /* 처리시간에 따라 주기가 밀리지 않도록 절대시각으로 대기한다. */
+        next.tv_nsec += (long)(interval % 1000000) * 1000;
+        next.tv_sec += interval / 1000000;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) != 0);
+    } while (1);
+
+    return NULL;
+}
+
+
+/**
+ * WSA 송신 기능을 초기화하고 WSA 송신쓰레드를 시작한다.
+ *  - 서비스채널이 설정되어 있으면 송신 PSID 에 대한 PSR 을 등록한다.
+ *  - 위치가 설정되어 있으면 WSA 에 3D 위치정보를 수납한다.
+ *
+ * @param timer_interval    WSA 송신주기 (usec 단위)
+ * @return                  성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_InitWsaTx(const uint32_t timer_interval)
+{
+    const uint8_t ifindex = g_mib.wsa.ifindex;
+    struct Dot3Psr psr;
+    int ret;
+
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Initializing WSA tx - if: %u, chan: %u, interval: %uusec\n",
+           ifindex, g_mib.ifs[ifindex].channel, timer_interval);
+
+    if ((timer_interval == 0) || !g_mib.ifs[ifindex].enable) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to initialize WSA tx - invalid interval or interface\n");
+        return -1;
+    }
+
+    if (g_mib.wsa.service_chan) {
+        memset(&psr, 0, sizeof(psr));
+        psr.wsa_id = g_mib.wsa.wsa_id;
+        psr.psid = g_mib.psid;
+        psr.service_chan_num = g_mib.wsa.service_chan;
+        psr.chan_access = kDot3ProviderChannelAccess_Continuous;
+        ret = Dot3_AddPsr(&psr);
+        if (ret < 0) {
+            syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to Dot3_AddPsr() - %d\n", ret);
+            return -1;
+        }
+    }
+
+    if (g_mib.wsa.loc_valid) {
+        ret = V2X_OBU_SetWsaLocation(g_mib.wsa.loc.latitude, g_mib.wsa.loc.longitude, g_mib.wsa.loc.elevation);
+        if (ret < 0) {
+            return -1;
+        }
+    }
+
+    ret = pthread_create(&g_wsa_tx.thread, NULL, V2X_OBU_WsaTxThread, (void *)(uintptr_t)timer_interval);
+    if (ret) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to create WSA tx thread - %s\n", strerror(ret));
+        return -1;
+    }
+    V2X_OBU_SetThreadAffinity(g_wsa_tx.thread, g_mib.ifs[ifindex].txCpu);
+
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to initialize WSA tx\n");
+    return 0;
+}
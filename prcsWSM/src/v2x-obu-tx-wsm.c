@@ -23,28 +23,65 @@ static timer_t g_tx_timer; ///< 송신타이머
 static pthread_mutex_t g_tx_timer_mtx; ///< 송신타이머 뮤텍스
 static pthread_cond_t tx_timer_cond; ///< 송신타이머 컨디션
 #endif
-static pthread_t g_tx_thread; ///< 송신쓰레드
+static pthread_t g_tx_thread[V2X_OBU_IF_MAX_NUM]; ///< 인터페이스 별 송신쓰레드
+static pthread_t g_tx_ipc_thread[V2X_OBU_IF_MAX_NUM]; ///< 인터페이스 별 송신 메시지큐 수신쓰레드
+
+
+/**
+ * 송신 메시지큐 수신 쓰레드 함수
+ *  - 인터페이스 별로 하나씩 생성되며, 해당 인터페이스의 송신 메시지를 꺼내 송신 스케줄러에 넣는다.
+ *  - 우선순위, 송신 TimeSlot, 유효기간은 인터페이스 설정값을 사용한다.
+ *  - DCC 가 동작 중이면 PSID 별 최소 송신간격(ITT) 안에 들어온 메시지는 버린다.
+ *
+ * @param arg       송신 인터페이스 식별번호
+ * @return          NULL (프로그램 종료시에만 리턴됨)
+ */
+static void* V2X_OBU_WsmTxIpcThread(void *arg)
+{
+    const uint8_t ifindex = (uint8_t)(uintptr_t)arg;
+    const struct V2X_OBU_IF_MIB *const ifmib = &g_mib.ifs[ifindex];
+    struct V2X_OBU_TxTag tag;
+
+    /* 190827- yslee */
+    uint8_t pkt[kMpduMaxSize];
+    int len = 0;
+
+    do {
+        /* Receive MsgQ */
+        len = recvMQ(ifindex, (char *)pkt);
+        if (len < 0)
+            continue;
+
+        if (!V2X_OBU_CheckDccTx(ifindex, g_mib.psid, V2X_OBU_GetMonoTimeNs())) {
+            continue; // DCC 상태의 최소 송신간격(ITT)이 지나지 않았다.
+        }
+        V2X_OBU_InitTxTag(&tag, ifindex, g_mib.psid);
+        V2X_OBU_EnqueueTxReq(ifindex, &tag, ifmib->priority, ifmib->timeSlot, ifmib->lifetime, pkt, (uint16_t)len);
+    } while(1);
+
+    return NULL;
+}
 
 
 /**
  * WSM 송신 쓰레드 함수
- *  - 대기하고 있다가, 송신타이머쓰레드로부터 컨디션 시그널을 수신하면, WSM을 송신한다.
+ *  - 인터페이스 별로 하나씩 생성되며, 송신 스케줄러에서 꺼낸 송신 요청을 WSM 으로 송신한다.
  *
- * @param notused   사용되지 않음
+ * @param arg       송신 인터페이스 식별번호
  * @return          NULL (프로그램 종료시에만 리턴됨)
  */
-static void* V2X_OBU_WsmTxThread(void *notused)
+static void* V2X_OBU_WsmTxThread(void *arg)
 {
+    const uint8_t ifindex = (uint8_t)(uintptr_t)arg;
+    const struct V2X_OBU_IF_MIB *const ifmib = &g_mib.ifs[ifindex];
     int mpdu_size;
     uint8_t mpdu[kMpduMaxSize];
 
     struct Dot3WsmMpduTxParams wsm_params;
     struct AlMpduTxParams al_params;
-
-    /* 190827- yslee */
-    uint8_t pkt[kMpduMaxSize];
-    uint32_t len = 0;
-
+    struct V2X_OBU_TxReq req;
+    Dot3Power power;
+    Dot3DataRate datarate;
 
     do {
         if (g_dbg >= kDbgMsgLevel_msgdump) {
@@ -52,83 +89,84 @@ static void* V2X_OBU_WsmTxThread(void *notused)
             syslog(LOG_INFO | LOG_LOCAL0, "\n-- Sending WSM ---------------------------------------------\n");
         }
 
-        /* Receive MsgQ */
-        len = recvMQ(pkt);
-        if (len < 0)
-            continue;
-        else
-        {
+        /* 송신 스케줄러에서 다음 송신 요청을 꺼낸다. (유효기간이 지난 요청은 스케줄러에서 버려진다) */
+        V2X_OBU_DequeueTxReq(ifindex, &req);
+        V2X_OBU_GetDccTxParams(ifindex, &power, &datarate);
 
-            /*
-             * WSM MPDU 를 생성한다.
-             */
-            memset(&wsm_params, 0, sizeof(wsm_params));
-            wsm_params.hdr_extensions.chan_num = true;
-            wsm_params.hdr_extensions.datarate = true;
-            wsm_params.hdr_extensions.transmit_power = true;
-            wsm_params.ifindex = g_mib.netIfIndex;
-            wsm_params.chan_num = g_mib.channel;
-            wsm_params.timeslot = g_mib.timeSlot;
-            wsm_params.datarate = g_mib.dataRate;
-            wsm_params.transmit_power = g_mib.power;
-            wsm_params.priority = g_mib.priority;
-            memcpy(wsm_params.dst_mac_addr, g_mib.destMac, MAC_ALEN);
-            memcpy(wsm_params.src_mac_addr, g_if1_mac_address, MAC_ALEN);
-            wsm_params.psid = g_mib.psid;
-            mpdu_size = Dot3_ConstructWsmMpdu(&wsm_params, pkt, len, mpdu, sizeof(mpdu));
-            if (mpdu_size < 0) {
-                //printf("Fail to Dot3_ConstructWsmMpdu() - %d\n", mpdu_size);
-                //printf("------------------------------------------------------------\n\n");
-                syslog(LOG_ERR | LOG_LOCAL1, "Fail to Dot3_ConstructWsmMpdu() - %d\n", mpdu_size);
-                syslog(LOG_INFO | LOG_LOCAL0, "------------------------------------------------------------\n\n");
-                continue;
+        /*
+         * WSM MPDU 를 생성한다.
+         */
+        memset(&wsm_params, 0, sizeof(wsm_params));
+        wsm_params.hdr_extensions.chan_num = true;
+        wsm_params.hdr_extensions.datarate = true;
+        wsm_params.hdr_extensions.transmit_power = true;
+        wsm_params.ifindex = ifindex;
+        wsm_params.chan_num = ifmib->channel;
+        wsm_params.timeslot = req.timeslot;
+        wsm_params.datarate = datarate;
+        wsm_params.transmit_power = power;
+        wsm_params.priority = req.priority;
+        memcpy(wsm_params.dst_mac_addr, g_mib.destMac, MAC_ALEN);
+        memcpy(wsm_params.src_mac_addr, ifmib->macAddr, MAC_ALEN);
+        wsm_params.psid = req.tag.psid;
+        mpdu_size = Dot3_ConstructWsmMpdu(&wsm_params, req.pkt, req.len, mpdu, sizeof(mpdu));
+        if (mpdu_size < 0) {
+            //printf("Fail to Dot3_ConstructWsmMpdu() - %d\n", mpdu_size);
+            //printf("------------------------------------------------------------\n\n");
+            syslog(LOG_ERR | LOG_LOCAL1, "Fail to Dot3_ConstructWsmMpdu() - %d\n", mpdu_size);
+            syslog(LOG_INFO | LOG_LOCAL0, "------------------------------------------------------------\n\n");
+            continue;
+        }
+        req.tag.t_build = V2X_OBU_GetMonoTimeNs();
+        if (g_dbg >= kDbgMsgLevel_event) {
+            {
+                //printf("[prcsWSM] Success to construct %d-bytes WSM MPDU\n", mpdu_size);
+                syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to construct %d-bytes WSM MPDU\n", mpdu_size);
             }
-            if (g_dbg >= kDbgMsgLevel_event) {
-                {
-                    //printf("[prcsWSM] Success to construct %d-bytes WSM MPDU\n", mpdu_size);
-                    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to construct %d-bytes WSM MPDU\n", mpdu_size);
-                }
-                if (g_dbg >= kDbgMsgLevel_msgdump) {
-                    for (int i = 0; i < mpdu_size; i++) {
-                        if ((i!=0) && (i%16==0)) {
-                            printf("\n");
-                        }
-                        printf("%02X ", mpdu[i]);
+            if (g_dbg >= kDbgMsgLevel_msgdump) {
+                for (int i = 0; i < mpdu_size; i++) {
+                    if ((i!=0) && (i%16==0)) {
+                        printf("\n");
                     }
-                    printf("\n");
+                    printf("%02X ", mpdu[i]);
                 }
+                printf("\n");
             }
+        }
 
-            /*
-             * WSM MPDU 를 전송한다.
-             */
-            memset(&al_params, 0, sizeof(al_params));
-            al_params.channel = g_mib.channel;
-            al_params.timeslot = g_mib.timeSlot; // 현재까지 TimeSlot_0 동작만 확인됨.
-            al_params.datarate = g_mib.dataRate;
-            al_params.expiry = 0;
-            al_params.txpower = g_mib.power;
-            int ret = Al_TransmitMpdu(g_mib.netIfIndex, mpdu, mpdu_size, &al_params);
-            if (ret < 0) {
-                //printf("Fail to Al_TransmitMpdu() - ret: %d\n", ret);
-                //printf("------------------------------------------------------------\n\n");
-                syslog(LOG_ERR | LOG_LOCAL1, "Fail to Al_TransmitMpdu() - ret: %d\n", ret);
-                syslog(LOG_INFO | LOG_LOCAL0, "------------------------------------------------------------\n\n");
-                continue;
-            } else {
-                if (g_dbg >= kDbgMsgLevel_event)
-                {
-                    //printf("[prcsWSM] Success to Al_TransmitMpdu()\n");
-                    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to Al_TransmitMpdu()\n");
-                }
-            }
-            if (g_dbg >= kDbgMsgLevel_msgdump)
+        /*
+         * WSM MPDU 를 전송한다.
+         *  - 디바이스에도 남은 유효기간을 전달하여, 디바이스 내부에서 지연된 프레임이 늦게 송신되지 않도록 한다.
+         */
+        memset(&al_params, 0, sizeof(al_params));
+        al_params.channel = ifmib->channel;
+        al_params.timeslot = req.timeslot; // 송신 스케줄러가 해당 TimeSlot 안에서만 꺼내준다.
+        al_params.datarate = datarate;
+        al_params.expiry = V2X_OBU_GetTxReqRemainingLifetime(&req);
+        al_params.txpower = power;
+        int ret = V2X_OBU_TransmitTaggedMpdu(&req.tag, mpdu, mpdu_size, &al_params);
+        V2X_OBU_CaptureTxMpdu(&req.tag, mpdu, (uint16_t)mpdu_size, &al_params, ret);
+        if (ret < 0) {
+            //printf("Fail to Al_TransmitMpdu() - ret: %d\n", ret);
+            //printf("------------------------------------------------------------\n\n");
+            syslog(LOG_ERR | LOG_LOCAL1, "Fail to Al_TransmitMpdu() - ret: %d\n", ret);
+            syslog(LOG_INFO | LOG_LOCAL0, "------------------------------------------------------------\n\n");
+            continue;
+        } else {
+            if (g_dbg >= kDbgMsgLevel_event)
             {
-                //printf("------------------------------------------------------------\n\n");
-                syslog(LOG_INFO | LOG_LOCAL0, "------------------------------------------------------------\n\n");
+                //printf("[prcsWSM] Success to Al_TransmitMpdu()\n");
+                syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to Al_TransmitMpdu()\n");
             }
         }
+        if (g_dbg >= kDbgMsgLevel_msgdump)
+        {
+            //printf("------------------------------------------------------------\n\n");
+            syslog(LOG_INFO | LOG_LOCAL0, "------------------------------------------------------------\n\n");
+        }
     } while(1);
+
+    return NULL;
 }
 
 
@@ -207,11 +245,24 @@ int V2X_OBU_InitWsmTx(const uint32_t timer_interval)
 {
     //printf("Initializing WSM tx operation\n");
     syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Initializing WSM tx operation\n");
-    int ret = pthread_create(&g_tx_thread, NULL, V2X_OBU_WsmTxThread, NULL);
-    if (ret < 0) {
-        //perror("Fail to create WSM tx thread() ");
-        syslog(LOG_ERR | LOG_LOCAL1, "Fail to create WSM tx thread() : %s\n", strerror(errno));
-        return -1;
+    V2X_OBU_InitTxSched();
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        if (!g_mib.ifs[i].enable) {
+            continue;
+        }
+        int ret = pthread_create(&g_tx_thread[i], NULL, V2X_OBU_WsmTxThread, (void *)(uintptr_t)i);
+        if (ret) {
+            //perror("Fail to create WSM tx thread() ");
+            syslog(LOG_ERR | LOG_LOCAL1, "Fail to create WSM tx thread() for if%d : %s\n", i, strerror(ret));
+            return -1;
+        }
+        V2X_OBU_SetThreadAffinity(g_tx_thread[i], g_mib.ifs[i].txCpu);
+        ret = pthread_create(&g_tx_ipc_thread[i], NULL, V2X_OBU_WsmTxIpcThread, (void *)(uintptr_t)i);
+        if (ret) {
+            syslog(LOG_ERR | LOG_LOCAL1, "Fail to create WSM tx ipc thread() for if%d : %s\n", i, strerror(ret));
+            return -1;
+        }
+        V2X_OBU_SetThreadAffinity(g_tx_ipc_thread[i], g_mib.ifs[i].txCpu);
     }
 
     //printf("Success to initialize WSM tx operation\n");
@@ -5,6 +5,9 @@
  * @brief v2x-obu 어플리케이션 메인 파일
  */
 
+#define _GNU_SOURCE
+#include <sched.h>
+#include <time.h>
 
 #include "dot3/dot3.h"
 #include "wlanaccess/wlanaccess.h"
@@ -20,6 +23,48 @@ DbgMsgLevel g_dbg = kDbgMsgLevel_nothing;  ///< 디버그메시지 출력레벨
  */
 const uint8_t g_if0_mac_address[] = { 0x00, 0x49, 0x54, 0x45, 0xCC, 0x00};
 const uint8_t g_if1_mac_address[] = { 0x00, 0x49, 0x54, 0x45, 0xCC, 0x01};
+const uint8_t *const g_if_mac_address[V2X_OBU_IF_MAX_NUM] = { g_if0_mac_address, g_if1_mac_address };
+
+
+/**
+ * 쓰레드를 특정 CPU 코어에 할당한다.
+ *
+ * @param thread    쓰레드
+ * @param cpu       CPU 코어 번호 (CPU_NOT_SPECIFIED 이면 할당하지 않는다)
+ * @return          성공 시 0, 실패 시 -1
+ */
+int V2X_OBU_SetThreadAffinity(const pthread_t thread, const int cpu)
+{
+    cpu_set_t cpuset;
+    int ret;
+
+    if (cpu == CPU_NOT_SPECIFIED) {
+        return 0;
+    }
+
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    ret = pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+    if (ret) {
+        syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Fail to set thread affinity to cpu %d : %s\n", cpu, strerror(ret));
+        return -1;
+    }
+    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Set thread affinity to cpu %d\n", cpu);
+    return 0;
+}
+
+
+/**
+ * 현재 시각을 반환한다.
+ *
+ * @return  CLOCK_MONOTONIC 시각 (나노초)
+ */
+uint64_t V2X_OBU_GetMonoTimeNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
 
 
 /**
@@ -67,7 +112,9 @@ static int V2X_OBU_InitV2XLibs(void)
  * @param argv  어플리케이션 실행 시 입력되는 명령줄 내 파라미터들의 문자열 집합 (어플리케이션 실행파일명 포함)
  * @return      성공 시 0, 실패 시 -1
  */
+#ifndef V2X_OBU_NO_MAIN   /* 성능측정 프로그램(bench/)은 자체 main 함수를 사용한다. */
 #define V2X_OBU_Main  main
+#endif
 int V2X_OBU_Main(int argc, char *argv[])
 {
     int ret;
@@ -77,13 +124,21 @@ int V2X_OBU_Main(int argc, char *argv[])
 
     /* MIB 초기화 및 입력 파라미터 설정 */
     memset(&g_mib, 0, sizeof(struct V2X_OBU_MIB));
-    g_mib.netIfIndex = 0;
-    g_mib.channel = 178;
-    g_mib.priority = 7;
-    g_mib.timeSlot = kDot3TimeSlot_0;
-    g_mib.dataRate = 12;
-    g_mib.power = 20;
     memset(g_mib.destMac, 0xff, kDot3MacAddrSize);
+    g_mib.telemetry_interval = V2X_OBU_TELEMETRY_DEFAULT_INTERVAL;
+    g_mib.wsa.repeat_rate = V2X_OBU_WSA_DEFAULT_REPEAT_RATE;
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        g_mib.ifs[i].enable = false;
+        g_mib.ifs[i].channel = (i == 0) ? IF0_CHAN_NUM : IF1_CHAN_NUM;
+        g_mib.ifs[i].priority = 7;
+        g_mib.ifs[i].timeSlot = kDot3TimeSlot_0;
+        g_mib.ifs[i].dataRate = (i == 0) ? IF0_DATARATE : IF1_DATARATE;
+        g_mib.ifs[i].power = (i == 0) ? IF0_POWER : IF1_POWER;
+        g_mib.ifs[i].lifetime = V2X_OBU_TX_DEFAULT_LIFETIME;
+        g_mib.ifs[i].macAddr = g_if_mac_address[i];
+        g_mib.ifs[i].txCpu = CPU_NOT_SPECIFIED;
+        g_mib.ifs[i].rxCpu = CPU_NOT_SPECIFIED;
+    }
 
 	/* 사용자가 입력한 파라미터들을 MIB에 저장한다. */
 	ret =	ParsingOptions(argc, argv);
@@ -96,56 +151,92 @@ int V2X_OBU_Main(int argc, char *argv[])
         return -1;
     }
 
+    /* 운용할 인터페이스가 플랫폼에서 지원되는지 확인한다. */
+    for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+        if (g_mib.ifs[i].enable && (i >= g_mib.if_num)) {
+            syslog(LOG_ERR | LOG_LOCAL1, "[prcsWSM] Interface %d is not supported - %u interface is supported\n", i, g_mib.if_num);
+            return -1;
+        }
+    }
+
 #if 0
-    /* 채널 접속*/
-    ret = V2X_OBU_AccessChannel(g_mib.netIfIndex, g_mib.channel, g_mib.channel);
+    /*
+     * 채널 접속 및 인터페이스 MAC 주소 설정
+     *  - 모든 인터페이스에 동시에 요청하고, 결과 콜백을 타임아웃을 두고 대기한다. (결과를 받지 못해도 무한대기하지 않는다)
+     */
+    ret = V2X_OBU_AccessChannelAll();
     if (ret < 0) {
         return ret;
     }
-    //printf("Success to access chanel %d on if%d\n", g_mib.channel, g_mib.netIfIndex);
-    syslog(LOG_INFO | LOG_LOCAL0, "[prcsWSM] Success to access chanel %d on if%d\n", g_mib.channel, g_mib.netIfIndex);
-
-    /* 인터페이스 MAC 주소 설정*/
-    ret = V2X_OBU_SetIfMacAddress(g_mib.netIfIndex, g_if0_mac_address);
+    ret = V2X_OBU_SetIfMacAddressAll();
     if (ret < 0) {
         return ret;
     }
-    printf("Success to set mac address %02X:%02X:%02X:%02X:%02X:%02X on if0\n",
-            g_if0_mac_address[0], g_if0_mac_address[1], g_if0_mac_address[2],
-            g_if0_mac_address[3], g_if0_mac_address[4], g_if0_mac_address[5]);
 #endif
 
     /* MsgQ Open */
     if(initMQ() == -1)
         return -1;
 
-    if(g_mib.op == opTX || g_mib.op == opTRX)
+    /* 송수신 MPDU 캡쳐 시작 - 송수신 쓰레드보다 먼저 시작하여 처음부터 캡쳐한다. */
+    if (g_mib.capture_path) {
+        ret = V2X_OBU_InitCapture(g_mib.capture_path);
+        if (ret < 0) {
+            return -1;
+        }
+    }
+
+    /*
+     * 송신/수신 파이프라인을 각각 독립된 쓰레드로 시작한다.
+     *  - TRX 동작 시 두 파이프라인이 모두 시작된다.
+     *  - 운용하는 인터페이스마다 송신쓰레드와 수신쓰레드가 하나씩 생성된다.
+     *  - 송신: J2735 송신 메시지큐 -> 메시지큐 수신쓰레드 -> 송신 스케줄러(AC 별 큐) -> 송신쓰레드 -> Al_TransmitMpdu()
+     *  - 수신: MPDU 수신 콜백(폴링쓰레드) -> 수신 큐 -> 수신쓰레드 -> J2735/PAR 수신 메시지큐
+     */
+    if(g_mib.op == opRX || g_mib.op == opTRX)
     {
-        /* WSM 송신 타이머 생성- 시나리오: WSM을 정해진 주기로 전송된다.*/
-        ret = V2X_OBU_InitWsmTx(WSM_TX_INTERVAL);
+        ret = V2X_OBU_InitWsmRx();
         if (ret < 0) {
             return -1;
         }
 
-        /* 액세스계층 이벤트 폴링 쓰레드 종료 대기 - 프로그램 종료 방지*/
-        V2X_OBU_WaitEventPolling();
+        /* 서비스 접속 모드 인터페이스는 CCH 를 탐색하며 WSA 로 광고된 서비스채널에 자동 접속한다. */
+        for (int i = 0; i < V2X_OBU_IF_MAX_NUM; i++) {
+            if (g_mib.ifs[i].enable && g_mib.ifs[i].svcJoin) {
+                ret = V2X_OBU_InitSvcJoin();
+                if (ret < 0) {
+                    return -1;
+                }
+                break;
+            }
+        }
     }
-    else if(g_mib.op == opRX || g_mib.op == opTRX)
+    if(g_mib.op == opTX || g_mib.op == opTRX)
     {
-#if 0
-        ret = rtcmCheckTimer(1000000);
-        if(ret < 0)
-        {
-            printf("prcsWSM] Timer init fail \n");
+        /* WSM 송신 타이머 생성- 시나리오: WSM을 정해진 주기로 전송된다.*/
+        ret = V2X_OBU_InitWsmTx(WSM_TX_INTERVAL);
+        if (ret < 0) {
             return -1;
         }
-#endif
-        while(1)
-        {
-            sleep(1);
-        }
 
+        /* WSA 송신 - 캐시된 WSA 를 반복주기(5초당 repeat_rate 회)마다 WSA 송신 인터페이스로 송신한다. */
+        if (g_mib.wsa.enable) {
+            ret = V2X_OBU_InitWsaTx(5000000 / g_mib.wsa.repeat_rate);
+            if (ret < 0) {
+                return -1;
+            }
+        }
     }
+
+    /* DCC 시작 - 실패하면 DCC 없이 송수신 동작을 계속한다. */
+    V2X_OBU_InitDcc();
+
+    /* 통계 텔레메트리 시작 - 실패해도 송수신 동작은 계속한다. */
+    V2X_OBU_InitTelemetry();
+
+    /* 액세스계층 이벤트 폴링 쓰레드 종료 대기 - 프로그램 종료 방지*/
+    V2X_OBU_WaitEventPolling();
+
     /* MsgQ Close */
     releaseMQ();
 
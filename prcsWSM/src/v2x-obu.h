@@ -16,6 +16,8 @@
 #include <msgQ.h>
 #include <syslog.h>
 #include "dot3/dot3.h"
+#include "wlanaccess/wlanaccess.h"
+#include "v2x-obu-shm-stats.h"
 
 
 // 서비스 PSID
@@ -51,6 +53,79 @@
 // 전송 주기
 #define WSM_TX_INTERVAL (2000000) // 1usec 단위
 
+// 수신 MPDU 큐 크기 (이벤트 폴링 쓰레드 -> 수신 쓰레드)
+#define RX_MPDU_QUEUE_SIZE (64)
+
+// 쓰레드 CPU 코어 미지정
+#define CPU_NOT_SPECIFIED (-1)
+
+// 한 프로세스에서 동시에 운용 가능한 최대 인터페이스 개수
+#define V2X_OBU_IF_MAX_NUM (2)
+
+// 액세스계층 제어요청 결과 대기시간 (msec 단위)
+#define V2X_OBU_AL_REQ_TIMEOUT (200)
+// 액세스계층 제어요청 최대 시도 횟수 (결과 대기시간 초과 시 재시도)
+#define V2X_OBU_AL_REQ_TRY_NUM (3)
+
+/// 결과 콜백으로 완료가 통지되는 액세스계층 제어요청 종류
+enum eV2XObuAlReqKind {
+  kV2XObuAlReq_AccessChannel, ///< Al_AccessChannel()
+  kV2XObuAlReq_SetIfMacAddress, ///< Al_SetIfMacAddress()
+  kV2XObuAlReq_Num
+};
+typedef uint32_t V2XObuAlReqKind; ///< @copydoc eV2XObuAlReqKind
+
+// WSA 기본 반복주기 (5초당 송신 횟수)
+#define V2X_OBU_WSA_DEFAULT_REPEAT_RATE (50)
+// WSA 를 다시 인코딩하는 위치 이동 거리 임계값 (m 단위)
+#define V2X_OBU_WSA_LOC_THRESHOLD (5)
+
+// 수신 WSA 캐시 - 인터페이스 별 엔트리 개수 (송신지 MAC 주소 + WSA 내용 별로 하나씩 사용)
+#define V2X_OBU_RX_WSA_CACHE_SIZE (32)
+// 수신 WSA 캐시 - 송신지 하나가 사용할 수 있는 최대 엔트리 개수 (WSA 내용이 계속 바뀌는 송신지가 캐시를 독차지하지 않도록)
+#define V2X_OBU_RX_WSA_CACHE_SRC_MAX_NUM (4)
+
+// 서비스 접속 모드 - 광고된 반복주기의 몇 배 동안 WSA 가 수신되지 않으면 만료로 판단할지
+#define V2X_OBU_SVC_TIMEOUT_REPEAT_NUM (3)
+// 서비스 접속 모드 - WSA 에 반복주기가 없을 때의 WSA 만료시간 (msec 단위)
+#define V2X_OBU_SVC_DEFAULT_TIMEOUT (5000)
+// 서비스 접속 모드 - 접속 상태 확인 주기 (msec 단위)
+#define V2X_OBU_SVC_CHECK_INTERVAL (100)
+// 서비스 접속 모드 - WSA count threshold 확인을 위해 기록하는 최근 WSA 수신시각 개수
+#define V2X_OBU_SVC_WSA_CNT_MAX_NUM (kDot3WsaCountThreshold_Max + 1)
+
+// DCC - 최대 상태 개수
+#define V2X_OBU_DCC_STATE_MAX_NUM (8)
+// DCC - CBR 측정주기 (msec 단위)
+#define V2X_OBU_DCC_MEAS_INTERVAL (100)
+// DCC - 상향 전이에 필요한 기본 연속 측정 횟수
+#define V2X_OBU_DCC_DEFAULT_UP_NUM (2)
+// DCC - 하향 전이에 필요한 기본 연속 측정 횟수
+#define V2X_OBU_DCC_DEFAULT_DOWN_NUM (10)
+
+/**
+ * DCC 상태 정보
+ */
+struct V2X_OBU_DccState
+{
+  uint16_t cbr;           ///< 이 상태로 진입하는 CBR 하한 (0.1% 단위)
+  uint16_t itt;           ///< PSID 별 최소 송신간격 (msec 단위, 0 이면 제한하지 않음)
+  Dot3Power power;        ///< 최대 송신파워 (dBm)
+  Dot3DataRate datarate;  ///< 최소 송신 DataRate (500kbps 단위, 인터페이스 설정값이 더 높거나 0 이면 인터페이스 설정값 사용)
+};
+
+// 캡쳐 링 크기 (MPDU 개수, 2의 거듭제곱)
+#define V2X_OBU_CAPTURE_RING_SIZE (2048)
+// 캡쳐 링이 비어 있을 때 캡쳐 쓰레드가 쉬는 시간 (msec 단위)
+#define V2X_OBU_CAPTURE_POLL_INTERVAL (1)
+// 캡쳐 파일 flush 및 ISB 기록 주기 (msec 단위)
+#define V2X_OBU_CAPTURE_FLUSH_INTERVAL (1000)
+// 캡쳐 파일 버퍼 크기
+#define V2X_OBU_CAPTURE_FILE_BUF_SIZE (1 << 20)
+
+// 텔레메트리 기본 주기 (msec 단위)
+#define V2X_OBU_TELEMETRY_DEFAULT_INTERVAL (1000)
+
 // 로그메시지 출력 레벨
 enum eDbgMsgLevel {
   kDbgMsgLevel_nothing, ///< 미출력
@@ -67,24 +142,185 @@ typedef enum
     opTRX
 } op_e;
 
-struct V2X_OBU_MIB
+// 송신 지연 히스토그램 구간 개수 (구간 i = [2^i, 2^(i+1)) usec)
+#define V2X_OBU_LATENCY_HIST_BIN_NUM (20)
+// 송신 통계를 따로 집계하는 최대 PSID 개수
+#define V2X_OBU_TX_STATS_PSID_MAX_NUM (16)
+// 송신 실패 상세 에러코드를 따로 집계하는 최대 개수
+#define V2X_OBU_TX_ERRCODE_MAX_NUM (8)
+
+/**
+ * 송신 태그 - 송신되는 WSM 하나의 처리 단계별 시각 (CLOCK_MONOTONIC, 나노초)
+ */
+struct V2X_OBU_TxTag
 {
-    uint8_t if_num; ///< v2x 송수신 인터페이스 총 개수 (플랫폼 하드웨어에 의존적이다)
+  uint32_t seq;         ///< 태그 일련번호
+  uint8_t  ifindex;     ///< 송신 인터페이스 식별번호
+  Dot3Psid psid;        ///< 송신 PSID
+  uint64_t t_dequeue;   ///< 메시지큐에서 꺼낸 시각
+  uint64_t t_build;     ///< MPDU 생성 완료 시각
+  uint64_t t_submit;    ///< Al_TransmitMpdu() 리턴 시각
+  uint64_t t_complete;  ///< 송신결과 콜백 호출 시각
+};
 
-  /* 동작변수 */
-  op_e op;
+/**
+ * 송신 통계정보 (인터페이스 별 또는 PSID 별)
+ */
+struct V2X_OBU_TxStats
+{
+  uint32_t tx_cnt;              ///< 송신요청 개수
+  uint32_t submit_fail_cnt;     ///< Al_TransmitMpdu() 실패 개수
+  uint32_t complete_cnt;        ///< 송신결과 수신 개수
+  uint32_t complete_fail_cnt;   ///< 송신결과가 실패인 개수
+  uint32_t untracked_cnt;       ///< 송신중 FIFO 가 가득 차서 추적하지 못한 개수
+  uint32_t lost_cnt;            ///< 유효기간이 지나도록 송신결과를 받지 못해 버려진 개수
+  struct {
+    int errcode;
+    uint32_t cnt;
+  } errcode[V2X_OBU_TX_ERRCODE_MAX_NUM]; ///< 상세 에러코드 별 송신실패 개수
+  uint32_t other_errcode_cnt;   ///< errcode 에 집계되지 못한 송신실패 개수
+  uint32_t hist_pipeline[V2X_OBU_LATENCY_HIST_BIN_NUM]; ///< 메시지큐 ~ Al_TransmitMpdu() 리턴
+  uint32_t hist_radio[V2X_OBU_LATENCY_HIST_BIN_NUM];    ///< Al_TransmitMpdu() 리턴 ~ 송신결과 콜백
+  uint32_t hist_total[V2X_OBU_LATENCY_HIST_BIN_NUM];    ///< 메시지큐 ~ 송신결과 콜백
+};
+
+// 송신 요청 기본 유효기간 (1usec 단위)
+#define V2X_OBU_TX_DEFAULT_LIFETIME (1000000)
+
+/// 802.11p EDCA AC(Access Category). 값이 클수록 우선순위가 높다.
+enum eV2XObuAc {
+  kV2XObuAc_BK, ///< Background (UP 1, 2)
+  kV2XObuAc_BE, ///< Best effort (UP 0, 3)
+  kV2XObuAc_VI, ///< Video (UP 4, 5)
+  kV2XObuAc_VO, ///< Voice (UP 6, 7)
+  kV2XObuAc_Num
+};
+typedef uint32_t V2XObuAc; ///< @copydoc eV2XObuAc
+
+// 송신 스케줄러의 TimeSlot 별 큐 개수 (TimeSlot0, TimeSlot1, Continuous)
+#define V2X_OBU_TX_SLOT_NUM (3)
+// 교번 채널접속 시 TimeSlot 길이 (1usec 단위, IEEE 1609.4 SyncInterval 100msec 의 절반)
+#define V2X_OBU_TIMESLOT_INTERVAL (50000)
+// TimeSlot 시작 후 송신하지 않는 guard interval (1usec 단위)
+#define V2X_OBU_TIMESLOT_GUARD_INTERVAL (4000)
+
+/**
+ * 송신 스케줄러에 저장되는 송신 요청
+ */
+struct V2X_OBU_TxReq
+{
+  struct V2X_OBU_TxTag tag; ///< 송신 태그
+  Dot3Priority priority;    ///< 사용자 우선순위
+  Dot3TimeSlot timeslot;    ///< 송신 TimeSlot
+  uint64_t deadline;        ///< 유효기간 만료 시각 (CLOCK_MONOTONIC, 나노초). 0 이면 만료되지 않음
+  bool deferred;            ///< 다음 TimeSlot 으로 미뤄진 적이 있는지 여부 (미뤄진 횟수를 요청 당 한 번만 세기 위함)
+  uint16_t len;             ///< 페이로드 길이
+  uint8_t pkt[kMpduMaxSize]; ///< 페이로드 (WSM body)
+};
+
+/**
+ * 송신 스케줄러 AC 별 통계정보
+ */
+struct V2X_OBU_TxSchedStats
+{
+  uint32_t queued;        ///< 현재 큐에 대기 중인 요청 개수
+  uint32_t enqueue_cnt;   ///< 큐에 들어온 요청 개수
+  uint32_t dequeue_cnt;   ///< 송신을 위해 꺼낸 요청 개수
+  uint32_t expire_cnt;    ///< 유효기간 만료로 버려진 요청 개수
+  uint32_t overflow_cnt;  ///< 큐가 가득 차서 버려진 요청 개수
+};
+
+/**
+ * 송신 스케줄러 TimeSlot 별 통계정보
+ */
+struct V2X_OBU_TxSlotStats
+{
+  uint32_t slot_cnt;      ///< 시작된 TimeSlot 개수 (TimeSlot 이벤트 수신 횟수)
+  uint32_t tx_cnt;        ///< 해당 TimeSlot 에 송신을 위해 꺼낸 요청 개수
+  uint32_t deferred_cnt;  ///< 남은 시간이 부족하여 다음 TimeSlot 으로 미뤄진 요청 개수
+  uint64_t tx_bytes;      ///< 송신 페이로드 바이트 수
+  uint64_t airtime;       ///< 추정 송신시간 합 (usec)
+};
+
+/**
+ * 인터페이스 별 prcsWSM 카운터 - V2X_OBU_INC_CNT() 로 증가시킨다.
+ */
+struct V2X_OBU_Counters
+{
+  uint64_t rx_mpdu;           ///< 수신 MPDU
+  uint64_t rx_queue_drop;     ///< 수신 큐가 가득 차서 버려진 MPDU
+  uint64_t rx_parse_fail;     ///< WSM 파싱 실패
+  uint64_t rx_wsa;            ///< 수신 WSA
+  uint64_t rx_wsa_parse_fail; ///< WSA 파싱 실패
+  uint64_t rx_wsa_cache_hit;  ///< 이전과 동일하여 WSA 파싱을 생략한 수신 WSA
+  uint64_t rx_wsa_cache_miss; ///< 새로 파싱한 수신 WSA
+  uint64_t rx_ipc;            ///< 수신 메시지큐 전달 성공
+  uint64_t rx_ipc_fail;       ///< 수신 메시지큐 전달 실패
+  uint64_t tx_ipc;            ///< 송신 메시지큐 수신
+  uint64_t tx_ipc_fail;       ///< 송신 메시지큐 수신 실패
+  uint64_t tx_wsa;            ///< 송신 스케줄러에 넣은 WSA
+  uint64_t tx_wsa_encode;     ///< WSA 인코딩 (캐시 갱신)
+  uint64_t svc_join;          ///< 서비스채널 접속
+  uint64_t svc_leave;         ///< 서비스채널 이탈 (WSA 만료)
+  uint64_t dcc_drop;          ///< DCC ITT 제한으로 버려진 송신 메시지
+  uint64_t dcc_state_change;  ///< DCC 상태 전이
+  uint64_t cap_pkt;           ///< 캡쳐 파일에 기록된 MPDU
+  uint64_t cap_drop;          ///< 캡쳐 링이 가득 차서 버려진 MPDU
+};
+
+/// prcsWSM 카운터 증가 (여러 쓰레드에서 잠금 없이 호출 가능)
+#define V2X_OBU_INC_CNT(ifindex, name) \
+  do { if ((ifindex) < V2X_OBU_IF_MAX_NUM) __atomic_fetch_add(&g_cnt[(ifindex)].name, 1, __ATOMIC_RELAXED); } while (0)
+
+/**
+ * 인터페이스 별 관리정보
+ */
+struct V2X_OBU_IF_MIB
+{
+  bool              enable; ///< 운용 여부
 
   /* 송신환경 변수 */
-  uint32_t          netIfIndex;
-  uint8_t           destMac[kDot3MacAddrSize];
   Dot3ChannelNumber channel;
   Dot3Priority      priority;
   Dot3TimeSlot      timeSlot;
   Dot3DataRate      dataRate;
   Dot3Power         power;
+  uint32_t          lifetime; ///< 송신 요청 유효기간 (1usec 단위, 0 이면 만료되지 않음)
+  const uint8_t     *macAddr; ///< 인터페이스 MAC 주소 (송신 MPDU 의 송신지 주소)
+  bool              svcJoin;  ///< 서비스 접속 모드 - channel 을 CCH 로 탐색하며 WSA 로 광고된 서비스채널에 자동 접속
+
+  /* 쓰레드 CPU 코어 (CPU_NOT_SPECIFIED 이면 지정하지 않음) */
+  int               txCpu;
+  int               rxCpu;
+};
+
+struct V2X_OBU_MIB
+{
+    uint8_t if_num; ///< v2x 송수신 인터페이스 총 개수 (플랫폼 하드웨어에 의존적이다)
+
+  /* 동작변수 */
+  op_e op;
+
+  /* 송신환경 변수 */
+  uint8_t           destMac[kDot3MacAddrSize];
   Dot3Psid          psid;
-  int16_t rxpower;
-  uint8_t rcpi;
+
+  /* 인터페이스 별 관리정보 */
+  struct V2X_OBU_IF_MIB ifs[V2X_OBU_IF_MAX_NUM];
+
+  uint32_t telemetry_interval; ///< 텔레메트리 주기 (msec 단위, 0 이면 동작하지 않음)
+  const char *capture_path;    ///< 송수신 MPDU 캡쳐 파일 경로 (NULL 이면 캡쳐하지 않음)
+
+  /* WSA 송신 */
+  struct {
+    bool enable;                      ///< WSA 송신 여부
+    uint8_t ifindex;                  ///< WSA 를 송신할 인터페이스 (CCH 에 접속하는 인터페이스)
+    Dot3WsaIdentifier wsa_id;
+    Dot3WsaRepeatRate repeat_rate;    ///< 5초당 송신 횟수
+    Dot3ChannelNumber service_chan;   ///< 송신 PSID 서비스를 광고할 서비스채널 (0 이면 PSR 을 등록하지 않음)
+    bool loc_valid;                   ///< loc 설정 여부
+    struct Dot3WsaThreeDLocation loc; ///< WSA 에 수납할 고정 위치
+  } wsa;
 
 };
 
@@ -96,6 +332,14 @@ extern struct V2X_OBU_MIB g_mib;
 extern DbgMsgLevel g_dbg;
 extern const uint8_t g_if0_mac_address[];
 extern const uint8_t g_if1_mac_address[];
+extern const uint8_t *const g_if_mac_address[];
+extern struct V2X_OBU_Counters g_cnt[V2X_OBU_IF_MAX_NUM];
+
+/*
+ * v2x-obu.c
+ */
+int V2X_OBU_SetThreadAffinity(const pthread_t thread, const int cpu);
+uint64_t V2X_OBU_GetMonoTimeNs(void);
 
 /*
  * v2x-obu-libdot3.c
@@ -107,26 +351,127 @@ int V2X_OBU_InitDot3Library(int log_level);
  */
 int V2X_OBU_OpenAccessLibrary(const int log_level);
 int V2X_OBU_AccessChannel(const uint8_t if_idx, const uint8_t ts0_chan, const uint8_t ts1_chan);
+int V2X_OBU_AccessChannelAll(void);
 int V2X_OBU_GetCurrentChannel(uint8_t *const ts0_chan, uint8_t *const ts1_chan);
 int V2X_OBU_SetIfMacAddress(const uint8_t if_idx, const uint8_t *addr);
+int V2X_OBU_SetIfMacAddressAll(void);
 void V2X_OBU_WaitEventPolling(void);
 
 /*
  * v2s-obu-rx.c
  */
-void V2X_OBU_ProcessRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size);
+void V2X_OBU_ProcessRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size, struct msgQ_rx_meta *const meta);
+int V2X_OBU_EnqueueRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size, const struct msgQ_rx_meta *const meta);
+int V2X_OBU_EnqueueRxMpdus(
+        const uint8_t *const *const mpdus,
+        const uint16_t *const mpdu_sizes,
+        const struct msgQ_rx_meta *const metas,
+        const unsigned int num);
+int V2X_OBU_InitWsmRx(void);
 //int rtcmCheckTimer(const uint32_t interval);
 
 /*
- * v2x-obu-wsa.c
+ * v2x-obu-rx-wsa.c
+ */
+int V2X_OBU_ParseRxWsa(
+        const uint8_t *const wsa,
+        const uint16_t wsa_size,
+        const struct msgQ_rx_meta *const meta,
+        const struct Dot3ParseWsaParams **const params);
+
+/*
+ * v2x-obu-tx-wsa.c
  */
+int V2X_OBU_SetWsaLocation(const Dot3Latitude latitude, const Dot3Longitude longitude, const Dot3Elevation elevation);
 int V2X_OBU_InitWsaTx(const uint32_t timer_interval);
 
+/*
+ * v2x-obu-capture.c
+ */
+void V2X_OBU_CaptureRxMpdu(const uint8_t *const mpdu, const uint16_t mpdu_size, const struct msgQ_rx_meta *const meta);
+void V2X_OBU_CaptureTxMpdu(
+        const struct V2X_OBU_TxTag *const tag,
+        const uint8_t *const mpdu,
+        const uint16_t mpdu_size,
+        const struct AlMpduTxParams *const al_params,
+        const int ret);
+int V2X_OBU_InitCapture(const char *const path);
+
+/*
+ * v2x-obu-dcc.c
+ */
+int V2X_OBU_ConfigDcc(const char *const conf);
+void V2X_OBU_CountDccRxAirtime(const uint8_t ifindex, const uint16_t mpdu_size, const uint8_t datarate);
+void V2X_OBU_GetDccTxParams(const uint8_t ifindex, Dot3Power *const power, Dot3DataRate *const datarate);
+bool V2X_OBU_CheckDccTx(const uint8_t ifindex, const Dot3Psid psid, const uint64_t now);
+bool V2X_OBU_GetDccStatus(const uint8_t ifindex, uint32_t *const cbr, uint32_t *const state, struct V2X_OBU_DccState *const st);
+int V2X_OBU_InitDcc(void);
+
+/*
+ * v2x-obu-svc-join.c
+ */
+void V2X_OBU_ProcessRxWsaForSvcJoin(const struct Dot3ParseWsaParams *const wsa, const struct msgQ_rx_meta *const meta);
+void V2X_OBU_GetSvcJoinStatus(const uint8_t ifindex, uint8_t *const sch, uint32_t *const latency);
+int V2X_OBU_InitSvcJoin(void);
+
 /*
  * v2x-obu-wsm.c
  */
 int V2X_OBU_InitWsmTx(const uint32_t timer_interval);
 
+/*
+ * v2x-obu-tx-stats.c
+ */
+void V2X_OBU_InitTxTag(struct V2X_OBU_TxTag *const tag, const uint8_t ifindex, const Dot3Psid psid);
+int V2X_OBU_TransmitTaggedMpdu(
+        struct V2X_OBU_TxTag *const tag,
+        const uint8_t *const mpdu,
+        const uint16_t mpdu_size,
+        const struct AlMpduTxParams *const al_params);
+void V2X_OBU_ProcessTxResult(const AlTxResultCode result, const int errcode);
+int V2X_OBU_GetTxStats(
+        struct V2X_OBU_TxStats *const if_stats,
+        Dot3Psid *const psid,
+        struct V2X_OBU_TxStats *const psid_stats);
+void V2X_OBU_PrintTxStats(void);
+
+/*
+ * v2x-obu-tx-sched.c
+ */
+V2XObuAc V2X_OBU_GetAcFromPriority(const Dot3Priority priority);
+uint32_t V2X_OBU_GetTxAirtime(const uint32_t mpdu_size, const Dot3DataRate datarate);
+void V2X_OBU_InitTxSched(void);
+void V2X_OBU_ProcessTimeSlotEvent(const Dot3TimeSlot slot);
+int V2X_OBU_EnqueueTxReq(
+        const uint8_t ifindex,
+        const struct V2X_OBU_TxTag *const tag,
+        const Dot3Priority priority,
+        const Dot3TimeSlot timeslot,
+        const uint32_t lifetime,
+        const uint8_t *const pkt,
+        const uint16_t len);
+void V2X_OBU_DequeueTxReq(const uint8_t ifindex, struct V2X_OBU_TxReq *const req);
+uint64_t V2X_OBU_GetTxReqRemainingLifetime(const struct V2X_OBU_TxReq *const req);
+void V2X_OBU_GetTxSchedStats(
+        const uint8_t ifindex,
+        struct V2X_OBU_TxSchedStats *const stats,
+        struct V2X_OBU_TxSlotStats *const slot_stats);
+void V2X_OBU_PrintTxSchedStats(void);
+
+/*
+ * v2x-obu-al-req.c
+ */
+void V2X_OBU_InitAlReq(void);
+uint32_t V2X_OBU_StartAlReq(const V2XObuAlReqKind kind, const uint8_t ifindex);
+void V2X_OBU_CompleteAlReq(const V2XObuAlReqKind kind, const uint8_t ifindex);
+int V2X_OBU_WaitAlReq(const V2XObuAlReqKind kind, const uint8_t ifindex, const uint32_t token, const uint32_t timeout);
+
+/*
+ * v2x-obu-telemetry.c
+ */
+void V2X_OBU_CountRxPsid(const Dot3Psid psid);
+int V2X_OBU_InitTelemetry(void);
+
 /* options.c */
 int32_t ParsingOptions(int32_t argc, char *argv[]);
 